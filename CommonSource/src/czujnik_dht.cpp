@@ -0,0 +1,171 @@
+/*
+ * czujnik_dht.cpp
+ *
+ * Nieblokujący sterownik DHT22 (opis protokołu i stanów w czujnik_dht.h).
+ * Przerwanie tylko zapisuje czasy zboczy - dekodowanie odbywa się w pętli.
+ */
+
+#include "czujnik_dht.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#endif
+
+// === DEKODOWANIE (bez Arduino) ===
+
+WynikDHT dhtDekoduj(const uint32_t* czasy, uint8_t liczba, uint8_t ramka[DHT_RAMKA_BAJTY]) {
+    if (liczba < DHT_BITY + 1) return DHT_BLAD_CZASU;
+
+    // Ostatnie 41 zboczy wyznacza 40 okresów bitów
+    const uint32_t* bity = czasy + (liczba - (DHT_BITY + 1));
+    memset(ramka, 0, DHT_RAMKA_BAJTY);
+    for (uint8_t i = 0; i < DHT_BITY; i++) {
+        uint32_t okres = bity[i + 1] - bity[i];
+        if (okres < DHT_MIN_OKRES_US || okres > DHT_MAX_OKRES_US) return DHT_BLAD_CZASU;
+        if (okres > DHT_PROG_JEDYNKI_US) {
+            ramka[i / 8] |= (uint8_t)(0x80 >> (i % 8));
+        }
+    }
+
+    uint8_t suma = (uint8_t)(ramka[0] + ramka[1] + ramka[2] + ramka[3]);
+    return suma == ramka[4] ? DHT_OK : DHT_BLAD_SUMY;
+}
+
+void dhtPrzelicz(const uint8_t ramka[DHT_RAMKA_BAJTY], float* temperatura, float* wilgotnosc) {
+    // Wartości w dziesiątych, najstarszy bit temperatury to znak
+    uint16_t h = ((uint16_t)ramka[0] << 8) | ramka[1];
+    uint16_t t = ((uint16_t)(ramka[2] & 0x7F) << 8) | ramka[3];
+    *wilgotnosc = h * 0.1f;
+    *temperatura = (ramka[2] & 0x80) ? -(t * 0.1f) : t * 0.1f;
+}
+
+#if defined(ARDUINO)
+
+// === OBSŁUGA PINU (Arduino, ESP32 i ESP8266) ===
+
+typedef enum {
+    STAN_BEZCZYNNY = 0,
+    STAN_START,          // Linia w stanie niskim (sygnał startu)
+    STAN_ODBIOR          // Przerwanie zbiera zbocza ramki
+} StanDHT;
+
+static uint8_t pinDHT = 0xFF;
+static StanDHT stan = STAN_BEZCZYNNY;
+static uint32_t startUs = 0;
+static uint32_t ostatniaTransakcjaMs = 0;
+
+// Zapisywane w przerwaniu tylko gdy odbior == true
+static volatile bool odbior = false;
+static volatile uint8_t liczbaKrawedzi = 0;
+static volatile uint32_t krawedzie[DHT_MAX_KRAWEDZI];
+
+static OdczytDHT ostatni = { NAN, NAN, false, 0, 0 };
+static StatystykiDHT statystyki;
+
+static void IRAM_ATTR przerwanieDHT() {
+    if (!odbior) return;
+    uint8_t n = liczbaKrawedzi;
+    if (n < DHT_MAX_KRAWEDZI) {
+        krawedzie[n] = micros();
+        liczbaKrawedzi = n + 1;
+    }
+}
+
+void dhtInicjalizuj(uint8_t pin) {
+    pinDHT = pin;
+    // Open-drain: ten sam tryb do nadawania startu i odbioru (bez przełączania pinMode)
+#if defined(ESP32)
+    pinMode(pin, OUTPUT_OPEN_DRAIN | PULLUP);
+#else
+    pinMode(pin, OUTPUT_OPEN_DRAIN);
+#endif
+    digitalWrite(pin, HIGH);
+    attachInterrupt(digitalPinToInterrupt(pin), przerwanieDHT, FALLING);
+    ostatniaTransakcjaMs = millis() - DHT_OKRES_MS;   // Pierwsza transakcja od razu
+    stan = STAN_BEZCZYNNY;
+}
+
+static void zakonczRamke() {
+    odbior = false;
+    uint8_t liczba = liczbaKrawedzi;
+    uint32_t czasy[DHT_MAX_KRAWEDZI];
+    for (uint8_t i = 0; i < liczba; i++) czasy[i] = krawedzie[i];
+
+    uint8_t ramka[DHT_RAMKA_BAJTY];
+    switch (dhtDekoduj(czasy, liczba, ramka)) {
+        case DHT_OK: {
+            float t, h;
+            dhtPrzelicz(ramka, &t, &h);
+            uint32_t teraz = millis();
+            ostatni.temperatura = t;
+            ostatni.wilgotnosc = h;
+            ostatni.czas_ms = teraz ? teraz : 1;
+            ostatni.numer++;
+            statystyki.poprawne++;
+            break;
+        }
+        case DHT_BLAD_SUMY:
+            statystyki.bledy_sumy++;
+            break;
+        default:
+            statystyki.bledy_czasu++;
+            break;
+    }
+}
+
+void dhtObsluga() {
+    if (pinDHT == 0xFF) return;
+
+    switch (stan) {
+        case STAN_BEZCZYNNY:
+            if (millis() - ostatniaTransakcjaMs < DHT_OKRES_MS) return;
+            ostatniaTransakcjaMs = millis();
+            statystyki.ramki++;
+            digitalWrite(pinDHT, LOW);
+            startUs = micros();
+            stan = STAN_START;
+            break;
+
+        case STAN_START: {
+            uint32_t trwa = micros() - startUs;
+            if (trwa < DHT_START_US) return;
+            if (trwa > DHT_START_MAX_US) {
+                // Pętla wróciła za późno - czujnik mógł nie rozpoznać startu
+                digitalWrite(pinDHT, HIGH);
+                statystyki.bledy_startu++;
+                stan = STAN_BEZCZYNNY;
+                return;
+            }
+            liczbaKrawedzi = 0;
+            odbior = true;
+            digitalWrite(pinDHT, HIGH);
+            startUs = micros();
+            stan = STAN_ODBIOR;
+            break;
+        }
+
+        case STAN_ODBIOR:
+            if (liczbaKrawedzi < DHT_KRAWEDZI_RAMKI && micros() - startUs < DHT_ODBIOR_US) return;
+            zakonczRamke();
+            stan = STAN_BEZCZYNNY;
+            break;
+    }
+}
+
+bool dhtPobierz(OdczytDHT* odczyt) {
+    *odczyt = ostatni;
+    odczyt->poprawny = ostatni.czas_ms != 0 && millis() - ostatni.czas_ms < DHT_WAZNOSC_MS;
+    if (!odczyt->poprawny) {
+        odczyt->temperatura = NAN;
+        odczyt->wilgotnosc = NAN;
+    }
+    return odczyt->poprawny;
+}
+
+void dhtPobierzStatystyki(StatystykiDHT* wynik) {
+    *wynik = statystyki;
+}
+
+#endif
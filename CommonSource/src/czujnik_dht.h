@@ -0,0 +1,114 @@
+/*
+ * WSPÓLNY STEROWNIK DHT22 - czujnik_dht.h
+ *
+ * Nieblokujący odczyt czujnika DHT22 (AM2302) używany przez Kurnik_IoT
+ * i Czujnik_IoT zamiast biblioteki Adafruit DHT, która odczytuje ramkę
+ * aktywnym oczekiwaniem z wyłączonymi przerwaniami (ok. 5 ms).
+ *
+ * Jedna transakcja na okres DHT_OKRES_MS daje temperaturę i wilgotność
+ * z tej samej ramki. Maszyna stanów w dhtObsluga() (wywoływanej w każdym
+ * obiegu loop()):
+ *   BEZCZYNNY  -> linia w stanie niskim (sygnał startu, >= DHT_START_US)
+ *   START      -> zwolnienie linii, przerwanie na zboczu opadającym zapisuje
+ *                 micros() każdego zbocza
+ *   ODBIOR     -> po DHT_KRAWEDZI_RAMKI zboczach lub DHT_ODBIOR_US dekodowanie
+ *
+ * Bit ramki to okres między kolejnymi zboczami opadającymi: ok. 77 us dla
+ * zera (50 + 27 us) i ok. 120 us dla jedynki (50 + 70 us).
+ *
+ * Ramka z błędem czasu lub sumy kontrolnej nie zmienia ostatniego odczytu -
+ * jest tylko liczona w statystykach. Odczyt starszy niż DHT_WAZNOSC_MS
+ * jest zgłaszany jako niepoprawny (zamiast dawnego 0.0).
+ *
+ * Dekoder ramki nie używa Arduino - kompiluje się również na hoście.
+ */
+
+#ifndef CZUJNIK_DHT_H
+#define CZUJNIK_DHT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Okres pomiaru - DHT22 nie mierzy częściej niż co 2 s
+#define DHT_OKRES_MS          2000
+// Odczyt jest ważny przez dwa okresy (jedna błędna ramka nie unieważnia danych)
+#define DHT_WAZNOSC_MS        (2 * DHT_OKRES_MS + 500)
+
+// Sygnał startu: min. 1 ms, czujnik akceptuje do ok. 20 ms
+#define DHT_START_US          1100
+#define DHT_START_MAX_US      18000
+// Pełna ramka trwa max. ok. 5 ms
+#define DHT_ODBIOR_US         6000
+
+// Zbocza opadające: odpowiedź czujnika (2) + 40 bitów
+#define DHT_KRAWEDZI_RAMKI    42
+#define DHT_MAX_KRAWEDZI      48
+#define DHT_BITY              40
+#define DHT_RAMKA_BAJTY       5
+
+// Granica okresu bitu 0/1 oraz dopuszczalny zakres okresu (us)
+#define DHT_PROG_JEDYNKI_US   98
+#define DHT_MIN_OKRES_US      60
+#define DHT_MAX_OKRES_US      160
+
+// Wynik dekodowania ramki
+typedef enum {
+    DHT_OK = 0,
+    DHT_BLAD_CZASU,     // Za mało zboczy lub okres bitu poza zakresem
+    DHT_BLAD_SUMY       // Niezgodna suma kontrolna
+} WynikDHT;
+
+// Ostatni poprawny odczyt
+typedef struct {
+    float temperatura;    // °C (NAN gdy niepoprawny)
+    float wilgotnosc;     // % (NAN gdy niepoprawny)
+    bool poprawny;        // Jest ramka młodsza niż DHT_WAZNOSC_MS
+    uint32_t czas_ms;     // millis() odebrania ramki (0 = brak)
+    uint32_t numer;       // Numer poprawnej ramki (zmienia się przy nowym odczycie)
+} OdczytDHT;
+
+// Statystyki transakcji
+typedef struct {
+    uint32_t ramki;           // Rozpoczęte transakcje
+    uint32_t poprawne;
+    uint32_t bledy_czasu;
+    uint32_t bledy_sumy;
+    uint32_t bledy_startu;    // Sygnał startu dłuższy niż DHT_START_MAX_US (pętla nie zdążyła)
+} StatystykiDHT;
+
+/*
+ * Dekoduje ramkę z czasów zboczy opadających (us). Używa ostatnich
+ * DHT_BITY + 1 zboczy, więc pominięcie zbocza odpowiedzi czujnika nie
+ * psuje ramki.
+ * return: DHT_OK i 5 bajtów w ramka albo kod błędu
+ */
+WynikDHT dhtDekoduj(const uint32_t* czasy, uint8_t liczba, uint8_t ramka[DHT_RAMKA_BAJTY]);
+
+/*
+ * Przelicza zdekodowaną ramkę na °C i % (temperatura ze znakiem w bicie 15).
+ */
+void dhtPrzelicz(const uint8_t ramka[DHT_RAMKA_BAJTY], float* temperatura, float* wilgotnosc);
+
+#if defined(ARDUINO)
+/*
+ * Konfiguruje pin (open-drain) i przerwanie na zboczu opadającym.
+ * Pierwsza transakcja startuje w najbliższym dhtObsluga().
+ */
+void dhtInicjalizuj(uint8_t pin);
+
+/*
+ * Krok maszyny stanów - wywoływany w każdym obiegu loop(), nie czeka.
+ */
+void dhtObsluga();
+
+/*
+ * Kopiuje ostatni poprawny odczyt (poprawny = false gdy jest starszy niż
+ * DHT_WAZNOSC_MS lub jeszcze go nie ma).
+ * return: odczyt->poprawny
+ */
+bool dhtPobierz(OdczytDHT* odczyt);
+
+void dhtPobierzStatystyki(StatystykiDHT* statystyki);
+#endif
+
+#endif
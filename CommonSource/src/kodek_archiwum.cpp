@@ -0,0 +1,402 @@
+/*
+ * kodek_archiwum.cpp
+ *
+ * Strumień bitów zapisywany od najstarszego bitu bajtu (MSB-first).
+ *
+ * Klasy delta-of-delta czasu (jak w Gorilla):
+ *   '0'                    dod == 0
+ *   '10'   + 7 bitów       dod w [-63, 64]
+ *   '110'  + 9 bitów       dod w [-255, 256]
+ *   '1110' + 12 bitów      dod w [-2047, 2048]
+ *   '1111' + 32 bity       pozostałe
+ *
+ * Klasy różnic pól (po kodowaniu zigzag z = (d << 1) ^ (d >> 31)) - 5 pól
+ * czujników, a od wersji 2 jeszcze przeniesione i pominięte:
+ *   '0'                    z == 0
+ *   '10'   + 4 bity        z < 16
+ *   '110'  + 8 bitów       z < 256
+ *   '1110' + 16 bitów      z < 65536
+ *   '1111' + 32 bity       pozostałe
+ */
+
+#include "kodek_archiwum.h"
+#include "ramka_mesh.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <ctype.h>
+
+// Liczba pól różnicowych próbki w wersji 1 i w bieżącej wersji
+static const int POLA_WERSJA_1 = 5;
+static const int POLA = 7;
+
+// Najgorszy przypadek jednej próbki: czas 4+32 bity i każde pole po 4+32 bity
+static const uint32_t MAX_BITY_PROBKI = 36 + POLA * 36;
+
+static const char ZNACZNIK_0 = 'K';
+static const char ZNACZNIK_1 = 'A';
+
+static inline void zapiszU16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void zapiszU32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint16_t czytajU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t czytajU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// === STRUMIEŃ BITÓW ===
+
+static void zapiszBity(KoderBloku* k, uint32_t wartosc, uint8_t liczba) {
+    for (int i = liczba - 1; i >= 0; i--) {
+        uint32_t bajt = k->bity >> 3;
+        uint8_t maska = (uint8_t)(0x80 >> (k->bity & 7));
+        if ((wartosc >> i) & 1) {
+            k->dane[bajt] |= maska;
+        } else {
+            k->dane[bajt] &= (uint8_t)~maska;
+        }
+        k->bity++;
+    }
+}
+
+typedef struct {
+    const uint8_t* dane;
+    uint32_t pozycja;
+    uint32_t limit;     // Liczba dostępnych bitów
+} CzytnikBitow;
+
+static bool czytajBity(CzytnikBitow* c, uint8_t liczba, uint32_t* wartosc) {
+    if (c->pozycja + liczba > c->limit) return false;
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < liczba; i++) {
+        v = (v << 1) | ((c->dane[c->pozycja >> 3] >> (7 - (c->pozycja & 7))) & 1);
+        c->pozycja++;
+    }
+    *wartosc = v;
+    return true;
+}
+
+// Liczba jedynek prefiksu klasy (maksymalnie 4)
+static bool czytajPrefiks(CzytnikBitow* c, uint8_t* klasa) {
+    uint8_t n = 0;
+    uint32_t bit;
+    while (n < 4) {
+        if (!czytajBity(c, 1, &bit)) return false;
+        if (bit == 0) break;
+        n++;
+    }
+    *klasa = n;
+    return true;
+}
+
+// === KODOWANIE ===
+
+static inline int32_t roznica(int32_t a, int32_t b) {
+    return (int32_t)((uint32_t)a - (uint32_t)b);   // Zawijanie zamiast przepełnienia
+}
+
+static void zapiszDod(KoderBloku* k, int32_t dod) {
+    if (dod == 0) {
+        zapiszBity(k, 0x0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+        zapiszBity(k, 0x2, 2);
+        zapiszBity(k, (uint32_t)(dod + 63), 7);
+    } else if (dod >= -255 && dod <= 256) {
+        zapiszBity(k, 0x6, 3);
+        zapiszBity(k, (uint32_t)(dod + 255), 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+        zapiszBity(k, 0xE, 4);
+        zapiszBity(k, (uint32_t)(dod + 2047), 12);
+    } else {
+        zapiszBity(k, 0xF, 4);
+        zapiszBity(k, (uint32_t)dod, 32);
+    }
+}
+
+static void zapiszRoznice(KoderBloku* k, int32_t d) {
+    uint32_t z = ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+    if (z == 0) {
+        zapiszBity(k, 0x0, 1);
+    } else if (z < 16) {
+        zapiszBity(k, 0x2, 2);
+        zapiszBity(k, z, 4);
+    } else if (z < 256) {
+        zapiszBity(k, 0x6, 3);
+        zapiszBity(k, z, 8);
+    } else if (z < 65536) {
+        zapiszBity(k, 0xE, 4);
+        zapiszBity(k, z, 16);
+    } else {
+        zapiszBity(k, 0xF, 4);
+        zapiszBity(k, z, 32);
+    }
+}
+
+void kodekRozpocznij(KoderBloku* koder, uint8_t typ, int32_t id_urzadzenia) {
+    koder->typ = typ;
+    koder->id_urzadzenia = id_urzadzenia;
+    koder->liczba = 0;
+    koder->bity = 0;
+    koder->epoch_poczatku = 0;
+    koder->poprzednia_delta = 0;
+    memset(&koder->poprzednia, 0, sizeof(koder->poprzednia));
+}
+
+bool kodekDodaj(KoderBloku* koder, const ProbkaArchiwum* probka) {
+    if (koder->typ != KODEK_BLOK_SZEREG || koder->liczba == UINT16_MAX) return false;
+    if (koder->bity + MAX_BITY_PROBKI > KODEK_MAX_DANE * 8) return false;
+
+    if (koder->liczba == 0) {
+        // Czas pierwszej próbki jest w nagłówku, pola kodowane względem zera
+        koder->epoch_poczatku = probka->epoch;
+    } else {
+        int32_t delta = roznica((int32_t)probka->epoch, (int32_t)koder->poprzednia.epoch);
+        zapiszDod(koder, roznica(delta, koder->poprzednia_delta));
+        koder->poprzednia_delta = delta;
+    }
+
+    const ProbkaArchiwum* p = &koder->poprzednia;
+    zapiszRoznice(koder, roznica(probka->temperatura_c, p->temperatura_c));
+    zapiszRoznice(koder, roznica(probka->wilgotnosc_c, p->wilgotnosc_c));
+    zapiszRoznice(koder, roznica(probka->poziom_co2, p->poziom_co2));
+    zapiszRoznice(koder, roznica(probka->poziom_amoniaku, p->poziom_amoniaku));
+    zapiszRoznice(koder, roznica(probka->naslonecznienie, p->naslonecznienie));
+    zapiszRoznice(koder, roznica(probka->przeniesione, p->przeniesione));
+    zapiszRoznice(koder, roznica(probka->pominiete, p->pominiete));
+
+    koder->poprzednia = *probka;
+    koder->liczba++;
+    return true;
+}
+
+bool kodekDodajTekst(KoderBloku* koder, const char* linia) {
+    if (koder->typ != KODEK_BLOK_TEKST || koder->liczba == UINT16_MAX) return false;
+    size_t dlugosc = strlen(linia);
+    size_t zajete = koder->bity / 8;
+    if (zajete + dlugosc + 1 > KODEK_MAX_DANE) return false;
+
+    memcpy(koder->dane + zajete, linia, dlugosc);
+    koder->dane[zajete + dlugosc] = '\n';
+    koder->bity += (uint32_t)(dlugosc + 1) * 8;
+    koder->liczba++;
+    return true;
+}
+
+size_t kodekZamknij(const KoderBloku* koder, uint8_t* bufor, size_t rozmiar) {
+    if (koder->liczba == 0) return 0;
+    size_t dane = (koder->bity + 7) / 8;
+    size_t dlugosc = KODEK_NAGLOWEK_BAJTY + dane;
+    if (rozmiar < dlugosc + KODEK_CRC_BAJTY) return 0;
+
+    bufor[0] = (uint8_t)ZNACZNIK_0;
+    bufor[1] = (uint8_t)ZNACZNIK_1;
+    bufor[2] = KODEK_WERSJA;
+    bufor[3] = koder->typ;
+    zapiszU32(bufor + 4, (uint32_t)koder->id_urzadzenia);
+    zapiszU16(bufor + 8, koder->liczba);
+    zapiszU16(bufor + 10, (uint16_t)dane);
+    zapiszU32(bufor + 12, koder->epoch_poczatku);
+    memcpy(bufor + KODEK_NAGLOWEK_BAJTY, koder->dane, dane);
+    // Niepełny ostatni bajt - wyzeruj nieużywane bity
+    if (koder->bity & 7) {
+        bufor[dlugosc - 1] &= (uint8_t)(0xFF << (8 - (koder->bity & 7)));
+    }
+    zapiszU16(bufor + dlugosc, ramkaCrc16(bufor, dlugosc));
+    return dlugosc + KODEK_CRC_BAJTY;
+}
+
+// === DEKODOWANIE ===
+
+size_t kodekDlugoscBloku(const uint8_t* bufor, size_t dostepne) {
+    if (dostepne < KODEK_NAGLOWEK_BAJTY) return 0;
+    if (bufor[0] != (uint8_t)ZNACZNIK_0 || bufor[1] != (uint8_t)ZNACZNIK_1) return 0;
+    if (bufor[2] < 1 || bufor[2] > KODEK_WERSJA) return 0;
+    size_t dane = czytajU16(bufor + 10);
+    if (dane > KODEK_MAX_DANE) return 0;
+    return KODEK_NAGLOWEK_BAJTY + dane + KODEK_CRC_BAJTY;
+}
+
+static bool czytajDod(CzytnikBitow* c, int32_t* dod) {
+    uint8_t klasa;
+    uint32_t v;
+    if (!czytajPrefiks(c, &klasa)) return false;
+    switch (klasa) {
+        case 0: *dod = 0; return true;
+        case 1: if (!czytajBity(c, 7, &v)) return false;  *dod = (int32_t)v - 63;   return true;
+        case 2: if (!czytajBity(c, 9, &v)) return false;  *dod = (int32_t)v - 255;  return true;
+        case 3: if (!czytajBity(c, 12, &v)) return false; *dod = (int32_t)v - 2047; return true;
+        default: if (!czytajBity(c, 32, &v)) return false; *dod = (int32_t)v;       return true;
+    }
+}
+
+static bool czytajRoznice(CzytnikBitow* c, int32_t* d) {
+    static const uint8_t BITY_KLASY[] = {0, 4, 8, 16, 32};
+    uint8_t klasa;
+    uint32_t z = 0;
+    if (!czytajPrefiks(c, &klasa)) return false;
+    if (klasa > 0 && !czytajBity(c, BITY_KLASY[klasa], &z)) return false;
+    *d = (int32_t)((z >> 1) ^ (0u - (z & 1)));
+    return true;
+}
+
+static inline int32_t suma(int32_t a, int32_t b) {
+    return (int32_t)((uint32_t)a + (uint32_t)b);
+}
+
+int kodekDekoduj(const uint8_t* blok, size_t dlugosc, int32_t* id_urzadzenia,
+                 ProbkaArchiwum* probki, int max_probek) {
+    size_t oczekiwana = kodekDlugoscBloku(blok, dlugosc);
+    if (oczekiwana == 0 || oczekiwana > dlugosc) return -1;
+    size_t bez_crc = oczekiwana - KODEK_CRC_BAJTY;
+    if (ramkaCrc16(blok, bez_crc) != czytajU16(blok + bez_crc)) return -1;
+    if (blok[3] != KODEK_BLOK_SZEREG) return -1;
+
+    *id_urzadzenia = (int32_t)czytajU32(blok + 4);
+    int liczba = czytajU16(blok + 8);
+    if (liczba > max_probek) return -1;
+
+    CzytnikBitow c = { blok + KODEK_NAGLOWEK_BAJTY, 0, (uint32_t)(bez_crc - KODEK_NAGLOWEK_BAJTY) * 8 };
+    ProbkaArchiwum poprzednia;
+    memset(&poprzednia, 0, sizeof(poprzednia));
+    poprzednia.epoch = czytajU32(blok + 12);
+    int32_t delta = 0;
+    int liczba_pol = (blok[2] == 1) ? POLA_WERSJA_1 : POLA;
+
+    for (int i = 0; i < liczba; i++) {
+        ProbkaArchiwum p = poprzednia;
+        int32_t d;
+        if (i > 0) {
+            if (!czytajDod(&c, &d)) return -1;
+            delta = suma(delta, d);
+            p.epoch = (uint32_t)suma((int32_t)poprzednia.epoch, delta);
+        }
+        int32_t* pola[POLA] = {&p.temperatura_c, &p.wilgotnosc_c, &p.poziom_co2,
+                               &p.poziom_amoniaku, &p.naslonecznienie,
+                               &p.przeniesione, &p.pominiete};
+        for (int j = 0; j < liczba_pol; j++) {
+            if (!czytajRoznice(&c, &d)) return -1;
+            *pola[j] = suma(*pola[j], d);
+        }
+        probki[i] = p;
+        poprzednia = p;
+    }
+    return liczba;
+}
+
+// === CSV ===
+
+static int64_t dniOdEpoki(int rok, int miesiac, int dzien) {
+    // Algorytm "days from civil" (kalendarz gregoriański proleptyczny)
+    rok -= miesiac <= 2;
+    const int64_t era = (rok >= 0 ? rok : rok - 399) / 400;
+    const int yoe = (int)(rok - era * 400);
+    const int doy = (153 * (miesiac + (miesiac > 2 ? -3 : 9)) + 2) / 5 + dzien - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+uint32_t kodekCzasZTekstu(const char* tekst) {
+    static const char* MIESIACE[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                     "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    int h, m, s, dzien, rok;
+    char nazwa[4];
+    if (sscanf(tekst, "%d:%d:%d %*s %3s %d %d", &h, &m, &s, nazwa, &dzien, &rok) != 6) return 0;
+
+    int miesiac = 0;
+    for (int i = 0; i < 12; i++) {
+        if (strcmp(nazwa, MIESIACE[i]) == 0) {
+            miesiac = i + 1;
+            break;
+        }
+    }
+    if (miesiac == 0 || rok < 1970 || dzien < 1 || dzien > 31 || h > 23 || m > 59 || s > 60) return 0;
+
+    int64_t epoch = dniOdEpoki(rok, miesiac, dzien) * 86400 + h * 3600 + m * 60 + s;
+    if (epoch <= 0 || epoch > (int64_t)UINT32_MAX) return 0;
+    return (uint32_t)epoch;
+}
+
+// Pole liczbowe zakończone ';' - przesuwa wskaźnik za separator
+static bool czytajLiczbe(const char** p, double* wartosc) {
+    char* koniec;
+    *wartosc = strtod(*p, &koniec);
+    if (koniec == *p || *koniec != ';') return false;
+    *p = koniec + 1;
+    return true;
+}
+
+bool kodekParsujCSV(const char* rekord, int32_t* id_urzadzenia, ProbkaArchiwum* probka) {
+    const char* p = rekord;
+    double id, temp, hum, co2, nh3, sun;
+    if (!czytajLiczbe(&p, &id) || !czytajLiczbe(&p, &temp) || !czytajLiczbe(&p, &hum) ||
+        !czytajLiczbe(&p, &co2) || !czytajLiczbe(&p, &nh3) || !czytajLiczbe(&p, &sun)) {
+        return false;
+    }
+
+    uint32_t epoch = kodekCzasZTekstu(p);
+    if (epoch == 0) return false;
+
+    // Opcjonalne pola strefy martwej węzła za czasem: ;przeniesione;pominiete
+    unsigned long przeniesione = 0, pominiete = 0;
+    const char* pola = strchr(p, ';');
+    if (pola != NULL) {
+        char* koniec;
+        przeniesione = strtoul(pola + 1, &koniec, 10);
+        if (koniec == pola + 1 || *koniec != ';') return false;
+        const char* drugie = koniec + 1;
+        pominiete = strtoul(drugie, &koniec, 10);
+        if (koniec == drugie || *koniec != '\0') return false;
+        // Tylko postać, którą kodekFormatujCSV() odtworzy bez zmian - inne rekordy
+        // (np. ";0;0" albo wartości spoza pakietu) trafiają do bloku tekstowego
+        if (!isdigit((unsigned char)pola[1]) || !isdigit((unsigned char)drugie[0])) return false;
+        if (przeniesione > UINT8_MAX || pominiete > UINT16_MAX) return false;
+        if (przeniesione == 0 && pominiete == 0) return false;
+    }
+
+    // Rekord musi dać się odtworzyć bez zmian - pola całkowite nie mogą mieć części ułamkowej
+    if (id != floor(id) || co2 != floor(co2) || nh3 != floor(nh3) || sun != floor(sun)) return false;
+
+    *id_urzadzenia = (int32_t)id;
+    probka->epoch = epoch;
+    probka->temperatura_c = (int32_t)lround(temp * 100.0);
+    probka->wilgotnosc_c = (int32_t)lround(hum * 100.0);
+    probka->poziom_co2 = (int32_t)co2;
+    probka->poziom_amoniaku = (int32_t)nh3;
+    probka->naslonecznienie = (int32_t)sun;
+    probka->przeniesione = (int32_t)przeniesione;
+    probka->pominiete = (int32_t)pominiete;
+    return true;
+}
+
+size_t kodekFormatujCSV(int32_t id_urzadzenia, const ProbkaArchiwum* probka, char* bufor, size_t rozmiar) {
+    char czas[RAMKA_CZAS_DL];
+    ramkaFormatujCzas(probka->epoch, czas, sizeof(czas));
+    int n = snprintf(bufor, rozmiar, "%ld;%.2f;%.2f;%ld;%ld;%ld;%s",
+                     (long)id_urzadzenia,
+                     probka->temperatura_c / 100.0,
+                     probka->wilgotnosc_c / 100.0,
+                     (long)probka->poziom_co2,
+                     (long)probka->poziom_amoniaku,
+                     (long)probka->naslonecznienie,
+                     czas);
+    if (n < 0) return 0;
+    if ((size_t)n < rozmiar && (probka->przeniesione != 0 || probka->pominiete != 0)) {
+        int m = snprintf(bufor + n, rozmiar - n, ";%ld;%ld",
+                         (long)probka->przeniesione, (long)probka->pominiete);
+        if (m > 0) n += m;
+    }
+    return ((size_t)n < rozmiar) ? (size_t)n : rozmiar - 1;
+}
@@ -0,0 +1,128 @@
+/*
+ * KODEK ARCHIWUM - kodek_archiwum.h
+ *
+ * Kompresja szeregów czasowych pomiarów do archiwum na karcie SD
+ * (w stylu Gorilla). Rekordy jednego urządzenia trafiają do wspólnego bloku:
+ * - czas: delta-of-delta (przy stałym okresie próbkowania - 1 bit na rekord),
+ * - pola czujników: stałoprzecinkowe różnice względem poprzedniej próbki,
+ *   kodowane zigzag w klasach długości (0 -> 1 bit),
+ * - od wersji 2 także pola strefy martwej węzła (przeniesione, pominięte)
+ *   w ten sam sposób - przy ich braku kosztują 2 bity na rekord.
+ *
+ * Układ bloku (little-endian):
+ *   [0..1]   znacznik "KA"
+ *   [2]      wersja (KODEK_WERSJA)
+ *   [3]      typ bloku (KODEK_BLOK_SZEREG lub KODEK_BLOK_TEKST)
+ *   [4..7]   ID urządzenia (int32)
+ *   [8..9]   liczba rekordów
+ *   [10..11] długość danych w bajtach
+ *   [12..15] epoch pierwszego rekordu
+ *   [16..]   dane (strumień bitów lub linie tekstu)
+ *   [n-2..]  CRC-16/CCITT-FALSE z nagłówka i danych
+ *
+ * Blok nie przekracza KODEK_MAX_BLOK (jeden sektor karty SD).
+ * Blok tekstowy przechowuje rekordy, których nie da się sparsować (bez utraty danych).
+ * Dekoder czyta też bloki wersji 1 (bez pól strefy martwej).
+ *
+ * Moduł nie używa Arduino ani sterty - kompiluje się również na hoście.
+ * Dekoder referencyjny dla komputera: Narzędzia/dekoder_archiwum.py
+ */
+
+#ifndef KODEK_ARCHIWUM_H
+#define KODEK_ARCHIWUM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define KODEK_WERSJA          2
+
+#define KODEK_BLOK_SZEREG     1     // Strumień bitów z próbkami jednego urządzenia
+#define KODEK_BLOK_TEKST      2     // Surowe linie CSV zakończone '\n'
+
+#define KODEK_NAGLOWEK_BAJTY  16
+#define KODEK_CRC_BAJTY       2
+#define KODEK_MAX_BLOK        512
+#define KODEK_MAX_DANE        (KODEK_MAX_BLOK - KODEK_NAGLOWEK_BAJTY - KODEK_CRC_BAJTY)
+
+// Próbka w postaci stałoprzecinkowej
+typedef struct {
+    uint32_t epoch;
+    int32_t  temperatura_c;     // Setne °C
+    int32_t  wilgotnosc_c;      // Setne %
+    int32_t  poziom_co2;        // ppm (-1 = brak odczytu)
+    int32_t  poziom_amoniaku;   // ppm (-1 = brak odczytu)
+    int32_t  naslonecznienie;   // lux
+    int32_t  przeniesione;      // Maska RAMKA_POLE_* pól powtórzonych przez węzeł (0 = brak)
+    int32_t  pominiete;         // Próbki niewysłane przez węzeł od poprzedniego rekordu
+} ProbkaArchiwum;
+
+// Stan kodera jednego bloku
+typedef struct {
+    uint8_t  typ;
+    int32_t  id_urzadzenia;
+    uint16_t liczba;
+    uint32_t bity;                  // Zapisane bity danych (dla bloku tekstowego: bajty * 8)
+    uint32_t epoch_poczatku;
+    int32_t  poprzednia_delta;
+    ProbkaArchiwum poprzednia;
+    uint8_t  dane[KODEK_MAX_DANE];
+} KoderBloku;
+
+/*
+ * Rozpoczyna pusty blok danego typu dla urządzenia.
+ */
+void kodekRozpocznij(KoderBloku* koder, uint8_t typ, int32_t id_urzadzenia);
+
+/*
+ * Dodaje próbkę do bloku KODEK_BLOK_SZEREG.
+ * return: false gdy w bloku brakuje miejsca - należy go zamknąć i rozpocząć nowy
+ */
+bool kodekDodaj(KoderBloku* koder, const ProbkaArchiwum* probka);
+
+/*
+ * Dodaje linię tekstu (bez '\n') do bloku KODEK_BLOK_TEKST.
+ * return: false gdy w bloku brakuje miejsca
+ */
+bool kodekDodajTekst(KoderBloku* koder, const char* linia);
+
+/*
+ * Zapisuje blok (nagłówek + dane + CRC) do bufora.
+ * return: długość bloku lub 0 gdy blok jest pusty albo bufor za mały
+ */
+size_t kodekZamknij(const KoderBloku* koder, uint8_t* bufor, size_t rozmiar);
+
+/*
+ * Sprawdza nagłówek bloku i zwraca jego pełną długość (z CRC).
+ * return: 0 gdy nagłówek jest nieprawidłowy
+ */
+size_t kodekDlugoscBloku(const uint8_t* bufor, size_t dostepne);
+
+/*
+ * Dekoduje blok KODEK_BLOK_SZEREG (po sprawdzeniu CRC).
+ * return: liczba próbek lub -1 gdy blok jest uszkodzony / innego typu
+ */
+int kodekDekoduj(const uint8_t* blok, size_t dlugosc, int32_t* id_urzadzenia,
+                 ProbkaArchiwum* probki, int max_probek);
+
+/*
+ * Parsuje rekord CSV "ID;temp;hum;co2;nh3;sun;HH:MM:SS Www, Mmm DD YYYY"
+ * z opcjonalnym ";przeniesione;pominiete" (FormatujPakietCSV() dopisuje je,
+ * gdy choć jedno jest niezerowe).
+ * return: false gdy rekord ma inny format
+ */
+bool kodekParsujCSV(const char* rekord, int32_t* id_urzadzenia, ProbkaArchiwum* probka);
+
+/*
+ * Formatuje próbkę z powrotem do rekordu CSV (ten sam format co WyslijPakiet()).
+ * return: długość tekstu (bez '\0')
+ */
+size_t kodekFormatujCSV(int32_t id_urzadzenia, const ProbkaArchiwum* probka, char* bufor, size_t rozmiar);
+
+/*
+ * Zamienia czas "HH:MM:SS Www, Mmm DD YYYY" na epoch (bez strefy czasowej,
+ * odwrotność ramkaFormatujCzas()).
+ * return: 0 przy błędzie
+ */
+uint32_t kodekCzasZTekstu(const char* tekst);
+
+#endif
@@ -0,0 +1,389 @@
+/*
+ * ramka_mesh.cpp
+ *
+ * Kodowanie i dekodowanie binarnej ramki mesh (opis formatu w ramka_mesh.h).
+ * Wszystkie operacje działają na buforach podanych przez wywołującego,
+ * bez alokacji na stercie.
+ */
+
+#include "ramka_mesh.h"
+#include <string.h>
+#include <time.h>
+
+// Rozmiary pól poszczególnych typów ramek (bez nagłówka i CRC)
+static const size_t DANE_POLA_BAJTY = 2 + 2 + 2 + 2 + 4;
+static const size_t STREFA_POLA_BAJTY = 1 + 2;     // Dopisane do pól DANE
+static const size_t KURA_POLA_BAJTY = 4 + 1;   // + uid_dlugosc bajtów UID
+// okres + próbki, 4 statystyki po 2 bajty (temperatura..amoniak) i po 4 bajty (nasłonecznienie)
+static const size_t AGREGAT_POLA_BAJTY = 2 + 2 + 4 * (2 + 2 + 2 + 2 + 4);
+// Paczka: liczba próbek, potem na próbkę przesunięcie czasu + pola DANE + pola strefy
+static const size_t PACZKA_PROBKA_BAJTY = 2 + DANE_POLA_BAJTY + STREFA_POLA_BAJTY;
+
+static const char BASE64_ZNAKI[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// === ZAPIS/ODCZYT LITTLE-ENDIAN ===
+
+static void zapiszU16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)(v);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void zapiszU32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v);
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint16_t czytajU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t czytajU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Odczyt CO2/TVOC (-1 = błąd) -> pole uint16 z wartością specjalną
+static uint16_t odczytNaU16(int32_t v) {
+    if (v < 0) return RAMKA_BRAK_ODCZYTU;
+    if (v >= RAMKA_BRAK_ODCZYTU) return RAMKA_BRAK_ODCZYTU - 1;
+    return (uint16_t)v;
+}
+
+static int32_t u16NaOdczyt(uint16_t v) {
+    return v == RAMKA_BRAK_ODCZYTU ? -1 : (int32_t)v;
+}
+
+int32_t ramkaSetne(float wartosc) {
+    if (wartosc != wartosc) return 0;   // NaN
+    float skalowana = wartosc * 100.0f;
+    if (skalowana >= 2147483520.0f) return INT32_MAX;
+    if (skalowana <= -2147483520.0f) return INT32_MIN;
+    return (int32_t)(skalowana >= 0 ? skalowana + 0.5f : skalowana - 0.5f);
+}
+
+uint16_t ramkaCrc16(const uint8_t* dane, size_t dlugosc) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < dlugosc; i++) {
+        crc ^= (uint16_t)dane[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Zapisuje nagłówek i zwraca wskaźnik na pierwsze pole ramki
+static uint8_t* zapiszNaglowek(uint8_t* bufor, uint8_t typ, const RamkaNaglowek* n) {
+    bufor[0] = RAMKA_WERSJA;
+    bufor[1] = typ;
+    zapiszU32(bufor + 2, n->id_wezla);
+    zapiszU16(bufor + 6, n->sekwencja);
+    zapiszU32(bufor + 8, n->epoch);
+    return bufor + RAMKA_NAGLOWEK_BAJTY;
+}
+
+static void czytajNaglowek(const uint8_t* bufor, RamkaNaglowek* n) {
+    n->wersja    = bufor[0];
+    n->typ       = bufor[1];
+    n->id_wezla  = czytajU32(bufor + 2);
+    n->sekwencja = czytajU16(bufor + 6);
+    n->epoch     = czytajU32(bufor + 8);
+}
+
+// Dopisuje CRC na końcu ramki i zwraca jej pełną długość
+static size_t zamknijRamke(uint8_t* bufor, size_t dlugosc) {
+    zapiszU16(bufor + dlugosc, ramkaCrc16(bufor, dlugosc));
+    return dlugosc + RAMKA_CRC_BAJTY;
+}
+
+// Pola pomiarowe ramki DANE (bez strefy) - wspólne dla DANE i PACZKA
+static uint8_t* zapiszPolaDane(uint8_t* p, const RamkaDane* ramka) {
+    zapiszU16(p, (uint16_t)ramka->temperatura_c);          p += 2;
+    zapiszU16(p, ramka->wilgotnosc_c);                     p += 2;
+    zapiszU16(p, odczytNaU16(ramka->poziom_co2));          p += 2;
+    zapiszU16(p, odczytNaU16(ramka->poziom_amoniaku));     p += 2;
+    zapiszU32(p, ramka->naslonecznienie);                  p += 4;
+    return p;
+}
+
+static const uint8_t* czytajPolaDane(const uint8_t* p, RamkaDane* ramka) {
+    ramka->temperatura_c   = (int16_t)czytajU16(p);     p += 2;
+    ramka->wilgotnosc_c    = czytajU16(p);              p += 2;
+    ramka->poziom_co2      = u16NaOdczyt(czytajU16(p)); p += 2;
+    ramka->poziom_amoniaku = u16NaOdczyt(czytajU16(p)); p += 2;
+    ramka->naslonecznienie = czytajU32(p);              p += 4;
+    return p;
+}
+
+size_t ramkaKodujDane(const RamkaDane* ramka, uint8_t* bufor, size_t rozmiar) {
+    // Zwykła ramka DANE, gdy węzeł nie pomija próbek ani nie przenosi pól
+    const bool strefa = ramka->przeniesione != 0 || ramka->pominiete != 0;
+    const size_t dlugosc = RAMKA_NAGLOWEK_BAJTY + DANE_POLA_BAJTY + (strefa ? STREFA_POLA_BAJTY : 0);
+    if (rozmiar < dlugosc + RAMKA_CRC_BAJTY) return 0;
+
+    uint8_t* p = zapiszNaglowek(bufor, strefa ? RAMKA_TYP_DANE_STREFA : RAMKA_TYP_DANE, &ramka->naglowek);
+    p = zapiszPolaDane(p, ramka);
+    if (strefa) {
+        *p++ = ramka->przeniesione;
+        zapiszU16(p, ramka->pominiete);
+    }
+
+    return zamknijRamke(bufor, dlugosc);
+}
+
+size_t ramkaKodujKura(const RamkaKura* ramka, uint8_t* bufor, size_t rozmiar) {
+    uint8_t uid_dl = ramka->uid_dlugosc > RAMKA_MAX_UID ? RAMKA_MAX_UID : ramka->uid_dlugosc;
+    const size_t dlugosc = RAMKA_NAGLOWEK_BAJTY + KURA_POLA_BAJTY + uid_dl;
+    if (rozmiar < dlugosc + RAMKA_CRC_BAJTY) return 0;
+
+    uint8_t* p = zapiszNaglowek(bufor, RAMKA_TYP_KURA, &ramka->naglowek);
+    zapiszU32(p, (uint32_t)ramka->waga_c);  p += 4;
+    *p++ = uid_dl;
+    memcpy(p, ramka->uid, uid_dl);
+
+    return zamknijRamke(bufor, dlugosc);
+}
+
+uint8_t ramkaSprawdz(const uint8_t* bufor, size_t dlugosc) {
+    if (dlugosc < RAMKA_NAGLOWEK_BAJTY + RAMKA_CRC_BAJTY) return 0;
+    // Nowsze wersje formatu muszą zostać obsłużone jawnie
+    if (bufor[0] == 0 || bufor[0] > RAMKA_WERSJA) return 0;
+
+    size_t bez_crc = dlugosc - RAMKA_CRC_BAJTY;
+    if (ramkaCrc16(bufor, bez_crc) != czytajU16(bufor + bez_crc)) return 0;
+    return bufor[1];
+}
+
+bool ramkaDekodujDane(const uint8_t* bufor, size_t dlugosc, RamkaDane* ramka) {
+    uint8_t typ = ramkaSprawdz(bufor, dlugosc);
+    if (typ != RAMKA_TYP_DANE && typ != RAMKA_TYP_DANE_STREFA) return false;
+    const bool strefa = typ == RAMKA_TYP_DANE_STREFA;
+    if (dlugosc != RAMKA_NAGLOWEK_BAJTY + DANE_POLA_BAJTY + (strefa ? STREFA_POLA_BAJTY : 0) + RAMKA_CRC_BAJTY) {
+        return false;
+    }
+
+    czytajNaglowek(bufor, &ramka->naglowek);
+    const uint8_t* p = czytajPolaDane(bufor + RAMKA_NAGLOWEK_BAJTY, ramka);
+    ramka->przeniesione    = strefa ? p[0] : 0;
+    ramka->pominiete       = strefa ? czytajU16(p + 1) : 0;
+    return true;
+}
+
+// Statystyki pól w kolejności min, max, średnia, odchylenie
+static int32_t* statystykaPola(RamkaStatystyka* s, int i) {
+    int32_t* wartosci[4] = { &s->min, &s->max, &s->srednia, &s->odchylenie };
+    return wartosci[i];
+}
+
+size_t ramkaKodujAgregat(const RamkaAgregat* ramka, uint8_t* bufor, size_t rozmiar) {
+    const size_t dlugosc = RAMKA_NAGLOWEK_BAJTY + AGREGAT_POLA_BAJTY;
+    if (rozmiar < dlugosc + RAMKA_CRC_BAJTY) return 0;
+
+    uint8_t* p = zapiszNaglowek(bufor, RAMKA_TYP_AGREGAT, &ramka->naglowek);
+    zapiszU16(p, ramka->okres_s);  p += 2;
+    zapiszU16(p, ramka->probki);   p += 2;
+    for (int pole = 0; pole < RAMKA_LICZBA_POL; pole++) {
+        RamkaStatystyka s = ramka->pola[pole];
+        for (int i = 0; i < 4; i++) {
+            int32_t v = *statystykaPola(&s, i);
+            // Pola jak w ramce DANE: temperatura int16, wilgotność uint16,
+            // CO2/amoniak uint16 z RAMKA_BRAK_ODCZYTU, nasłonecznienie uint32
+            if (pole == 0)      { zapiszU16(p, (uint16_t)(int16_t)v);  p += 2; }
+            else if (pole == 4) { zapiszU32(p, (uint32_t)v);           p += 4; }
+            else                { zapiszU16(p, odczytNaU16(v));        p += 2; }
+        }
+    }
+
+    return zamknijRamke(bufor, dlugosc);
+}
+
+size_t ramkaKodujPaczke(const RamkaPaczka* ramka, uint8_t* bufor, size_t rozmiar) {
+    if (ramka->liczba == 0 || ramka->liczba > RAMKA_PACZKA_MAX) return 0;
+    const size_t dlugosc = RAMKA_NAGLOWEK_BAJTY + 1 + ramka->liczba * PACZKA_PROBKA_BAJTY;
+    if (rozmiar < dlugosc + RAMKA_CRC_BAJTY) return 0;
+
+    // Czas paczki = najwcześniejsza próbka (RTC węzła mógł zostać cofnięty przez SYNC)
+    RamkaNaglowek naglowek = ramka->naglowek;
+    naglowek.epoch = ramka->probki[0].naglowek.epoch;
+    for (uint8_t i = 1; i < ramka->liczba; i++) {
+        if (ramka->probki[i].naglowek.epoch < naglowek.epoch) naglowek.epoch = ramka->probki[i].naglowek.epoch;
+    }
+
+    uint8_t* p = zapiszNaglowek(bufor, RAMKA_TYP_PACZKA, &naglowek);
+    *p++ = ramka->liczba;
+    for (uint8_t i = 0; i < ramka->liczba; i++) {
+        const RamkaDane* probka = &ramka->probki[i];
+        uint32_t przesuniecie = probka->naglowek.epoch - naglowek.epoch;
+        if (przesuniecie > UINT16_MAX) return 0;
+        zapiszU16(p, (uint16_t)przesuniecie);  p += 2;
+        p = zapiszPolaDane(p, probka);
+        *p++ = probka->przeniesione;
+        zapiszU16(p, probka->pominiete);       p += 2;
+    }
+
+    return zamknijRamke(bufor, dlugosc);
+}
+
+bool ramkaDekodujKura(const uint8_t* bufor, size_t dlugosc, RamkaKura* ramka) {
+    if (ramkaSprawdz(bufor, dlugosc) != RAMKA_TYP_KURA) return false;
+    if (dlugosc < RAMKA_NAGLOWEK_BAJTY + KURA_POLA_BAJTY + RAMKA_CRC_BAJTY) return false;
+
+    czytajNaglowek(bufor, &ramka->naglowek);
+    const uint8_t* p = bufor + RAMKA_NAGLOWEK_BAJTY;
+    ramka->waga_c = (int32_t)czytajU32(p);  p += 4;
+    uint8_t uid_dl = *p++;
+    if (uid_dl > RAMKA_MAX_UID) return false;
+    if (dlugosc != RAMKA_NAGLOWEK_BAJTY + KURA_POLA_BAJTY + uid_dl + RAMKA_CRC_BAJTY) return false;
+    ramka->uid_dlugosc = uid_dl;
+    memcpy(ramka->uid, p, uid_dl);
+    return true;
+}
+
+bool ramkaDekodujAgregat(const uint8_t* bufor, size_t dlugosc, RamkaAgregat* ramka) {
+    if (ramkaSprawdz(bufor, dlugosc) != RAMKA_TYP_AGREGAT) return false;
+    if (dlugosc != RAMKA_NAGLOWEK_BAJTY + AGREGAT_POLA_BAJTY + RAMKA_CRC_BAJTY) return false;
+
+    czytajNaglowek(bufor, &ramka->naglowek);
+    const uint8_t* p = bufor + RAMKA_NAGLOWEK_BAJTY;
+    ramka->okres_s = czytajU16(p);  p += 2;
+    ramka->probki  = czytajU16(p);  p += 2;
+    for (int pole = 0; pole < RAMKA_LICZBA_POL; pole++) {
+        for (int i = 0; i < 4; i++) {
+            int32_t* v = statystykaPola(&ramka->pola[pole], i);
+            if (pole == 0)      { *v = (int16_t)czytajU16(p);       p += 2; }
+            else if (pole == 4) { *v = (int32_t)czytajU32(p);       p += 4; }
+            else                { *v = u16NaOdczyt(czytajU16(p));   p += 2; }
+        }
+    }
+    return true;
+}
+
+bool ramkaDekodujPaczke(const uint8_t* bufor, size_t dlugosc, RamkaPaczka* ramka) {
+    if (ramkaSprawdz(bufor, dlugosc) != RAMKA_TYP_PACZKA) return false;
+    if (dlugosc < RAMKA_NAGLOWEK_BAJTY + 1 + RAMKA_CRC_BAJTY) return false;
+    uint8_t liczba = bufor[RAMKA_NAGLOWEK_BAJTY];
+    if (liczba == 0 || liczba > RAMKA_PACZKA_MAX) return false;
+    if (dlugosc != RAMKA_NAGLOWEK_BAJTY + 1 + liczba * PACZKA_PROBKA_BAJTY + RAMKA_CRC_BAJTY) return false;
+
+    czytajNaglowek(bufor, &ramka->naglowek);
+    ramka->liczba = liczba;
+    const uint8_t* p = bufor + RAMKA_NAGLOWEK_BAJTY + 1;
+    for (uint8_t i = 0; i < liczba; i++) {
+        RamkaDane* probka = &ramka->probki[i];
+        probka->naglowek = ramka->naglowek;
+        probka->naglowek.typ = RAMKA_TYP_DANE;
+        probka->naglowek.epoch += czytajU16(p);  p += 2;
+        p = czytajPolaDane(p, probka);
+        probka->przeniesione = *p++;
+        probka->pominiete = czytajU16(p);        p += 2;
+    }
+    return true;
+}
+
+// === WARSTWA TEKSTOWA (base64) ===
+
+size_t ramkaDoTekstu(const uint8_t* ramka, size_t dlugosc, char* tekst, size_t rozmiar) {
+    size_t potrzeba = RAMKA_PREFIX_DL + ((dlugosc + 2) / 3) * 4 + 1;
+    if (rozmiar < potrzeba) return 0;
+
+    memcpy(tekst, RAMKA_PREFIX, RAMKA_PREFIX_DL);
+    char* w = tekst + RAMKA_PREFIX_DL;
+    size_t i = 0;
+    for (; i + 2 < dlugosc; i += 3) {
+        uint32_t v = ((uint32_t)ramka[i] << 16) | ((uint32_t)ramka[i + 1] << 8) | ramka[i + 2];
+        *w++ = BASE64_ZNAKI[(v >> 18) & 0x3F];
+        *w++ = BASE64_ZNAKI[(v >> 12) & 0x3F];
+        *w++ = BASE64_ZNAKI[(v >> 6) & 0x3F];
+        *w++ = BASE64_ZNAKI[v & 0x3F];
+    }
+    if (i < dlugosc) {
+        uint32_t v = (uint32_t)ramka[i] << 16;
+        if (i + 1 < dlugosc) v |= (uint32_t)ramka[i + 1] << 8;
+        *w++ = BASE64_ZNAKI[(v >> 18) & 0x3F];
+        *w++ = BASE64_ZNAKI[(v >> 12) & 0x3F];
+        *w++ = (i + 1 < dlugosc) ? BASE64_ZNAKI[(v >> 6) & 0x3F] : '=';
+        *w++ = '=';
+    }
+    *w = '\0';
+    return (size_t)(w - tekst);
+}
+
+static int wartoscBase64(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+size_t ramkaZTekstu(const char* tekst, size_t dlugosc, uint8_t* ramka, size_t rozmiar) {
+    if (dlugosc == 0 || (dlugosc % 4) != 0) return 0;
+
+    size_t n = 0;
+    for (size_t i = 0; i < dlugosc; i += 4) {
+        int a = wartoscBase64(tekst[i]);
+        int b = wartoscBase64(tekst[i + 1]);
+        if (a < 0 || b < 0) return 0;
+
+        bool ostatni = (i + 4 == dlugosc);
+        int c = (ostatni && tekst[i + 2] == '=') ? -2 : wartoscBase64(tekst[i + 2]);
+        int d = (ostatni && tekst[i + 3] == '=') ? -2 : wartoscBase64(tekst[i + 3]);
+        if (c == -1 || d == -1 || (c == -2 && d != -2)) return 0;
+
+        size_t bajtow = (c == -2) ? 1 : (d == -2) ? 2 : 3;
+        if (n + bajtow > rozmiar) return 0;
+
+        uint32_t v = ((uint32_t)a << 18) | ((uint32_t)b << 12);
+        if (c >= 0) v |= (uint32_t)c << 6;
+        if (d >= 0) v |= (uint32_t)d;
+        ramka[n++] = (uint8_t)(v >> 16);
+        if (bajtow > 1) ramka[n++] = (uint8_t)(v >> 8);
+        if (bajtow > 2) ramka[n++] = (uint8_t)v;
+    }
+    return n;
+}
+
+// === POMOCNICZE ===
+
+void ramkaFormatujCzas(uint32_t epoch, char* bufor, size_t rozmiar) {
+    time_t t = (time_t)epoch;
+    struct tm czas;
+    gmtime_r(&t, &czas);
+    if (strftime(bufor, rozmiar, "%H:%M:%S %a, %b %d %Y", &czas) == 0 && rozmiar > 0) {
+        bufor[0] = '\0';
+    }
+}
+
+void ramkaUidNaHex(const uint8_t* uid, uint8_t dlugosc, char* bufor, size_t rozmiar) {
+    static const char HEX_ZNAKI[] = "0123456789ABCDEF";
+    size_t w = 0;
+    for (uint8_t i = 0; i < dlugosc && w + 2 < rozmiar; i++) {
+        bufor[w++] = HEX_ZNAKI[uid[i] >> 4];
+        bufor[w++] = HEX_ZNAKI[uid[i] & 0x0F];
+    }
+    if (rozmiar > 0) bufor[w] = '\0';
+}
+
+static int wartoscHex(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+uint8_t ramkaUidZHex(const char* hex, uint8_t* uid, uint8_t rozmiar) {
+    uint8_t n = 0;
+    while (hex[0] != '\0' && hex[1] != '\0') {
+        int h = wartoscHex(hex[0]);
+        int l = wartoscHex(hex[1]);
+        if (h < 0 || l < 0 || n >= rozmiar) return 0;
+        uid[n++] = (uint8_t)((h << 4) | l);
+        hex += 2;
+    }
+    // Nieparzysta liczba znaków HEX - błędny UID
+    if (hex[0] != '\0') return 0;
+    return n;
+}
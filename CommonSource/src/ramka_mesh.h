@@ -0,0 +1,192 @@
+/*
+ * WSPÓLNY FORMAT RAMKI MESH - ramka_mesh.h
+ *
+ * Binarna, wersjonowana ramka danych przesyłana z węzłów (Czujnik_IoT,
+ * Czujnik_IoT_waga) do roota (Kurnik_IoT) zamiast tekstu CSV.
+ *
+ * Układ ramki (little-endian):
+ *   [0]     wersja formatu (RAMKA_WERSJA)
+ *   [1]     typ ramki (RAMKA_TYP_*)
+ *   [2..5]  ID węzła mesh (uint32)
+ *   [6..7]  numer sekwencyjny (uint16, zawija się)
+ *   [8..11] czas pomiaru - epoch w sekundach (uint32)
+ *   [12..]  pola typu ramki (stałoprzecinkowe)
+ *   [n-2..] CRC-16/CCITT-FALSE liczone ze wszystkich poprzednich bajtów
+ *
+ * painlessMesh przesyła wiadomości jako tekst w kopercie JSON, dlatego
+ * ramka jest wysyłana jako "RAMK" + base64(ramka).
+ *
+ * Moduł nie używa Arduino ani sterty - kompiluje się również na hoście.
+ */
+
+#ifndef RAMKA_MESH_H
+#define RAMKA_MESH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Tag wiadomości mesh niosącej ramkę binarną (4 znaki, jak "DANE"/"KURA")
+#define RAMKA_PREFIX         "RAMK"
+#define RAMKA_PREFIX_DL      4
+
+#define RAMKA_WERSJA         1
+
+// Typy ramek
+#define RAMKA_TYP_DANE       1     // Pomiary z czujników środowiskowych
+#define RAMKA_TYP_KURA       2     // Pomiar wagi kury z RFID
+#define RAMKA_TYP_DANE_STREFA 3    // DANE + pola przeniesione i liczba pominiętych próbek
+#define RAMKA_TYP_AGREGAT    4     // Min/max/średnia/odchylenie pomiarów z okna węzła
+#define RAMKA_TYP_PACZKA     5     // Do RAMKA_PACZKA_MAX ramek DANE w jednej wiadomości mesh
+
+// Bity pola "przeniesione" - wartość pola powtarza ostatnio wysłaną (strefa martwa węzła)
+#define RAMKA_POLE_TEMPERATURA     0x01
+#define RAMKA_POLE_WILGOTNOSC      0x02
+#define RAMKA_POLE_CO2             0x04
+#define RAMKA_POLE_AMONIAK         0x08
+#define RAMKA_POLE_NASLONECZNIENIE 0x10
+
+// Liczba pól pomiarowych - indeks pola w ramce AGREGAT odpowiada bitowi RAMKA_POLE_* (1 << i)
+#define RAMKA_LICZBA_POL           5
+
+// Rozmiary
+#define RAMKA_NAGLOWEK_BAJTY 12
+#define RAMKA_CRC_BAJTY      2
+#define RAMKA_MAX_UID        10    // Maksymalna długość UID RFID (MIFARE: 4, 7 lub 10 bajtów)
+#define RAMKA_PACZKA_MAX     8     // Maksymalna liczba próbek w ramce PACZKA
+#define RAMKA_MAX_BAJTY      160   // Bufor wystarczający na każdą ramkę
+#define RAMKA_MAX_TEKST      (RAMKA_PREFIX_DL + ((RAMKA_MAX_BAJTY + 2) / 3) * 4 + 1)
+
+// Wartość pola uint16 oznaczająca brak odczytu (czujnik zwrócił -1)
+#define RAMKA_BRAK_ODCZYTU   0xFFFF
+// Wartość pola naslonecznienie (uint32) oznaczająca błąd czujnika światła (-1);
+// 0 lux to poprawny odczyt w ciemności
+#define RAMKA_BRAK_SWIATLA   0xFFFFFFFFu
+
+// Rozmiar bufora na sformatowany czas "HH:MM:SS Www, Mmm DD YYYY"
+#define RAMKA_CZAS_DL        32
+
+// Nagłówek wspólny dla wszystkich typów ramek
+typedef struct {
+    uint8_t  wersja;
+    uint8_t  typ;
+    uint32_t id_wezla;
+    uint16_t sekwencja;
+    uint32_t epoch;
+} RamkaNaglowek;
+
+// Ramka typu DANE - wartości w postaci stałoprzecinkowej
+typedef struct {
+    RamkaNaglowek naglowek;
+    int16_t  temperatura_c;     // Temperatura w setnych °C
+    uint16_t wilgotnosc_c;      // Wilgotność w setnych %
+    int32_t  poziom_co2;        // CO2 w ppm (-1 = brak odczytu)
+    int32_t  poziom_amoniaku;   // Amoniak/TVOC (-1 = brak odczytu)
+    uint32_t naslonecznienie;   // Natężenie światła w luksach (RAMKA_BRAK_SWIATLA = brak odczytu)
+    uint8_t  przeniesione;      // Maska RAMKA_POLE_* pól powtórzonych z poprzedniej ramki
+    uint16_t pominiete;         // Próbki niewysłane (w strefie martwej) od poprzedniej ramki
+} RamkaDane;
+
+// Ramka typu KURA - waga kury przypisana do UID karty RFID
+typedef struct {
+    RamkaNaglowek naglowek;
+    int32_t  waga_c;                  // Waga w setnych grama
+    uint8_t  uid_dlugosc;             // Liczba bajtów UID
+    uint8_t  uid[RAMKA_MAX_UID];      // Surowe bajty UID
+} RamkaKura;
+
+// Statystyki jednego pola z okna agregacji (jednostki jak w RamkaDane:
+// setne °C / setne % / ppm / lux). CO2, amoniak i nasłonecznienie mają -1
+// we wszystkich polach, gdy w oknie nie było ważnego odczytu.
+typedef struct {
+    int32_t min;
+    int32_t max;
+    int32_t srednia;
+    int32_t odchylenie;         // Odchylenie standardowe (populacji) próbek okna
+} RamkaStatystyka;
+
+// Ramka typu AGREGAT - podsumowanie okna pomiarów węzła (epoch = koniec okna)
+typedef struct {
+    RamkaNaglowek naglowek;
+    uint16_t okres_s;           // Długość okna w sekundach
+    uint16_t probki;            // Liczba próbek w oknie
+    RamkaStatystyka pola[RAMKA_LICZBA_POL];   // Kolejność bitów RAMKA_POLE_*
+} RamkaAgregat;
+
+// Ramka typu PACZKA - kilka próbek DANE jednego węzła. Nagłówek paczki
+// jest wspólny; próbki niosą własny czas jako przesunięcie (uint16, s)
+// względem naglowek.epoch, który koder ustawia na najwcześniejszą próbkę.
+typedef struct {
+    RamkaNaglowek naglowek;
+    uint8_t  liczba;                          // Liczba próbek (1..RAMKA_PACZKA_MAX)
+    RamkaDane probki[RAMKA_PACZKA_MAX];       // Koder bierze z nagłówka próbki tylko epoch
+} RamkaPaczka;
+
+/*
+ * Konwersja float -> wartość stałoprzecinkowa w setnych (z zaokrągleniem).
+ */
+int32_t ramkaSetne(float wartosc);
+
+/*
+ * Kodują ramkę do bufora binarnego (nagłówek.wersja/typ są ustawiane automatycznie).
+ * Ramka DANE z niezerowymi polami przeniesione/pominiete jest kodowana jako
+ * RAMKA_TYP_DANE_STREFA (3 bajty więcej), w przeciwnym razie jako RAMKA_TYP_DANE.
+ * return: liczba zapisanych bajtów lub 0 gdy bufor jest za mały
+ */
+size_t ramkaKodujDane(const RamkaDane* ramka, uint8_t* bufor, size_t rozmiar);
+size_t ramkaKodujKura(const RamkaKura* ramka, uint8_t* bufor, size_t rozmiar);
+size_t ramkaKodujAgregat(const RamkaAgregat* ramka, uint8_t* bufor, size_t rozmiar);
+// Paczka: 0 także gdy liczba jest spoza 1..RAMKA_PACZKA_MAX lub próbki
+// są rozrzucone w czasie o więcej niż uint16 sekund
+size_t ramkaKodujPaczke(const RamkaPaczka* ramka, uint8_t* bufor, size_t rozmiar);
+
+/*
+ * Sprawdza wersję i CRC ramki binarnej.
+ * return: typ ramki (RAMKA_TYP_*) lub 0 gdy ramka jest nieprawidłowa
+ */
+uint8_t ramkaSprawdz(const uint8_t* bufor, size_t dlugosc);
+
+/*
+ * Dekodują zweryfikowaną ramkę do struktury. ramkaDekodujDane przyjmuje
+ * RAMKA_TYP_DANE (przeniesione = pominiete = 0) i RAMKA_TYP_DANE_STREFA.
+ * return: true jeśli ramka ma właściwy typ, długość i CRC
+ */
+bool ramkaDekodujDane(const uint8_t* bufor, size_t dlugosc, RamkaDane* ramka);
+bool ramkaDekodujKura(const uint8_t* bufor, size_t dlugosc, RamkaKura* ramka);
+bool ramkaDekodujAgregat(const uint8_t* bufor, size_t dlugosc, RamkaAgregat* ramka);
+bool ramkaDekodujPaczke(const uint8_t* bufor, size_t dlugosc, RamkaPaczka* ramka);
+
+/*
+ * Zamienia ramkę binarną na wiadomość tekstową "RAMK<base64>".
+ * return: długość tekstu (bez '\0') lub 0 gdy bufor jest za mały
+ */
+size_t ramkaDoTekstu(const uint8_t* ramka, size_t dlugosc, char* tekst, size_t rozmiar);
+
+/*
+ * Dekoduje część base64 wiadomości (tekst PO prefiksie "RAMK").
+ * return: liczba bajtów ramki lub 0 przy błędzie
+ */
+size_t ramkaZTekstu(const char* tekst, size_t dlugosc, uint8_t* ramka, size_t rozmiar);
+
+/*
+ * Formatuje epoch do postaci używanej w CSV: "HH:MM:SS Www, Mmm DD YYYY"
+ * (ten sam format co ESP32Time::getTimeDate()).
+ */
+void ramkaFormatujCzas(uint32_t epoch, char* bufor, size_t rozmiar);
+
+/*
+ * Formatuje UID jako wielkie litery HEX (np. "F7474A39").
+ */
+void ramkaUidNaHex(const uint8_t* uid, uint8_t dlugosc, char* bufor, size_t rozmiar);
+
+/*
+ * Parsuje UID zapisany jako HEX do bajtów.
+ * return: liczba bajtów UID lub 0 przy błędzie
+ */
+uint8_t ramkaUidZHex(const char* hex, uint8_t* uid, uint8_t rozmiar);
+
+/*
+ * CRC-16/CCITT-FALSE (wielomian 0x1021, wartość początkowa 0xFFFF).
+ */
+uint16_t ramkaCrc16(const uint8_t* dane, size_t dlugosc);
+
+#endif
@@ -0,0 +1,156 @@
+#include "agregacja.h"
+
+// Stan jednego pola w oknie (Welford: średnia i suma kwadratów odchyleń)
+typedef struct {
+    uint16_t n;
+    float    srednia;
+    float    m2;
+    int32_t  min;
+    int32_t  max;
+} PoleOkna;
+
+// Surowa próbka w postaci stałoprzecinkowej jak w ramce DANE (16 bajtów)
+typedef struct {
+    uint32_t epoch;
+    int16_t  temperatura_c;
+    uint16_t wilgotnosc_c;
+    uint16_t poziom_co2;          // RAMKA_BRAK_ODCZYTU = błąd odczytu
+    uint16_t poziom_amoniaku;     // RAMKA_BRAK_ODCZYTU = błąd odczytu
+    uint32_t naslonecznienie;     // RAMKA_BRAK_SWIATLA = błąd odczytu
+} ProbkaSurowa;
+
+static PoleOkna okno[RAMKA_LICZBA_POL];
+static uint16_t probkiOkna = 0;
+static uint32_t poczatekOkna = 0;     // epoch zamknięcia poprzedniego okna (lub pierwszej próbki)
+
+static ProbkaSurowa pierscien[AGREGACJA_SUROWE];
+static uint32_t zapisane = 0;         // Próbki zapisane od startu (indeks bezwzględny)
+static uint32_t nastepnaSurowa = 0;   // Zakres [nastepnaSurowa, koniecSurowych) do wysłania
+static uint32_t koniecSurowych = 0;
+
+static uint32_t licznikOkna = 0;
+static uint32_t licznikSurowe = 0;
+
+static uint16_t odczytNaU16(int32_t v) {
+    if (v < 0) return RAMKA_BRAK_ODCZYTU;
+    if (v >= RAMKA_BRAK_ODCZYTU) return RAMKA_BRAK_ODCZYTU - 1;
+    return (uint16_t)v;
+}
+
+static int32_t u16NaOdczyt(uint16_t v) {
+    return v == RAMKA_BRAK_ODCZYTU ? -1 : (int32_t)v;
+}
+
+static void dodajDoPola(PoleOkna* pole, int32_t wartosc) {
+    if (pole->n == 0) {
+        pole->min = pole->max = wartosc;
+        pole->srednia = 0.0f;
+        pole->m2 = 0.0f;
+    } else {
+        if (wartosc < pole->min) pole->min = wartosc;
+        if (wartosc > pole->max) pole->max = wartosc;
+    }
+    pole->n++;
+    float delta = wartosc - pole->srednia;
+    pole->srednia += delta / pole->n;
+    pole->m2 += delta * (wartosc - pole->srednia);
+}
+
+// Wartości w jednostkach ramki (kolejność bitów RAMKA_POLE_*)
+static void wartosciRamki(const Pakiet_Danych* odczyt, int32_t* wartosci) {
+    wartosci[0] = ramkaSetne(odczyt->temperatura);
+    wartosci[1] = ramkaSetne(odczyt->wilgotnosc);
+    wartosci[2] = odczyt->poziom_co2;
+    wartosci[3] = odczyt->poziom_amoniaku;
+    wartosci[4] = odczyt->naslonecznienie;
+}
+
+static void zapiszSurowa(const int32_t* wartosci, uint32_t epoch) {
+    ProbkaSurowa* p = &pierscien[zapisane % AGREGACJA_SUROWE];
+    p->epoch           = epoch;
+    p->temperatura_c   = (int16_t)wartosci[0];
+    p->wilgotnosc_c    = (uint16_t)wartosci[1];
+    p->poziom_co2      = odczytNaU16(wartosci[2]);
+    p->poziom_amoniaku = odczytNaU16(wartosci[3]);
+    p->naslonecznienie = wartosci[4] < 0 ? RAMKA_BRAK_SWIATLA : (uint32_t)wartosci[4];
+    zapisane++;
+}
+
+void agregacjaDodaj(const Pakiet_Danych* odczyt, uint32_t epoch) {
+    int32_t wartosci[RAMKA_LICZBA_POL];
+    wartosciRamki(odczyt, wartosci);
+
+    if (poczatekOkna == 0) poczatekOkna = epoch;
+    for (int i = 0; i < RAMKA_LICZBA_POL; i++) {
+        // Temperatura i wilgotność pochodzą z ważnej ramki DHT22, pozostałe mają -1 przy błędzie
+        if (i >= 2 && wartosci[i] < 0) continue;
+        if (okno[i].n < UINT16_MAX) dodajDoPola(&okno[i], wartosci[i]);
+    }
+    if (probkiOkna < UINT16_MAX) probkiOkna++;
+
+    zapiszSurowa(wartosci, epoch);
+}
+
+void agregacjaZapiszSurowa(const Pakiet_Danych* odczyt, uint32_t epoch) {
+    int32_t wartosci[RAMKA_LICZBA_POL];
+    wartosciRamki(odczyt, wartosci);
+    zapiszSurowa(wartosci, epoch);
+}
+
+bool agregacjaZamknijOkno(uint32_t epoch, RamkaAgregat* ramka) {
+    if (probkiOkna == 0) return false;
+
+    ramka->naglowek.epoch = epoch;
+    ramka->okres_s = (uint16_t)(epoch - poczatekOkna > UINT16_MAX ? UINT16_MAX : epoch - poczatekOkna);
+    ramka->probki = probkiOkna;
+    for (int i = 0; i < RAMKA_LICZBA_POL; i++) {
+        RamkaStatystyka* s = &ramka->pola[i];
+        if (okno[i].n == 0) {
+            s->min = s->max = s->srednia = s->odchylenie = -1;
+            continue;
+        }
+        s->min        = okno[i].min;
+        s->max        = okno[i].max;
+        s->srednia    = (int32_t)lroundf(okno[i].srednia);
+        s->odchylenie = (int32_t)lroundf(sqrtf(okno[i].m2 / okno[i].n));
+        okno[i].n = 0;
+    }
+    probkiOkna = 0;
+    poczatekOkna = epoch;
+    licznikOkna++;
+    return true;
+}
+
+uint16_t agregacjaZadajSurowe(uint16_t liczba) {
+    uint32_t dostepne = zapisane < AGREGACJA_SUROWE ? zapisane : AGREGACJA_SUROWE;
+    if (liczba == 0 || liczba > dostepne) liczba = (uint16_t)dostepne;
+    nastepnaSurowa = zapisane - liczba;
+    koniecSurowych = zapisane;
+    return liczba;
+}
+
+bool agregacjaNastepnaSurowa(RamkaDane* ramka) {
+    // Próbki nadpisane od czasu żądania są już niedostępne
+    if (zapisane - nastepnaSurowa > AGREGACJA_SUROWE) {
+        nastepnaSurowa = zapisane - AGREGACJA_SUROWE;
+    }
+    if (nastepnaSurowa >= koniecSurowych) return false;
+
+    const ProbkaSurowa* p = &pierscien[nastepnaSurowa % AGREGACJA_SUROWE];
+    ramka->naglowek.epoch  = p->epoch;
+    ramka->temperatura_c   = p->temperatura_c;
+    ramka->wilgotnosc_c    = p->wilgotnosc_c;
+    ramka->poziom_co2      = u16NaOdczyt(p->poziom_co2);
+    ramka->poziom_amoniaku = u16NaOdczyt(p->poziom_amoniaku);
+    ramka->naslonecznienie = p->naslonecznienie;
+    ramka->przeniesione    = 0;
+    ramka->pominiete       = 0;
+    nastepnaSurowa++;
+    licznikSurowe++;
+    return true;
+}
+
+void agregacjaStatystyki(uint32_t* okna, uint32_t* surowe_wyslane) {
+    *okna = licznikOkna;
+    *surowe_wyslane = licznikSurowe;
+}
@@ -0,0 +1,48 @@
+#ifndef AGREGACJA_H
+#define AGREGACJA_H
+
+#include "czujniki.h"
+#include "ramka_mesh.h"
+
+// Agregacja pomiarów węzła w oknach czasowych + pierścień surowych próbek
+//
+// Zamiast wysyłać każdą próbkę (co 5 s) węzeł zbiera je w oknie i co
+// AGREGACJA_OKRES_S wysyła jedną ramkę RAMKA_TYP_AGREGAT z min/max/średnią
+// i odchyleniem standardowym każdego pola (algorytm Welforda - bez
+// przechowywania próbek okna). Błędne odczyty (-1) nie wchodzą do statystyk.
+//
+// Ostatnie AGREGACJA_SUROWE próbek zostaje w pamięci RAM - także bez
+// agregacji (UZYJ_AGREGACJI 0), przed oceną strefy martwej. Root może je
+// pobrać wiadomością "SURO<liczba>" - węzeł odsyła je (od najstarszej) w ramkach
+// PACZKA, po RAMKA_PACZKA_MAX próbek w jednym kroku taska.
+
+// Okres ramek agregatu (s)
+#define AGREGACJA_OKRES_S        60
+// Pojemność pierścienia surowych próbek (10 minut przy próbce co 5 s)
+#define AGREGACJA_SUROWE         120
+// Odstęp kroków odpowiedzi na żądanie surowych próbek (ms)
+#define AGREGACJA_KROK_MS        200
+
+// Dodaje próbkę do okna i do pierścienia surowych próbek
+void agregacjaDodaj(const Pakiet_Danych* odczyt, uint32_t epoch);
+
+// Dodaje próbkę tylko do pierścienia surowych próbek (wysyłka bez agregacji)
+void agregacjaZapiszSurowa(const Pakiet_Danych* odczyt, uint32_t epoch);
+
+// Wypełnia ramkę statystykami okna (bez nagłówka id/sekwencja) i otwiera
+// nowe okno. return: false gdy okno jest puste - nie ma czego wysłać
+bool agregacjaZamknijOkno(uint32_t epoch, RamkaAgregat* ramka);
+
+// Zaznacza do wysłania ostatnie `liczba` surowych próbek (0 = wszystkie).
+// return: liczba próbek zaznaczonych do wysłania
+uint16_t agregacjaZadajSurowe(uint16_t liczba);
+
+// Pobiera następną zaznaczoną próbkę jako ramkę DANE (bez id/sekwencji).
+// Próbki nadpisane w pierścieniu w trakcie wysyłki są pomijane.
+// return: false gdy nie ma już nic do wysłania
+bool agregacjaNastepnaSurowa(RamkaDane* ramka);
+
+// Liczniki od startu (do statusu węzła)
+void agregacjaStatystyki(uint32_t* okna, uint32_t* surowe_wyslane);
+
+#endif
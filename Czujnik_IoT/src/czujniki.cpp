@@ -1,7 +1,7 @@
 #include <czujniki.h>
 #include "mesh_local.h" 
+#include "ramka_mesh.h"
 
-DHT dht22(PIN_DHT22, DHTTYPE);
 Adafruit_SGP30 sgp;
 
 // Inicjalizacja czujnika SGP30
@@ -13,6 +13,9 @@ void InicjalizacjaCzujnikow() {
         Serial.println("Czujnik SGP30 zainicjalizowany pomyślnie");
         // Czujnik wymaga ok. 15 sekund na inicjalizację
     }
+
+    // DHT22 - ramka co DHT_OKRES_MS zbierana w tle (dhtObsluga() w loop())
+    dhtInicjalizuj(PIN_DHT22);
 }
 
 // CO2 Sensor - Oblicza bezwzględną wilgotność na podstawie temperatury i wilgotności względnej
@@ -23,18 +26,6 @@ uint32_t getAbsoluteHumidity(float temperature, float humidity) {
     return absoluteHumidityScaled;
 }
 
-float measureDHT22_Temp(){
-  float t = dht22.readTemperature();
-  if (isnan(t)) return 0.0; 
-  return t;
-}
-
-float measureDHT22_Hum(){
-  float h = dht22.readHumidity();
-  if (isnan(h)) return 0.0; 
-  return h;
-}
-
 int odczytCO2(float temperature, float humidity) {
     if (!sgp.IAQmeasure()) {
         Serial.println("Błąd odczytu czujnika SGP30");
@@ -52,7 +43,7 @@ int odczytTVOC(float temperature, float humidity) {
     return TVOC;
 }
 void pakietToCSV(const Pakiet_Danych* pakiet, char* buffer, size_t bufferSize) {
-    snprintf(buffer, bufferSize, "%d;%.2f;%.2f;%d;%d;%d;%s",
+    int n = snprintf(buffer, bufferSize, "%d;%.2f;%.2f;%d;%d;%d;%s",
         pakiet->ID_urzadzenia,      // ID urządzenia (int)
         pakiet->temperatura,        // Temperatura w °C (float, 2 miejsca po przecinku)
         pakiet->wilgotnosc,         // Wilgotność w % (float, 2 miejsca po przecinku)
@@ -60,17 +51,48 @@ void pakietToCSV(const Pakiet_Danych* pakiet, char* buffer, size_t bufferSize) {
         pakiet->poziom_amoniaku,    // Amoniak w ppm (int)
         pakiet->naslonecznienie,    // Nasłonecznienie w lux (int)
         pakiet->data_i_czas.c_str()); // Data i czas (String)
+    // Pola strefy martwej tylko gdy są niezerowe (root przyjmuje oba warianty)
+    if (n > 0 && (size_t)n < bufferSize && (pakiet->przeniesione != 0 || pakiet->pominiete != 0)) {
+        snprintf(buffer + n, bufferSize - n, ";%u;%u", pakiet->przeniesione, pakiet->pominiete);
+    }
+}
+
+void pakietNaRamkeDane(const Pakiet_Danych* pakiet, uint16_t sekwencja, uint32_t epoch, RamkaDane* ramka) {
+    ramka->naglowek.id_wezla  = (uint32_t)pakiet->ID_urzadzenia;
+    ramka->naglowek.sekwencja = sekwencja;
+    ramka->naglowek.epoch     = epoch;
+    ramka->temperatura_c      = (int16_t)ramkaSetne(pakiet->temperatura);   // setne °C
+    ramka->wilgotnosc_c       = (uint16_t)ramkaSetne(pakiet->wilgotnosc);   // setne %
+    ramka->poziom_co2         = pakiet->poziom_co2;
+    ramka->poziom_amoniaku    = pakiet->poziom_amoniaku;
+    ramka->naslonecznienie    = pakiet->naslonecznienie < 0 ? RAMKA_BRAK_SWIATLA : (uint32_t)pakiet->naslonecznienie;
+    ramka->przeniesione       = pakiet->przeniesione;
+    ramka->pominiete          = pakiet->pominiete;
+}
+
+size_t pakietToRamka(const Pakiet_Danych* pakiet, uint16_t sekwencja, uint32_t epoch, char* buffer, size_t bufferSize) {
+    RamkaDane ramka;
+    pakietNaRamkeDane(pakiet, sekwencja, epoch, &ramka);
+
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujDane(&ramka, bin, sizeof(bin));
+    if (n == 0) return 0;
+    return ramkaDoTekstu(bin, n, buffer, bufferSize);
 }
-Pakiet_Danych odczytCzujniki() {
-    Pakiet_Danych odczyt;
-    odczyt.ID_urzadzenia   = mesh.getNodeId();
-    odczyt.temperatura     = measureDHT22_Temp();        
-    odczyt.wilgotnosc      = measureDHT22_Hum();
-    odczyt.poziom_co2      = 10;
-    odczyt.poziom_amoniaku = 10;
-    odczyt.naslonecznienie = 2137; 
-    odczyt.data_i_czas     = rtc.getTimeDate();
-    return odczyt;
+bool odczytCzujniki(Pakiet_Danych* odczyt) {
+    // Temperatura i wilgotność z tej samej ramki DHT22
+    OdczytDHT dht;
+    dhtPobierz(&dht);
+    odczyt->ID_urzadzenia   = mesh.getNodeId();
+    odczyt->temperatura     = dht.temperatura;
+    odczyt->wilgotnosc      = dht.wilgotnosc;
+    odczyt->poziom_co2      = 10;
+    odczyt->poziom_amoniaku = 10;
+    odczyt->naslonecznienie = 2137; 
+    odczyt->data_i_czas     = rtc.getTimeDate();
+    odczyt->przeniesione    = 0;
+    odczyt->pominiete       = 0;
+    return dht.poprawny;
 }
 
 void TEST_zapelnijPakiet(Pakiet_Danych* pakiet, int wielkosc) {
@@ -86,6 +108,8 @@ void TEST_zapelnijPakiet(Pakiet_Danych* pakiet, int wielkosc) {
         pakiet[i].poziom_co2      = 1200 + 400 * sin(t * 0.8);   // 800-1600 ppm
         pakiet[i].poziom_amoniaku = 15 + 8   * sin(t * 1.7);     // 7-23 ppm
         pakiet[i].naslonecznienie = 50 + 45  * sin(t * 0.5);     // 5-95 lux
+        pakiet[i].przeniesione    = 0;
+        pakiet[i].pominiete       = 0;
         
         // Timestamp jest ustawiany przez roota
     }
@@ -4,7 +4,8 @@
 #include <Adafruit_SGP30.h>
 #include <cstdint>
 #include <cmath>
-#include <DHT.h>
+#include "czujnik_dht.h"
+#include "ramka_mesh.h"
 
 typedef struct {
     int   ID_urzadzenia;      // Identyfikator urządzenia
@@ -14,21 +15,27 @@ typedef struct {
     int   poziom_amoniaku;    // Stężenie amoniaku w ppm
     int   naslonecznienie;    // Natężenie światła w luksach
     String data_i_czas;       // Timestamp pomiaru (format: "HH:MM:SS Www, Mmm DD YYYY")
+    uint8_t  przeniesione;    // Maska RAMKA_POLE_* pól powtórzonych z poprzedniego pakietu (strefa_martwa.h)
+    uint16_t pominiete;       // Próbki niewysłane od poprzedniego pakietu
 } Pakiet_Danych;
 
 
 // CO2 Sensor - Oblicza bezwzględną wilgotność na podstawie temperatury i wilgotności względnej
 extern Adafruit_SGP30 sgp;
-extern DHT dht22;
 
 #define PIN_DHT22 14
-#define DHTTYPE DHT22
 
 void InicjalizacjaCzujnikow();
 uint32_t getAbsoluteHumidity(float temperature, float humidity);
 int odczytCO2(float temperature, float humidity);
 int odczytTVOC(float temperature, float humidity);
-Pakiet_Danych odczytCzujniki(); 
+// Wypełnia pakiet ostatnim odczytem czujników (DHT22 ze sterownika czujnik_dht.h).
+// return: false gdy brak ważnej ramki DHT22 - pakiet nie powinien być wysłany
+bool odczytCzujniki(Pakiet_Danych* odczyt);
 void pakietToCSV(const Pakiet_Danych* pakiet, char* buffer, size_t bufferSize);
+// Przepisuje pakiet do struktury ramki DANE (wartości stałoprzecinkowe)
+void pakietNaRamkeDane(const Pakiet_Danych* pakiet, uint16_t sekwencja, uint32_t epoch, RamkaDane* ramka);
+// Koduje pakiet jako binarną ramkę mesh "RAMK<base64>" (zob. CommonSource/src/ramka_mesh.h)
+size_t pakietToRamka(const Pakiet_Danych* pakiet, uint16_t sekwencja, uint32_t epoch, char* buffer, size_t bufferSize);
 void TEST_zapelnijPakiet(Pakiet_Danych* pakiet, int wielkosc);
 #endif
\ No newline at end of file
@@ -2,6 +2,9 @@
 #include "czujniki.h"
 #include "mesh_local.h"
 #include "pamiec.h"
+#include "strefa_martwa.h"
+#include "agregacja.h"
+#include "paczka.h"
 
 void setup() {
   Serial.begin(115200);
@@ -40,6 +43,9 @@ void loop() {
   // 
   // Zawsze wywołuj mesh.update()
   mesh.update();
+
+  // Sterownik DHT22 - krok maszyny stanów bez czekania
+  dhtObsluga();
   
   // Co 10 sekund wyświetl status
   if (millis() - lastDebug > 10000) {
@@ -49,6 +55,23 @@ void loop() {
     Serial.printf("Liczba węzłów: %d\n", mesh.getNodeList().size());
     Serial.printf("Czy ma czas: %s\n", czy_ma_czas ? "TAK" : "NIE");
     Serial.printf("Root ID: %u\n", root_id);
+    StatystykiDHT dht;
+    dhtPobierzStatystyki(&dht);
+    Serial.printf("DHT22: ramki %lu, poprawne %lu, błędy czasu/sumy/startu %lu/%lu/%lu\n",
+                  (unsigned long)dht.ramki, (unsigned long)dht.poprawne, (unsigned long)dht.bledy_czasu,
+                  (unsigned long)dht.bledy_sumy, (unsigned long)dht.bledy_startu);
+    uint32_t wyslane, pominiete;
+    strefaMartwaStatystyki(&wyslane, &pominiete);
+    Serial.printf("Odczyty: wysłane %lu, pominięte (strefa martwa) %lu\n",
+                  (unsigned long)wyslane, (unsigned long)pominiete);
+    uint32_t okna, surowe;
+    agregacjaStatystyki(&okna, &surowe);
+    Serial.printf("Agregacja: okna %lu, surowe próbki wysłane na żądanie %lu\n",
+                  (unsigned long)okna, (unsigned long)surowe);
+    uint32_t paczki, probki, nadpisane;
+    paczkaStatystyki(&paczki, &probki, &nadpisane);
+    Serial.printf("Paczki: wysłane %lu (%lu próbek), nadpisane bez roota %lu\n",
+                  (unsigned long)paczki, (unsigned long)probki, (unsigned long)nadpisane);
     Serial.println("-------------------\n");
   }
 }
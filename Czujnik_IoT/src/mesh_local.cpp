@@ -4,6 +4,10 @@
 #include "mesh_local.h"
 #include "czujniki.h"
 #include "pamiec.h"
+#include "ramka_mesh.h"
+#include "strefa_martwa.h"
+#include "agregacja.h"
+#include "paczka.h"
 
 painlessMesh mesh;
 Scheduler userScheduler;
@@ -11,18 +15,39 @@ ESP32Time rtc;
 uint32_t root_id = 0;
 bool czy_ma_czas = false;
 bool polaczony_z_mesh = false;
+static uint16_t sekwencjaRamek = 0;  // Numer sekwencyjny ramek binarnych węzła
 int mesh_channel = 0;  // Znaleziony kanał sieci mesh
 String mesh_ssid = "";  // Pełna nazwa znalezionej sieci mesh
 
 // Deklaracje forward
 void wyslijOdczyt();
 void zapytajOCzas();
+void wyslijAgregat();
+void wyslijSurowe();
+void wyslijPaczke();
 
 
 // Task wysyłania odczytów co 5 sekund
 Task taskWyslijOdczyt(TASK_SECOND * 5, TASK_FOREVER, &wyslijOdczyt);
 // Task żądania czasu co 10 sekund (aktywne dopóki nie ma czasu)
 Task taskZapytajCzas(TASK_SECOND * 10, TASK_FOREVER, &zapytajOCzas);
+// Task wysyłania agregatu okna pomiarów
+Task taskWyslijAgregat(TASK_SECOND * AGREGACJA_OKRES_S, TASK_FOREVER, &wyslijAgregat);
+// Task odsyłania surowych próbek (włączany przez żądanie SURO)
+Task taskWyslijSurowe(AGREGACJA_KROK_MS, TASK_FOREVER, &wyslijSurowe);
+// Task sprawdzania wieku odłożonej paczki co sekundę
+Task taskWyslijPaczke(TASK_SECOND, TASK_FOREVER, &wyslijPaczke);
+
+// Wysyła ramkę binarną do roota jako "RAMK<base64>"
+static bool wyslijRamke(const uint8_t* bin, size_t n) {
+    char ramka[RAMKA_MAX_TEKST];
+    if (n == 0 || ramkaDoTekstu(bin, n, ramka, sizeof(ramka)) == 0) {
+        Serial.println("Błąd kodowania ramki - pomijam wysyłkę");
+        return false;
+    }
+    mesh.sendSingle(root_id, ramka);
+    return true;
+}
 
 void receivedCallback(uint32_t from, String &msg) {
     Serial.printf(">>> ODEBRANO od %u: %s\n", from, msg.c_str());
@@ -31,6 +56,8 @@ void receivedCallback(uint32_t from, String &msg) {
     Serial.printf(">>> Prefix: '%s'\n", prefix.c_str());
     
     if(prefix == "SYNC") {
+        // Nowy root nie zna ostatnio wysłanych wartości - pierwszy raport w całości
+        if (root_id != from) strefaMartwaResetuj();
         root_id = from;
         String time = msg.substring(4);
         Serial.printf(">>> Time string: '%s'\n", time.c_str());
@@ -45,6 +72,12 @@ void receivedCallback(uint32_t from, String &msg) {
         taskZapytajCzas.disable();
         Serial.printf(">>> ZSYNCHRONIZOWANO CZAS z ROOT (ID: %u)\n", root_id);
         Serial.printf(">>> Aktualny czas RTC: %s\n", rtc.getTimeDate().c_str());
+    } else if (prefix == "SURO") {
+        // SURO<liczba> - root prosi o ostatnie surowe próbki (0 lub brak = wszystkie)
+        if (root_id == 0) return;
+        uint16_t liczba = agregacjaZadajSurowe((uint16_t)strtoul(msg.c_str() + 4, NULL, 10));
+        Serial.printf(">>> Żądanie surowych próbek od %u - wysyłam %u\n", from, liczba);
+        if (liczba > 0) taskWyslijSurowe.enable();
     } else {
         Serial.printf(">>> Nieznany prefix: %s\n", prefix.c_str());
     }
@@ -80,8 +113,40 @@ void wyslijOdczyt() {
     }
     
     // Odczytaj dane z czujników
-    Pakiet_Danych odczyt = odczytCzujniki();
+    Pakiet_Danych odczyt;
+    if (!odczytCzujniki(&odczyt)) {
+        Serial.println("Brak ważnego odczytu DHT22 - pomijam wysyłkę");
+        return;
+    }
+
+#if UZYJ_AGREGACJI
+    // Próbka trafia do okna agregatu i pierścienia surowych - wysyła je wyslijAgregat()/wyslijSurowe()
+    // (strefa martwa i paczki poniżej działają tylko bez agregacji)
+    agregacjaDodaj(&odczyt, rtc.getLocalEpoch());
+#else
+    // Każda próbka (także pominięta przez strefę martwą) zostaje w pierścieniu na żądanie SURO
+    agregacjaZapiszSurowa(&odczyt, rtc.getLocalEpoch());
+
+    // Bez zmian większych niż progi strefy martwej i przed heartbeatem - nie wysyłaj
+    if (!strefaMartwaOcen(&odczyt)) {
+        return;
+    }
     
+#if UZYJ_PACZEK
+    // Próbka czeka w paczce - wysyłka po PACZKA_ROZMIAR próbkach lub PACZKA_MAX_WIEK_MS
+    RamkaDane probka;
+    pakietNaRamkeDane(&odczyt, 0, rtc.getLocalEpoch(), &probka);
+    paczkaDodaj(&probka);
+    wyslijPaczke();
+    return;
+#elif UZYJ_RAMKI_BINARNEJ
+    char ramka[RAMKA_MAX_TEKST];
+    if (pakietToRamka(&odczyt, sekwencjaRamek++, rtc.getLocalEpoch(), ramka, sizeof(ramka)) == 0) {
+        Serial.println("Błąd kodowania ramki - pomijam wysyłkę");
+        return;
+    }
+    mesh.sendSingle(root_id, ramka);
+#else
     char dane[150];
     pakietToCSV(&odczyt, dane, 150);
     
@@ -89,8 +154,66 @@ void wyslijOdczyt() {
     msg += String(dane);
     
     mesh.sendSingle(root_id, msg);
+#endif
     
-    Serial.printf(">>> Wysłano odczyt z czujników do ROOT (ID: %u)\n", root_id);
+    Serial.printf(">>> Wysłano odczyt z czujników do ROOT (ID: %u, przeniesione: 0x%02X, pominięte: %u)\n",
+                  root_id, odczyt.przeniesione, odczyt.pominiete);
+#endif
+}
+
+void wyslijAgregat() {
+    if (!czy_ma_czas || root_id == 0) return;
+
+    RamkaAgregat agregat;
+    if (!agregacjaZamknijOkno(rtc.getLocalEpoch(), &agregat)) return;
+    agregat.naglowek.id_wezla  = mesh.getNodeId();
+    agregat.naglowek.sekwencja = sekwencjaRamek++;
+
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    if (wyslijRamke(bin, ramkaKodujAgregat(&agregat, bin, sizeof(bin)))) {
+        Serial.printf(">>> Wysłano agregat %u próbek z %u s do ROOT (ID: %u)\n",
+                      agregat.probki, agregat.okres_s, root_id);
+    }
+}
+
+// Krok odpowiedzi na SURO - jedna ramka PACZKA na wywołanie, żeby nie zapchać kolejki mesh
+void wyslijSurowe() {
+    RamkaPaczka paczka;
+    paczka.liczba = 0;
+    while (root_id != 0 && paczka.liczba < RAMKA_PACZKA_MAX && agregacjaNastepnaSurowa(&paczka.probki[paczka.liczba])) {
+        paczka.liczba++;
+    }
+    if (paczka.liczba < RAMKA_PACZKA_MAX) taskWyslijSurowe.disable();
+    if (paczka.liczba == 0) return;
+
+    paczka.naglowek.id_wezla  = mesh.getNodeId();
+    paczka.naglowek.sekwencja = sekwencjaRamek++;
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    wyslijRamke(bin, ramkaKodujPaczke(&paczka, bin, sizeof(bin)));
+}
+
+// Wysyła odłożone próbki, gdy paczka jest pełna lub najstarsza próbka czeka za długo
+void wyslijPaczke() {
+    if (root_id == 0 || !paczkaGotowa()) return;
+
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    size_t n = paczkaKoduj(mesh.getNodeId(), sekwencjaRamek++, bin, sizeof(bin));
+    if (n > 0) {
+        if (wyslijRamke(bin, n)) {
+            Serial.printf(">>> Wysłano paczkę próbek do ROOT (ID: %u, %u B)\n", root_id, (unsigned)n);
+        }
+        return;
+    }
+
+    // Paczki nie da się zakodować (np. skok RTC po SYNC poza 16-bitowe przesunięcie
+    // czasu) - nie gub próbek, wyślij każdą jako osobną ramkę DANE
+    Serial.println(">>> Błąd kodowania paczki - wysyłam próbki pojedynczo");
+    RamkaDane probka;
+    while (paczkaZdejmij(&probka)) {
+        probka.naglowek.id_wezla  = mesh.getNodeId();
+        probka.naglowek.sekwencja = sekwencjaRamek++;
+        wyslijRamke(bin, ramkaKodujDane(&probka, bin, sizeof(bin)));
+    }
 }
 
 // Skanuj sieci WiFi
@@ -236,9 +359,18 @@ void InicjalizacjaMesh() {
     // Dodanie tasków do schedulera
     userScheduler.addTask(taskWyslijOdczyt);
     userScheduler.addTask(taskZapytajCzas);
+    userScheduler.addTask(taskWyslijAgregat);
+    userScheduler.addTask(taskWyslijSurowe);
+    userScheduler.addTask(taskWyslijPaczke);
     
     // Włącz wysyłanie odczytów
     taskWyslijOdczyt.enable();
+#if UZYJ_AGREGACJI
+    taskWyslijAgregat.enable();
+#endif
+#if UZYJ_PACZEK
+    taskWyslijPaczke.enable();
+#endif
     
     Serial.println(">>> ROZPOCZĘTO PRACĘ JAKO NODE <<<");
     Serial.printf(">>> Node ID: %u\n", mesh.getNodeId());
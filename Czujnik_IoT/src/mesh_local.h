@@ -8,6 +8,27 @@
 #define MESH_PASSWORD   "pbl_haslo123"
 #define MESH_PORT       5555
 
+// 1 = wysyłaj pomiary jako binarną ramkę "RAMK" (ramka_mesh.h), 0 = stary format CSV
+// Root akceptuje oba formaty w okresie migracji
+#define UZYJ_RAMKI_BINARNEJ 1
+
+// 1 = wysyłaj co AGREGACJA_OKRES_S ramkę agregatu zamiast każdej próbki (agregacja.h),
+// 0 = każda próbka ze strefą martwą. W obu trybach ostatnie surowe próbki
+// root pobiera na żądanie ("SURO")
+// Agregacja wyklucza strefę martwą (strefa_martwa.h) i paczki: agregat opisuje
+// wszystkie próbki okna, więc wyslijOdczyt() kończy się na agregacjaDodaj()
+// Domyślnie wyłączona: panel WWW (webapp) czyta tylko pomiary z kurniki_dane,
+// a agregaty trafiają do kurniki_agregaty
+#define UZYJ_AGREGACJI 0
+
+// 1 = odkładaj wysyłane próbki i wysyłaj je razem jako ramkę PACZKA (paczka.h),
+// 0 = jedna wiadomość mesh na próbkę
+#define UZYJ_PACZEK 1
+
+#if (UZYJ_AGREGACJI || UZYJ_PACZEK) && !UZYJ_RAMKI_BINARNEJ
+#error "UZYJ_AGREGACJI i UZYJ_PACZEK wymagają UZYJ_RAMKI_BINARNEJ"
+#endif
+
 extern painlessMesh mesh;
 extern Scheduler userScheduler;
 extern uint32_t root_id;
@@ -0,0 +1,66 @@
+#include <Arduino.h>
+#include "paczka.h"
+
+static RamkaDane pierscien[RAMKA_PACZKA_MAX];
+static uint32_t czasDodania[RAMKA_PACZKA_MAX];  // millis() odłożenia próbki
+static uint8_t poczatek = 0;                    // Indeks najstarszej próbki
+static uint8_t liczba = 0;
+
+static uint32_t licznikPaczki = 0;
+static uint32_t licznikProbki = 0;
+static uint32_t licznikNadpisane = 0;
+
+void paczkaDodaj(const RamkaDane* probka) {
+    uint8_t indeks;
+    if (liczba == RAMKA_PACZKA_MAX) {
+        // Pełny pierścień (brak roota) - nadpisz najstarszą próbkę
+        indeks = poczatek;
+        poczatek = (poczatek + 1) % RAMKA_PACZKA_MAX;
+        licznikNadpisane++;
+    } else {
+        indeks = (poczatek + liczba) % RAMKA_PACZKA_MAX;
+        liczba++;
+    }
+    pierscien[indeks] = *probka;
+    czasDodania[indeks] = millis();
+}
+
+bool paczkaGotowa() {
+    if (liczba == 0) return false;
+    return liczba >= PACZKA_ROZMIAR || millis() - czasDodania[poczatek] >= PACZKA_MAX_WIEK_MS;
+}
+
+size_t paczkaKoduj(uint32_t id_wezla, uint16_t sekwencja, uint8_t* bufor, size_t rozmiar) {
+    if (liczba == 0) return 0;
+
+    // Koder oczekuje próbek od indeksu 0 - przesuń pierścień na początek tablicy
+    RamkaPaczka ramka;
+    ramka.naglowek.id_wezla  = id_wezla;
+    ramka.naglowek.sekwencja = sekwencja;
+    ramka.liczba = liczba;
+    for (uint8_t i = 0; i < liczba; i++) {
+        ramka.probki[i] = pierscien[(poczatek + i) % RAMKA_PACZKA_MAX];
+    }
+
+    size_t n = ramkaKodujPaczke(&ramka, bufor, rozmiar);
+    if (n == 0) return 0;   // Próbki zostają - wywołujący wyśle je przez paczkaZdejmij()
+    licznikPaczki++;
+    licznikProbki += liczba;
+    poczatek = 0;
+    liczba = 0;
+    return n;
+}
+
+bool paczkaZdejmij(RamkaDane* probka) {
+    if (liczba == 0) return false;
+    *probka = pierscien[poczatek];
+    poczatek = (poczatek + 1) % RAMKA_PACZKA_MAX;
+    liczba--;
+    return true;
+}
+
+void paczkaStatystyki(uint32_t* paczki, uint32_t* probki, uint32_t* nadpisane) {
+    *paczki = licznikPaczki;
+    *probki = licznikProbki;
+    *nadpisane = licznikNadpisane;
+}
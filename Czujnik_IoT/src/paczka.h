@@ -0,0 +1,43 @@
+#ifndef PACZKA_H
+#define PACZKA_H
+
+#include "ramka_mesh.h"
+
+// Łączenie próbek w paczki (jedna wiadomość mesh na kilka próbek)
+//
+// Każda wiadomość mesh to koperta JSON painlessMesh i osobne trasowanie,
+// więc zamiast wysyłać każdą próbkę węzeł odkłada ramki DANE do stałego
+// pierścienia i wysyła je razem jako RAMKA_TYP_PACZKA, gdy zbierze
+// PACZKA_ROZMIAR próbek albo najstarsza czeka PACZKA_MAX_WIEK_MS.
+// Pierścień mieści RAMKA_PACZKA_MAX próbek - zapas na czas bez roota;
+// po jego zapełnieniu najstarsza próbka jest nadpisywana.
+// Działa tylko bez agregacji (UZYJ_AGREGACJI 0 w mesh_local.h).
+
+// Liczba próbek wyzwalająca wysyłkę (1..RAMKA_PACZKA_MAX)
+#define PACZKA_ROZMIAR       6
+// Maksymalny czas oczekiwania najstarszej próbki (ms)
+#define PACZKA_MAX_WIEK_MS   30000
+
+#if PACZKA_ROZMIAR < 1 || PACZKA_ROZMIAR > RAMKA_PACZKA_MAX
+#error "PACZKA_ROZMIAR musi mieścić się w 1..RAMKA_PACZKA_MAX"
+#endif
+
+// Odkłada próbkę (nagłówek: liczy się tylko epoch)
+void paczkaDodaj(const RamkaDane* probka);
+
+// return: true gdy paczka osiągnęła PACZKA_ROZMIAR lub PACZKA_MAX_WIEK_MS
+bool paczkaGotowa();
+
+// Koduje odłożone próbki jako ramkę PACZKA i opróżnia pierścień.
+// return: liczba bajtów ramki lub 0 (pusto lub błąd kodowania, np. próbki
+//         odległe o ponad 16-bitowe przesunięcie czasu - pierścień zostaje)
+size_t paczkaKoduj(uint32_t id_wezla, uint16_t sekwencja, uint8_t* bufor, size_t rozmiar);
+
+// Zdejmuje najstarszą próbkę (wysyłka pojedynczymi ramkami po błędzie kodowania)
+// return: false gdy pierścień jest pusty
+bool paczkaZdejmij(RamkaDane* probka);
+
+// Liczniki od startu (do statusu węzła)
+void paczkaStatystyki(uint32_t* paczki, uint32_t* probki, uint32_t* nadpisane);
+
+#endif
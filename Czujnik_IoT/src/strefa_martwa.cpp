@@ -0,0 +1,76 @@
+#include "strefa_martwa.h"
+#include "ramka_mesh.h"
+
+static Pakiet_Danych ostatniWyslany;      // Wartości ostatnio wysłane do roota
+static bool jestWyslany = false;
+static uint32_t ostatniPelnyMs = 0;       // millis() ostatniego pełnego raportu
+static uint16_t pominieteOdWyslania = 0;
+
+static uint32_t licznikWyslane = 0;
+static uint32_t licznikPominiete = 0;
+
+static bool zmianaFloat(float nowa, float stara, float prog) {
+    return fabsf(nowa - stara) > prog;
+}
+
+// Pojawienie się lub zniknięcie błędu odczytu (-1) też jest zmianą
+static bool zmianaInt(int nowa, int stara, int prog) {
+    if ((nowa < 0) != (stara < 0)) return true;
+    return abs(nowa - stara) > prog;
+}
+
+bool strefaMartwaOcen(Pakiet_Danych* odczyt) {
+    uint32_t teraz = millis();
+    bool heartbeat = !jestWyslany || teraz - ostatniPelnyMs >= STREFA_HEARTBEAT_MS;
+
+    // Bit ustawiony = pole w strefie martwej (do przeniesienia)
+    uint8_t przeniesione = 0;
+    if (!heartbeat) {
+        if (!zmianaFloat(odczyt->temperatura, ostatniWyslany.temperatura, STREFA_TEMPERATURA))
+            przeniesione |= RAMKA_POLE_TEMPERATURA;
+        if (!zmianaFloat(odczyt->wilgotnosc, ostatniWyslany.wilgotnosc, STREFA_WILGOTNOSC))
+            przeniesione |= RAMKA_POLE_WILGOTNOSC;
+        if (!zmianaInt(odczyt->poziom_co2, ostatniWyslany.poziom_co2, STREFA_CO2))
+            przeniesione |= RAMKA_POLE_CO2;
+        if (!zmianaInt(odczyt->poziom_amoniaku, ostatniWyslany.poziom_amoniaku, STREFA_AMONIAK))
+            przeniesione |= RAMKA_POLE_AMONIAK;
+        if (!zmianaInt(odczyt->naslonecznienie, ostatniWyslany.naslonecznienie, STREFA_NASLONECZNIENIE))
+            przeniesione |= RAMKA_POLE_NASLONECZNIENIE;
+
+        const uint8_t wszystkie = RAMKA_POLE_TEMPERATURA | RAMKA_POLE_WILGOTNOSC | RAMKA_POLE_CO2 |
+                                  RAMKA_POLE_AMONIAK | RAMKA_POLE_NASLONECZNIENIE;
+        if (przeniesione == wszystkie) {
+            if (pominieteOdWyslania < UINT16_MAX) pominieteOdWyslania++;
+            licznikPominiete++;
+            return false;
+        }
+    }
+
+    // Pola w strefie powtarzają wysłaną wartość - odniesienie zmienia się
+    // dopiero po przekroczeniu progu (wolny dryf też zostanie zgłoszony)
+    if (przeniesione & RAMKA_POLE_TEMPERATURA)     odczyt->temperatura = ostatniWyslany.temperatura;
+    if (przeniesione & RAMKA_POLE_WILGOTNOSC)      odczyt->wilgotnosc = ostatniWyslany.wilgotnosc;
+    if (przeniesione & RAMKA_POLE_CO2)             odczyt->poziom_co2 = ostatniWyslany.poziom_co2;
+    if (przeniesione & RAMKA_POLE_AMONIAK)         odczyt->poziom_amoniaku = ostatniWyslany.poziom_amoniaku;
+    if (przeniesione & RAMKA_POLE_NASLONECZNIENIE) odczyt->naslonecznienie = ostatniWyslany.naslonecznienie;
+
+    odczyt->przeniesione = przeniesione;
+    odczyt->pominiete = pominieteOdWyslania;
+
+    ostatniWyslany = *odczyt;
+    jestWyslany = true;
+    if (heartbeat) ostatniPelnyMs = teraz;
+    pominieteOdWyslania = 0;
+    licznikWyslane++;
+    return true;
+}
+
+void strefaMartwaResetuj() {
+    jestWyslany = false;
+    pominieteOdWyslania = 0;
+}
+
+void strefaMartwaStatystyki(uint32_t* wyslane, uint32_t* pominiete) {
+    *wyslane = licznikWyslane;
+    *pominiete = licznikPominiete;
+}
@@ -0,0 +1,38 @@
+#ifndef STREFA_MARTWA_H
+#define STREFA_MARTWA_H
+
+#include "czujniki.h"
+
+// Tłumienie raportów węzła (strefa martwa + heartbeat)
+//
+// Odczyt jest wysyłany tylko wtedy, gdy któreś pole zmieniło się względem
+// ostatnio wysłanej wartości o więcej niż jego próg albo minął
+// STREFA_HEARTBEAT_MS od ostatniego pełnego raportu. W wysłanym pakiecie
+// pola mieszczące się w strefie powtarzają ostatnio wysłaną wartość
+// i są oznaczone w masce "przeniesione" (RAMKA_POLE_*), a "pominiete"
+// podaje liczbę niewysłanych próbek od poprzedniego pakietu - serwer może
+// odtworzyć pełny szereg, przenosząc wartości na pominięte próbki.
+// Heartbeat wysyła wszystkie pola jako nowe (pusta maska).
+
+// Progi zmian wymuszających wysyłkę (wartość bezwzględna różnicy)
+#define STREFA_TEMPERATURA      0.2f    // °C
+#define STREFA_WILGOTNOSC       1.0f    // %
+#define STREFA_CO2              25      // ppm
+#define STREFA_AMONIAK          2       // ppm
+#define STREFA_NASLONECZNIENIE  10      // lux
+
+// Maksymalny odstęp między pełnymi raportami (ms)
+#define STREFA_HEARTBEAT_MS     60000
+
+// Ocenia odczyt względem ostatnio wysłanego. Gdy zwraca true, pakiet ma
+// ustawione przeniesione/pominiete i wartości przeniesionych pól - należy
+// go wysłać. Gdy false, próbka jest liczona jako pominięta.
+bool strefaMartwaOcen(Pakiet_Danych* odczyt);
+
+// Zapomina ostatnio wysłany odczyt - następny zostanie wysłany w całości
+void strefaMartwaResetuj();
+
+// Liczniki od startu (do statusu węzła)
+void strefaMartwaStatystyki(uint32_t* wyslane, uint32_t* pominiete);
+
+#endif
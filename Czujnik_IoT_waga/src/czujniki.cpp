@@ -1,5 +1,6 @@
 #include <czujniki.h>
 #include "mesh_local.h" 
+#include "ramka_mesh.h"
 
 HX711 scale1;
 HX711 scale2;
@@ -94,6 +95,21 @@ void pakietToCSV(const Pakiet_Danych* pakiet, char* buffer, size_t bufferSize) {
         pakiet->waga,               // Waga (float)
         pakiet->data_i_czas.c_str()); // Data i czas (String)
 }
+
+size_t pakietToRamka(const Pakiet_Danych* pakiet, uint16_t sekwencja, uint32_t epoch, char* buffer, size_t bufferSize) {
+    RamkaKura ramka;
+    ramka.naglowek.id_wezla  = (uint32_t)pakiet->ID_urzadzenia;
+    ramka.naglowek.sekwencja = sekwencja;
+    ramka.naglowek.epoch     = epoch;
+    ramka.waga_c             = ramkaSetne(pakiet->waga);   // setne grama
+    ramka.uid_dlugosc        = ramkaUidZHex(pakiet->uid_rfid.c_str(), ramka.uid, RAMKA_MAX_UID);
+    if (ramka.uid_dlugosc == 0) return 0;
+
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujKura(&ramka, bin, sizeof(bin));
+    if (n == 0) return 0;
+    return ramkaDoTekstu(bin, n, buffer, bufferSize);
+}
 Pakiet_Danych odczytCzujniki() {
     Pakiet_Danych odczyt;
     odczyt.ID_urzadzenia   = mesh.getNodeId();
@@ -46,4 +46,6 @@ String pobierz_uid_rfid();
 void zakoncz_komunikacje_rfid();
 Pakiet_Danych odczytCzujniki(); 
 void pakietToCSV(const Pakiet_Danych* pakiet, char* buffer, size_t bufferSize);
+// Koduje pomiar jako binarną ramkę mesh "RAMK<base64>" (zob. CommonSource/src/ramka_mesh.h)
+size_t pakietToRamka(const Pakiet_Danych* pakiet, uint16_t sekwencja, uint32_t epoch, char* buffer, size_t bufferSize);
 #endif
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "mesh_local.h"
 #include "czujniki.h"
 #include "pamiec.h"
+#include "ramka_mesh.h"
 
 painlessMesh mesh;
 Scheduler userScheduler;
@@ -119,6 +120,18 @@ void wyslij_pomiar_rfid(String uid, float waga) {
     Serial.printf("    Waga: %.2f g\n", pomiar.waga);
     Serial.printf("    Data/Czas: %s\n", pomiar.data_i_czas.c_str());
     
+#if UZYJ_RAMKI_BINARNEJ
+    static uint16_t sekwencja = 0;
+    char ramka[RAMKA_MAX_TEKST];
+    if (pakietToRamka(&pomiar, sekwencja++, rtc.getLocalEpoch(), ramka, sizeof(ramka)) == 0) {
+        Serial.println(">>> BŁĄD: Nie udało się zakodować ramki (nieprawidłowy UID?)");
+        return;
+    }
+    
+    Serial.printf(">>> DEBUG Ramka: %s\n", ramka);
+    
+    mesh.sendSingle(root_id, ramka);
+#else
     char dane[150];
     pakietToCSV(&pomiar, dane, 150);
     
@@ -130,6 +143,7 @@ void wyslij_pomiar_rfid(String uid, float waga) {
     Serial.printf(">>> DEBUG Wiadomość: %s\n", msg.c_str());
     
     mesh.sendSingle(root_id, msg);
+#endif
     
     Serial.printf(">>> Wysłano pomiar RFID do ROOT (ID: %u)\n", root_id);
 }
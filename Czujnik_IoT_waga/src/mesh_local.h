@@ -8,6 +8,10 @@
 #define MESH_PASSWORD   "pbl_haslo123"
 #define MESH_PORT       5555
 
+// 1 = wysyłaj pomiary jako binarną ramkę "RAMK" (ramka_mesh.h), 0 = stary format CSV
+// Root akceptuje oba formaty w okresie migracji
+#define UZYJ_RAMKI_BINARNEJ 1
+
 extern painlessMesh mesh;
 extern Scheduler userScheduler;
 extern uint32_t root_id;
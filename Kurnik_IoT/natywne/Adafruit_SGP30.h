@@ -0,0 +1,10 @@
+/*
+ * ZASTĘPNIK Adafruit_SGP30.h - env:native (typ potrzebny nagłówkom czujników)
+ */
+
+#ifndef NATYWNE_ADAFRUIT_SGP30_H
+#define NATYWNE_ADAFRUIT_SGP30_H
+
+class Adafruit_SGP30 {};
+
+#endif
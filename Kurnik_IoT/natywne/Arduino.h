@@ -0,0 +1,127 @@
+/*
+ * ZASTĘPNIK Arduino.h - env:native
+ *
+ * Minimalny podzbiór rdzenia Arduino-ESP32 potrzebny modułom kompilowanym
+ * w testach hosta (build_src_filter env:native). Zegar jest sterowany przez
+ * test (natywne.h), Serial wypisuje na stdout.
+ */
+
+#ifndef NATYWNE_ARDUINO_H
+#define NATYWNE_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <string>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+typedef uint8_t byte;
+
+#define ARDUINO_RUNNING_CORE 1
+#define INPUT_PULLUP 0x05
+#define IRAM_ATTR
+
+inline void pinMode(uint8_t, uint8_t) {}
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+inline void yield() {}
+uint32_t getCpuFrequencyMhz();
+
+// glibc < 2.38 nie ma strlcpy (newlib na ESP32 ma)
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+size_t strlcpy(char* cel, const char* zrodlo, size_t rozmiar);
+#endif
+
+/*
+ * String - tylko metody używane przez moduły hosta
+ */
+class String {
+public:
+    String(const char* s = "") : s_(s ? s : "") {}
+    String(const std::string& s) : s_(s) {}
+    explicit String(int v) : s_(std::to_string(v)) {}
+    explicit String(unsigned int v) : s_(std::to_string(v)) {}
+    explicit String(long v) : s_(std::to_string(v)) {}
+    explicit String(unsigned long v) : s_(std::to_string(v)) {}
+
+    const char* c_str() const { return s_.c_str(); }
+    unsigned int length() const { return (unsigned int)s_.size(); }
+
+    String substring(unsigned int od) const { return substring(od, length()); }
+    String substring(unsigned int od, unsigned int doPozycji) const {
+        if (od > doPozycji) { unsigned int t = od; od = doPozycji; doPozycji = t; }
+        if (od >= s_.size()) return String();
+        if (doPozycji > s_.size()) doPozycji = (unsigned int)s_.size();
+        return String(s_.substr(od, doPozycji - od));
+    }
+    int indexOf(char c) const { size_t p = s_.find(c); return p == std::string::npos ? -1 : (int)p; }
+    int lastIndexOf(char c) const { size_t p = s_.rfind(c); return p == std::string::npos ? -1 : (int)p; }
+    bool startsWith(const String& p) const { return s_.compare(0, p.s_.size(), p.s_) == 0; }
+    bool endsWith(const String& p) const {
+        return s_.size() >= p.s_.size() && s_.compare(s_.size() - p.s_.size(), p.s_.size(), p.s_) == 0;
+    }
+    void toCharArray(char* buf, unsigned int rozmiar) const {
+        if (!buf || rozmiar == 0) return;
+        size_t n = s_.size() < rozmiar - 1 ? s_.size() : rozmiar - 1;
+        memcpy(buf, s_.data(), n);
+        buf[n] = '\0';
+    }
+
+    bool operator==(const String& o) const { return s_ == o.s_; }
+    bool operator==(const char* o) const { return s_ == (o ? o : ""); }
+    bool operator!=(const String& o) const { return s_ != o.s_; }
+    bool operator!=(const char* o) const { return !(*this == o); }
+    String& operator+=(const String& o) { s_ += o.s_; return *this; }
+    String& operator+=(const char* o) { s_ += (o ? o : ""); return *this; }
+    String& operator+=(char c) { s_ += c; return *this; }
+
+    friend String operator+(const String& a, const String& b) { return String(a.s_ + b.s_); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a ? a : "") + b.s_); }
+    friend String operator+(const String& a, const char* b) { return String(a.s_ + (b ? b : "")); }
+
+private:
+    std::string s_;
+};
+
+/*
+ * Serial - wypisuje na stdout
+ */
+class HardwareSerial {
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* buf, size_t n);
+    size_t print(const char* s);
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned int v) { return printf("%u", v); }
+    size_t print(long v) { return printf("%ld", v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t print(double v, int cyfry = 2) { return printf("%.*f", cyfry, v); }
+    size_t println() { return print("\n"); }
+    template <typename T> size_t println(const T& v) { size_t n = print(v); return n + println(); }
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+extern HardwareSerial Serial;
+
+/*
+ * ESP - licznik cykli liczony z zegara monotonicznego hosta (1 cykl = 1 ns
+ * przy getCpuFrequencyMhz() == 1000), żeby pomiary ns/op miały sens
+ */
+class EspClass {
+public:
+    uint32_t getCycleCount();
+    uint32_t getFreeHeap() { return 0; }
+};
+extern EspClass ESP;
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * ZASTĘPNIK AsyncMqttClient.h - env:native
+ *
+ * Klient zapisuje publikacje w modelu brokera (natywne.h). connect() nie
+ * łączy sam - test wywołuje NatywnyBrokerPolacz(), które tak jak prawdziwy
+ * klient woła callback onConnect. PUBACK dla QoS 1 wysyła dopiero
+ * NatywnyBrokerPotwierdz().
+ */
+
+#ifndef NATYWNE_ASYNCMQTTCLIENT_H
+#define NATYWNE_ASYNCMQTTCLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <functional>
+
+enum class AsyncMqttClientDisconnectReason : uint8_t {
+    TCP_DISCONNECTED = 0
+};
+
+struct AsyncMqttClientMessageProperties {
+    uint8_t qos;
+    bool dup;
+    bool retain;
+};
+
+class AsyncMqttClient {
+public:
+    typedef std::function<void(bool sessionPresent)> OnConnectUserCallback;
+    typedef std::function<void(AsyncMqttClientDisconnectReason reason)> OnDisconnectUserCallback;
+    typedef std::function<void(uint16_t packetId)> OnPublishUserCallback;
+    typedef std::function<void(char* topic, char* payload, AsyncMqttClientMessageProperties properties,
+                               size_t len, size_t index, size_t total)> OnMessageUserCallback;
+
+    AsyncMqttClient& setServer(IPAddress ip, uint16_t port) { (void)ip; (void)port; return *this; }
+    AsyncMqttClient& setCredentials(const char* uzytkownik, const char* haslo = nullptr) {
+        (void)uzytkownik; (void)haslo; return *this;
+    }
+    AsyncMqttClient& setClientId(const char* id) { (void)id; return *this; }
+
+    AsyncMqttClient& onConnect(OnConnectUserCallback cb) { naPolaczenie = cb; return *this; }
+    AsyncMqttClient& onDisconnect(OnDisconnectUserCallback cb) { naRozlaczenie = cb; return *this; }
+    AsyncMqttClient& onPublish(OnPublishUserCallback cb) { naPublikacje = cb; return *this; }
+    AsyncMqttClient& onMessage(OnMessageUserCallback cb) { naWiadomosc = cb; return *this; }
+
+    void connect() {}
+    void disconnect(bool wymus = false) { (void)wymus; }
+    bool connected() const { return polaczony; }
+
+    uint16_t subscribe(const char* topic, uint8_t qos) { (void)topic; (void)qos; return 1; }
+    uint16_t publish(const char* topic, uint8_t qos, bool retain,
+                     const char* payload = nullptr, size_t dlugosc = 0,
+                     bool dup = false, uint16_t idWiadomosci = 0);
+
+    // Stan modelu brokera - obsługiwany przez natywne.cpp
+    bool polaczony = false;
+    OnConnectUserCallback naPolaczenie;
+    OnDisconnectUserCallback naRozlaczenie;
+    OnPublishUserCallback naPublikacje;
+    OnMessageUserCallback naWiadomosc;
+};
+
+#endif
@@ -0,0 +1,8 @@
+/*
+ * ZASTĘPNIK EEPROM.h - env:native (dołączany przez main.h, nieużywany)
+ */
+
+#ifndef NATYWNE_EEPROM_H
+#define NATYWNE_EEPROM_H
+
+#endif
@@ -0,0 +1,26 @@
+/*
+ * ZASTĘPNIK ESP32Time.h - env:native
+ *
+ * Czas = epoch ustawiony przez setTime() + upływ zegara millis() (UTC).
+ */
+
+#ifndef NATYWNE_ESP32TIME_H
+#define NATYWNE_ESP32TIME_H
+
+#include <Arduino.h>
+
+class ESP32Time {
+public:
+    explicit ESP32Time(unsigned long przesuniecie = 0) : przesuniecie_(przesuniecie) {}
+    void setTime(unsigned long epoch);
+    unsigned long getEpoch();
+    unsigned long getLocalEpoch() { return getEpoch() + przesuniecie_; }
+    struct tm getTimeStruct();
+    String getTimeDate(bool pelny = false);
+private:
+    unsigned long przesuniecie_;
+    unsigned long epoch_ = 0;
+    uint32_t ustawionoMs_ = 0;
+};
+
+#endif
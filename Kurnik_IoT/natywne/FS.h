@@ -0,0 +1,77 @@
+/*
+ * ZASTĘPNIK FS.h - env:native
+ *
+ * System plików w pamięci (mapa ścieżka -> zawartość). Zachowuje się jak FAT
+ * na karcie w tym, na czym polegają moduły SD: plik/katalog tworzony tylko
+ * w istniejącym katalogu, rename nie nadpisuje, rmdir tylko pustego katalogu.
+ */
+
+#ifndef NATYWNE_FS_H
+#define NATYWNE_FS_H
+
+#include <Arduino.h>
+#include <memory>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+struct StanPliku;
+
+class File {
+public:
+    File() {}
+    explicit File(std::shared_ptr<StanPliku> stan) : stan_(stan) {}
+
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t n);
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t println(const char* s) { return print(s) + print("\n"); }
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    int available();
+    int read();
+    size_t read(uint8_t* buf, size_t n);
+    int peek();
+    bool seek(uint32_t pozycja);
+    size_t position() const;
+    size_t size() const;
+    void flush() {}
+    void close() { stan_.reset(); }
+    const char* name() const;
+    const char* path() const;
+    bool isDirectory() const;
+    File openNextFile(const char* tryb = FILE_READ);
+    void rewindDirectory();
+    operator bool() const { return stan_ != nullptr; }
+
+private:
+    std::shared_ptr<StanPliku> stan_;
+};
+
+class FS {
+public:
+    File open(const char* sciezka, const char* tryb = FILE_READ, bool utworz = false);
+    File open(const String& sciezka, const char* tryb = FILE_READ, bool utworz = false) {
+        return open(sciezka.c_str(), tryb, utworz);
+    }
+    bool exists(const char* sciezka);
+    bool exists(const String& sciezka) { return exists(sciezka.c_str()); }
+    bool remove(const char* sciezka);
+    bool remove(const String& sciezka) { return remove(sciezka.c_str()); }
+    bool rename(const char* z, const char* na);
+    bool rename(const String& z, const String& na) { return rename(z.c_str(), na.c_str()); }
+    bool mkdir(const char* sciezka);
+    bool mkdir(const String& sciezka) { return mkdir(sciezka.c_str()); }
+    bool rmdir(const char* sciezka);
+    bool rmdir(const String& sciezka) { return rmdir(sciezka.c_str()); }
+};
+
+}  // namespace fs
+
+using fs::FS;
+using fs::File;
+
+#endif
@@ -0,0 +1,24 @@
+/*
+ * ZASTĘPNIK NimBLEDevice.h - env:native
+ *
+ * Stały adres BLE - topic MQTT w testach to kurnik/000000000000.
+ */
+
+#ifndef NATYWNE_NIMBLEDEVICE_H
+#define NATYWNE_NIMBLEDEVICE_H
+
+#include <string>
+
+class NimBLEAddress {
+public:
+    std::string toString() const { return "00:00:00:00:00:00"; }
+};
+
+class NimBLEDevice {
+public:
+    static NimBLEAddress getAddress() { return NimBLEAddress(); }
+};
+
+#define BLEDevice NimBLEDevice
+
+#endif
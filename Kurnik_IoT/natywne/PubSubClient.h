@@ -0,0 +1,8 @@
+/*
+ * ZASTĘPNIK PubSubClient.h - env:native (dołączany przez main.h, nieużywany)
+ */
+
+#ifndef NATYWNE_PUBSUBCLIENT_H
+#define NATYWNE_PUBSUBCLIENT_H
+
+#endif
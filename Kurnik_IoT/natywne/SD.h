@@ -0,0 +1,34 @@
+/*
+ * ZASTĘPNIK SD.h - env:native
+ *
+ * Karta w pamięci (FS.h); awarię karty włącza NatywnaKartaUstawAwarie().
+ */
+
+#ifndef NATYWNE_SD_H
+#define NATYWNE_SD_H
+
+#include "FS.h"
+#include "SPI.h"
+
+typedef enum {
+    CARD_NONE,
+    CARD_MMC,
+    CARD_SD,
+    CARD_SDHC,
+    CARD_UNKNOWN
+} sdcard_type_t;
+
+class SDFS : public fs::FS {
+public:
+    bool begin(uint8_t ss, SPIClass& spi, uint32_t czestotliwosc = 4000000,
+               const char* punktMontowania = "/sd", uint8_t maxPlikow = 5, bool formatuj = false);
+    void end() {}
+    sdcard_type_t cardType();
+    uint64_t cardSize();
+    uint64_t totalBytes();
+    uint64_t usedBytes();
+};
+
+extern SDFS SD;
+
+#endif
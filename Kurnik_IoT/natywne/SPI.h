@@ -0,0 +1,22 @@
+/*
+ * ZASTĘPNIK SPI.h - env:native
+ */
+
+#ifndef NATYWNE_SPI_H
+#define NATYWNE_SPI_H
+
+#include <stdint.h>
+
+#define HSPI 2
+#define VSPI 3
+
+class SPIClass {
+public:
+    explicit SPIClass(uint8_t magistrala = HSPI) { (void)magistrala; }
+    void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {
+        (void)sck; (void)miso; (void)mosi; (void)ss;
+    }
+    void end() {}
+};
+
+#endif
@@ -0,0 +1,34 @@
+/*
+ * ZASTĘPNIK WiFi.h - env:native
+ */
+
+#ifndef NATYWNE_WIFI_H
+#define NATYWNE_WIFI_H
+
+#include <Arduino.h>
+
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+class IPAddress {
+public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : adres_{a, b, c, d} {}
+    bool fromString(const char* tekst) {
+        unsigned int a, b, c, d;
+        if (!tekst || sscanf(tekst, "%u.%u.%u.%u", &a, &b, &c, &d) != 4) return false;
+        adres_[0] = (uint8_t)a; adres_[1] = (uint8_t)b; adres_[2] = (uint8_t)c; adres_[3] = (uint8_t)d;
+        return true;
+    }
+    uint8_t operator[](int i) const { return adres_[i]; }
+private:
+    uint8_t adres_[4] = {0, 0, 0, 0};
+};
+
+class WiFiClass {
+public:
+    int status() { return WL_CONNECTED; }
+};
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,10 @@
+/*
+ * ZASTĘPNIK WiFiClient.h - env:native
+ */
+
+#ifndef NATYWNE_WIFICLIENT_H
+#define NATYWNE_WIFICLIENT_H
+
+class WiFiClient {};
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * arduino.cpp (env:native)
+ *
+ * Zegar sterowany przez test, Serial na stdout, licznik cykli z zegara
+ * monotonicznego hosta i czas rtc.
+ */
+
+#include <Arduino.h>
+#include <ESP32Time.h>
+#include <WiFi.h>
+#include <stdarg.h>
+#include <chrono>
+#include "natywne.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+WiFiClass WiFi;
+
+static uint64_t zegarUs = 0;
+
+void NatywnyZegarPrzesun(uint32_t ms) {
+    zegarUs += (uint64_t)ms * 1000;
+}
+
+uint32_t millis() { return (uint32_t)(zegarUs / 1000); }
+uint32_t micros() { return (uint32_t)zegarUs; }
+void delay(uint32_t ms) { NatywnyZegarPrzesun(ms); }
+void vTaskDelay(TickType_t ticks) { NatywnyZegarPrzesun(ticks * portTICK_PERIOD_MS); }
+uint32_t getCpuFrequencyMhz() { return 1000; }
+
+uint32_t EspClass::getCycleCount() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+size_t strlcpy(char* cel, const char* zrodlo, size_t rozmiar) {
+    size_t dlugosc = strlen(zrodlo);
+    if (rozmiar > 0) {
+        size_t n = dlugosc < rozmiar - 1 ? dlugosc : rozmiar - 1;
+        memcpy(cel, zrodlo, n);
+        cel[n] = '\0';
+    }
+    return dlugosc;
+}
+#endif
+
+// === Serial ===
+
+size_t HardwareSerial::write(uint8_t c) {
+    return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t n) {
+    return fwrite(buf, 1, n, stdout);
+}
+
+size_t HardwareSerial::print(const char* s) {
+    return write((const uint8_t*)s, strlen(s));
+}
+
+size_t HardwareSerial::printf(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vprintf(fmt, args);
+    va_end(args);
+    return n < 0 ? 0 : (size_t)n;
+}
+
+// === rtc ===
+
+void ESP32Time::setTime(unsigned long epoch) {
+    epoch_ = epoch;
+    ustawionoMs_ = millis();
+}
+
+unsigned long ESP32Time::getEpoch() {
+    return epoch_ + (millis() - ustawionoMs_) / 1000;
+}
+
+struct tm ESP32Time::getTimeStruct() {
+    time_t t = (time_t)getLocalEpoch();
+    struct tm czas;
+    gmtime_r(&t, &czas);
+    return czas;
+}
+
+String ESP32Time::getTimeDate(bool pelny) {
+    struct tm czas = getTimeStruct();
+    char bufor[64];
+    strftime(bufor, sizeof(bufor), pelny ? "%H:%M:%S %A, %B %d %Y" : "%H:%M:%S %a, %b %d %Y", &czas);
+    return String(bufor);
+}
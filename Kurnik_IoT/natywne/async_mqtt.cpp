@@ -0,0 +1,88 @@
+/*
+ * async_mqtt.cpp (env:native)
+ *
+ * Model brokera MQTT za zastępnikiem AsyncMqttClient: lista przyjętych
+ * publikacji, utrata wiadomości i ręcznie wyzwalane PUBACK.
+ */
+
+#include <AsyncMqttClient.h>
+#include <vector>
+#include "natywne.h"
+#include "mqtt.h"
+
+static std::vector<NatywnaPublikacja> publikacje;
+static uint16_t ostatniPacketId = 0;
+static bool utrata = false;
+
+uint16_t AsyncMqttClient::publish(const char* topic, uint8_t qos, bool retain,
+                                  const char* payload, size_t dlugosc, bool dup, uint16_t idWiadomosci) {
+    (void)retain; (void)dup; (void)idWiadomosci;
+    if (!polaczony) return 0;
+
+    NatywnaPublikacja p;
+    // QoS 0 ma w AsyncMqttClient packetId 1; QoS 1 dostaje kolejny niezerowy
+    p.packetId = 1;
+    if (qos > 0) {
+        if (++ostatniPacketId == 0) ostatniPacketId = 1;
+        p.packetId = ostatniPacketId;
+    }
+    p.qos = qos;
+    p.utracona = utrata;
+    p.potwierdzona = false;
+    p.topic = topic ? topic : "";
+    if (payload != nullptr) p.tresc.assign(payload, dlugosc > 0 ? dlugosc : strlen(payload));
+    publikacje.push_back(p);
+    return p.packetId;
+}
+
+void NatywnyBrokerPolacz() {
+    asyncMqttClient.polaczony = true;
+    if (asyncMqttClient.naPolaczenie) asyncMqttClient.naPolaczenie(false);
+}
+
+void NatywnyBrokerRozlacz() {
+    asyncMqttClient.polaczony = false;
+    if (asyncMqttClient.naRozlaczenie) {
+        asyncMqttClient.naRozlaczenie(AsyncMqttClientDisconnectReason::TCP_DISCONNECTED);
+    }
+}
+
+void NatywnyBrokerUstawUtrate(bool stan) {
+    utrata = stan;
+}
+
+uint32_t NatywnyBrokerPotwierdz() {
+    uint32_t n = 0;
+    // Indeksy, nie iteratory - callback może publikować (np. kolejną paczkę zaległych)
+    for (size_t i = 0; i < publikacje.size(); i++) {
+        if (publikacje[i].qos == 0 || publikacje[i].utracona || publikacje[i].potwierdzona) continue;
+        publikacje[i].potwierdzona = true;
+        n++;
+        if (asyncMqttClient.naPublikacje) asyncMqttClient.naPublikacje(publikacje[i].packetId);
+    }
+    return n;
+}
+
+uint32_t NatywnyBrokerOtrzymal(const char* fragmentTopicu, const char* fragmentTresci) {
+    uint32_t n = 0;
+    for (const NatywnaPublikacja& p : publikacje) {
+        if (p.utracona) continue;
+        if (fragmentTopicu && p.topic.find(fragmentTopicu) == std::string::npos) continue;
+        if (fragmentTresci && p.tresc.find(fragmentTresci) == std::string::npos) continue;
+        n++;
+    }
+    return n;
+}
+
+size_t NatywnyBrokerLiczbaPublikacji() {
+    return publikacje.size();
+}
+
+const NatywnaPublikacja* NatywnyBrokerPublikacja(size_t indeks) {
+    return indeks < publikacje.size() ? &publikacje[indeks] : nullptr;
+}
+
+void NatywnyBrokerWyczysc() {
+    publikacje.clear();
+    utrata = false;
+}
@@ -0,0 +1,64 @@
+/*
+ * freertos.cpp (env:native)
+ *
+ * Kolejki FIFO bez blokowania; zadania nie są uruchamiane.
+ */
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <deque>
+#include <vector>
+#include <string.h>
+
+struct NatywnaKolejka {
+    UBaseType_t dlugosc;
+    UBaseType_t rozmiarElementu;
+    std::deque<std::vector<uint8_t>> elementy;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t dlugosc, UBaseType_t rozmiarElementu) {
+    NatywnaKolejka* k = new NatywnaKolejka();
+    k->dlugosc = dlugosc;
+    k->rozmiarElementu = rozmiarElementu;
+    return k;
+}
+
+BaseType_t xQueueSend(QueueHandle_t kolejka, const void* element, TickType_t) {
+    if (kolejka == nullptr || kolejka->elementy.size() >= kolejka->dlugosc) return pdFALSE;
+    const uint8_t* bajty = (const uint8_t*)element;
+    kolejka->elementy.emplace_back(bajty, bajty + kolejka->rozmiarElementu);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t kolejka, void* bufor, TickType_t) {
+    if (kolejka == nullptr || kolejka->elementy.empty()) return pdFALSE;
+    memcpy(bufor, kolejka->elementy.front().data(), kolejka->rozmiarElementu);
+    kolejka->elementy.pop_front();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t kolejka) {
+    if (kolejka != nullptr) kolejka->elementy.clear();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t kolejka) {
+    return kolejka == nullptr ? 0 : (UBaseType_t)kolejka->elementy.size();
+}
+
+void vQueueDelete(QueueHandle_t kolejka) {
+    delete kolejka;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return xQueueCreate(1, 0);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t, void*, UBaseType_t,
+                                   TaskHandle_t* uchwyt, BaseType_t) {
+    static int zadanie;
+    if (uchwyt != nullptr) *uchwyt = &zadanie;
+    return pdPASS;
+}
@@ -0,0 +1,26 @@
+/*
+ * ZASTĘPNIK freertos/FreeRTOS.h - env:native
+ *
+ * Typy i makra FreeRTOS używane przez moduły hosta. Testy są
+ * jednowątkowe: kolejki nie blokują, mutexy zawsze się udają.
+ */
+
+#ifndef NATYWNE_FREERTOS_H
+#define NATYWNE_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+#endif
@@ -0,0 +1,24 @@
+/*
+ * ZASTĘPNIK freertos/queue.h - env:native
+ *
+ * Kolejka FIFO o stałym rozmiarze elementu; nie blokuje (czas oczekiwania
+ * jest ignorowany).
+ */
+
+#ifndef NATYWNE_FREERTOS_QUEUE_H
+#define NATYWNE_FREERTOS_QUEUE_H
+
+#include "FreeRTOS.h"
+
+typedef struct NatywnaKolejka* QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t dlugosc, UBaseType_t rozmiarElementu);
+BaseType_t xQueueSend(QueueHandle_t kolejka, const void* element, TickType_t czekaj);
+BaseType_t xQueueReceive(QueueHandle_t kolejka, void* bufor, TickType_t czekaj);
+BaseType_t xQueueReset(QueueHandle_t kolejka);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t kolejka);
+void vQueueDelete(QueueHandle_t kolejka);
+
+#define xQueueSendToBack xQueueSend
+
+#endif
@@ -0,0 +1,23 @@
+/*
+ * ZASTĘPNIK freertos/ringbuf.h - env:native
+ *
+ * Bufor pierścieniowy nie jest tworzony (xRingbufferCreate zwraca nullptr),
+ * więc dziennik pisze wprost na Serial.
+ */
+
+#ifndef NATYWNE_FREERTOS_RINGBUF_H
+#define NATYWNE_FREERTOS_RINGBUF_H
+
+#include "FreeRTOS.h"
+
+typedef void* RingbufHandle_t;
+typedef enum { RINGBUF_TYPE_NOSPLIT = 0, RINGBUF_TYPE_ALLOWSPLIT, RINGBUF_TYPE_BYTEBUF } RingbufferType_t;
+
+inline RingbufHandle_t xRingbufferCreate(size_t, RingbufferType_t) { return nullptr; }
+inline BaseType_t xRingbufferSend(RingbufHandle_t, const void*, size_t, TickType_t) { return pdFALSE; }
+inline void* xRingbufferReceive(RingbufHandle_t, size_t* rozmiar, TickType_t) { if (rozmiar) *rozmiar = 0; return nullptr; }
+inline void vRingbufferReturnItem(RingbufHandle_t, void*) {}
+inline size_t xRingbufferGetCurFreeSize(RingbufHandle_t) { return 0; }
+inline void vRingbufferDelete(RingbufHandle_t) {}
+
+#endif
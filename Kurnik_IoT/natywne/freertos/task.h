@@ -0,0 +1,23 @@
+/*
+ * ZASTĘPNIK freertos/task.h - env:native
+ *
+ * Zadania nie są uruchamiane - test woła ich kroki bezpośrednio
+ * (np. UplinkKrok()).
+ */
+
+#ifndef NATYWNE_FREERTOS_TASK_H
+#define NATYWNE_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t funkcja, const char* nazwa, uint32_t stos,
+                                   void* parametr, UBaseType_t priorytet,
+                                   TaskHandle_t* uchwyt, BaseType_t rdzen);
+inline void vTaskSuspend(TaskHandle_t) {}
+inline void vTaskDelete(TaskHandle_t) {}
+void vTaskDelay(TickType_t ticks);
+
+#endif
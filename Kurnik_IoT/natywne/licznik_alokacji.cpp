@@ -0,0 +1,104 @@
+/*
+ * licznik_alokacji.cpp (env:native)
+ *
+ * Pomiar alokacji benchmarku na hoście. Firmware opakowuje funkcje sterty
+ * przez --wrap; tu w glibc podmieniane są malloc/calloc/realloc/free
+ * (wywołują __libc_*), więc liczone są także alokacje z bibliotek
+ * (operator new, strptime, stdio). Poza glibc podmieniany jest tylko
+ * operator new/delete. Host ma jeden wątek - mierzy się cały proces;
+ * przypisanie do podsystemów nie jest liczone.
+ */
+
+#include "main.h"
+#include "licznik_alokacji.h"
+#include <new>
+
+static bool mierzone = false;
+static LicznikAlokacji licznik;
+
+static inline void zliczAlokacje(size_t rozmiar) {
+    if (!mierzone) return;
+    licznik.alokacje++;
+    licznik.bajty += (uint32_t)rozmiar;
+}
+
+static inline void zliczZwolnienie(void* wskaznik) {
+    if (mierzone && wskaznik != nullptr) licznik.zwolnienia++;
+}
+
+#if defined(__GLIBC__)
+
+extern "C" {
+void* __libc_malloc(size_t rozmiar);
+void* __libc_calloc(size_t liczba, size_t rozmiar);
+void* __libc_realloc(void* wskaznik, size_t rozmiar);
+void __libc_free(void* wskaznik);
+
+void* malloc(size_t rozmiar) {
+    zliczAlokacje(rozmiar);
+    return __libc_malloc(rozmiar);
+}
+
+void* calloc(size_t liczba, size_t rozmiar) {
+    zliczAlokacje(liczba * rozmiar);
+    return __libc_calloc(liczba, rozmiar);
+}
+
+void* realloc(void* wskaznik, size_t rozmiar) {
+    zliczAlokacje(rozmiar);
+    return __libc_realloc(wskaznik, rozmiar);
+}
+
+void free(void* wskaznik) {
+    zliczZwolnienie(wskaznik);
+    __libc_free(wskaznik);
+}
+}
+
+#else
+
+void* operator new(size_t rozmiar) {
+    zliczAlokacje(rozmiar);
+    void* wskaznik = malloc(rozmiar ? rozmiar : 1);
+    if (wskaznik == nullptr) throw std::bad_alloc();
+    return wskaznik;
+}
+
+void* operator new[](size_t rozmiar) {
+    return operator new(rozmiar);
+}
+
+void operator delete(void* wskaznik) noexcept {
+    zliczZwolnienie(wskaznik);
+    free(wskaznik);
+}
+
+void operator delete[](void* wskaznik) noexcept {
+    operator delete(wskaznik);
+}
+
+void operator delete(void* wskaznik, size_t) noexcept {
+    operator delete(wskaznik);
+}
+
+void operator delete[](void* wskaznik, size_t) noexcept {
+    operator delete(wskaznik);
+}
+
+#endif
+
+void LicznikAlokacjiStart() {
+    licznik.alokacje = 0;
+    licznik.zwolnienia = 0;
+    licznik.bajty = 0;
+    mierzone = true;
+}
+
+void LicznikAlokacjiStop(LicznikAlokacji* wynik) {
+    mierzone = false;
+    *wynik = licznik;
+}
+
+// Podsystemy nie są rozróżniane na hoście
+ZakresPodsystemu::ZakresPodsystemu(PodsystemPamieci podsystem) : poprzedni((uint8_t)podsystem), wpis(-1) {}
+ZakresPodsystemu::~ZakresPodsystemu() {}
@@ -0,0 +1,75 @@
+/*
+ * STEROWANIE ZASTĘPNIKAMI - natywne.h (env:native)
+ *
+ * Funkcje, którymi testy hosta sterują zastępnikami platformy: zegarem
+ * millis()/micros(), kartą SD w pamięci i modelem brokera MQTT
+ * (AsyncMqttClient.h). Firmware ich nie używa.
+ */
+
+#ifndef NATYWNE_H
+#define NATYWNE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+// === ZEGAR ===
+
+/* Przesuwa zegar millis()/micros() (oraz czas rtc) o podaną liczbę ms */
+void NatywnyZegarPrzesun(uint32_t ms);
+
+// === KARTA SD ===
+
+/* Czyści kartę (pusty katalog główny) i wyłącza awarię */
+void NatywnaKartaWyczysc();
+
+/* Włącza/wyłącza awarię karty: begin/open/mkdir/write zawodzą */
+void NatywnaKartaUstawAwarie(bool awaria);
+
+/* return: rozmiar pliku w bajtach, 0 gdy plik nie istnieje */
+size_t NatywnaKartaRozmiarPliku(const char* sciezka);
+
+/* return: liczba plików (bez podkatalogów) bezpośrednio w katalogu */
+size_t NatywnaKartaLiczbaPlikow(const char* katalog);
+
+// === BROKER MQTT ===
+
+// Publikacja przyjęta przez klienta
+typedef struct {
+    uint16_t    packetId;
+    uint8_t     qos;
+    bool        utracona;      // Nie dotarła do brokera (NatywnyBrokerUstawUtrate)
+    bool        potwierdzona;  // Broker wysłał PUBACK
+    std::string topic;
+    std::string tresc;
+} NatywnaPublikacja;
+
+/* Nawiązuje połączenie i woła callback onConnect klienta */
+void NatywnyBrokerPolacz();
+
+/* Zrywa połączenie i woła callback onDisconnect klienta */
+void NatywnyBrokerRozlacz();
+
+/* Gdy włączona, publish() zwraca packetId, ale wiadomość ginie (brak PUBACK) */
+void NatywnyBrokerUstawUtrate(bool utrata);
+
+/*
+ * Wysyła PUBACK (callback onPublish) dla każdej doręczonej, jeszcze
+ * niepotwierdzonej publikacji QoS 1.
+ * return: liczba wysłanych potwierdzeń
+ */
+uint32_t NatywnyBrokerPotwierdz();
+
+/* return: liczba publikacji doręczonych brokerowi, których topic i treść zawierają podane fragmenty */
+uint32_t NatywnyBrokerOtrzymal(const char* fragmentTopicu, const char* fragmentTresci);
+
+/* return: liczba wszystkich publikacji przyjętych przez klienta */
+size_t NatywnyBrokerLiczbaPublikacji();
+
+/* return: publikacja o podanym indeksie lub nullptr */
+const NatywnaPublikacja* NatywnyBrokerPublikacja(size_t indeks);
+
+/* Czyści listę publikacji i wyłącza utratę (stan połączenia bez zmian) */
+void NatywnyBrokerWyczysc();
+
+#endif
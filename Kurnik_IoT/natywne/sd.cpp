@@ -0,0 +1,260 @@
+/*
+ * sd.cpp (env:native)
+ *
+ * Karta SD w pamięci: mapa znormalizowana ścieżka -> wpis (plik lub katalog).
+ * Otwarty plik trzyma wskaźnik na wpis, więc usunięcie go z mapy nie psuje
+ * otwartych uchwytów (jak zwolnienie klastrów dopiero po zamknięciu).
+ */
+
+#include <FS.h>
+#include <SD.h>
+#include <stdarg.h>
+#include <map>
+#include <vector>
+#include "natywne.h"
+
+SDFS SD;
+
+namespace {
+
+struct Wpis {
+    bool katalog;
+    std::vector<uint8_t> dane;
+};
+
+std::map<std::string, std::shared_ptr<Wpis>>& wpisy() {
+    static std::map<std::string, std::shared_ptr<Wpis>> mapa = {
+        { "/", std::make_shared<Wpis>(Wpis{ true, {} }) }
+    };
+    return mapa;
+}
+
+bool awaria = false;
+
+std::string normalizuj(const char* sciezka) {
+    std::string s = sciezka ? sciezka : "";
+    if (s.empty() || s[0] != '/') s = "/" + s;
+    while (s.size() > 1 && s.back() == '/') s.pop_back();
+    return s;
+}
+
+std::string rodzic(const std::string& s) {
+    size_t p = s.rfind('/');
+    return p == 0 ? "/" : s.substr(0, p);
+}
+
+std::shared_ptr<Wpis> znajdz(const std::string& s) {
+    auto it = wpisy().find(s);
+    return it == wpisy().end() ? nullptr : it->second;
+}
+
+bool katalogIstnieje(const std::string& s) {
+    auto w = znajdz(s);
+    return w && w->katalog;
+}
+
+// Bezpośrednie dzieci katalogu w kolejności nazw
+std::vector<std::string> dzieci(const std::string& katalog) {
+    std::vector<std::string> wynik;
+    std::string prefiks = katalog == "/" ? "/" : katalog + "/";
+    for (auto it = wpisy().lower_bound(prefiks); it != wpisy().end(); ++it) {
+        if (it->first.compare(0, prefiks.size(), prefiks) != 0) break;
+        if (it->first.size() > prefiks.size() && it->first.find('/', prefiks.size()) == std::string::npos) {
+            wynik.push_back(it->first);
+        }
+    }
+    return wynik;
+}
+
+}  // namespace
+
+namespace fs {
+
+struct StanPliku {
+    std::string sciezka;
+    std::string nazwa;
+    std::shared_ptr<Wpis> wpis;
+    size_t pozycja;
+    bool zapis;
+    size_t nastepneDziecko;
+};
+
+static File otworz(const std::string& s, std::shared_ptr<Wpis> wpis, bool zapis, size_t pozycja) {
+    auto stan = std::make_shared<StanPliku>();
+    stan->sciezka = s;
+    stan->nazwa = s == "/" ? "/" : s.substr(s.rfind('/') + 1);
+    stan->wpis = wpis;
+    stan->pozycja = pozycja;
+    stan->zapis = zapis;
+    stan->nastepneDziecko = 0;
+    return File(stan);
+}
+
+size_t File::write(const uint8_t* buf, size_t n) {
+    if (!stan_ || !stan_->zapis || stan_->wpis->katalog || awaria) return 0;
+    std::vector<uint8_t>& dane = stan_->wpis->dane;
+    if (stan_->pozycja + n > dane.size()) dane.resize(stan_->pozycja + n);
+    memcpy(dane.data() + stan_->pozycja, buf, n);
+    stan_->pozycja += n;
+    return n;
+}
+
+size_t File::printf(const char* fmt, ...) {
+    char bufor[512];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(bufor, sizeof(bufor), fmt, args);
+    va_end(args);
+    if (n < 0) return 0;
+    return write((const uint8_t*)bufor, (size_t)n < sizeof(bufor) ? (size_t)n : sizeof(bufor) - 1);
+}
+
+int File::available() {
+    if (!stan_ || stan_->wpis->katalog) return 0;
+    return (int)(stan_->wpis->dane.size() - stan_->pozycja);
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+size_t File::read(uint8_t* buf, size_t n) {
+    if (!stan_ || stan_->wpis->katalog) return 0;
+    const std::vector<uint8_t>& dane = stan_->wpis->dane;
+    size_t dostepne = dane.size() > stan_->pozycja ? dane.size() - stan_->pozycja : 0;
+    if (n > dostepne) n = dostepne;
+    memcpy(buf, dane.data() + stan_->pozycja, n);
+    stan_->pozycja += n;
+    return n;
+}
+
+int File::peek() {
+    if (available() <= 0) return -1;
+    return stan_->wpis->dane[stan_->pozycja];
+}
+
+bool File::seek(uint32_t pozycja) {
+    if (!stan_ || pozycja > stan_->wpis->dane.size()) return false;
+    stan_->pozycja = pozycja;
+    return true;
+}
+
+size_t File::position() const { return stan_ ? stan_->pozycja : 0; }
+size_t File::size() const { return stan_ ? stan_->wpis->dane.size() : 0; }
+const char* File::name() const { return stan_ ? stan_->nazwa.c_str() : ""; }
+const char* File::path() const { return stan_ ? stan_->sciezka.c_str() : ""; }
+bool File::isDirectory() const { return stan_ && stan_->wpis->katalog; }
+
+File File::openNextFile(const char* tryb) {
+    if (!isDirectory()) return File();
+    std::vector<std::string> lista = dzieci(stan_->sciezka);
+    if (stan_->nastepneDziecko >= lista.size()) return File();
+    const std::string& s = lista[stan_->nastepneDziecko++];
+    return otworz(s, znajdz(s), strcmp(tryb, FILE_READ) != 0, 0);
+}
+
+void File::rewindDirectory() {
+    if (stan_) stan_->nastepneDziecko = 0;
+}
+
+File FS::open(const char* sciezka, const char* tryb, bool) {
+    if (awaria) return File();
+    std::string s = normalizuj(sciezka);
+    auto wpis = znajdz(s);
+
+    if (strcmp(tryb, FILE_READ) == 0) {
+        return wpis ? otworz(s, wpis, false, 0) : File();
+    }
+    if (wpis && wpis->katalog) return File();
+    if (!wpis) {
+        if (!katalogIstnieje(rodzic(s))) return File();
+        wpis = std::make_shared<Wpis>(Wpis{ false, {} });
+        wpisy()[s] = wpis;
+    }
+    if (strcmp(tryb, FILE_WRITE) == 0) wpis->dane.clear();
+    return otworz(s, wpis, true, wpis->dane.size());
+}
+
+bool FS::exists(const char* sciezka) {
+    return !awaria && znajdz(normalizuj(sciezka)) != nullptr;
+}
+
+bool FS::remove(const char* sciezka) {
+    std::string s = normalizuj(sciezka);
+    auto wpis = znajdz(s);
+    if (awaria || !wpis || wpis->katalog) return false;
+    wpisy().erase(s);
+    return true;
+}
+
+bool FS::rename(const char* z, const char* na) {
+    std::string zrodlo = normalizuj(z), cel = normalizuj(na);
+    auto wpis = znajdz(zrodlo);
+    if (awaria || !wpis || znajdz(cel) || !katalogIstnieje(rodzic(cel))) return false;
+    if (wpis->katalog && !dzieci(zrodlo).empty()) return false;
+    wpisy().erase(zrodlo);
+    wpisy()[cel] = wpis;
+    return true;
+}
+
+bool FS::mkdir(const char* sciezka) {
+    std::string s = normalizuj(sciezka);
+    if (awaria || znajdz(s) || !katalogIstnieje(rodzic(s))) return false;
+    wpisy()[s] = std::make_shared<Wpis>(Wpis{ true, {} });
+    return true;
+}
+
+bool FS::rmdir(const char* sciezka) {
+    std::string s = normalizuj(sciezka);
+    if (awaria || s == "/" || !katalogIstnieje(s) || !dzieci(s).empty()) return false;
+    wpisy().erase(s);
+    return true;
+}
+
+}  // namespace fs
+
+bool SDFS::begin(uint8_t, SPIClass&, uint32_t, const char*, uint8_t, bool) {
+    return !awaria;
+}
+
+sdcard_type_t SDFS::cardType() {
+    return awaria ? CARD_NONE : CARD_SDHC;
+}
+
+uint64_t SDFS::cardSize() {
+    return 1ULL << 30;
+}
+
+uint64_t SDFS::totalBytes() {
+    return cardSize();
+}
+
+uint64_t SDFS::usedBytes() {
+    uint64_t suma = 0;
+    for (auto& e : wpisy()) suma += e.second->dane.size();
+    return suma;
+}
+
+void NatywnaKartaWyczysc() {
+    wpisy().clear();
+    wpisy()["/"] = std::make_shared<Wpis>(Wpis{ true, {} });
+    awaria = false;
+}
+
+void NatywnaKartaUstawAwarie(bool stan) {
+    awaria = stan;
+}
+
+size_t NatywnaKartaRozmiarPliku(const char* sciezka) {
+    auto wpis = znajdz(normalizuj(sciezka));
+    return wpis && !wpis->katalog ? wpis->dane.size() : 0;
+}
+
+size_t NatywnaKartaLiczbaPlikow(const char* katalog) {
+    size_t n = 0;
+    for (const std::string& s : dzieci(normalizuj(katalog))) {
+        if (!znajdz(s)->katalog) n++;
+    }
+    return n;
+}
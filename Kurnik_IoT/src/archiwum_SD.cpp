@@ -0,0 +1,334 @@
+/*
+ * archiwum_SD.cpp
+ *
+ * Segmenty archiwum numerowane są rosnąco i nie mają luk - retencja usuwa
+ * zawsze najstarszy, a rotacja dodaje kolejny. Manifest jest przepisywany
+ * tylko przy rotacji i retencji (rzadko), nie przy każdym rekordzie.
+ *
+ * Rekordy są kodowane w blokach kodeka (kodek_archiwum.h) - jeden otwarty blok
+ * na urządzenie. Blok trafia do rejestratora dopiero po zapełnieniu, po
+ * ARCHIWUM_MAX_WIEK_BLOKU_MS lub przed rotacją segmentu. Segmenty sprzed
+ * kodeka (.txt) są zachowywane i usuwane przez retencję jak pozostałe.
+ */
+
+#include "archiwum_SD.h"
+#include "rejestrator_SD.h"
+#include "kodek_archiwum.h"
+#include "FS.h"
+#include "SD.h"
+
+#define SCIEZKA_MANIFESTU       ARCHIWUM_KATALOG "/manifest.txt"
+#define SCIEZKA_STAREGO_BACKUPU "/backup_data.txt"
+
+// Czas RTC przed synchronizacją NTP - nie rotuj segmentów według czasu
+#define CZAS_NIEZSYNCHRONIZOWANY  1600000000UL
+
+static uint32_t najstarszy = 0;
+static uint32_t biezacy = 0;            // 0 = archiwum niezainicjalizowane
+static uint32_t poczatekBiezacego = 0;  // Epoch rozpoczęcia bieżącego segmentu
+static uint32_t rozmiarBiezacego = 0;
+static uint32_t usuniete = 0;
+static uint32_t wolneMB = 0;
+
+// Otwarty blok kodeka
+typedef struct {
+    bool aktywny;
+    uint32_t czasOtwarcia;          // millis() pierwszego rekordu w bloku
+    KoderBloku koder;
+} OtwartyBlok;
+
+// Bloki szeregów urządzeń + jeden blok tekstowy dla rekordów w innym formacie
+static OtwartyBlok bloki[ARCHIWUM_BLOKI_URZADZEN];
+static OtwartyBlok blokTekstowy;
+static uint8_t buforBloku[KODEK_MAX_BLOK];
+static uint32_t rekordy = 0;
+static uint32_t bajtyRekordow = 0;    // Rozmiar rekordów w postaci tekstowej
+static uint32_t bajtyBlokow = 0;      // Rozmiar zapisanych bloków
+
+static void sciezkaSegmentu(uint32_t numer, const char* rozszerzenie, char* bufor, size_t rozmiar) {
+    snprintf(bufor, rozmiar, ARCHIWUM_KATALOG "/%08lu%s", (unsigned long)numer, rozszerzenie);
+}
+
+// Usuwa segment niezależnie od formatu (.txt sprzed kodeka lub .bin)
+static void usunSegment(uint32_t numer) {
+    char sciezka[32];
+    sciezkaSegmentu(numer, ".bin", sciezka, sizeof(sciezka));
+    if (SD.exists(sciezka)) SD.remove(sciezka);
+    sciezkaSegmentu(numer, ".txt", sciezka, sizeof(sciezka));
+    if (SD.exists(sciezka)) SD.remove(sciezka);
+}
+
+static uint32_t teraz() {
+    return (uint32_t)rtc.getLocalEpoch();
+}
+
+static void zapiszManifest() {
+    File plik = SD.open(SCIEZKA_MANIFESTU, FILE_WRITE);
+    if (!plik) {
+        Serial.println("[Archiwum] Nie udało się zapisać manifestu");
+        return;
+    }
+    plik.printf("%lu %lu %lu\n", (unsigned long)najstarszy, (unsigned long)biezacy,
+                (unsigned long)poczatekBiezacego);
+    plik.close();
+}
+
+static bool wczytajManifest() {
+    File plik = SD.open(SCIEZKA_MANIFESTU, FILE_READ);
+    if (!plik) return false;
+
+    char bufor[48];
+    size_t n = plik.read((uint8_t*)bufor, sizeof(bufor) - 1);
+    plik.close();
+    bufor[n] = '\0';
+
+    unsigned long a, b, c;
+    if (sscanf(bufor, "%lu %lu %lu", &a, &b, &c) != 3 || a == 0 || b < a) return false;
+    najstarszy = a;
+    biezacy = b;
+    poczatekBiezacego = c;
+    return true;
+}
+
+// Odtwarza zakres segmentów z zawartości katalogu (brak lub uszkodzony manifest)
+static void skanujKatalog() {
+    najstarszy = biezacy = 0;
+    File katalog = SD.open(ARCHIWUM_KATALOG);
+    if (!katalog) return;
+
+    File plik = katalog.openNextFile();
+    while (plik) {
+        if (!plik.isDirectory()) {
+            // Zależnie od wersji rdzenia name() zwraca samą nazwę lub pełną ścieżkę
+            const char* nazwa = plik.name();
+            const char* ukosnik = strrchr(nazwa, '/');
+            if (ukosnik) nazwa = ukosnik + 1;
+
+            char* koniec;
+            unsigned long numer = strtoul(nazwa, &koniec, 10);
+            if (koniec != nazwa && (strcmp(koniec, ".bin") == 0 || strcmp(koniec, ".txt") == 0) && numer > 0) {
+                if (najstarszy == 0 || numer < najstarszy) najstarszy = numer;
+                if (numer > biezacy) biezacy = numer;
+            }
+        }
+        plik.close();
+        plik = katalog.openNextFile();
+    }
+    katalog.close();
+}
+
+/*
+ * Usuwa najstarsze segmenty, dopóki wolne miejsce jest poniżej progu.
+ * Bieżący segment nigdy nie jest usuwany.
+ */
+static void retencja() {
+    bool zmiana = false;
+    wolneMB = (uint32_t)((SD.totalBytes() - SD.usedBytes()) / (1024ULL * 1024ULL));
+
+    while (wolneMB < ARCHIWUM_MIN_WOLNE_MB && najstarszy < biezacy) {
+        usunSegment(najstarszy);
+        Serial.printf("[Archiwum] Mało miejsca (%lu MB) - usunięto segment %lu\n",
+                      (unsigned long)wolneMB, (unsigned long)najstarszy);
+        najstarszy++;
+        usuniete++;
+        zmiana = true;
+        wolneMB = (uint32_t)((SD.totalBytes() - SD.usedBytes()) / (1024ULL * 1024ULL));
+    }
+
+    if (zmiana) zapiszManifest();
+}
+
+static void rozpocznijSegment(uint32_t numer) {
+    char sciezka[32];
+    biezacy = numer;
+    rozmiarBiezacego = 0;
+    poczatekBiezacego = teraz();
+    sciezkaSegmentu(biezacy, ".bin", sciezka, sizeof(sciezka));
+    RejestratorUstawSciezke(REJESTR_ARCHIWUM, sciezka);
+    zapiszManifest();
+}
+
+// Zamyka blok i przekazuje go do rejestratora
+static void zapiszBlok(OtwartyBlok& b) {
+    if (!b.aktywny) return;
+    b.aktywny = false;
+    size_t n = kodekZamknij(&b.koder, buforBloku, sizeof(buforBloku));
+    if (n == 0) return;
+    RejestratorZapiszBajty(REJESTR_ARCHIWUM, buforBloku, n);
+    rozmiarBiezacego += n;
+    bajtyBlokow += n;
+}
+
+static void zapiszWszystkieBloki() {
+    for (int i = 0; i < ARCHIWUM_BLOKI_URZADZEN; i++) {
+        zapiszBlok(bloki[i]);
+    }
+    zapiszBlok(blokTekstowy);
+}
+
+static void otworzBlok(OtwartyBlok& b, uint8_t typ, int32_t id) {
+    kodekRozpocznij(&b.koder, typ, id);
+    b.czasOtwarcia = millis();
+    b.aktywny = true;
+}
+
+/*
+ * Blok urządzenia: istniejący, wolny albo - gdy wszystkie zajęte - najstarszy
+ * (po zapisaniu go na kartę).
+ */
+static OtwartyBlok& blokUrzadzenia(int32_t id) {
+    OtwartyBlok* wolny = nullptr;
+    OtwartyBlok* najstarszyBlok = &bloki[0];
+    for (int i = 0; i < ARCHIWUM_BLOKI_URZADZEN; i++) {
+        OtwartyBlok& b = bloki[i];
+        if (b.aktywny && b.koder.id_urzadzenia == id) return b;
+        if (!b.aktywny) {
+            if (!wolny) wolny = &b;
+        } else if (najstarszyBlok->aktywny &&
+                   (int32_t)(b.czasOtwarcia - najstarszyBlok->czasOtwarcia) < 0) {
+            najstarszyBlok = &b;
+        }
+    }
+    if (!wolny) {
+        zapiszBlok(*najstarszyBlok);
+        wolny = najstarszyBlok;
+    }
+    otworzBlok(*wolny, KODEK_BLOK_SZEREG, id);
+    return *wolny;
+}
+
+void ArchiwumInicjalizacja() {
+    if (!SD.exists(ARCHIWUM_KATALOG) && !SD.mkdir(ARCHIWUM_KATALOG)) {
+        Serial.println("[Archiwum] BŁĄD: Nie udało się utworzyć katalogu " ARCHIWUM_KATALOG);
+        return;
+    }
+
+    if (!wczytajManifest()) {
+        skanujKatalog();
+        poczatekBiezacego = 0;
+    }
+
+    // Migracja starego pliku archiwum jako najstarszego segmentu
+    char sciezka[32];
+    if (biezacy == 0 && SD.exists(SCIEZKA_STAREGO_BACKUPU)) {
+        sciezkaSegmentu(1, ".txt", sciezka, sizeof(sciezka));
+        if (SD.rename(SCIEZKA_STAREGO_BACKUPU, sciezka)) {
+            Serial.printf("[Archiwum] Przeniesiono backup_data.txt do %s\n", sciezka);
+            najstarszy = biezacy = 1;
+        }
+    }
+
+    sciezkaSegmentu(biezacy, ".txt", sciezka, sizeof(sciezka));
+    if (biezacy == 0) {
+        najstarszy = 1;
+        rozpocznijSegment(1);
+    } else if (SD.exists(sciezka)) {
+        // Segment tekstowy sprzed kodeka - bloki binarne zaczynają nowy segment
+        rozpocznijSegment(biezacy + 1);
+    } else {
+        // Kontynuuj bieżący segment - rozmiar z karty, czas z manifestu
+        sciezkaSegmentu(biezacy, ".bin", sciezka, sizeof(sciezka));
+        File plik = SD.open(sciezka, FILE_READ);
+        rozmiarBiezacego = plik ? plik.size() : 0;
+        if (plik) plik.close();
+        if (poczatekBiezacego == 0) poczatekBiezacego = teraz();
+        RejestratorUstawSciezke(REJESTR_ARCHIWUM, sciezka);
+        zapiszManifest();
+    }
+
+    retencja();
+
+    Serial.printf("[Archiwum] Segmenty %lu..%lu, bieżący: %lu B, wolne: %lu MB\n",
+                  (unsigned long)najstarszy, (unsigned long)biezacy,
+                  (unsigned long)rozmiarBiezacego, (unsigned long)wolneMB);
+}
+
+void ArchiwumDopisz(const char* rekord) {
+    if (biezacy == 0) return;
+
+    uint32_t czas = teraz();
+    bool pelny = rozmiarBiezacego >= ARCHIWUM_ROZMIAR_SEGMENTU;
+    bool stary = czas > CZAS_NIEZSYNCHRONIZOWANY && poczatekBiezacego > CZAS_NIEZSYNCHRONIZOWANY &&
+                 czas - poczatekBiezacego >= ARCHIWUM_CZAS_SEGMENTU_S;
+    if (rozmiarBiezacego > 0 && (pelny || stary)) {
+        zapiszWszystkieBloki();
+        rozpocznijSegment(biezacy + 1);
+        retencja();
+    } else if (poczatekBiezacego <= CZAS_NIEZSYNCHRONIZOWANY && czas > CZAS_NIEZSYNCHRONIZOWANY) {
+        // Segment rozpoczęty przed synchronizacją NTP - licz czas od teraz
+        poczatekBiezacego = czas;
+        zapiszManifest();
+    }
+
+    rekordy++;
+    bajtyRekordow += strlen(rekord) + 1;
+
+    int32_t id;
+    ProbkaArchiwum probka;
+    if (kodekParsujCSV(rekord, &id, &probka)) {
+        OtwartyBlok& b = blokUrzadzenia(id);
+        if (!kodekDodaj(&b.koder, &probka)) {
+            zapiszBlok(b);
+            otworzBlok(b, KODEK_BLOK_SZEREG, id);
+            kodekDodaj(&b.koder, &probka);
+        }
+        return;
+    }
+
+    // Rekord w innym formacie - zachowaj dosłownie w bloku tekstowym
+    if (strlen(rekord) + 1 > KODEK_MAX_DANE) {
+        Serial.printf("[Archiwum] Rekord za długi (%u B) - pominięto\n", (unsigned)strlen(rekord));
+        return;
+    }
+    if (!blokTekstowy.aktywny) otworzBlok(blokTekstowy, KODEK_BLOK_TEKST, 0);
+    if (!kodekDodajTekst(&blokTekstowy.koder, rekord)) {
+        zapiszBlok(blokTekstowy);
+        otworzBlok(blokTekstowy, KODEK_BLOK_TEKST, 0);
+        kodekDodajTekst(&blokTekstowy.koder, rekord);
+    }
+}
+
+void ArchiwumObsluga() {
+    if (biezacy == 0) return;
+    uint32_t teraz = millis();
+    for (int i = 0; i < ARCHIWUM_BLOKI_URZADZEN; i++) {
+        if (bloki[i].aktywny && teraz - bloki[i].czasOtwarcia >= ARCHIWUM_MAX_WIEK_BLOKU_MS) {
+            zapiszBlok(bloki[i]);
+        }
+    }
+    if (blokTekstowy.aktywny && teraz - blokTekstowy.czasOtwarcia >= ARCHIWUM_MAX_WIEK_BLOKU_MS) {
+        zapiszBlok(blokTekstowy);
+    }
+}
+
+void ArchiwumWyczysc() {
+    if (biezacy == 0) return;
+    RejestratorZamknijPlik(REJESTR_ARCHIWUM);
+
+    // Otwarte bloki należą do usuwanego archiwum - odrzuć je
+    for (int i = 0; i < ARCHIWUM_BLOKI_URZADZEN; i++) {
+        bloki[i].aktywny = false;
+    }
+    blokTekstowy.aktywny = false;
+
+    for (uint32_t numer = najstarszy; numer <= biezacy; numer++) {
+        usunSegment(numer);
+    }
+    SD.remove(SCIEZKA_MANIFESTU);
+    SD.rmdir(ARCHIWUM_KATALOG);
+
+    najstarszy = biezacy = 0;
+    rozmiarBiezacego = 0;
+    Serial.println("[Archiwum] Archiwum wyczyszczone");
+}
+
+void ArchiwumPobierzStatystyki(StatystykiArchiwum* statystyki) {
+    statystyki->najstarszy = najstarszy;
+    statystyki->biezacy = biezacy;
+    statystyki->rozmiar_biezacego = rozmiarBiezacego;
+    statystyki->usuniete = usuniete;
+    statystyki->wolne_mb = wolneMB;
+    statystyki->rekordy = rekordy;
+    statystyki->bajty_rekordow = bajtyRekordow;
+    statystyki->bajty_blokow = bajtyBlokow;
+}
@@ -0,0 +1,86 @@
+/*
+ * MODUŁ ARCHIWUM - archiwum_SD.h
+ *
+ * Archiwum wysłanych danych (dawniej jeden plik /backup_data.txt) podzielone
+ * na segmenty /archiwum/00000001.bin, ... Nowy segment zaczyna się po
+ * przekroczeniu ARCHIWUM_ROZMIAR_SEGMENTU lub ARCHIWUM_CZAS_SEGMENTU_S,
+ * więc koszt dopisywania nie rośnie z długością łańcucha klastrów FAT.
+ *
+ * Mały manifest /archiwum/manifest.txt przechowuje najstarszy i bieżący
+ * segment oraz czas rozpoczęcia bieżącego. Gdy wolne miejsce na karcie spadnie
+ * poniżej ARCHIWUM_MIN_WOLNE_MB, najstarsze segmenty są usuwane.
+ *
+ * Segmenty zawierają bloki kodeka kodek_archiwum.h (delta-of-delta czasu,
+ * różnice pól stałoprzecinkowych) zamiast linii CSV. Segmenty .txt sprzed
+ * kodeka pozostają czytelne bez zmian. Odczyt na komputerze:
+ * Narzędzia/dekoder_archiwum.py
+ *
+ * Moduł jest używany wyłącznie z zadania uplinku.
+ */
+
+#ifndef ARCHIWUM_SD_H
+#define ARCHIWUM_SD_H
+
+#include "main.h"
+
+// Katalog segmentów archiwum (podkatalog - InicjalizacjaSD() czyści tylko katalog główny)
+#define ARCHIWUM_KATALOG            "/archiwum"
+// Maksymalny rozmiar segmentu (bajty)
+#define ARCHIWUM_ROZMIAR_SEGMENTU   (1024UL * 1024UL)
+// Maksymalny czas zapisu do jednego segmentu (s)
+#define ARCHIWUM_CZAS_SEGMENTU_S    (24UL * 3600UL)
+// Próg wolnego miejsca, poniżej którego usuwane są najstarsze segmenty (MB)
+#define ARCHIWUM_MIN_WOLNE_MB       64
+// Liczba jednocześnie otwartych bloków (urządzeń) kodeka
+#define ARCHIWUM_BLOKI_URZADZEN     8
+// Maksymalny czas, po którym niepełny blok jest zapisywany (ms).
+// Niepełne bloki są tylko w RAM - zanik zasilania traci do tego czasu
+// (plus REJESTRATOR_MAX_WIEK_MS) archiwum każdego urządzenia. Krótszy czas
+// to mniej rekordów w bloku i słabsza kompresja: przy próbce co 5 s blok
+// 60 s (12 rekordów) daje ok. 10x względem CSV, blok 300 s (60 rekordów) ok. 15x.
+// Rekordy są też w bazie serwera (archiwum trafia tylko to, co potwierdził broker).
+#define ARCHIWUM_MAX_WIEK_BLOKU_MS  60000
+
+// Statystyki archiwum
+typedef struct {
+    uint32_t najstarszy;          // Numer najstarszego zachowanego segmentu
+    uint32_t biezacy;             // Numer segmentu, do którego trafiają rekordy
+    uint32_t rozmiar_biezacego;   // Bajty zapisane w bieżącym segmencie
+    uint32_t usuniete;            // Segmenty usunięte przez retencję (od startu)
+    uint32_t wolne_mb;            // Wolne miejsce przy ostatnim sprawdzeniu (MB)
+    uint32_t rekordy;             // Rekordy przyjęte od startu
+    uint32_t bajty_rekordow;      // Ich rozmiar w postaci CSV
+    uint32_t bajty_blokow;        // Rozmiar zapisanych bloków kodeka
+} StatystykiArchiwum;
+
+/*
+ * Odtwarza stan archiwum z manifestu (lub z zawartości katalogu).
+ * Przenosi stary /backup_data.txt jako najstarszy segment.
+ * Wywoływana przez InicjalizacjaSD() po przygotowaniu rejestratora.
+ */
+void ArchiwumInicjalizacja();
+
+/*
+ * Dodaje rekord do otwartego bloku urządzenia. Zapełniony blok trafia do
+ * bieżącego segmentu (przez buforowany rejestrator).
+ * W razie potrzeby rozpoczyna nowy segment i uruchamia retencję.
+ */
+void ArchiwumDopisz(const char* rekord);
+
+/*
+ * Zapisuje bloki otwarte dłużej niż ARCHIWUM_MAX_WIEK_BLOKU_MS.
+ * Wywoływana cyklicznie z pętli zadania uplinku.
+ */
+void ArchiwumObsluga();
+
+/*
+ * Usuwa wszystkie segmenty i manifest (pełny reset systemu).
+ */
+void ArchiwumWyczysc();
+
+/*
+ * Kopiuje bieżące statystyki archiwum.
+ */
+void ArchiwumPobierzStatystyki(StatystykiArchiwum* statystyki);
+
+#endif
@@ -0,0 +1,269 @@
+/*
+ * benchmark_kodekow.cpp
+ *
+ * Dane wejściowe są przygotowywane raz przed pomiarem, a wynik każdego
+ * wywołania trafia do zmiennej volatile, aby kompilator nie usunął pracy.
+ */
+
+#include "benchmark_kodekow.h"
+#include "licznik_alokacji.h"
+#include "mqtt.h"
+#include "odbior_mesh.h"
+#include "dyspozytor_mesh.h"
+#include "ramka_mesh.h"
+#include "kodek_archiwum.h"
+
+typedef void (*FunkcjaPrzypadku)();
+
+typedef struct {
+    const char* nazwa;
+    FunkcjaPrzypadku funkcja;
+} PrzypadekBenchmarku;
+
+static volatile uint32_t ujscie = 0;
+
+// Wspólne dane wejściowe
+static Pakiet_Danych pakiet;
+static char rekordCSV[150];
+static char wiadomoscDane[160];
+static size_t dlugoscDane = 0;
+static char wiadomoscRamka[RAMKA_MAX_TEKST];
+static size_t dlugoscRamki = 0;
+static uint32_t epoch = 0;
+
+// Pakiet węzła (Czujnik_IoT/czujniki.h) - znacznik czasu jako String
+typedef struct {
+    int ID_urzadzenia;
+    float temperatura;
+    float wilgotnosc;
+    int poziom_co2;
+    int poziom_amoniaku;
+    int naslonecznienie;
+    String data_i_czas;
+} PakietWezla;
+
+// === PRZYPADKI BAZOWE ===
+
+// Dawny parser pakietu: sscanf po całym rekordzie
+static void bazowySscanf() {
+    Pakiet_Danych p;
+    int n = sscanf(rekordCSV, "%d;%f;%f;%d;%d;%d;%31[^\n]", &p.ID_urzadzenia, &p.temperatura,
+                   &p.wilgotnosc, &p.poziom_co2, &p.poziom_amoniaku, &p.naslonecznienie, p.data_i_czas);
+    ujscie += n + p.poziom_co2;
+}
+
+// Dawne rozpoznawanie wiadomości i wyciąganie czasu przez String
+static void bazowyString() {
+    String msg(wiadomoscDane);
+    String prefix = msg.substring(0, 4);
+    String czas = msg.substring(msg.lastIndexOf(';') + 1);
+    ujscie += (prefix == "DANE") + czas.length();
+}
+
+static void bazowyGetTimeDate() {
+    String czas = rtc.getTimeDate();
+    ujscie += czas.length();
+}
+
+// Kopia pakietToCSV() węzła (Czujnik_IoT): czas z rtc.getTimeDate() jako String, potem snprintf
+static void bazowyPakietToCSVWezla() {
+    PakietWezla p;
+    p.ID_urzadzenia = pakiet.ID_urzadzenia;
+    p.temperatura = pakiet.temperatura;
+    p.wilgotnosc = pakiet.wilgotnosc;
+    p.poziom_co2 = pakiet.poziom_co2;
+    p.poziom_amoniaku = pakiet.poziom_amoniaku;
+    p.naslonecznienie = pakiet.naslonecznienie;
+    p.data_i_czas = rtc.getTimeDate();
+
+    char bufor[150];
+    snprintf(bufor, sizeof(bufor), "%d;%.2f;%.2f;%d;%d;%d;%s", p.ID_urzadzenia, p.temperatura,
+             p.wilgotnosc, p.poziom_co2, p.poziom_amoniaku, p.naslonecznienie, p.data_i_czas.c_str());
+    ujscie += bufor[0];
+}
+
+static void bazowyStrptime() {
+    struct tm czas = {};
+    strptime(pakiet.data_i_czas, "%H:%M:%S %a, %b %d %Y", &czas);
+    ujscie += (uint32_t)mktime(&czas);
+}
+
+// === BIEŻĄCE IMPLEMENTACJE ===
+
+static void formatujCSV() {
+    char bufor[150];
+    ujscie += FormatujPakietCSV(&pakiet, bufor, sizeof(bufor));
+}
+
+static void parsujDane() {
+    Pakiet_Danych p;
+    // Treść za tagiem "DANE"
+    ujscie += ParsujPakietDane(wiadomoscDane + 4, dlugoscDane - 4, &p, nullptr) + p.poziom_co2;
+}
+
+static void dyspozytorNieznanyTag() {
+    ujscie += ObsluzWiadomoscMesh(0, "XXXX;", 5);
+}
+
+static void formatujCzas() {
+    char bufor[RAMKA_CZAS_DL];
+    ramkaFormatujCzas(epoch, bufor, sizeof(bufor));
+    ujscie += bufor[0];
+}
+
+static void czasZTekstu() {
+    ujscie += kodekCzasZTekstu(pakiet.data_i_czas);
+}
+
+static void kodujRamke() {
+    RamkaDane ramka = {};
+    ramka.naglowek.id_wezla = (uint32_t)pakiet.ID_urzadzenia;
+    ramka.naglowek.epoch = epoch;
+    ramka.temperatura_c = (int16_t)ramkaSetne(pakiet.temperatura);
+    ramka.wilgotnosc_c = (uint16_t)ramkaSetne(pakiet.wilgotnosc);
+    ramka.poziom_co2 = pakiet.poziom_co2;
+    ramka.poziom_amoniaku = pakiet.poziom_amoniaku;
+    ramka.naslonecznienie = (uint32_t)pakiet.naslonecznienie;
+
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    char tekst[RAMKA_MAX_TEKST];
+    size_t n = ramkaKodujDane(&ramka, bin, sizeof(bin));
+    ujscie += ramkaDoTekstu(bin, n, tekst, sizeof(tekst));
+}
+
+static void dekodujRamke() {
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    RamkaDane ramka;
+    // Treść za prefiksem "RAMK"
+    size_t n = ramkaZTekstu(wiadomoscRamka + 4, dlugoscRamki - 4, bin, sizeof(bin));
+    ujscie += ramkaDekodujDane(bin, n, &ramka) + ramka.poziom_co2;
+}
+
+static void parsujCSVArchiwum() {
+    int32_t id;
+    ProbkaArchiwum probka;
+    ujscie += kodekParsujCSV(rekordCSV, &id, &probka) + probka.poziom_co2;
+}
+
+// Próbka archiwum z wartościami pakietu testowego (bez przeniesionych i pominiętych)
+static ProbkaArchiwum probkaArchiwum(uint32_t czas, int32_t temperatura_c) {
+    ProbkaArchiwum probka{};
+    probka.epoch = czas;
+    probka.temperatura_c = temperatura_c;
+    probka.wilgotnosc_c = 5512;
+    probka.poziom_co2 = 1200;
+    probka.poziom_amoniaku = 15;
+    probka.naslonecznienie = 50;
+    return probka;
+}
+
+static void formatujCSVArchiwum() {
+    ProbkaArchiwum probka = probkaArchiwum(epoch, 2231);
+    char bufor[150];
+    ujscie += kodekFormatujCSV(pakiet.ID_urzadzenia, &probka, bufor, sizeof(bufor));
+}
+
+static void kodujProbkeArchiwum() {
+    static KoderBloku koder;
+    static uint32_t t = 0;
+    t += 5;
+    ProbkaArchiwum probka = probkaArchiwum(epoch + t, 2231 + (int32_t)(t & 3));
+    if (!kodekDodaj(&koder, &probka)) {
+        kodekRozpocznij(&koder, KODEK_BLOK_SZEREG, pakiet.ID_urzadzenia);
+        kodekDodaj(&koder, &probka);
+    }
+    ujscie += koder.bity;
+}
+
+static const PrzypadekBenchmarku PRZYPADKI[] = {
+    { "sscanf CSV (bazowy)",            bazowySscanf },
+    { "String substring (bazowy)",      bazowyString },
+    { "rtc.getTimeDate (bazowy)",       bazowyGetTimeDate },
+    { "pakietToCSV węzła (bazowy)",     bazowyPakietToCSVWezla },
+    { "strptime+mktime (bazowy)",       bazowyStrptime },
+    { "FormatujPakietCSV",              formatujCSV },
+    { "ParsujPakietDane",               parsujDane },
+    { "ObsluzWiadomoscMesh (nieznany)", dyspozytorNieznanyTag },
+    { "ramkaFormatujCzas",              formatujCzas },
+    { "kodekCzasZTekstu",               czasZTekstu },
+    { "ramka kodowanie+base64",         kodujRamke },
+    { "ramka base64+dekodowanie",       dekodujRamke },
+    { "kodekParsujCSV",                 parsujCSVArchiwum },
+    { "kodekFormatujCSV",               formatujCSVArchiwum },
+    { "kodekDodaj",                     kodujProbkeArchiwum },
+};
+
+static void przygotujDane() {
+    epoch = (uint32_t)rtc.getLocalEpoch();
+    pakiet.ID_urzadzenia = 692641124;
+    pakiet.temperatura = 22.31f;
+    pakiet.wilgotnosc = 55.12f;
+    pakiet.poziom_co2 = 1200;
+    pakiet.poziom_amoniaku = 15;
+    pakiet.naslonecznienie = 50;
+    ramkaFormatujCzas(epoch, pakiet.data_i_czas, sizeof(pakiet.data_i_czas));
+
+    FormatujPakietCSV(&pakiet, rekordCSV, sizeof(rekordCSV));
+    int n = snprintf(wiadomoscDane, sizeof(wiadomoscDane), "DANE;%s", rekordCSV);
+    dlugoscDane = (n > 0) ? (size_t)n : 0;
+
+    RamkaDane ramka = {};
+    ramka.naglowek.id_wezla = (uint32_t)pakiet.ID_urzadzenia;
+    ramka.naglowek.epoch = epoch;
+    ramka.temperatura_c = (int16_t)ramkaSetne(pakiet.temperatura);
+    ramka.wilgotnosc_c = (uint16_t)ramkaSetne(pakiet.wilgotnosc);
+    ramka.poziom_co2 = pakiet.poziom_co2;
+    ramka.poziom_amoniaku = pakiet.poziom_amoniaku;
+    ramka.naslonecznienie = (uint32_t)pakiet.naslonecznienie;
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    size_t dl = ramkaKodujDane(&ramka, bin, sizeof(bin));
+    dlugoscRamki = ramkaDoTekstu(bin, dl, wiadomoscRamka, sizeof(wiadomoscRamka));
+}
+
+size_t ZmierzBenchmarkKodekow(uint32_t iteracje, WynikBenchmarku* wyniki, size_t maks) {
+    if (iteracje == 0) iteracje = BENCHMARK_ITERACJE;
+    przygotujDane();
+
+    uint32_t mhz = getCpuFrequencyMhz();
+    size_t n = 0;
+    for (size_t i = 0; i < sizeof(PRZYPADKI) / sizeof(PRZYPADKI[0]) && n < maks; i++) {
+        const PrzypadekBenchmarku& p = PRZYPADKI[i];
+
+        // Rozgrzewka (pamięć podręczna flash, pierwsze alokacje bibliotek)
+        for (int k = 0; k < 8; k++) p.funkcja();
+
+        uint32_t najlepszy = UINT32_MAX;
+        LicznikAlokacji alokacje = {};
+        for (int powtorzenie = 0; powtorzenie < BENCHMARK_POWTORZENIA; powtorzenie++) {
+            if (powtorzenie == 0) LicznikAlokacjiStart();
+            uint32_t start = ESP.getCycleCount();
+            for (uint32_t k = 0; k < iteracje; k++) p.funkcja();
+            uint32_t cykle = ESP.getCycleCount() - start;
+            if (powtorzenie == 0) LicznikAlokacjiStop(&alokacje);
+            if (cykle < najlepszy) najlepszy = cykle;
+        }
+
+        WynikBenchmarku& w = wyniki[n++];
+        w.nazwa = p.nazwa;
+        w.ns_na_op = (float)najlepszy * 1000.0f / ((float)mhz * iteracje);
+        w.alokacje_na_op = (float)alokacje.alokacje / iteracje;
+        w.bajty_na_op = (float)alokacje.bajty / iteracje;
+        yield();
+    }
+    return n;
+}
+
+void UruchomBenchmarkKodekow(uint32_t iteracje) {
+    if (iteracje == 0) iteracje = BENCHMARK_ITERACJE;
+    WynikBenchmarku wyniki[sizeof(PRZYPADKI) / sizeof(PRZYPADKI[0])];
+    size_t n = ZmierzBenchmarkKodekow(iteracje, wyniki, sizeof(wyniki) / sizeof(wyniki[0]));
+
+    Serial.printf("\n=== BENCHMARK KODEKÓW (%lu iteracji, CPU %lu MHz) ===\n",
+                  (unsigned long)iteracje, (unsigned long)getCpuFrequencyMhz());
+    Serial.println("Przypadek                          ns/op   alok/op    B/op");
+    for (size_t i = 0; i < n; i++) {
+        Serial.printf("%-32s %8.0f  %8.2f  %6.1f\n", wyniki[i].nazwa, wyniki[i].ns_na_op,
+                      wyniki[i].alokacje_na_op, wyniki[i].bajty_na_op);
+    }
+    Serial.println("==============================================\n");
+}
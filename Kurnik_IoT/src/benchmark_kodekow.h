@@ -0,0 +1,47 @@
+/*
+ * MODUŁ BENCHMARKU KODEKÓW - benchmark_kodekow.h
+ *
+ * Mikrobenchmark funkcji parsujących i formatujących wykonywanych dla
+ * każdego pakietu (mqtt.cpp, odbior_mesh.cpp, ramka_mesh, kodek archiwum,
+ * pakietToCSV węzłów). Każdy przypadek jest mierzony licznikiem cykli CPU,
+ * a alokacje sterty - licznikiem z licznik_alokacji.h.
+ *
+ * Przypadki oznaczone "(bazowy)" to dawne implementacje oparte na
+ * sscanf/String, zachowane jako punkt odniesienia dla zamienników.
+ *
+ * Komenda Serial: "benchmark [iteracje]"; na hoście (CI) te same przypadki
+ * mierzy test_benchmark_kodekow (pio test -e native).
+ */
+
+#ifndef BENCHMARK_KODEKOW_H
+#define BENCHMARK_KODEKOW_H
+
+#include "main.h"
+
+// Domyślna liczba iteracji jednego przypadku
+#define BENCHMARK_ITERACJE        1000
+// Liczba powtórzeń pomiaru - raportowany jest najszybszy
+#define BENCHMARK_POWTORZENIA     3
+
+// Wynik jednego przypadku
+typedef struct {
+    const char* nazwa;
+    float ns_na_op;           // Najszybsze z BENCHMARK_POWTORZENIA powtórzeń
+    float alokacje_na_op;
+    float bajty_na_op;
+} WynikBenchmarku;
+
+/*
+ * Mierzy wszystkie przypadki bez wypisywania (także w testach hosta,
+ * test_benchmark_kodekow). Na hoście alokacje są zawsze zerowe.
+ * return: liczba zapisanych wyników (najwyżej maks)
+ */
+size_t ZmierzBenchmarkKodekow(uint32_t iteracje, WynikBenchmarku* wyniki, size_t maks);
+
+/*
+ * Uruchamia wszystkie przypadki i wypisuje tabelę ns/op i alokacji/op.
+ * Blokuje pętlę Arduino na czas pomiaru (typowo < 1 s dla 1000 iteracji).
+ */
+void UruchomBenchmarkKodekow(uint32_t iteracje);
+
+#endif
@@ -1,26 +1,148 @@
 #include <cstdint>
 #include <cmath>
 #include "czujniki.h"
+#include "dziennik.h"
+#include "pamiec_lokalna.h"
+#include "probkownik_adc.h"
+#include "tablice_analogowe.h"
+#include <freertos/task.h>
 
 Adafruit_SGP30 sgp;
 
-DHT dht22(PIN_DHT22, DHTTYPE);
+// Migawka pomiarów - zapisywana i czytana tylko w pętli Arduino (scheduler)
+static MigawkaCzujnikow migawka;
 
-// Stałe dla termistora NTC
-const float REFERENCE_RESISTANCE = 10000.0;   // Rezystancja referencyjna (10kΩ)
-const float NOMINAL_RESISTANCE = 10000.0;    // Rezystancja NTC w 25°C (10kΩ)
-const float NOMINAL_TEMPERATURE = 25.0;      // Temperatura referencyjna (°C)
-const float B_VALUE = 3950.0;                // Współczynnik Beta
+static const uint32_t MAX_WIEK_MS[CZUJNIK_LICZBA] = {
+    CZUJNIKI_MAX_WIEK_DHT_MS, CZUJNIKI_MAX_WIEK_NTC_MS, CZUJNIKI_MAX_WIEK_LDR_MS, CZUJNIKI_MAX_WIEK_SGP_MS
+};
 
-// Inicjalizacja czujnika SGP30
+// === PRÓBKOWANIE SGP30 (osobne zadanie FreeRTOS) ===
+// Ten sam rdzeń co zadanie uplinku - delay() w bibliotece SGP30 nie blokuje pętli mesh
+static const BaseType_t SGP_RDZEN = (ARDUINO_RUNNING_CORE == 0) ? 1 : 0;
+
+static portMUX_TYPE blokadaSGP = portMUX_INITIALIZER_UNLOCKED;
+static int sgpECO2 = -1, sgpTVOC = -1;       // Ostatni pomiar (pod blokadaSGP)
+static uint32_t sgpCzasPomiaru = 0;
+static volatile uint32_t sgpWilgotnosc = 0;  // Wilgotność bezwzględna z DHT (mg/m^3), 0 = brak
+static StatystykiSGP sgpStatystyki;
+
+static bool czasZnany() {
+    return rtc.getEpoch() > 1600000000UL;   // Czas z NTP (po 2020 r.)
+}
+
+// Przywraca bazę, gdy znany jest czas (wiek bazy) - raz po starcie
+static void przywrocBaze() {
+    BazaSGP baza;
+    if (!WczytajBazeSGP(&baza)) {
+        Serial.println("[SGP30] Brak zapisanej bazy - kalibracja od zera (ok. 12 h)");
+        return;
+    }
+    uint32_t wiek = (uint32_t)rtc.getEpoch() - baza.epoch;
+    if (wiek > SGP_MAX_WIEK_BAZY_S) {
+        Serial.printf("[SGP30] Zapisana baza jest za stara (%lu h) - pomijam\n", (unsigned long)(wiek / 3600));
+        return;
+    }
+    if (sgp.setIAQBaseline(baza.eco2, baza.tvoc)) {
+        sgpStatystyki.baza_przywrocona = true;
+        sgpStatystyki.baza_eco2 = baza.eco2;
+        sgpStatystyki.baza_tvoc = baza.tvoc;
+        Serial.printf("[SGP30] Przywrócono bazę eCO2 0x%04X, TVOC 0x%04X (wiek %lu h)\n",
+                      baza.eco2, baza.tvoc, (unsigned long)(wiek / 3600));
+    }
+}
+
+static void zapiszBaze() {
+    BazaSGP baza;
+    if (!sgp.getIAQBaseline(&baza.eco2, &baza.tvoc)) {
+        LOG_BLAD("[SGP30] Błąd odczytu bazy");
+        return;
+    }
+    baza.epoch = (uint32_t)rtc.getEpoch();
+    ZapiszBazeSGP(&baza);
+    sgpStatystyki.baza_eco2 = baza.eco2;
+    sgpStatystyki.baza_tvoc = baza.tvoc;
+    sgpStatystyki.zapisy_bazy++;
+    LOG_INFO("[SGP30] Zapisano bazę eCO2 0x%04X, TVOC 0x%04X", baza.eco2, baza.tvoc);
+}
+
+static void zadanieSGP(void* parametr) {
+    bool bazaSprawdzona = false;
+    uint32_t ostatniaWilgotnosc = 0;
+    uint32_t ostatniZapis_s = 0;
+    TickType_t ostatniPomiar = xTaskGetTickCount();
+
+    for (;;) {
+        vTaskDelayUntil(&ostatniPomiar, pdMS_TO_TICKS(SGP_OKRES_MS));
+
+        if (!bazaSprawdzona && czasZnany()) {
+            przywrocBaze();
+            bazaSprawdzona = true;
+        }
+
+        // Kompensacja wilgotności tylko przy zmianie (osobna transakcja I2C)
+        uint32_t wilgotnosc = sgpWilgotnosc;
+        if (wilgotnosc != ostatniaWilgotnosc) {
+            sgp.setHumidity(wilgotnosc);
+            ostatniaWilgotnosc = wilgotnosc;
+        }
+
+        // Jeden pomiar IAQ daje eCO2 i TVOC
+        if (sgp.IAQmeasure()) {
+            portENTER_CRITICAL(&blokadaSGP);
+            sgpECO2 = sgp.eCO2;
+            sgpTVOC = sgp.TVOC;
+            sgpCzasPomiaru = millis();
+            portEXIT_CRITICAL(&blokadaSGP);
+            sgpStatystyki.pomiary++;
+        } else {
+            sgpStatystyki.bledy++;
+            LOG_BLAD("Błąd odczytu czujnika SGP30");
+        }
+
+        // Baza jest wiarygodna po 12 h pracy albo od razu po przywróceniu
+        uint32_t uptime_s = millis() / 1000;
+        bool bazaGotowa = sgpStatystyki.baza_przywrocona || uptime_s >= SGP_PIERWSZY_ZAPIS_BAZY_S;
+        if (bazaGotowa && czasZnany() && uptime_s - ostatniZapis_s >= SGP_OKRES_ZAPISU_BAZY_S) {
+            zapiszBaze();
+            ostatniZapis_s = uptime_s;
+        }
+    }
+}
+
+void SGPUstawWilgotnosc(float temperatura, float wilgotnosc) {
+    sgpWilgotnosc = (wilgotnosc > 0) ? getAbsoluteHumidity(temperatura, wilgotnosc) : 0;
+}
+
+void SGPPobierzStatystyki(StatystykiSGP* statystyki) {
+    *statystyki = sgpStatystyki;
+}
+
+// Inicjalizacja czujników i zadania próbkowania SGP30
 void InicjalizacjaCzujnikow() {
     if (!sgp.begin()) {
         Serial.println("Nie znaleziono czujnika SGP30!");
-        // Kontynuuj mimo braku czujnika - użyj wartości domyślnych
+        // Kontynuuj mimo braku czujnika - migawka podaje eCO2/TVOC = -1
     } else {
         Serial.println("Czujnik SGP30 zainicjalizowany pomyślnie");
-        // Czujnik wymaga ok. 15 sekund na inicjalizację
+        // Czujnik wymaga ok. 15 sekund na inicjalizację, algorytm IAQ pomiarów co 1 s
+        if (xTaskCreatePinnedToCore(zadanieSGP, "sgp30", SGP_STOS, nullptr, SGP_PRIORYTET, nullptr, SGP_RDZEN) != pdPASS) {
+            Serial.println("[SGP30] BŁĄD: Nie udało się uruchomić zadania próbkowania");
+        } else {
+            sgpStatystyki.aktywny = true;
+        }
     }
+
+    // DHT22 - pierwsza ramka w najbliższym obiegu loop()
+    dhtInicjalizuj(PIN_DHT22);
+    // NTC i LDR - próbkowanie ciągłe przez DMA, pierwsza wartość po ADC_OKRES_MS
+    AdcInicjalizacja();
+
+    // Pierwsza migawka, aby ekran i pierwszy pakiet miały dane
+    migawka.dht_temp = NAN;
+    migawka.dht_hum = NAN;
+    migawka.eco2 = -1;
+    migawka.tvoc = -1;
+    CzujnikiOdswiez(true);
 }
 
 // CO2 Sensor - Oblicza bezwzględną wilgotność na podstawie temperatury i wilgotności względnej
@@ -32,94 +154,91 @@ uint32_t getAbsoluteHumidity(float temperature, float humidity) {
 }
 
 
-int odczytCO2(float temperature, float humidity) {
-  // Ustaw wilgotność kompensacyjną przed pomiarem zgodnie z dokumentacją Sensirion
-  sgp.setHumidity(getAbsoluteHumidity(temperature, humidity));
-  if (!sgp.IAQmeasure()) {
-    Serial.println("Błąd odczytu czujnika SGP30");
-    return -1;
-  }
-  int eCO2 = sgp.eCO2;
-  return eCO2;
-}
-
-int odczytTVOC(float temperature, float humidity) {
-  // Ustaw wilgotność kompensacyjną przed pomiarem i wykonaj pomiar IAQ
-  sgp.setHumidity(getAbsoluteHumidity(temperature, humidity));
-  if (!sgp.IAQmeasure()) {
-    Serial.println("Błąd odczytu czujnika SGP30");
-    return -1;
-  }
-  int TVOC = sgp.TVOC;
-  return TVOC;
-}
-
-float measureDHT22_Temp(){
-  float t = dht22.readTemperature();
-  if (isnan(t)) return 0.0; 
-  return t;
-}
-
-float measureDHT22_Hum(){
-  float h = dht22.readHumidity();
-  if (isnan(h)) return 0.0; 
-  return h;
-}
-
 float measureNTC() {
-  int raw = analogRead(PIN_NTC);
+  // Zdecymowany i skalibrowany kod z próbkownika ADC (probkownik_adc.h)
+  OdczytAdc adc;
+  if (!AdcPobierz(ADC_NTC, &adc)) return NAN;
+  int raw = adc.kod;
   
   if (raw <= 0 || raw >= 4095) {
-    Serial.println("NTC: Błędny odczyt ADC");
+    LOG_DEBUG("NTC: Błędny odczyt ADC");
     return NAN;
   }
   
-  // Oblicz rezystancję NTC z dzielnika napięciowego
-  // Konfiguracja: VCC --- R_REF(9.55k) --- ADC_PIN --- NTC(10k) --- GND
-  float resistance = REFERENCE_RESISTANCE * raw / (4095.0 - raw);
-  
-  // Wzór Steinharta-Harta (uproszczony z parametrem Beta)
-  // T = 1 / (1/T0 + (1/B) * ln(R/R0))
-  float steinhart = resistance / NOMINAL_RESISTANCE;    // (R/R0)
-  steinhart = log(steinhart);                           // ln(R/R0)
-  steinhart /= B_VALUE;                                 // (1/B) * ln(R/R0)
-  steinhart += 1.0 / (NOMINAL_TEMPERATURE + 273.15);    // 1/T0 + (1/B)*ln(R/R0)
-  steinhart = 1.0 / steinhart;                          // Temperatura w Kelvinach
-  float celsius = steinhart - 273.15;                   // Konwersja na °C
-  
-  return celsius;
+  // Model Beta sondy SONDA_NTC z tablicy constexpr (tablice_analogowe.h)
+  // Konfiguracja: VCC --- R_REF --- ADC_PIN --- NTC --- GND
+  return TablicaNTC::przelicz(raw);
 }
 
 int measureLDR(){
-  int raw = analogRead(PIN_LDR);
-  // zabezpieczenia przed skrajnymi wartościami ADC
-  raw = constrain(raw, 1, 4094);
+  OdczytAdc adc;
+  if (!AdcPobierz(ADC_LDR, &adc)) return -1;
 
-  // Referencyjny rezystor w dzielniku (dopasuj jeśli inny)
-  const float LDR_REF_R = 10000.0f;
+  // Model R = A * lux^-B z kalibracją do miernika wzorcowego, z tablicy
+  // constexpr sondy SONDA_LDR (tablice_analogowe.h); kody skrajne są
+  // ograniczane do 1..4094 przy generowaniu tablicy
+  float lux = TablicaLDR::przelicz(adc.kod);
+  if (!isfinite(lux) || lux < 0) lux = 0.0f;
+  return (int)roundf(lux);
+}
 
-  // Domyślne współczynniki kalibracyjne (A,B) dla modelu R = A * lux^-B
-  // Po kalibracji można je dopasować; wartości poniżej są przybliżone.
-  const float LDR_A = 150000.0f;
-  const float LDR_B = 0.7f;
+static bool nieaktualny(CzujnikKurnika czujnik, uint32_t teraz) {
+  return migawka.czas_ms[czujnik] == 0 || teraz - migawka.czas_ms[czujnik] >= MAX_WIEK_MS[czujnik];
+}
 
-  // Oblicz rezystancję LDR z dzielnika: Vnode = raw/4095*Vcc
-  // Rldr = Rref * Vnode / (Vcc - Vnode) => Rref * raw / (4095 - raw)
-  float Rldr = LDR_REF_R * (float)raw / (4095.0f - (float)raw);
+static void oznaczOdczyt(CzujnikKurnika czujnik) {
+  uint32_t teraz = millis();
+  migawka.czas_ms[czujnik] = teraz ? teraz : 1;
+  migawka.odczyty[czujnik]++;
+}
 
-  // Oblicz lux z odwróconego modelu: lux = (A / R)^(1/B)
-  float lux = powf(LDR_A / Rldr, 1.0f / LDR_B);
-  if (!isfinite(lux) || lux < 0) lux = 0.0f;
+void CzujnikiOdswiez(bool wszystkie) {
+  uint32_t teraz = millis();
+
+  // DHT22 odczytuje sterownik w loop() (dhtObsluga) - migawka kopiuje ostatnią
+  // ramkę, a nowa ramka trafia też do kompensacji wilgotności SGP30.
+  // Bez nowej ramki przez CZUJNIKI_MAX_WIEK_DHT_MS odczyt jest niepoprawny.
+  OdczytDHT dht;
+  dhtPobierz(&dht);
+  if (dht.poprawny && dht.czas_ms != migawka.czas_ms[CZUJNIK_DHT]) {
+    migawka.dht_temp = dht.temperatura;
+    migawka.dht_hum = dht.wilgotnosc;
+    migawka.dht_poprawny = true;
+    migawka.czas_ms[CZUJNIK_DHT] = dht.czas_ms;
+    migawka.odczyty[CZUJNIK_DHT]++;
+    SGPUstawWilgotnosc(dht.temperatura, dht.wilgotnosc);
+  } else if (!dht.poprawny || nieaktualny(CZUJNIK_DHT, teraz)) {
+    migawka.dht_temp = NAN;
+    migawka.dht_hum = NAN;
+    migawka.dht_poprawny = false;
+    SGPUstawWilgotnosc(0, 0);
+  }
+  if (wszystkie || nieaktualny(CZUJNIK_NTC, teraz)) {
+    migawka.ntc_temp = measureNTC();
+    oznaczOdczyt(CZUJNIK_NTC);
+  }
+  if (wszystkie || nieaktualny(CZUJNIK_LDR, teraz)) {
+    migawka.ldr = measureLDR();
+    oznaczOdczyt(CZUJNIK_LDR);
+  }
+  // SGP30 mierzy zadanie próbkowania - migawka kopiuje tylko nowy pomiar,
+  // a bez nowego pomiaru przez CZUJNIKI_MAX_WIEK_SGP_MS zgłasza -1
+  portENTER_CRITICAL(&blokadaSGP);
+  uint32_t czasSGP = sgpCzasPomiaru;
+  if (czasSGP != 0 && czasSGP != migawka.czas_ms[CZUJNIK_SGP]) {
+    migawka.eco2 = sgpECO2;
+    migawka.tvoc = sgpTVOC;
+    migawka.czas_ms[CZUJNIK_SGP] = czasSGP;
+    migawka.odczyty[CZUJNIK_SGP]++;
+  } else if (nieaktualny(CZUJNIK_SGP, teraz)) {
+    migawka.eco2 = -1;
+    migawka.tvoc = -1;
+  }
+  portEXIT_CRITICAL(&blokadaSGP);
+}
 
-  int ilux = (int)roundf(lux);
-  // --- Calibration to match reference meter ---
-  // Measured pairs from reference device -> device produced a linear mapping
-  // Solve for phone = a*device + b. Default values computed from samples:
-  const float CAL_A = 0.587444f; // slope
-  const float CAL_B = 22.2009f;  // offset
-  float corrected = CAL_A * (float)ilux + CAL_B;
-  if (!isfinite(corrected) || corrected < 0) corrected = 0.0f;
-  return (int)roundf(corrected);
+void CzujnikiPobierzMigawke(MigawkaCzujnikow* wynik) {
+  *wynik = migawka;
 }
 
 /*
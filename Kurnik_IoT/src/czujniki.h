@@ -3,29 +3,101 @@
 
 #include "main.h"
 #include <Adafruit_SGP30.h>
-#include <DHT.h>
-#include <NTC_Thermistor.h>
+#include "czujnik_dht.h"
 #include <cstdint>
 #include <cmath>
 
 #define PIN_DHT22 14
 #define PIN_NTC 33
 #define PIN_LDR 32
-#define DHTTYPE DHT22
 
-extern DHT dht22;
-extern NTC_Thermistor* ntcThermistor;
+// === PRÓBKOWANIE SGP30 ===
+// Algorytm IAQ czujnika wymaga pomiaru co 1 s, a po starcie bez zapisanej
+// bazy kalibruje się ok. 12 h. Osobne zadanie FreeRTOS wykonuje IAQmeasure
+// co SGP_OKRES_MS (z kompensacją wilgotności z ostatniego odczytu DHT22),
+// przywraca bazę z EEPROM i zapisuje ją co SGP_OKRES_ZAPISU_BAZY_S.
+
+#define SGP_OKRES_MS                 1000
+#define SGP_STOS                     3072
+#define SGP_PRIORYTET                1
+// Pierwszy zapis bazy bez przywróconej bazy - po 12 h pracy (zalecenie Sensirion)
+#define SGP_PIERWSZY_ZAPIS_BAZY_S    (12UL * 3600)
+#define SGP_OKRES_ZAPISU_BAZY_S      3600
+// Starsza baza jest odrzucana (czujnik był zbyt długo wyłączony)
+#define SGP_MAX_WIEK_BAZY_S          (7UL * 24 * 3600)
+
+// Statystyki próbkowania SGP30
+typedef struct {
+    bool aktywny;             // Zadanie próbkowania działa
+    bool baza_przywrocona;    // Baza wczytana z EEPROM po starcie
+    uint16_t baza_eco2;       // Ostatnio przywrócona lub zapisana baza
+    uint16_t baza_tvoc;
+    uint32_t pomiary;
+    uint32_t bledy;
+    uint32_t zapisy_bazy;
+} StatystykiSGP;
+
+// === MIGAWKA POMIARÓW ===
+// Czujniki są odczytywane tylko przez CzujnikiOdswiez() (task taskPomiary
+// co CZUJNIKI_OKRES_MS). Odczyt jest powtarzany, gdy poprzedni jest starszy
+// niż maksymalny wiek danego czujnika. DHT22, SGP30, NTC i LDR mierzą w tle
+// (sterownik dhtObsluga() w loop(), zadania sgp30 i adc) - migawka kopiuje
+// ich ostatni pomiar. Gdy DHT22 lub SGP30 nie dały nowego pomiaru przez
+// maksymalny wiek, migawka zgłasza brak odczytu (NAN / -1) zamiast
+// powtarzać starą wartość.
+// MQTT, OLED i diagnostyka czytają migawkę (CzujnikiPobierzMigawke) bez
+// dostępu do sprzętu.
+
+// Okres zadania odświeżającego migawkę (ms)
+#define CZUJNIKI_OKRES_MS          1000
+// Maksymalny wiek odczytu poszczególnych czujników (ms)
+#define CZUJNIKI_MAX_WIEK_DHT_MS   DHT_WAZNOSC_MS                // Jedna zgubiona ramka DHT22 (czujnik_dht.h)
+#define CZUJNIKI_MAX_WIEK_NTC_MS   1000
+#define CZUJNIKI_MAX_WIEK_LDR_MS   1000
+#define CZUJNIKI_MAX_WIEK_SGP_MS   (2 * SGP_OKRES_MS + 500)      // Jeden nieudany pomiar SGP30
+
+// Czujniki w migawce
+typedef enum {
+    CZUJNIK_DHT = 0,    // Temperatura i wilgotność (DHT22)
+    CZUJNIK_NTC,        // Temperatura (termistor NTC)
+    CZUJNIK_LDR,        // Natężenie światła (fotorezystor)
+    CZUJNIK_SGP,        // eCO2 i TVOC (SGP30)
+    CZUJNIK_LICZBA
+} CzujnikKurnika;
+
+// Ostatnie odczyty wszystkich czujników
+typedef struct {
+    float dht_temp;                     // NAN gdy brak ważnej ramki DHT22
+    float dht_hum;
+    bool dht_poprawny;                  // Ramka DHT22 młodsza niż CZUJNIKI_MAX_WIEK_DHT_MS
+    float ntc_temp;
+    int ldr;
+    int eco2;                           // -1 gdy brak pomiaru młodszego niż CZUJNIKI_MAX_WIEK_SGP_MS
+    int tvoc;
+    uint32_t czas_ms[CZUJNIK_LICZBA];   // millis() ostatniego odczytu (0 = brak odczytu)
+    uint32_t odczyty[CZUJNIK_LICZBA];   // Liczba odczytów sprzętu od startu
+} MigawkaCzujnikow;
 
 // CO2 Sensor - Oblicza bezwzględną wilgotność na podstawie temperatury i wilgotności względnej
 extern Adafruit_SGP30 sgp;
 
 void InicjalizacjaCzujnikow();
 uint32_t getAbsoluteHumidity(float temperature, float humidity);
-int odczytCO2(float temperature, float humidity);
-int odczytTVOC(float temperature, float humidity);
 
-float measureDHT22_Temp();
-float measureDHT22_Hum();
-float measureNTC();
-int measureLDR();
+// Przekazuje odczyt DHT22 do kompensacji wilgotności SGP30
+void SGPUstawWilgotnosc(float temperatura, float wilgotnosc);
+
+// Kopiuje statystyki próbkowania SGP30
+void SGPPobierzStatystyki(StatystykiSGP* statystyki);
+
+// Przeliczają ostatnią wartość próbkownika ADC - bez odczytu sprzętu
+float measureNTC();     // NAN gdy brak ważnego odczytu
+int measureLDR();       // -1 gdy brak ważnego odczytu
+
+// Odczytuje czujniki, których odczyt jest starszy niż ich maksymalny wiek
+// (wszystkie, gdy wszystkie = true). Callback taskPomiary.
+void CzujnikiOdswiez(bool wszystkie = false);
+
+// Kopiuje bieżącą migawkę - bez dostępu do sprzętu
+void CzujnikiPobierzMigawke(MigawkaCzujnikow* migawka);
 #endif
\ No newline at end of file
@@ -0,0 +1,240 @@
+/*
+ * dostarczanie_mqtt.cpp
+ *
+ * Tablica publikacji w locie (pojedynczych rekordów lub paczek) i otwarte
+ * paczki zbierające rekordy. Potwierdzenia PUBACK przychodzą w zadaniu
+ * AsyncTCP, więc trafiają najpierw do kolejki FreeRTOS, a tablicę zmienia
+ * wyłącznie zadanie uplinku (bez dodatkowych blokad).
+ */
+
+#include "dostarczanie_mqtt.h"
+#include "mqtt.h"
+#include "pamiec_SD.h"
+#include "symulator_ruchu.h"
+#include "uplink.h"
+#include <freertos/queue.h>
+
+typedef struct {
+    bool zajety;
+    uint16_t packetId;
+    uint8_t proby;
+    uint32_t czasWyslania;
+    char tresc[DOSTARCZANIE_MAX_PUBLIKACJA];   // Rekord lub rekordy paczki rozdzielone '\n'
+} PublikacjaWLocie;
+
+#if DOSTARCZANIE_PACZKI
+// Paczka zbierająca rekordy do publikacji
+typedef struct {
+    size_t dlugosc;
+    uint16_t rekordy;
+    uint32_t czasOtwarcia;
+    char tresc[DOSTARCZANIE_MAX_PACZKA];
+} OtwartaPaczka;
+
+// Ruch symulatora ma osobną paczkę - jego rekordy idą na topic symulacji
+enum { PACZKA_DANE = 0, PACZKA_SYMULACJA, PACZKA_LICZBA };
+static OtwartaPaczka otwarte[PACZKA_LICZBA];
+static char topicPaczki[64];
+#endif
+
+static PublikacjaWLocie wLocie[DOSTARCZANIE_W_LOCIE];
+static volatile uint32_t liczbaWLocie = 0;
+
+static QueueHandle_t kolejkaPotwierdzen = nullptr;
+static volatile uint32_t potwierdzone = 0;
+static volatile uint32_t ponowione = 0;
+static volatile uint32_t odlozone = 0;
+static volatile uint32_t paczki = 0;
+static volatile uint32_t rekordyPaczek = 0;
+static volatile uint32_t utraconePotwierdzenia = 0;
+
+static void zwolnij(PublikacjaWLocie& p) {
+    p.zajety = false;
+    liczbaWLocie--;
+}
+
+// Zapisuje każdy rekord publikacji na kartę SD (archiwum lub kolejka offline).
+// Rozdziela paczkę w miejscu - treść nie jest potem używana.
+static uint32_t zapiszRekordy(char* tresc, bool mqttSuccess) {
+    uint32_t n = 0;
+    char* rekord = tresc;
+    while (rekord != nullptr && *rekord != '\0') {
+        char* koniec = strchr(rekord, '\n');
+        if (koniec != nullptr) *koniec++ = '\0';
+        ZapiszDanePakiet(rekord, mqttSuccess);
+        n++;
+        rekord = koniec;
+    }
+    return n;
+}
+
+// Publikacja nie została potwierdzona - odłóż jej rekordy do kolejki offline.
+// Przy działającym połączeniu nie będzie ponownego połączenia, które zleciłoby
+// wysyłkę kolejki - zleć ją od razu, inaczej rekordy czekałyby do rozłączenia.
+static void odloz(char* tresc) {
+    odlozone += zapiszRekordy(tresc, false);
+    if (asyncMqttClient.connected()) ZlecPonowneWyslanie();
+}
+
+static const char* topicPublikacji(const char* tresc) {
+    const char* t = SymulatorTopicRekordu(tresc);
+#if DOSTARCZANIE_PACZKI
+    if (t == topic) {
+        snprintf(topicPaczki, sizeof(topicPaczki), "%s/paczka", topic);
+        return topicPaczki;
+    }
+#endif
+    return t;
+}
+
+static bool publikuj(PublikacjaWLocie& p) {
+    uint16_t packetId = PublikujMQTT(topicPublikacji(p.tresc), 1, false, p.tresc);
+    if (packetId == 0) return false;
+    p.packetId = packetId;
+    p.proby++;
+    p.czasWyslania = millis();
+    return true;
+}
+
+// Publikuje rekord lub paczkę i zajmuje miejsce w tablicy w locie
+static bool wyslij(char* tresc) {
+    if (!asyncMqttClient.connected()) {
+        odloz(tresc);
+        return false;
+    }
+
+    for (int i = 0; i < DOSTARCZANIE_W_LOCIE; i++) {
+        PublikacjaWLocie& p = wLocie[i];
+        if (p.zajety) continue;
+
+        strlcpy(p.tresc, tresc, sizeof(p.tresc));
+        p.proby = 0;
+        if (!publikuj(p)) {
+            odloz(tresc);
+            return false;
+        }
+        p.zajety = true;
+        liczbaWLocie++;
+        return true;
+    }
+
+    // Tablica pełna - broker nie nadąża z potwierdzeniami
+    odloz(tresc);
+    return false;
+}
+
+#if DOSTARCZANIE_PACZKI
+static void zamknijPaczke(OtwartaPaczka& o) {
+    if (o.rekordy == 0) return;
+    if (wyslij(o.tresc)) {
+        paczki++;
+        rekordyPaczek += o.rekordy;
+    }
+    o.dlugosc = 0;
+    o.rekordy = 0;
+    o.tresc[0] = '\0';
+}
+#endif
+
+void DostarczanieInicjalizacja() {
+    if (kolejkaPotwierdzen == nullptr) {
+        kolejkaPotwierdzen = xQueueCreate(MQTT_MAX_POTWIERDZEN, sizeof(uint16_t));
+    }
+}
+
+bool PublikujZPotwierdzeniem(const char* rekord) {
+#if DOSTARCZANIE_PACZKI
+    OtwartaPaczka& o = otwarte[SymulatorTopicRekordu(rekord) == topic ? PACZKA_DANE : PACZKA_SYMULACJA];
+    size_t dlugosc = strnlen(rekord, DOSTARCZANIE_MAX_REKORD - 1);
+
+    // Rekord nie zmieści się obok poprzednich - wyślij paczkę i zacznij nową
+    if (o.rekordy > 0 && o.dlugosc + 1 + dlugosc >= sizeof(o.tresc)) zamknijPaczke(o);
+    if (o.rekordy == 0) {
+        o.czasOtwarcia = millis();
+    } else {
+        o.tresc[o.dlugosc++] = '\n';
+    }
+    memcpy(o.tresc + o.dlugosc, rekord, dlugosc);
+    o.dlugosc += dlugosc;
+    o.tresc[o.dlugosc] = '\0';
+    o.rekordy++;
+    return true;
+#else
+    char tresc[DOSTARCZANIE_MAX_REKORD];
+    strlcpy(tresc, rekord, sizeof(tresc));
+    return wyslij(tresc);
+#endif
+}
+
+void DostarczanieObsluga() {
+#if DOSTARCZANIE_PACZKI
+    // 0. Paczki, których najstarszy rekord czeka już DOSTARCZANIE_OKNO_MS
+    for (int i = 0; i < PACZKA_LICZBA; i++) {
+        if (otwarte[i].rekordy > 0 && millis() - otwarte[i].czasOtwarcia >= DOSTARCZANIE_OKNO_MS) {
+            zamknijPaczke(otwarte[i]);
+        }
+    }
+#endif
+
+    // 1. Potwierdzenia PUBACK - rekordy dostarczone, zapisz do archiwum
+    uint16_t packetId;
+    while (kolejkaPotwierdzen && xQueueReceive(kolejkaPotwierdzen, &packetId, 0) == pdTRUE) {
+        for (int i = 0; i < DOSTARCZANIE_W_LOCIE; i++) {
+            PublikacjaWLocie& p = wLocie[i];
+            if (p.zajety && p.packetId == packetId) {
+                SymulatorZmierz(ETAP_POTWIERDZENIE, (millis() - p.czasWyslania) * 1000);
+                potwierdzone += zapiszRekordy(p.tresc, true);
+                zwolnij(p);
+                break;
+            }
+        }
+    }
+
+    if (liczbaWLocie == 0) return;
+
+    // 2. Rozłączenie - wszystko, co niepotwierdzone, trafia do kolejki offline
+    bool polaczony = asyncMqttClient.connected();
+    uint32_t teraz = millis();
+
+    for (int i = 0; i < DOSTARCZANIE_W_LOCIE; i++) {
+        PublikacjaWLocie& p = wLocie[i];
+        if (!p.zajety) continue;
+
+        if (!polaczony) {
+            odloz(p.tresc);
+            zwolnij(p);
+            continue;
+        }
+
+        // 3. Przekroczony czas PUBACK - ponów lub odłóż
+        if (teraz - p.czasWyslania > DOSTARCZANIE_TIMEOUT_MS) {
+            if (p.proby < DOSTARCZANIE_MAX_PROB && publikuj(p)) {
+                ponowione++;
+            } else {
+                odloz(p.tresc);
+                zwolnij(p);
+            }
+        }
+    }
+}
+
+void PotwierdzenieDostarczenia(uint16_t packetId) {
+    // Bez sprawdzania tablicy - PUBACK może wyprzedzić powrót z publish()
+    if (kolejkaPotwierdzen == nullptr) return;
+    // Nie blokuj zadania AsyncTCP - przy pojemności MQTT_MAX_POTWIERDZEN nie powinno się zdarzyć
+    if (xQueueSend(kolejkaPotwierdzen, &packetId, 0) != pdTRUE) utraconePotwierdzenia++;
+}
+
+bool DostarczanieOczekuje() {
+    return liczbaWLocie > 0;
+}
+
+void DostarczaniePobierzStatystyki(StatystykiDostarczania* statystyki) {
+    statystyki->w_locie = liczbaWLocie;
+    statystyki->potwierdzone = potwierdzone;
+    statystyki->ponowione = ponowione;
+    statystyki->odlozone = odlozone;
+    statystyki->paczki = paczki;
+    statystyki->rekordy_paczek = rekordyPaczek;
+    statystyki->utracone_potwierdzenia = utraconePotwierdzenia;
+}
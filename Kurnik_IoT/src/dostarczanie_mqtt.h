@@ -0,0 +1,100 @@
+/*
+ * MODUŁ POTWIERDZANEGO DOSTARCZANIA - dostarczanie_mqtt.h
+ *
+ * Publikacja bieżących pakietów czujników z QoS 1 i tablicą wiadomości
+ * w locie (klucz: packetId). Rekord trafia do archiwum (archiwum_SD.h) dopiero po
+ * potwierdzeniu PUBACK (onPublish). Rekordy bez potwierdzenia po
+ * DOSTARCZANIE_TIMEOUT_MS są publikowane ponownie, a po wyczerpaniu prób
+ * lub przy rozłączeniu MQTT - odkładane do kolejki offline (kolejka_SD.h).
+ * Odłożenie przy aktywnym połączeniu od razu zleca wysyłkę kolejki
+ * (ZlecPonowneWyslanie()), bez czekania na ponowne połączenie.
+ *
+ * Rekordy są łączone w paczki (DOSTARCZANIE_PACZKI): rekordy ze wszystkich
+ * węzłów trafiają do otwartej paczki, która jest publikowana jako jedna
+ * wiadomość na topicu "<topic>/paczka" (rekordy rozdzielone '\n'), gdy jej
+ * najstarszy rekord czeka DOSTARCZANIE_OKNO_MS lub kolejny rekord
+ * przekroczyłby DOSTARCZANIE_MAX_PACZKA bajtów. Potwierdzenie, ponowienie
+ * i odłożenie dotyczą całej paczki, a na kartę SD trafiają pojedyncze rekordy.
+ *
+ * Sam packetId != 0 oznacza tylko, że wiadomość trafiła do bufora TCP -
+ * przy zerwaniu połączenia mogła nigdy nie dotrzeć do brokera.
+ *
+ * Moduł jest używany wyłącznie z zadania uplinku.
+ */
+
+#ifndef DOSTARCZANIE_MQTT_H
+#define DOSTARCZANIE_MQTT_H
+
+#include "main.h"
+#include "kolejka_SD.h"
+
+// 1 = łącz rekordy w paczki na topicu "<topic>/paczka", 0 = rekord na publikację (główny topic)
+#define DOSTARCZANIE_PACZKI        1
+// Maksymalny czas oczekiwania rekordu w otwartej paczce (ms)
+#define DOSTARCZANIE_OKNO_MS       1000
+// Maksymalny rozmiar paczki w bajtach (z terminatorem)
+#define DOSTARCZANIE_MAX_PACZKA    1024
+// Czas oczekiwania na PUBACK (ms)
+#define DOSTARCZANIE_TIMEOUT_MS    10000
+// Liczba publikacji rekordu przed odłożeniem go do kolejki offline
+#define DOSTARCZANIE_MAX_PROB      2
+// Maksymalna długość rekordu (z terminatorem) - jak w kolejce offline, mieści rekord agregatu
+#define DOSTARCZANIE_MAX_REKORD    KOLEJKA_MAX_REKORD
+
+#if DOSTARCZANIE_PACZKI
+// Maksymalna liczba niepotwierdzonych publikacji (paczek)
+#define DOSTARCZANIE_W_LOCIE       8
+#define DOSTARCZANIE_MAX_PUBLIKACJA DOSTARCZANIE_MAX_PACZKA
+#else
+// Maksymalna liczba niepotwierdzonych publikacji bieżących pakietów
+#define DOSTARCZANIE_W_LOCIE       16
+#define DOSTARCZANIE_MAX_PUBLIKACJA DOSTARCZANIE_MAX_REKORD
+#endif
+
+// Statystyki dostarczania
+typedef struct {
+    uint32_t w_locie;         // Aktualnie niepotwierdzone publikacje
+    uint32_t potwierdzone;    // Rekordy potwierdzone przez broker
+    uint32_t ponowione;       // Ponowne publikacje po przekroczeniu czasu
+    uint32_t odlozone;        // Rekordy odłożone do kolejki offline
+    uint32_t paczki;          // Opublikowane paczki (bez ponowień)
+    uint32_t rekordy_paczek;  // Rekordy w opublikowanych paczkach
+    uint32_t utracone_potwierdzenia;  // PUBACK odrzucone przy pełnej kolejce potwierdzeń
+} StatystykiDostarczania;
+
+/*
+ * Tworzy kolejkę potwierdzeń. Wywoływana przez InicjalizacjaUplink().
+ */
+void DostarczanieInicjalizacja();
+
+/*
+ * Publikuje rekord z QoS 1 (lub dopisuje go do otwartej paczki) i zapamiętuje
+ * go do potwierdzenia. Gdy MQTT nie działa lub tablica jest pełna, rekord
+ * (albo cała paczka) trafia do kolejki offline.
+ * return: true jeśli rekord jest w locie lub w otwartej paczce
+ */
+bool PublikujZPotwierdzeniem(const char* rekord);
+
+/*
+ * Odbiera potwierdzenia, obsługuje przekroczenia czasu i rozłączenie,
+ * publikuje paczki, których okno minęło.
+ * Wywoływana w każdej iteracji pętli zadania uplinku.
+ */
+void DostarczanieObsluga();
+
+/*
+ * Przekazuje potwierdzenie PUBACK z callbacku onPublish (kontekst AsyncTCP).
+ */
+void PotwierdzenieDostarczenia(uint16_t packetId);
+
+/*
+ * return: true gdy są niepotwierdzone publikacje
+ */
+bool DostarczanieOczekuje();
+
+/*
+ * Kopiuje statystyki dostarczania.
+ */
+void DostarczaniePobierzStatystyki(StatystykiDostarczania* statystyki);
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * dyspozytor_mesh.cpp
+ *
+ * Tablica obsługi wiadomości mesh indeksowana skrótem tagu.
+ * Każdy slot przechowuje pełny tag, więc po wyznaczeniu slotu wystarczy
+ * jedno porównanie uint32_t, aby rozpoznać lub odrzucić wiadomość.
+ */
+
+#include "dyspozytor_mesh.h"
+#include <string.h>
+
+// Liczba slotów tablicy (potęga dwójki)
+static const int DYSPOZYTOR_BITY = 5;
+static const int DYSPOZYTOR_SLOTY = 1 << DYSPOZYTOR_BITY;
+
+typedef struct {
+    uint32_t tag;
+    ObslugaWiadomosciMesh obsluga;
+} SlotDyspozytora;
+
+static SlotDyspozytora tablica[DYSPOZYTOR_SLOTY];
+
+// Mieszanie multiplikatywne (Knuth) - górne bity iloczynu wybierają slot
+static inline uint32_t slotTagu(uint32_t tag) {
+    return (tag * 0x9E3779B1u) >> (32 - DYSPOZYTOR_BITY);
+}
+
+bool RejestrujObslugeMesh(uint32_t tag, ObslugaWiadomosciMesh obsluga) {
+    if (obsluga == nullptr) return false;
+    SlotDyspozytora& slot = tablica[slotTagu(tag)];
+    if (slot.obsluga != nullptr && slot.tag != tag) {
+        return false;  // Kolizja - zmień tag lub rozmiar tablicy
+    }
+    slot.tag = tag;
+    slot.obsluga = obsluga;
+    return true;
+}
+
+bool ObsluzWiadomoscMesh(uint32_t from, const char* msg, size_t dlugosc) {
+    if (dlugosc < 4) return false;
+
+    uint32_t tag;
+    memcpy(&tag, msg, sizeof(tag));   // Bufor String nie musi być wyrównany
+
+    const SlotDyspozytora& slot = tablica[slotTagu(tag)];
+    if (slot.obsluga == nullptr || slot.tag != tag) return false;
+
+    slot.obsluga(from, msg + 4, dlugosc - 4);
+    return true;
+}
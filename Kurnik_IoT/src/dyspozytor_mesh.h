@@ -0,0 +1,44 @@
+/*
+ * MODUŁ DYSPOZYTORA WIADOMOŚCI MESH - dyspozytor_mesh.h
+ *
+ * Kieruje wiadomości odebrane z sieci mesh do funkcji obsługi na podstawie
+ * 4-znakowego tagu na początku wiadomości ("DANE", "KURA", "RAMK", "TIME").
+ * Tag porównywany jest jako uint32_t w tablicy mieszającej z bezpośrednim
+ * adresowaniem - nieznany tag kosztuje jedno sprawdzenie, bez alokacji String.
+ */
+
+#ifndef DYSPOZYTOR_MESH_H
+#define DYSPOZYTOR_MESH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Funkcja obsługi wiadomości.
+ * parametr: from ID węzła nadawcy
+ * parametr: dane Wskaźnik na treść wiadomości ZA tagiem (bufor odebranej wiadomości, bez kopii)
+ * parametr: dlugosc Liczba bajtów treści za tagiem
+ */
+typedef void (*ObslugaWiadomosciMesh)(uint32_t from, const char* dane, size_t dlugosc);
+
+// Zamienia 4-znakowy tag na liczbę (kolejność bajtów jak w pamięci - little-endian)
+constexpr uint32_t TagMesh(const char (&t)[5]) {
+    return (uint32_t)(uint8_t)t[0]
+         | ((uint32_t)(uint8_t)t[1] << 8)
+         | ((uint32_t)(uint8_t)t[2] << 16)
+         | ((uint32_t)(uint8_t)t[3] << 24);
+}
+
+/*
+ * Rejestruje funkcję obsługi dla tagu.
+ * return: false gdy slot tablicy jest zajęty przez inny tag (kolizja) lub obsługa == nullptr
+ */
+bool RejestrujObslugeMesh(uint32_t tag, ObslugaWiadomosciMesh obsluga);
+
+/*
+ * Wywołuje obsługę zarejestrowaną dla tagu wiadomości.
+ * return: false gdy wiadomość jest krótsza niż tag lub tag jest nieznany
+ */
+bool ObsluzWiadomoscMesh(uint32_t from, const char* msg, size_t dlugosc);
+
+#endif
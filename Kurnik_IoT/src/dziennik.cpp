@@ -0,0 +1,87 @@
+/*
+ * dziennik.cpp
+ *
+ * Bufor typu RINGBUF_TYPE_NOSPLIT - każda linia jest osobnym elementem,
+ * więc zadanie dziennika wypisuje całe linie jednym Serial.write().
+ * Liczba odrzuconych linii jest zgłaszana, gdy bufor znów ma miejsce.
+ */
+
+#include "dziennik.h"
+#include <stdarg.h>
+#include <freertos/task.h>
+
+// Ten sam rdzeń co zadanie uplinku - pętla Arduino nie oddaje procesora
+static const BaseType_t DZIENNIK_RDZEN = (ARDUINO_RUNNING_CORE == 0) ? 1 : 0;
+
+static RingbufHandle_t bufor = nullptr;
+
+static volatile uint32_t linie = 0;
+static volatile uint32_t odrzucone = 0;
+static volatile uint32_t minWolne = DZIENNIK_BUFOR;
+
+static void zadanieDziennika(void* parametr) {
+    uint32_t zgloszoneOdrzucone = 0;
+
+    for (;;) {
+        size_t dlugosc = 0;
+        char* linia = (char*)xRingbufferReceive(bufor, &dlugosc, portMAX_DELAY);
+        if (linia == nullptr) continue;
+        Serial.write((const uint8_t*)linia, dlugosc);
+        vRingbufferReturnItem(bufor, linia);
+
+        uint32_t teraz = odrzucone;
+        if (teraz != zgloszoneOdrzucone) {
+            Serial.printf("[Dziennik] Pominięto %lu linii (pełny bufor)\n",
+                          (unsigned long)(teraz - zgloszoneOdrzucone));
+            zgloszoneOdrzucone = teraz;
+        }
+    }
+}
+
+void DziennikInicjalizacja() {
+    if (bufor != nullptr) return;
+
+    bufor = xRingbufferCreate(DZIENNIK_BUFOR, RINGBUF_TYPE_NOSPLIT);
+    if (bufor == nullptr) {
+        Serial.println("[Dziennik] BŁĄD: Nie udało się utworzyć bufora - logi bezpośrednio na Serial");
+        return;
+    }
+    if (xTaskCreatePinnedToCore(zadanieDziennika, "dziennik", DZIENNIK_STOS, nullptr,
+                                DZIENNIK_PRIORYTET, nullptr, DZIENNIK_RDZEN) != pdPASS) {
+        Serial.println("[Dziennik] BŁĄD: Nie udało się uruchomić zadania - logi bezpośrednio na Serial");
+        vRingbufferDelete(bufor);
+        bufor = nullptr;
+    }
+}
+
+void DziennikPisz(const char* format, ...) {
+    char linia[DZIENNIK_MAX_LINIA];
+    va_list argumenty;
+    va_start(argumenty, format);
+    int n = vsnprintf(linia, sizeof(linia) - 1, format, argumenty);
+    va_end(argumenty);
+    if (n < 0) return;
+    if ((size_t)n > sizeof(linia) - 2) n = sizeof(linia) - 2;   // Obcięta linia
+    linia[n++] = '\n';
+    linia[n] = '\0';
+
+    if (bufor == nullptr) {
+        Serial.write((const uint8_t*)linia, n);
+        return;
+    }
+
+    if (xRingbufferSend(bufor, linia, n, 0) != pdTRUE) {
+        odrzucone++;
+        return;
+    }
+    linie++;
+    uint32_t wolne = (uint32_t)xRingbufferGetCurFreeSize(bufor);
+    if (wolne < minWolne) minWolne = wolne;
+}
+
+void DziennikPobierzStatystyki(StatystykiDziennika* statystyki) {
+    statystyki->linie = linie;
+    statystyki->odrzucone = odrzucone;
+    statystyki->min_wolne = minWolne;
+    statystyki->rozmiar = DZIENNIK_BUFOR;
+}
@@ -0,0 +1,97 @@
+/*
+ * MODUŁ DZIENNIKA - dziennik.h
+ *
+ * Logi z poziomami filtrowanymi w czasie kompilacji. Poziom ustawia
+ * DZIENNIK_POZIOM (build_flags w platformio.ini) - makra poziomów powyżej
+ * niego kompilują się do pustej instrukcji, a ich argumenty nie są
+ * obliczane.
+ *
+ * Włączone logi nie piszą bezpośrednio na Serial (przy 115200 bodów linia
+ * to kilka milisekund). Sformatowana linia trafia do bufora pierścieniowego
+ * FreeRTOS w RAM, a na Serial wypisuje ją zadanie dziennika o najniższym
+ * priorytecie. Wstawienie nigdy nie czeka - gdy bufor jest pełny, linia
+ * jest pomijana i liczona jako odrzucona.
+ *
+ * Makra przyjmują format printf bez końcowego "\n" (dodawany automatycznie):
+ *   LOG_INFO("[Mesh] Nowy węzeł %u", id);
+ *
+ * Wyjście interaktywne (status, benchmark, raport symulacji) nadal idzie
+ * bezpośrednio na Serial.
+ */
+
+#ifndef DZIENNIK_H
+#define DZIENNIK_H
+
+#include "main.h"
+
+// Poziomy logów
+#define DZIENNIK_BRAK         0
+#define DZIENNIK_BLAD         1
+#define DZIENNIK_OSTRZEZENIE  2
+#define DZIENNIK_INFO         3
+#define DZIENNIK_DEBUG        4
+
+// Najwyższy kompilowany poziom
+#ifndef DZIENNIK_POZIOM
+#define DZIENNIK_POZIOM       DZIENNIK_INFO
+#endif
+
+// Rozmiar bufora pierścieniowego (bajty)
+#define DZIENNIK_BUFOR        4096
+// Maksymalna długość jednej linii (dłuższe są obcinane)
+#define DZIENNIK_MAX_LINIA    160
+// Zadanie wypisujące bufor na Serial (rdzeń bez pętli Arduino,
+// priorytet zadania bezczynności - działa tylko, gdy nic innego nie czeka)
+#define DZIENNIK_STOS         3072
+#define DZIENNIK_PRIORYTET    0
+
+#if DZIENNIK_POZIOM >= DZIENNIK_BLAD
+#define LOG_BLAD(...)         DziennikPisz(__VA_ARGS__)
+#else
+#define LOG_BLAD(...)         do {} while (0)
+#endif
+
+#if DZIENNIK_POZIOM >= DZIENNIK_OSTRZEZENIE
+#define LOG_OSTRZEZENIE(...)  DziennikPisz(__VA_ARGS__)
+#else
+#define LOG_OSTRZEZENIE(...)  do {} while (0)
+#endif
+
+#if DZIENNIK_POZIOM >= DZIENNIK_INFO
+#define LOG_INFO(...)         DziennikPisz(__VA_ARGS__)
+#else
+#define LOG_INFO(...)         do {} while (0)
+#endif
+
+#if DZIENNIK_POZIOM >= DZIENNIK_DEBUG
+#define LOG_DEBUG(...)        DziennikPisz(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...)        do {} while (0)
+#endif
+
+// Statystyki dziennika
+typedef struct {
+    uint32_t linie;           // Linie wstawione do bufora
+    uint32_t odrzucone;       // Linie pominięte (pełny bufor)
+    uint32_t min_wolne;       // Najmniej wolnego miejsca w buforze (bajty)
+    uint32_t rozmiar;         // Rozmiar bufora (bajty)
+} StatystykiDziennika;
+
+/*
+ * Tworzy bufor i zadanie dziennika. Do tego czasu (i gdy się nie uda)
+ * logi są wypisywane bezpośrednio na Serial.
+ */
+void DziennikInicjalizacja();
+
+/*
+ * Formatuje linię i wstawia ją do bufora bez czekania.
+ * Używana przez makra LOG_* - nie wywoływać z przerwań.
+ */
+void DziennikPisz(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+/*
+ * Kopiuje statystyki dziennika.
+ */
+void DziennikPobierzStatystyki(StatystykiDziennika* statystyki);
+
+#endif
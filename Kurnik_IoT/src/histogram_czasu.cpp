@@ -0,0 +1,54 @@
+/*
+ * histogram_czasu.cpp
+ *
+ * Kubełki 0..3 odpowiadają dokładnym wartościom, dalej dwa bity za
+ * najstarszym ustawionym bitem wybierają jeden z 4 kubełków oktawy.
+ */
+
+#include "histogram_czasu.h"
+#include <string.h>
+
+static int kubelek(uint32_t us) {
+    if (us < 4) return (int)us;
+    int potega = 31 - __builtin_clz(us);
+    int indeks = (potega - 1) * 4 + (int)((us >> (potega - 2)) & 3);
+    return (indeks < HISTOGRAM_KUBELKI) ? indeks : HISTOGRAM_KUBELKI - 1;
+}
+
+// Największa wartość należąca do kubełka
+static uint32_t gornaGranica(int indeks) {
+    if (indeks < 4) return (uint32_t)indeks;
+    int potega = indeks / 4 + 1;
+    return ((uint32_t)(5 + indeks % 4) << (potega - 2)) - 1;
+}
+
+void histogramWyczysc(HistogramCzasu* h) {
+    memset(h, 0, sizeof(*h));
+    h->min_us = UINT32_MAX;
+}
+
+void histogramDodaj(HistogramCzasu* h, uint32_t czas_us) {
+    h->kubelki[kubelek(czas_us)]++;
+    h->liczba++;
+    h->suma_us += czas_us;
+    if (czas_us < h->min_us) h->min_us = czas_us;
+    if (czas_us > h->max_us) h->max_us = czas_us;
+}
+
+uint32_t histogramPercentyl(const HistogramCzasu* h, uint32_t promile) {
+    if (h->liczba == 0) return 0;
+    uint32_t prog = (uint32_t)(((uint64_t)h->liczba * promile + 999) / 1000);
+    uint32_t suma = 0;
+    for (int i = 0; i < HISTOGRAM_KUBELKI; i++) {
+        suma += h->kubelki[i];
+        if (suma >= prog) {
+            uint32_t granica = gornaGranica(i);
+            return (granica < h->max_us) ? granica : h->max_us;
+        }
+    }
+    return h->max_us;
+}
+
+uint32_t histogramSrednia(const HistogramCzasu* h) {
+    return h->liczba ? (uint32_t)(h->suma_us / h->liczba) : 0;
+}
@@ -0,0 +1,47 @@
+/*
+ * MODUŁ HISTOGRAMU CZASU - histogram_czasu.h
+ *
+ * Histogram log-liniowy czasów w mikrosekundach: 4 kubełki na każdą potęgę
+ * dwójki (błąd percentyla do 25%), zakres do ~16 s. Stały rozmiar,
+ * bez alokacji i bez sortowania próbek - można go aktualizować w gorącej
+ * ścieżce. Używany przez symulator ruchu i profiler zadań.
+ */
+
+#ifndef HISTOGRAM_CZASU_H
+#define HISTOGRAM_CZASU_H
+
+#include <stdint.h>
+
+// Liczba kubełków histogramu
+#define HISTOGRAM_KUBELKI  96
+
+typedef struct {
+    uint32_t kubelki[HISTOGRAM_KUBELKI];
+    uint32_t liczba;
+    uint64_t suma_us;
+    uint32_t min_us;
+    uint32_t max_us;
+} HistogramCzasu;
+
+/*
+ * Zeruje histogram.
+ */
+void histogramWyczysc(HistogramCzasu* h);
+
+/*
+ * Dodaje jeden pomiar.
+ */
+void histogramDodaj(HistogramCzasu* h, uint32_t czas_us);
+
+/*
+ * Percentyl w promilach (500 = mediana, 990 = p99), ograniczony do max_us.
+ * return: 0 dla pustego histogramu
+ */
+uint32_t histogramPercentyl(const HistogramCzasu* h, uint32_t promile);
+
+/*
+ * return: średni czas (0 dla pustego histogramu)
+ */
+uint32_t histogramSrednia(const HistogramCzasu* h);
+
+#endif
@@ -0,0 +1,342 @@
+/*
+ * kolejka_SD.cpp
+ *
+ * Segmentowana kolejka offline z trwałym kursorem.
+ *
+ * Segmenty numerowane są rosnąco. Nowe rekordy trafiają do segmentu "głowy"
+ * (przez rejestrator_SD), odczyt odbywa się tylko z segmentów zamkniętych -
+ * gdy odczyt dogoni głowę, głowa jest zamykana i zapis przechodzi do nowego
+ * segmentu. Dzięki temu plik czytany nigdy nie jest równocześnie dopisywany.
+ *
+ * Kursor zapisywany jest co KOLEJKA_ZAPIS_KURSORA_CO rekordów oraz przy każdym
+ * usunięciu segmentu - po nagłym restarcie ponownie wysłanych zostanie
+ * najwyżej tyle rekordów (dostarczanie co najmniej raz).
+ *
+ * Błąd otwarcia lub odczytu segmentu nie jest traktowany jak koniec pliku -
+ * odczyt zatrzymuje się na bieżącej pozycji i jest ponawiany po
+ * KOLEJKA_PRZERWA_PO_BLEDZIE_MS, więc chwilowy problem z kartą nie usuwa
+ * niewysłanych rekordów.
+ */
+
+#include "kolejka_SD.h"
+#include "rejestrator_SD.h"
+#include "dziennik.h"
+#include "FS.h"
+#include "SD.h"
+
+#define SCIEZKA_KURSORA   KOLEJKA_KATALOG "/kursor.txt"
+#define SCIEZKA_STAREJ_KOLEJKI  "/transfer_waitlist.txt"
+
+static uint32_t glowa = 0;              // Segment zapisu (0 = kolejka niezainicjalizowana)
+static uint32_t rozmiarGlowy = 0;
+static PozycjaKolejki kursor = {0, 0};  // Pierwszy niepotwierdzony rekord
+static PozycjaKolejki odczyt = {0, 0};  // Następny rekord do odczytu
+static uint32_t niezapisaneZatwierdzenia = 0;
+static uint32_t bledyOdczytu = 0;
+static bool poBledzie = false;
+static uint32_t czasBledu = 0;           // millis() ostatniego błędu odczytu
+
+static File plikOdczytu;
+static uint32_t segmentOdczytu = 0;
+
+static void sciezkaSegmentu(uint32_t numer, char* bufor, size_t rozmiar) {
+    snprintf(bufor, rozmiar, KOLEJKA_KATALOG "/%08lu.txt", (unsigned long)numer);
+}
+
+static void zamknijOdczyt() {
+    if (segmentOdczytu != 0) {
+        plikOdczytu.close();
+        segmentOdczytu = 0;
+    }
+}
+
+static bool otworzDoOdczytu(uint32_t numer, uint32_t offset) {
+    if (segmentOdczytu == numer) return true;
+    zamknijOdczyt();
+
+    char sciezka[32];
+    sciezkaSegmentu(numer, sciezka, sizeof(sciezka));
+    plikOdczytu = SD.open(sciezka, FILE_READ);
+    if (!plikOdczytu) return false;
+    if (offset > plikOdczytu.size()) {
+        // Kursor za końcem pliku (np. utracona końcówka po zaniku zasilania) - segment jest już wysłany
+        LOG_OSTRZEZENIE("[Kolejka] Kursor %lu za końcem segmentu %s (%u B)",
+                        (unsigned long)offset, sciezka, (unsigned)plikOdczytu.size());
+        offset = plikOdczytu.size();
+    }
+    if (offset > 0 && !plikOdczytu.seek(offset)) {
+        plikOdczytu.close();
+        return false;
+    }
+    segmentOdczytu = numer;
+    return true;
+}
+
+// Zamyka bieżącą głowę - kolejne rekordy trafią do nowego segmentu
+static void zamknijGlowe() {
+    char sciezka[32];
+    glowa++;
+    rozmiarGlowy = 0;
+    sciezkaSegmentu(glowa, sciezka, sizeof(sciezka));
+    RejestratorUstawSciezke(REJESTR_KOLEJKA, sciezka);
+}
+
+// Wynik czytania jednej linii pliku
+typedef enum {
+    LINIA_OK = 0,
+    LINIA_KONIEC_PLIKU,       // Brak danych za pozycją (plik otwarty poprawnie)
+    LINIA_BLAD                // read() < 0 przed końcem pliku - błąd karty
+} WynikLinii;
+
+/*
+ * Czyta jedną linię (bez '\n' i '\r'). Zbyt długa linia jest obcinana,
+ * a jej reszta pomijana. read() zwraca -1 zarówno na końcu pliku, jak i przy
+ * błędzie karty - rozróżnia je available().
+ */
+static WynikLinii czytajLinie(File& plik, char* bufor, size_t rozmiar) {
+    size_t n = 0;
+    int znak = plik.read();
+    if (znak < 0) return plik.available() ? LINIA_BLAD : LINIA_KONIEC_PLIKU;
+
+    while (znak >= 0 && znak != '\n') {
+        if (znak != '\r' && n + 1 < rozmiar) bufor[n++] = (char)znak;
+        znak = plik.read();
+    }
+    bufor[n] = '\0';
+    // Linia przerwana w środku pliku - nie oddawaj obciętego rekordu
+    if (znak < 0 && plik.available()) return LINIA_BLAD;
+    return LINIA_OK;
+}
+
+static void zapiszKursor() {
+    File plik = SD.open(SCIEZKA_KURSORA, FILE_WRITE);
+    if (!plik) {
+        Serial.println("[Kolejka] Nie udało się zapisać kursora");
+        return;
+    }
+    plik.printf("%lu %lu\n", (unsigned long)kursor.segment, (unsigned long)kursor.offset);
+    plik.close();
+    niezapisaneZatwierdzenia = 0;
+}
+
+static bool wczytajKursor(PozycjaKolejki* pozycja) {
+    File plik = SD.open(SCIEZKA_KURSORA, FILE_READ);
+    if (!plik) return false;
+
+    char bufor[32];
+    bool ok = czytajLinie(plik, bufor, sizeof(bufor)) == LINIA_OK;
+    plik.close();
+
+    unsigned long segment, offset;
+    if (!ok || sscanf(bufor, "%lu %lu", &segment, &offset) != 2) return false;
+    pozycja->segment = segment;
+    pozycja->offset = offset;
+    return true;
+}
+
+void KolejkaInicjalizacja() {
+    if (!SD.exists(KOLEJKA_KATALOG) && !SD.mkdir(KOLEJKA_KATALOG)) {
+        Serial.println("[Kolejka] BŁĄD: Nie udało się utworzyć katalogu " KOLEJKA_KATALOG);
+        return;
+    }
+
+    // Znajdź najstarszy i najnowszy segment
+    uint32_t najstarszy = 0, najnowszy = 0;
+    File katalog = SD.open(KOLEJKA_KATALOG);
+    if (katalog) {
+        File plik = katalog.openNextFile();
+        while (plik) {
+            if (!plik.isDirectory()) {
+                // Zależnie od wersji rdzenia name() zwraca samą nazwę lub pełną ścieżkę
+                const char* nazwa = plik.name();
+                const char* ukosnik = strrchr(nazwa, '/');
+                if (ukosnik) nazwa = ukosnik + 1;
+
+                char* koniec;
+                unsigned long numer = strtoul(nazwa, &koniec, 10);
+                if (koniec != nazwa && strcmp(koniec, ".txt") == 0 && numer > 0) {
+                    if (najstarszy == 0 || numer < najstarszy) najstarszy = numer;
+                    if (numer > najnowszy) najnowszy = numer;
+                }
+            }
+            plik.close();
+            plik = katalog.openNextFile();
+        }
+        katalog.close();
+    }
+
+    // Migracja starej kolejki (jeden plik przepisywany w całości) do pierwszego segmentu
+    File stara = SD.open(SCIEZKA_STAREJ_KOLEJKI, FILE_READ);
+    if (stara) {
+        size_t rozmiar = stara.size();
+        stara.close();
+        char sciezka[32];
+        sciezkaSegmentu(1, sciezka, sizeof(sciezka));
+        if (rozmiar == 0) {
+            SD.remove(SCIEZKA_STAREJ_KOLEJKI);
+        } else if (najnowszy == 0 && SD.rename(SCIEZKA_STAREJ_KOLEJKI, sciezka)) {
+            Serial.printf("[Kolejka] Przeniesiono transfer_waitlist.txt (%u B) do %s\n", (unsigned)rozmiar, sciezka);
+            najstarszy = najnowszy = 1;
+            SD.remove(SCIEZKA_KURSORA);
+        } else {
+            Serial.println("[Kolejka] Pozostawiono transfer_waitlist.txt - kolejka segmentowa nie jest pusta");
+        }
+    }
+
+    glowa = najnowszy + 1;
+    rozmiarGlowy = 0;
+    uint32_t ogon = najstarszy ? najstarszy : glowa;
+
+    if (!wczytajKursor(&kursor) || kursor.segment < ogon || kursor.segment > glowa) {
+        kursor.segment = ogon;
+        kursor.offset = 0;
+    }
+    odczyt = kursor;
+
+    char sciezka[32];
+    sciezkaSegmentu(glowa, sciezka, sizeof(sciezka));
+    RejestratorUstawSciezke(REJESTR_KOLEJKA, sciezka);
+
+    Serial.printf("[Kolejka] Segmenty do wysłania: %lu (kursor: %lu:%lu, głowa: %lu)\n",
+                  (unsigned long)(glowa - kursor.segment), (unsigned long)kursor.segment,
+                  (unsigned long)kursor.offset, (unsigned long)glowa);
+}
+
+void KolejkaDopisz(const char* rekord) {
+    if (glowa == 0) return;
+    RejestratorZapisz(REJESTR_KOLEJKA, rekord);
+    rozmiarGlowy += strlen(rekord) + 1;
+    if (rozmiarGlowy >= KOLEJKA_ROZMIAR_SEGMENTU) {
+        zamknijGlowe();
+    }
+}
+
+// Odczyt doszedł do końca segmentu - przejdź do następnego
+static void nastepnySegment(uint32_t segment) {
+    zamknijOdczyt();
+    bool wszystkoZatwierdzone = (kursor.segment == segment && kursor.offset >= odczyt.offset);
+    odczyt.segment = segment + 1;
+    odczyt.offset = 0;
+    if (wszystkoZatwierdzone) KolejkaZatwierdz(&odczyt);
+}
+
+// Błąd karty - pozycja odczytu zostaje, plik zostanie otwarty ponownie przy następnej próbie
+static WynikOdczytuKolejki bladOdczytu(const char* operacja, uint32_t segment) {
+    zamknijOdczyt();
+    bledyOdczytu++;
+    poBledzie = true;
+    czasBledu = millis();
+    LOG_OSTRZEZENIE("[Kolejka] Błąd %s segmentu %lu (offset %lu) - ponowię za %d ms",
+                    operacja, (unsigned long)segment, (unsigned long)odczyt.offset,
+                    KOLEJKA_PRZERWA_PO_BLEDZIE_MS);
+    return KOLEJKA_ODCZYT_BLAD;
+}
+
+// Segmentu nie ma na karcie, choć katalog kolejki jest dostępny (np. rejestrator
+// nie mógł go utworzyć) - nie zawiera danych. Przy niedostępnej karcie oba
+// sprawdzenia zawodzą i segment nie jest pomijany.
+static bool segmentNieIstnieje(uint32_t numer) {
+    char sciezka[32];
+    sciezkaSegmentu(numer, sciezka, sizeof(sciezka));
+    return SD.exists(KOLEJKA_KATALOG) && !SD.exists(sciezka);
+}
+
+WynikOdczytuKolejki KolejkaOdczytaj(char* bufor, size_t rozmiar, PozycjaKolejki* pozycja) {
+    if (glowa == 0) return KOLEJKA_ODCZYT_PUSTA;
+    if (poBledzie) {
+        if (millis() - czasBledu < KOLEJKA_PRZERWA_PO_BLEDZIE_MS) return KOLEJKA_ODCZYT_BLAD;
+        poBledzie = false;
+    }
+
+    for (;;) {
+        if (odczyt.segment >= glowa) {
+            if (rozmiarGlowy == 0) return KOLEJKA_ODCZYT_PUSTA;
+            zamknijGlowe();                        // Odczyt dogonił zapis - zamknij segment
+        }
+
+        uint32_t segment = odczyt.segment;
+        if (!otworzDoOdczytu(segment, odczyt.offset)) {
+            if (!segmentNieIstnieje(segment)) return bladOdczytu("otwarcia", segment);
+            LOG_OSTRZEZENIE("[Kolejka] Brak pliku segmentu %lu - pomijam", (unsigned long)segment);
+            nastepnySegment(segment);
+            continue;
+        }
+
+        WynikLinii wynik = czytajLinie(plikOdczytu, bufor, rozmiar);
+        if (wynik == LINIA_BLAD) return bladOdczytu("odczytu", segment);
+        if (wynik == LINIA_KONIEC_PLIKU) {
+            nastepnySegment(segment);
+            continue;
+        }
+
+        odczyt.offset = plikOdczytu.position();
+        if (!plikOdczytu.available()) {
+            // Ostatni rekord segmentu - jego zatwierdzenie usunie cały segment
+            zamknijOdczyt();
+            odczyt.segment = segment + 1;
+            odczyt.offset = 0;
+        }
+        if (bufor[0] == '\0') continue;           // Pusta linia
+
+        *pozycja = odczyt;
+        return KOLEJKA_ODCZYT_REKORD;
+    }
+}
+
+void KolejkaZatwierdz(const PozycjaKolejki* pozycja) {
+    bool usunietoSegment = false;
+
+    // Segmenty przed pozycją są w całości wysłane - usuń pliki (bez przepisywania)
+    while (kursor.segment < pozycja->segment) {
+        char sciezka[32];
+        if (segmentOdczytu == kursor.segment) zamknijOdczyt();
+        sciezkaSegmentu(kursor.segment, sciezka, sizeof(sciezka));
+        SD.remove(sciezka);
+        kursor.segment++;
+        kursor.offset = 0;
+        usunietoSegment = true;
+    }
+    if (pozycja->offset > kursor.offset) kursor.offset = pozycja->offset;
+
+    if (usunietoSegment || ++niezapisaneZatwierdzenia >= KOLEJKA_ZAPIS_KURSORA_CO) {
+        zapiszKursor();
+    }
+}
+
+void KolejkaCofnij() {
+    zamknijOdczyt();
+    odczyt = kursor;
+}
+
+void KolejkaZapiszKursor() {
+    if (glowa == 0 || niezapisaneZatwierdzenia == 0) return;
+    zapiszKursor();
+}
+
+void KolejkaWyczysc() {
+    if (glowa == 0) return;
+    zamknijOdczyt();
+    RejestratorZamknijPlik(REJESTR_KOLEJKA);
+
+    for (uint32_t numer = kursor.segment; numer <= glowa; numer++) {
+        char sciezka[32];
+        sciezkaSegmentu(numer, sciezka, sizeof(sciezka));
+        if (SD.exists(sciezka)) SD.remove(sciezka);
+    }
+    SD.remove(SCIEZKA_KURSORA);
+    SD.rmdir(KOLEJKA_KATALOG);
+
+    glowa = 0;
+    rozmiarGlowy = 0;
+    kursor.segment = kursor.offset = 0;
+    odczyt = kursor;
+    Serial.println("[Kolejka] Kolejka offline wyczyszczona");
+}
+
+void KolejkaPobierzStatystyki(StatystykiKolejki* statystyki) {
+    statystyki->kursor = kursor;
+    statystyki->glowa = glowa;
+    statystyki->rozmiar_glowy = rozmiarGlowy;
+    statystyki->bledy_odczytu = bledyOdczytu;
+    statystyki->segmenty = (glowa - kursor.segment) + (rozmiarGlowy > 0 ? 1 : 0);
+}
@@ -0,0 +1,98 @@
+/*
+ * MODUŁ KOLEJKI OFFLINE - kolejka_SD.h
+ *
+ * Kolejka danych niewysłanych przez MQTT, przechowywana na karcie SD jako
+ * ciąg segmentów tylko do dopisywania (/kolejka/00000001.txt, ...).
+ * Postęp ponownej wysyłki zapisywany jest jako kursor (segment + offset)
+ * w /kolejka/kursor.txt, więc po zerwaniu połączenia wysyłka wznawia się
+ * dokładnie od pierwszego niepotwierdzonego rekordu, a w pełni wysłane
+ * segmenty są po prostu usuwane (bez przepisywania pliku).
+ *
+ * Moduł jest używany wyłącznie z zadania uplinku.
+ */
+
+#ifndef KOLEJKA_SD_H
+#define KOLEJKA_SD_H
+
+#include "main.h"
+
+// Katalog segmentów kolejki (podkatalog - InicjalizacjaSD() czyści tylko katalog główny)
+#define KOLEJKA_KATALOG           "/kolejka"
+// Rozmiar segmentu, po przekroczeniu którego rozpoczynany jest nowy (bajty)
+#define KOLEJKA_ROZMIAR_SEGMENTU  (64UL * 1024UL)
+// Co ile zatwierdzonych rekordów zapisywać kursor na kartę
+#define KOLEJKA_ZAPIS_KURSORA_CO  32
+// Maksymalna długość rekordu kolejki (z terminatorem)
+#define KOLEJKA_MAX_REKORD        256
+// Przerwa w odczycie po błędzie karty (ms) - potem odczyt jest ponawiany
+#define KOLEJKA_PRZERWA_PO_BLEDZIE_MS  1000
+
+// Pozycja w kolejce: numer segmentu i offset w pliku segmentu
+typedef struct {
+    uint32_t segment;
+    uint32_t offset;
+} PozycjaKolejki;
+
+// Wynik odczytu rekordu z kolejki
+typedef enum {
+    KOLEJKA_ODCZYT_REKORD = 0,    // Odczytano rekord
+    KOLEJKA_ODCZYT_PUSTA,         // Brak rekordów do wysłania
+    KOLEJKA_ODCZYT_BLAD           // Błąd otwarcia/odczytu segmentu - nic nie zatwierdzono, ponów później
+} WynikOdczytuKolejki;
+
+// Statystyki kolejki
+typedef struct {
+    uint32_t segmenty;            // Liczba segmentów z niewysłanymi danymi
+    PozycjaKolejki kursor;        // Pierwszy niepotwierdzony rekord
+    uint32_t glowa;               // Segment, do którego trafiają nowe rekordy
+    uint32_t rozmiar_glowy;       // Bajty zapisane w bieżącym segmencie
+    uint32_t bledy_odczytu;       // Nieudane otwarcia/odczyty segmentów (od startu)
+} StatystykiKolejki;
+
+/*
+ * Odtwarza stan kolejki z karty SD (segmenty + kursor).
+ * Przenosi dane ze starego pliku /transfer_waitlist.txt jako najstarszy segment.
+ * Wywoływana przez InicjalizacjaSD() po przygotowaniu rejestratora.
+ */
+void KolejkaInicjalizacja();
+
+/*
+ * Dopisuje rekord na koniec kolejki (przez buforowany rejestrator).
+ */
+void KolejkaDopisz(const char* rekord);
+
+/*
+ * Odczytuje następny rekord za pozycją odczytu (bez zatwierdzania).
+ * Do następnego segmentu odczyt przechodzi tylko po faktycznym końcu pliku -
+ * błąd karty zwraca KOLEJKA_ODCZYT_BLAD, a pozycja odczytu zostaje bez zmian.
+ * parametr: pozycja Pozycja ZA odczytanym rekordem - przekazywana do KolejkaZatwierdz()
+ */
+WynikOdczytuKolejki KolejkaOdczytaj(char* bufor, size_t rozmiar, PozycjaKolejki* pozycja);
+
+/*
+ * Zatwierdza wysłanie rekordów do podanej pozycji włącznie.
+ * W pełni wysłane segmenty są usuwane z karty.
+ */
+void KolejkaZatwierdz(const PozycjaKolejki* pozycja);
+
+/*
+ * Cofa pozycję odczytu do kursora (ponowna wysyłka niepotwierdzonych rekordów).
+ */
+void KolejkaCofnij();
+
+/*
+ * Zapisuje kursor na kartę SD (na końcu ponownej wysyłki).
+ */
+void KolejkaZapiszKursor();
+
+/*
+ * Usuwa wszystkie segmenty i kursor (pełny reset systemu).
+ */
+void KolejkaWyczysc();
+
+/*
+ * Kopiuje bieżące statystyki kolejki.
+ */
+void KolejkaPobierzStatystyki(StatystykiKolejki* statystyki);
+
+#endif
@@ -10,6 +10,7 @@
 
 #include "main.h"
 #include "kurnikwifi.h"
+#include "straznik_petli.h"
 
 // Bufory na dane dostępowe WiFi (eksportowane z pamiec_lokalna.cpp)
 char wifi_ssid[33] = "";      // SSID sieci WiFi (max 32 znaki + null terminator)
@@ -28,6 +29,7 @@ bool wifiConnected = false;   // Czy WiFi jest aktualnie połączone
  * Po pomyślnym połączeniu wyświetla adres IP urządzenia.
  */
 void PolaczZWiFi() {
+	OdcinekPetli odcinek("PolaczZWiFi");
 	Serial.print("Łączenie z WiFi: ");
 	Serial.println(wifi_ssid);
 
@@ -72,6 +74,7 @@ void PolaczZWiFi() {
  * i kontynuuje próby synchronizacji.
  */
 void UstawCzasZWiFi() {
+	OdcinekPetli odcinek("UstawCzasZWiFi");
 	// Sprawdź czy WiFi jest połączone
 	if (WiFi.status() != WL_CONNECTED) {
 		Serial.println("Brak połączenia WiFi - nie można ustawić czasu z NTP");
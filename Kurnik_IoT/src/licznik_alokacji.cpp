@@ -0,0 +1,188 @@
+/*
+ * licznik_alokacji.cpp
+ *
+ * Opakowania funkcji sterty (--wrap). Pomiar benchmarku kosztuje jedno
+ * porównanie wskaźnika poza pomiarem. Przypisanie do podsystemu szuka
+ * bieżącego zadania w małej tablicy (PAMIEC_MAX_ZADAN) - bez blokad,
+ * wpisy są tylko dodawane, nigdy usuwane.
+ */
+
+#include "licznik_alokacji.h"
+#include <freertos/task.h>
+
+extern "C" {
+void* __real_malloc(size_t rozmiar);
+void* __real_calloc(size_t liczba, size_t rozmiar);
+void* __real_realloc(void* wskaznik, size_t rozmiar);
+void __real_free(void* wskaznik);
+}
+
+static volatile TaskHandle_t mierzoneZadanie = nullptr;
+static volatile LicznikAlokacji licznik;
+
+// Bieżący podsystem zadania (zmieniany przez ZakresPodsystemu)
+typedef struct {
+    volatile TaskHandle_t zadanie;
+    volatile uint8_t podsystem;
+} PodsystemZadania;
+
+static PodsystemZadania zadania[PAMIEC_MAX_ZADAN];
+static volatile int liczbaZadan = 0;
+static portMUX_TYPE blokadaZadan = portMUX_INITIALIZER_UNLOCKED;
+
+static LicznikAlokacji podsystemy[PODSYSTEM_LICZBA];
+
+static const char* NAZWY_PODSYSTEMOW[PODSYSTEM_LICZBA] = {
+    "inne", "mesh", "mqtt", "sd", "oled", "tcp"
+};
+
+static inline bool mierzone() {
+    return mierzoneZadanie != nullptr && xTaskGetCurrentTaskHandle() == mierzoneZadanie;
+}
+
+static inline uint8_t biezacyPodsystem() {
+    int n = liczbaZadan;
+    if (n == 0) return PODSYSTEM_INNY;
+    TaskHandle_t biezace = xTaskGetCurrentTaskHandle();
+    for (int i = 0; i < n; i++) {
+        if (zadania[i].zadanie == biezace) return zadania[i].podsystem;
+    }
+    return PODSYSTEM_INNY;
+}
+
+static inline void zliczAlokacje(size_t rozmiar) {
+    if (mierzone()) {
+        licznik.alokacje++;
+        licznik.bajty += rozmiar;
+    }
+    LicznikAlokacji& p = podsystemy[biezacyPodsystem()];
+    __atomic_fetch_add(&p.alokacje, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&p.bajty, (uint32_t)rozmiar, __ATOMIC_RELAXED);
+}
+
+extern "C" void* __wrap_malloc(size_t rozmiar) {
+    zliczAlokacje(rozmiar);
+    return __real_malloc(rozmiar);
+}
+
+extern "C" void* __wrap_calloc(size_t liczba, size_t rozmiar) {
+    zliczAlokacje(liczba * rozmiar);
+    return __real_calloc(liczba, rozmiar);
+}
+
+extern "C" void* __wrap_realloc(void* wskaznik, size_t rozmiar) {
+    zliczAlokacje(rozmiar);
+    return __real_realloc(wskaznik, rozmiar);
+}
+
+extern "C" void __wrap_free(void* wskaznik) {
+    if (wskaznik != nullptr) {
+        if (mierzone()) {
+            licznik.zwolnienia++;
+        }
+        __atomic_fetch_add(&podsystemy[biezacyPodsystem()].zwolnienia, 1, __ATOMIC_RELAXED);
+    }
+    __real_free(wskaznik);
+}
+
+void LicznikAlokacjiStart() {
+    licznik.alokacje = 0;
+    licznik.zwolnienia = 0;
+    licznik.bajty = 0;
+    mierzoneZadanie = xTaskGetCurrentTaskHandle();
+}
+
+void LicznikAlokacjiStop(LicznikAlokacji* wynik) {
+    mierzoneZadanie = nullptr;
+    wynik->alokacje = licznik.alokacje;
+    wynik->zwolnienia = licznik.zwolnienia;
+    wynik->bajty = licznik.bajty;
+}
+
+// Wpis zadania w tablicy (tworzony przy pierwszym użyciu), -1 gdy brak miejsca
+static int wpisZadania(TaskHandle_t zadanie) {
+    for (int i = 0; i < liczbaZadan; i++) {
+        if (zadania[i].zadanie == zadanie) return i;
+    }
+
+    int wpis = -1;
+    portENTER_CRITICAL(&blokadaZadan);
+    for (int i = 0; i < liczbaZadan; i++) {
+        if (zadania[i].zadanie == zadanie) wpis = i;
+    }
+    if (wpis < 0 && liczbaZadan < PAMIEC_MAX_ZADAN) {
+        wpis = liczbaZadan;
+        zadania[wpis].podsystem = PODSYSTEM_INNY;
+        zadania[wpis].zadanie = zadanie;
+        liczbaZadan = wpis + 1;
+    }
+    portEXIT_CRITICAL(&blokadaZadan);
+    return wpis;
+}
+
+ZakresPodsystemu::ZakresPodsystemu(PodsystemPamieci podsystem) {
+    wpis = (int8_t)wpisZadania(xTaskGetCurrentTaskHandle());
+    if (wpis < 0) return;
+    poprzedni = zadania[wpis].podsystem;
+    zadania[wpis].podsystem = (uint8_t)podsystem;
+}
+
+ZakresPodsystemu::~ZakresPodsystemu() {
+    if (wpis >= 0) zadania[wpis].podsystem = poprzedni;
+}
+
+bool PamiecPrzypiszZadanie(const char* nazwaZadania, PodsystemPamieci podsystem) {
+    TaskHandle_t zadanie = xTaskGetHandle(nazwaZadania);
+    if (zadanie == nullptr) return false;
+
+    int wpis = wpisZadania(zadanie);
+    if (wpis < 0) {
+        Serial.printf("[Pamięć] Brak miejsca na przypisanie zadania %s\n", nazwaZadania);
+        return false;
+    }
+    zadania[wpis].podsystem = (uint8_t)podsystem;
+    return true;
+}
+
+void PamiecPobierzPodsystem(PodsystemPamieci podsystem, LicznikAlokacji* wynik) {
+    if (podsystem >= PODSYSTEM_LICZBA) return;
+    wynik->alokacje = __atomic_load_n(&podsystemy[podsystem].alokacje, __ATOMIC_RELAXED);
+    wynik->zwolnienia = __atomic_load_n(&podsystemy[podsystem].zwolnienia, __ATOMIC_RELAXED);
+    wynik->bajty = __atomic_load_n(&podsystemy[podsystem].bajty, __ATOMIC_RELAXED);
+}
+
+const char* PamiecNazwaPodsystemu(PodsystemPamieci podsystem) {
+    return (podsystem < PODSYSTEM_LICZBA) ? NAZWY_PODSYSTEMOW[podsystem] : "?";
+}
+
+void PamiecPobierzStatystyki(StatystykiSterty* statystyki) {
+    statystyki->rozmiar = ESP.getHeapSize();
+    statystyki->wolna = ESP.getFreeHeap();
+    statystyki->min_wolna = ESP.getMinFreeHeap();
+    statystyki->najwiekszy_blok = ESP.getMaxAllocHeap();
+    statystyki->fragmentacja = statystyki->wolna
+        ? (uint8_t)(100 - (uint64_t)statystyki->najwiekszy_blok * 100 / statystyki->wolna)
+        : 0;
+}
+
+size_t PamiecFormatujJSON(char* bufor, size_t rozmiar) {
+    StatystykiSterty s;
+    PamiecPobierzStatystyki(&s);
+
+    size_t n = (size_t)snprintf(bufor, rozmiar,
+                                "{\"wolna\":%lu,\"min_wolna\":%lu,\"najwiekszy_blok\":%lu,"
+                                "\"fragmentacja\":%u,\"podsystemy\":{",
+                                (unsigned long)s.wolna, (unsigned long)s.min_wolna,
+                                (unsigned long)s.najwiekszy_blok, (unsigned)s.fragmentacja);
+
+    for (int i = 0; i < PODSYSTEM_LICZBA && n < rozmiar; i++) {
+        LicznikAlokacji l;
+        PamiecPobierzPodsystem((PodsystemPamieci)i, &l);
+        n += (size_t)snprintf(bufor + n, rozmiar - n, "%s\"%s\":{\"alokacje\":%lu,\"zwolnienia\":%lu,\"bajty\":%lu}",
+                              i ? "," : "", NAZWY_PODSYSTEMOW[i], (unsigned long)l.alokacje,
+                              (unsigned long)l.zwolnienia, (unsigned long)l.bajty);
+    }
+    if (n + 3 > rozmiar) return 0;
+    strcpy(bufor + n, "}}");
+    return n + 2;
+}
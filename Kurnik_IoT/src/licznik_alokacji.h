@@ -0,0 +1,107 @@
+/*
+ * MODUŁ LICZNIKA ALOKACJI - licznik_alokacji.h
+ *
+ * Zlicza wywołania malloc/calloc/realloc/free. Funkcje sterty są opakowane
+ * przez linker (-Wl,--wrap=malloc ... w platformio.ini), więc liczone są
+ * także alokacje z bibliotek (String, operator new, snprintf z %f).
+ *
+ * Dwa tryby:
+ * - pomiar jednego zadania FreeRTOS (LicznikAlokacjiStart/Stop) - benchmark,
+ * - stałe przypisanie alokacji do podsystemów (mesh, MQTT, SD, OLED).
+ *   Podsystem wybiera obiekt ZakresPodsystemu na czas wywołania (zakresy
+ *   mogą się zagnieżdżać, obowiązuje najbardziej wewnętrzny) albo domyślny
+ *   podsystem zadania (PamiecPrzypiszZadanie). Stan jest trzymany osobno
+ *   dla każdego zadania, więc wywłaszczenie nie miesza podsystemów.
+ *
+ * Liczniki podsystemów rosną od startu - odbiorca metryk liczy przyrosty.
+ * Zwolnienia są przypisywane do podsystemu, który zwalnia blok, a nie do
+ * tego, który go zaalokował.
+ */
+
+#ifndef LICZNIK_ALOKACJI_H
+#define LICZNIK_ALOKACJI_H
+
+#include "main.h"
+
+// Maksymalna liczba zadań FreeRTOS z przypisanym podsystemem
+#define PAMIEC_MAX_ZADAN  8
+
+// Liczniki alokacji zadania
+typedef struct {
+    uint32_t alokacje;      // malloc + calloc + realloc
+    uint32_t zwolnienia;    // free
+    uint32_t bajty;         // Łączny rozmiar żądanych bloków
+} LicznikAlokacji;
+
+// Podsystemy, do których przypisywane są alokacje
+typedef enum {
+    PODSYSTEM_INNY = 0,     // Pozostałe zadania i kod bez zakresu (setup, komendy Serial)
+    PODSYSTEM_MESH,         // mesh.update(), callbacki mesh, zadania schedulera
+    PODSYSTEM_MQTT,         // PublikujMQTT
+    PODSYSTEM_SD,           // Archiwum, kolejka offline, rejestrator
+    PODSYSTEM_OLED,         // Odświeżanie ekranu
+    PODSYSTEM_TCP,          // Zadanie async_tcp (wspólne dla mesh i MQTT)
+    PODSYSTEM_LICZBA
+} PodsystemPamieci;
+
+// Stan sterty
+typedef struct {
+    uint32_t rozmiar;           // Całkowity rozmiar sterty
+    uint32_t wolna;
+    uint32_t min_wolna;         // Najmniej wolnej pamięci od startu
+    uint32_t najwiekszy_blok;   // Największy blok możliwy do zaalokowania
+    uint8_t fragmentacja;       // 100 - najwiekszy_blok / wolna (%)
+} StatystykiSterty;
+
+/*
+ * Zeruje liczniki i zaczyna liczyć alokacje bieżącego zadania.
+ */
+void LicznikAlokacjiStart();
+
+/*
+ * Kończy liczenie i kopiuje liczniki.
+ */
+void LicznikAlokacjiStop(LicznikAlokacji* wynik);
+
+/*
+ * Przypisuje alokacje bieżącego zadania do podsystemu do końca bloku:
+ *   { ZakresPodsystemu zakres(PODSYSTEM_SD); ... }
+ */
+class ZakresPodsystemu {
+public:
+    explicit ZakresPodsystemu(PodsystemPamieci podsystem);
+    ~ZakresPodsystemu();
+private:
+    uint8_t poprzedni;
+    int8_t wpis;
+};
+
+/*
+ * Ustawia domyślny podsystem zadania o podanej nazwie (np. "async_tcp").
+ * return: false, jeśli zadanie jeszcze nie istnieje lub brak miejsca w tablicy
+ */
+bool PamiecPrzypiszZadanie(const char* nazwaZadania, PodsystemPamieci podsystem);
+
+/*
+ * Kopiuje liczniki podsystemu (od startu).
+ */
+void PamiecPobierzPodsystem(PodsystemPamieci podsystem, LicznikAlokacji* wynik);
+
+/*
+ * return: nazwa podsystemu ("mesh", "mqtt", ...)
+ */
+const char* PamiecNazwaPodsystemu(PodsystemPamieci podsystem);
+
+/*
+ * Odczytuje bieżący stan sterty.
+ */
+void PamiecPobierzStatystyki(StatystykiSterty* statystyki);
+
+/*
+ * Zapisuje stan sterty i liczniki podsystemów jako obiekt JSON
+ * (do metryk publikowanych przez profiler_zadan).
+ * return: długość tekstu, 0 gdy nie mieści się w buforze
+ */
+size_t PamiecFormatujJSON(char* bufor, size_t rozmiar);
+
+#endif
@@ -5,8 +5,21 @@
 #include "mqtt.h"
 #include "pamiec_SD.h"
 #include "czujniki.h"
+#include "probkownik_adc.h"
 #include "mesh_local.h"
 #include "oled.h"
+#include "uplink.h"
+#include "rejestrator_SD.h"
+#include "kolejka_SD.h"
+#include "archiwum_SD.h"
+#include "ponowna_wysylka.h"
+#include "dostarczanie_mqtt.h"
+#include "symulator_ruchu.h"
+#include "benchmark_kodekow.h"
+#include "profiler_zadan.h"
+#include "licznik_alokacji.h"
+#include "straznik_petli.h"
+#include "dziennik.h"
 
 // Bufor komend z Serial
 String serialCommandBuffer = "";
@@ -32,6 +45,8 @@ static int currentScreen = 0;
 
 void setup() {
     Serial.begin(115200);
+    // Bufor logów i zadanie wypisujące je na Serial (dziennik.h)
+    DziennikInicjalizacja();
 
     // Inicjalizacja OLED
     if (!oled.begin()) {
@@ -56,6 +71,9 @@ void setup() {
     InicjalizacjaPamieci();
     InicjalizacjaSD();
 
+    // Zadanie uplinku (MQTT + SD) na drugim rdzeniu - od teraz jedyny użytkownik karty SD
+    InicjalizacjaUplink();
+
     oled.showBootScreen("KURNIK", "Inicjalizacja pamieci", 30);
 
     // Próba wczytania zapisanych danych WiFi z EEPROM
@@ -91,9 +109,9 @@ void setup() {
         // Aktualizuj OLED, aby pokazać zakończenie inicjalizacji
         oled.showBootScreen("KURNIK", "Gotowe", 100);
 		if (asyncMqttClient.connected()) {
-			asyncMqttClient.publish(topic, 0, false, "Wiadomosc inicjujaca");
-            // Wyślij dane oczekujące w kolejce na karcie SD
-			PonowWyslijZKolejki();
+			PublikujMQTT(topic, 0, false, "Wiadomosc inicjujaca");
+            // Wyślij dane oczekujące w kolejce na karcie SD (w zadaniu uplinku)
+			ZlecPonowneWyslanie();
 		}
 
     } else {
@@ -115,9 +133,9 @@ void setup() {
             InicjalizacjaTopicuZ_MAC();
             PolaczDoMQTT();
             delay(1000);
-            // Wyślij dane oczekujące w kolejce
+            // Wyślij dane oczekujące w kolejce (w zadaniu uplinku)
             if (asyncMqttClient.connected()) {
-                PonowWyslijZKolejki();
+                ZlecPonowneWyslanie();
             }
         }
         
@@ -145,8 +163,9 @@ void resetKurnik() {
     // Wyczyść pamięć EEPROM
     ResetPamiec();
     
-    // Wyczyść całą kartę SD ze wszystkich plików
-    WyczyscKarteSD();
+    // Wyczyść całą kartę SD ze wszystkich plików - w zadaniu uplinku,
+    // które jest jedynym użytkownikiem karty w czasie pracy
+    WyczyscKarteWUplinku();
 
     // Zerowanie zmiennych globalnych
     wifiConfigured = false;
@@ -203,10 +222,150 @@ void wyswietlStatusSystemu() {
     
     // Synchronizacja NTP jest zarządzana przez scheduler (co 1 godzinę)
     
+    // Migawka czujników (wiek odczytu w ms)
+    MigawkaCzujnikow czujniki;
+    CzujnikiPobierzMigawke(&czujniki);
+    uint32_t teraz = millis();
+    Serial.printf("Czujniki: DHT %.1f C %.1f %% (%lu ms), NTC %.1f C (%lu ms), LDR %d (%lu ms), eCO2 %d TVOC %d (%lu ms)\n",
+                  czujniki.dht_temp, czujniki.dht_hum, (unsigned long)(teraz - czujniki.czas_ms[CZUJNIK_DHT]),
+                  czujniki.ntc_temp, (unsigned long)(teraz - czujniki.czas_ms[CZUJNIK_NTC]),
+                  czujniki.ldr, (unsigned long)(teraz - czujniki.czas_ms[CZUJNIK_LDR]),
+                  czujniki.eco2, czujniki.tvoc, (unsigned long)(teraz - czujniki.czas_ms[CZUJNIK_SGP]));
+    StatystykiDHT dht;
+    dhtPobierzStatystyki(&dht);
+    Serial.printf("DHT22: %s, ramki: %lu, poprawne: %lu, błędy czasu/sumy/startu: %lu/%lu/%lu\n",
+                  czujniki.dht_poprawny ? "OK" : "brak ważnego odczytu", (unsigned long)dht.ramki,
+                  (unsigned long)dht.poprawne, (unsigned long)dht.bledy_czasu,
+                  (unsigned long)dht.bledy_sumy, (unsigned long)dht.bledy_startu);
+    StatystykiAdc adc;
+    AdcPobierzStatystyki(&adc);
+    OdczytAdc adcNTC, adcLDR;
+    AdcPobierz(ADC_NTC, &adcNTC);
+    AdcPobierz(ADC_LDR, &adcLDR);
+    Serial.printf("ADC (DMA): %s, kalibracja: %s, NTC %u mV (kod %u), LDR %u mV (kod %u), serie: %lu, pominięte: %lu, błędy: %lu\n",
+                  adc.aktywny ? "aktywny" : "brak", adc.kalibracja ? adc.kalibracja : "-",
+                  adcNTC.mv, adcNTC.kod, adcLDR.mv, adcLDR.kod, (unsigned long)adc.serie,
+                  (unsigned long)adc.pominiete, (unsigned long)adc.bledy);
+    StatystykiSGP sgp30;
+    SGPPobierzStatystyki(&sgp30);
+    Serial.printf("SGP30: %s, pomiary: %lu, błędy: %lu, baza eCO2/TVOC: 0x%04X/0x%04X (%s, zapisy: %lu)\n",
+                  sgp30.aktywny ? "aktywny" : "brak", (unsigned long)sgp30.pomiary, (unsigned long)sgp30.bledy,
+                  sgp30.baza_eco2, sgp30.baza_tvoc, sgp30.baza_przywrocona ? "przywrócona" : "nowa",
+                  (unsigned long)sgp30.zapisy_bazy);
+
     // Pamięć
-    Serial.print("Wolna RAM: ");
-    Serial.print(ESP.getFreeHeap());
-    Serial.println(" bajtów");
+    StatystykiSterty sterta;
+    PamiecPobierzStatystyki(&sterta);
+    Serial.printf("Wolna RAM: %lu/%lu bajtów (min: %lu, największy blok: %lu, fragmentacja: %u%%)\n",
+                  (unsigned long)sterta.wolna, (unsigned long)sterta.rozmiar, (unsigned long)sterta.min_wolna,
+                  (unsigned long)sterta.najwiekszy_blok, (unsigned)sterta.fragmentacja);
+    Serial.println("Alokacje od startu (podsystem: alokacje/zwolnienia, bajty):");
+    for (int i = 0; i < PODSYSTEM_LICZBA; i++) {
+        LicznikAlokacji alokacje;
+        PamiecPobierzPodsystem((PodsystemPamieci)i, &alokacje);
+        Serial.printf("  %-5s %lu/%lu, %lu B\n", PamiecNazwaPodsystemu((PodsystemPamieci)i),
+                      (unsigned long)alokacje.alokacje, (unsigned long)alokacje.zwolnienia,
+                      (unsigned long)alokacje.bajty);
+    }
+    
+    // Kolejka uplinku (mesh -> MQTT/SD)
+    StatystykiUplinku uplink;
+    PobierzStatystykiUplinku(&uplink);
+    Serial.printf("Kolejka uplinku: %u/%u (max: %u, odrzucone: %u, wysłane: %u)\n",
+                  uplink.glebokosc, uplink.pojemnosc, uplink.max_glebokosc,
+                  uplink.odrzucone, uplink.przetworzone);
+    Serial.printf("Pas bieżący: %lu/s (wiek w kolejce: %lu ms, max: %lu ms)\n",
+                  (unsigned long)uplink.biezace_na_s, (unsigned long)uplink.wiek_ms,
+                  (unsigned long)uplink.max_wiek_ms);
+
+    // Kolejka offline na karcie SD
+    StatystykiKolejki kolejka;
+    KolejkaPobierzStatystyki(&kolejka);
+    Serial.printf("Kolejka offline: %lu segmentów (kursor: %lu:%lu, głowa: %lu, %lu B, błędy odczytu: %lu)\n",
+                  (unsigned long)kolejka.segmenty, (unsigned long)kolejka.kursor.segment,
+                  (unsigned long)kolejka.kursor.offset, (unsigned long)kolejka.glowa,
+                  (unsigned long)kolejka.rozmiar_glowy, (unsigned long)kolejka.bledy_odczytu);
+    
+    // Potwierdzone dostarczanie bieżących pakietów (QoS 1)
+    StatystykiDostarczania dostarczanie;
+    DostarczaniePobierzStatystyki(&dostarczanie);
+    Serial.printf("MQTT QoS1: w locie: %lu, potwierdzone: %lu, ponowione: %lu, odłożone do kolejki: %lu, utracone PUBACK: %lu\n",
+                  (unsigned long)dostarczanie.w_locie, (unsigned long)dostarczanie.potwierdzone,
+                  (unsigned long)dostarczanie.ponowione, (unsigned long)dostarczanie.odlozone,
+                  (unsigned long)dostarczanie.utracone_potwierdzenia);
+#if DOSTARCZANIE_PACZKI
+    Serial.printf("Paczki MQTT: %lu, rekordów: %lu (średnio %.1f na paczkę, okno %d ms, max %d B)\n",
+                  (unsigned long)dostarczanie.paczki, (unsigned long)dostarczanie.rekordy_paczek,
+                  dostarczanie.paczki ? (float)dostarczanie.rekordy_paczek / dostarczanie.paczki : 0.0f,
+                  DOSTARCZANIE_OKNO_MS, DOSTARCZANIE_MAX_PACZKA);
+#endif
+    
+    StatystykiPonownejWysylki ponowna;
+    PonownaWysylkaPobierzStatystyki(&ponowna);
+    Serial.printf("Ponowna wysyłka: %s (w oknie: %lu, potwierdzone: %lu, ponowienia: %lu, przerwania: %lu, utracone PUBACK: %lu)\n",
+                  ponowna.aktywna ? "aktywna" : "nieaktywna", (unsigned long)ponowna.w_locie,
+                  (unsigned long)ponowna.potwierdzone, (unsigned long)ponowna.ponowienia,
+                  (unsigned long)ponowna.przerwania, (unsigned long)ponowna.utracone_potwierdzenia);
+    Serial.printf("Pas zaległy: %lu/s (wiek ostatniego rekordu: %ld s)\n",
+                  (unsigned long)uplink.zalegle_na_s, (long)ponowna.wiek_s);
+    
+    // Archiwum na karcie SD
+    StatystykiArchiwum archiwum;
+    ArchiwumPobierzStatystyki(&archiwum);
+    Serial.printf("Archiwum: segmenty %lu..%lu (bieżący: %lu B, usunięte: %lu, wolne: %lu MB)\n",
+                  (unsigned long)archiwum.najstarszy, (unsigned long)archiwum.biezacy,
+                  (unsigned long)archiwum.rozmiar_biezacego, (unsigned long)archiwum.usuniete,
+                  (unsigned long)archiwum.wolne_mb);
+    if (archiwum.bajty_blokow > 0) {
+        Serial.printf("Kodek archiwum: %lu rekordów, CSV %lu B -> bloki %lu B (%.1fx)\n",
+                      (unsigned long)archiwum.rekordy, (unsigned long)archiwum.bajty_rekordow,
+                      (unsigned long)archiwum.bajty_blokow,
+                      (float)archiwum.bajty_rekordow / archiwum.bajty_blokow);
+    }
+    
+    // Rejestrator SD (opóźnienie i średni rozmiar zapisu na kartę)
+    const char* nazwyRejestrow[REJESTR_LICZBA] = {"archiwum", "kolejka"};
+    for (int i = 0; i < REJESTR_LICZBA; i++) {
+        StatystykiRejestratora rej;
+        RejestratorPobierzStatystyki((KanalRejestratora)i, &rej);
+        Serial.printf("SD %s: %u rekordów, %u zapisów, %u B/zapis, opóźnienie śr./max: %u/%u us, błędy: %u\n",
+                      nazwyRejestrow[i], rej.rekordy, rej.zrzuty,
+                      rej.zrzuty ? rej.bajty / rej.zrzuty : 0,
+                      rej.zrzuty ? (uint32_t)(rej.suma_opoznien_us / rej.zrzuty) : 0,
+                      rej.max_opoznienie_us, rej.bledy);
+    }
+
+    // Czas wykonania zadań schedulera (bieżące okno metryk)
+    Serial.println("Zadania schedulera (okno metryk): wywołania, min/śr/max/p99 us, przekroczenia, max od startu");
+    for (int i = 0; i < ZADANIE_LICZBA; i++) {
+        StatystykiZadania zad;
+        ProfilerPobierzStatystyki((ZadanieSchedulera)i, &zad);
+        Serial.printf("  %-10s %5lu  %lu/%lu/%lu/%lu  %lu  %lu\n", zad.nazwa, (unsigned long)zad.wywolania,
+                      (unsigned long)zad.min_us, (unsigned long)zad.sr_us, (unsigned long)zad.max_us,
+                      (unsigned long)zad.p99_us, (unsigned long)zad.przekroczenia,
+                      (unsigned long)zad.max_us_calkowity);
+    }
+    
+    // Dziennik (bufor logów wypisywany w tle)
+    StatystykiDziennika dziennik;
+    DziennikPobierzStatystyki(&dziennik);
+    Serial.printf("Dziennik: poziom %d, %lu linii, pominięte: %lu, min. wolne: %lu/%lu B\n",
+                  DZIENNIK_POZIOM, (unsigned long)dziennik.linie, (unsigned long)dziennik.odrzucone,
+                  (unsigned long)dziennik.min_wolne, (unsigned long)dziennik.rozmiar);
+
+    // Przerwy między wywołaniami mesh.update() (bieżące okno metryk)
+    StatystykiPetli petla;
+    StraznikPetliPobierzStatystyki(&petla);
+    Serial.printf("Pętla mesh: %lu przerw, p50/p99/max: %lu/%lu/%lu us, przestoje > %d ms: %lu (od startu: %lu, max: %lu ms)\n",
+                  (unsigned long)petla.przerwy, (unsigned long)petla.p50_us, (unsigned long)petla.p99_us,
+                  (unsigned long)petla.max_us, STRAZNIK_PROG_US / 1000, (unsigned long)petla.przestoje,
+                  (unsigned long)petla.przestoje_calkowite, (unsigned long)(petla.max_us_calkowity / 1000));
+    PrzestojPetli przestoj;
+    for (int i = 0; StraznikPetliPobierzPrzestoj(i, &przestoj); i++) {
+        Serial.printf("  -%lu s: %lu ms (najdłużej: %s, %lu ms)\n",
+                      (unsigned long)((millis() - przestoj.czas_ms) / 1000), (unsigned long)(przestoj.trwanie_us / 1000),
+                      przestoj.etykieta, (unsigned long)(przestoj.etykieta_us / 1000));
+    }
     
     // Uptime
     Serial.print("Uptime: ");
@@ -223,7 +382,7 @@ void checkAndHandleSerialCommands() {
         char c = (char)Serial.read();
         
         // DEBUG: Pokaż co odbieramy
-        Serial.printf("[DEBUG] Odebrano znak: '%c' (kod: %d)\n", c, (int)c);
+        LOG_DEBUG("[DEBUG] Odebrano znak: '%c' (kod: %d)", c, (int)c);
         
         // Koniec komendy - wykonaj
         if (c == '\n' || c == '\r') {
@@ -231,13 +390,13 @@ void checkAndHandleSerialCommands() {
                 String cmd = serialCommandBuffer;
                 serialCommandBuffer = "";
                 
-                Serial.printf("[DEBUG] Przetwarzam komendę: '%s' (długość: %d)\n", 
-                             cmd.c_str(), cmd.length());
+                LOG_DEBUG("[DEBUG] Przetwarzam komendę: '%s' (długość: %d)",
+                          cmd.c_str(), cmd.length());
                 
                 cmd.trim();
                 cmd.toLowerCase();
                 
-                Serial.printf("[DEBUG] Po trim/lower: '%s'\n", cmd.c_str());
+                LOG_DEBUG("[DEBUG] Po trim/lower: '%s'", cmd.c_str());
                 
                 if (cmd == "reset") {
                     resetKurnik();
@@ -245,18 +404,46 @@ void checkAndHandleSerialCommands() {
                 else if (cmd == "status") {
                     wyswietlStatusSystemu();
                 }
+                else if (cmd.startsWith("benchmark")) {
+                    unsigned long iteracje = 0;
+                    sscanf(cmd.c_str(), "benchmark %lu", &iteracje);
+                    UruchomBenchmarkKodekow(iteracje);
+                }
+                else if (cmd == "symulacja stop") {
+                    SymulatorStop();
+                }
+                else if (cmd.startsWith("symulacja")) {
+                    // symulacja <węzły> <wiadomości/s na węzeł> <czas s> [ramka]
+                    unsigned long wezly = 0, czas = 0;
+                    float naSekunde = 0;
+                    char format[8] = "";
+                    if (sscanf(cmd.c_str(), "symulacja %lu %f %lu %7s", &wezly, &naSekunde, &czas, format) < 3) {
+                        Serial.println("Użycie: symulacja <węzły> <wiadomości/s na węzeł> <czas s> [ramka] | symulacja stop");
+                    } else {
+                        SymulatorStart(wezly, naSekunde, czas, strcmp(format, "ramka") == 0);
+                    }
+                }
+                else if (cmd.startsWith("surowe")) {
+                    // surowe <id węzła> [liczba próbek, domyślnie wszystkie]
+                    unsigned long wezel = 0, liczba = 0;
+                    if (sscanf(cmd.c_str(), "surowe %lu %lu", &wezel, &liczba) < 1) {
+                        Serial.println("Użycie: surowe <id węzła> [liczba]");
+                    } else {
+                        ZadajSurowePomiary((uint32_t)wezel, (uint16_t)liczba);
+                    }
+                }
                 else if (cmd.length() > 0) {
                     Serial.printf("Nieznana komenda: '%s'\n", cmd.c_str());
-                    Serial.println("Dostępne komendy: reset, status");
+                    Serial.println("Dostępne komendy: reset, status, symulacja, benchmark, surowe");
                 }
             } else {
-                Serial.println("[DEBUG] Pusty bufor - ignoruję");
+                LOG_DEBUG("[DEBUG] Pusty bufor - ignoruję");
             }
         }
         // Dodaj znak do bufora
         else {
             serialCommandBuffer += c;
-            Serial.printf("[DEBUG] Bufor: '%s'\n", serialCommandBuffer.c_str());
+            LOG_DEBUG("[DEBUG] Bufor: '%s'", serialCommandBuffer.c_str());
         }
     }
 }
@@ -271,13 +458,38 @@ void loop() {
     // - taskOLEDSwitch (przełączanie ekranu OLED co 5s)
     // - taskMonitorPolaczen (sprawdzanie WiFi/MQTT co 10s)
     // - taskSyncNTP (synchronizacja NTP co 1 godzinę)
-    mesh.update();
+    // Alokacje są przypisywane do mesh, o ile zadanie nie ustawi własnego zakresu
+    // Strażnik mierzy przerwy między kolejnymi wywołaniami mesh.update()
+    StraznikPetliTik();
+    {
+        ZakresPodsystemu zakres(PODSYSTEM_MESH);
+        OdcinekPetli odcinek("mesh.update");
+        mesh.update();
+    }
     
     // === OBSŁUGA KOMEND SERIAL ===
     // Sprawdź czy użytkownik wysłał komendę "reset" lub "status" przez Serial Monitor
-    checkAndHandleSerialCommands();
+    {
+        OdcinekPetli odcinek("komendy Serial");
+        checkAndHandleSerialCommands();
+    }
+
+    // === STEROWNIK DHT22 ===
+    // Krok maszyny stanów (bez czekania) - zbocza ramki zapisuje przerwanie
+    {
+        OdcinekPetli odcinek("dht22");
+        dhtObsluga();
+    }
+
+    // === SYMULATOR RUCHU ===
+    // Wiadomości wirtualnych węzłów w tym samym kontekście co callbacki mesh
+    {
+        OdcinekPetli odcinek("symulator");
+        SymulatorObsluga();
+    }
 
     // === OBSŁUGA PRZYCISKÓW ===
+    OdcinekPetli odcinekPrzyciskow("przyciski");
     // Przycisk ekranu (z eliminacją drgań, przełączanie po puszczeniu)
     int reading = digitalRead(BUTTON_SCREEN_PIN);
     if (reading != lastScreenReading) {
@@ -291,6 +503,7 @@ void loop() {
                 // nic nie rób przy wciśnięciu, czekaj na puszczenie
             } else {
                 // po puszczeniu -> przełącz ekrany: czujniki -> status -> mesh -> czujniki
+                ZakresPodsystemu zakres(PODSYSTEM_OLED);
                 if (currentScreen == 0) {
                     oledShowStatus();
                     currentScreen = 1;
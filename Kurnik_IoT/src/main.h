@@ -20,6 +20,7 @@
 #include <EEPROM.h>
 #include <math.h>
 #include <ESP32Time.h>
+#include "ramka_mesh.h"
 
 /*
  * Struktura przechowująca pojedynczy pakiet danych z czujników
@@ -32,9 +33,33 @@ typedef struct {
     int   poziom_co2;         // Stężenie CO2 w ppm
     int   poziom_amoniaku;    // Stężenie amoniaku w ppm
     int   naslonecznienie;    // Natężenie światła w luksach
-    String data_i_czas;       // Timestamp pomiaru (format: "HH:MM:SS Www, Mmm DD YYYY")
+    char  data_i_czas[32];    // Timestamp pomiaru (format: "HH:MM:SS Www, Mmm DD YYYY")
+    uint8_t  przeniesione;    // Maska RAMKA_POLE_* pól powtórzonych przez węzeł (strefa martwa)
+    uint16_t pominiete;       // Próbki niewysłane przez węzeł od poprzedniego pakietu
 } Pakiet_Danych;
 
+/*
+ * Struktura przechowująca pomiar wagi kury z węzła z czytnikiem RFID
+ */
+typedef struct {
+    int   id_urzadzenia;      // Identyfikator urządzenia (wagi)
+    char  id_kury[2 * RAMKA_MAX_UID + 1];  // UID karty RFID kury (HEX, do RAMKA_MAX_UID bajtów)
+    float waga;               // Zmierzona waga
+    char  data_i_czas[32];    // Timestamp pomiaru (format: "HH:MM:SS Www, Mmm DD YYYY")
+} Pakiet_Kury;
+
+/*
+ * Struktura przechowująca agregat okna pomiarów węzła (ramka RAMKA_TYP_AGREGAT)
+ * Statystyki w jednostkach ramki: temperatura i wilgotność w setnych
+ */
+typedef struct {
+    int      id_urzadzenia;       // Identyfikator urządzenia
+    uint16_t okres_s;             // Długość okna w sekundach
+    uint16_t probki;              // Liczba próbek w oknie
+    RamkaStatystyka pola[RAMKA_LICZBA_POL];  // min/max/średnia/odchylenie w kolejności RAMKA_POLE_*
+    char     data_i_czas[32];     // Koniec okna (format: "HH:MM:SS Www, Mmm DD YYYY")
+} Pakiet_Agregatu;
+
 // Globalny obiekt RTC (Real Time Clock) do zarządzania czasem
 extern ESP32Time rtc;
 
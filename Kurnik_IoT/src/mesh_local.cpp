@@ -6,6 +6,13 @@
 #include "kurnikwifi.h"
 #include "pamiec_SD.h"
 #include "oled.h"
+#include "ramka_mesh.h"
+#include "dyspozytor_mesh.h"
+#include "odbior_mesh.h"
+#include "uplink.h"
+#include "profiler_zadan.h"
+#include "licznik_alokacji.h"
+#include "dziennik.h"
 
 // Dynamiczna nazwa mesh z adresem MAC
 String MESH_PREFIX = "";
@@ -20,118 +27,53 @@ void wyslijDaneCzujnikowCallback();
 void oledSwitchCallback();
 void monitorPolaczenCallback();
 void syncNTPCallback();
+static void odswiezCzujnikiCallback();
 
 // === DEFINICJE TASKÓW ===
+// Callbacki są opakowane profilerem (profiler_zadan.h) - pomiar czasu wykonania
 // Task raportujący stan sieci mesh co 10 sekund
-Task taskRaport(TASK_SECOND * 10, TASK_FOREVER, &raportujSiec);
+Task taskRaport(TASK_SECOND * 10, TASK_FOREVER, &ZadanieProfilowane<ZADANIE_RAPORT, raportujSiec>);
 // Task synchronizacji czasu w sieci mesh co 20 sekund
-Task syncMeshDataTime(TASK_SECOND * 20, TASK_FOREVER, &broadcastEpoch);
+Task syncMeshDataTime(TASK_SECOND * 20, TASK_FOREVER, &ZadanieProfilowane<ZADANIE_SYNC_CZASU, broadcastEpoch>);
 // Task wysyłania danych z czujników co 5 sekund
-Task taskWyslijDaneCzujnikow(TASK_SECOND * 5, TASK_FOREVER, &wyslijDaneCzujnikowCallback);
+Task taskWyslijDaneCzujnikow(TASK_SECOND * 5, TASK_FOREVER, &ZadanieProfilowane<ZADANIE_CZUJNIKI, wyslijDaneCzujnikowCallback>);
 // Task przełączania ekranu OLED co 5 sekund
 Task taskOLEDSwitch(TASK_SECOND * 5, TASK_FOREVER, &oledSwitchCallback);
 // Task odświeżania ekranu OLED co 10 sekund (tylko gdy pokazuje czujniki)
-Task taskOLEDRefresh(TASK_SECOND * 10, TASK_FOREVER, &oledRefreshCallback);
+Task taskOLEDRefresh(TASK_SECOND * 10, TASK_FOREVER, &ZadanieProfilowane<ZADANIE_OLED, oledRefreshCallback>);
 // Task monitorowania połączeń WiFi/MQTT co 10 sekund
-Task taskMonitorPolaczen(TASK_SECOND * 10, TASK_FOREVER, &monitorPolaczenCallback);
+Task taskMonitorPolaczen(TASK_SECOND * 10, TASK_FOREVER, &ZadanieProfilowane<ZADANIE_MONITOR, monitorPolaczenCallback>);
 // Task synchronizacji NTP co 1 godzinę (3600 sekund)
-Task taskSyncNTP(TASK_SECOND * 3600, TASK_FOREVER, &syncNTPCallback);
+Task taskSyncNTP(TASK_SECOND * 3600, TASK_FOREVER, &ZadanieProfilowane<ZADANIE_NTP, syncNTPCallback>);
+// Task publikacji metryk profilera
+Task taskMetryki(TASK_SECOND * PROFILER_OKRES_METRYK_S, TASK_FOREVER, &ZadanieProfilowane<ZADANIE_METRYKI, ProfilerPublikujMetryki>);
+// Task odświeżania migawki czujników (czujniki.h)
+Task taskPomiary(CZUJNIKI_OKRES_MS, TASK_FOREVER, &ZadanieProfilowane<ZADANIE_POMIARY, odswiezCzujnikiCallback>);
 
 // === ZMIENNE STANU DLA TASKÓW ===
 static bool _showSensors = true;
 // 0 = sensors, 1 = connection status, 2 = mesh status
 static int _currentScreen = 0;
-static float _dhtTemp = 0, _dhtHum = 0, _ntcTemp = 0;
-static int _ldr = 0, _eCO2 = 0, _tvoc = 0;
 static bool mqttByloPolaczone = false;
 
+// === OBSŁUGA ŻĄDANIA CZASU (dane węzłów - odbior_mesh.h) ===
 
-void receivedCallback( uint32_t from, String &msg ) {
-	Serial.printf("[Mesh] Odebrano wiadomość od węzła %u: %s\n", from, msg.c_str());
-	
-	String prefix = msg.substring(0, 4);
-    if (prefix == "DANE") {
-		// Usuń prefiks "DANE;" (5 znaków) z pakietu
-		String dane_str = msg.substring(5);  // Było: substring(4), teraz: substring(5)
-		
-		Serial.printf("[Mesh] Pakiet danych po usunięciu prefiksu: %s\n", dane_str.c_str());
-		
-		// Utwórz pakiet i wypełnij danymi z CSV
-		Pakiet_Danych pakiet;
-		// Format CSV: ID;temp;hum;co2;nh3;sun;timestamp
-		int parseCount = sscanf(dane_str.c_str(), "%d;%f;%f;%d;%d;%d",
-			&pakiet.ID_urzadzenia,
-			&pakiet.temperatura,
-			&pakiet.wilgotnosc,
-			&pakiet.poziom_co2,
-			&pakiet.poziom_amoniaku,
-			&pakiet.naslonecznienie
-		);
-		
-		// Wyodrębnij timestamp (po ostatnim średniku)
-		int lastSemicolon = dane_str.lastIndexOf(';');
-		if (lastSemicolon != -1) {
-			pakiet.data_i_czas = dane_str.substring(lastSemicolon + 1);
-		}
-		
-		Serial.printf("[Mesh] Sparsowano %d pól z pakietu\n", parseCount);
-		
-		// Wyślij pakiet przez MQTT i zapisz na SD
-		if (parseCount >= 6) {
-			Serial.println("[Mesh] Przekazuję pakiet do WyslijPakiet()");
-			WyslijPakiet(&pakiet);
-		} else {
-			Serial.printf("[Mesh] BŁĄD: Nieprawidłowy format pakietu (sparsowano tylko %d/6 pól)\n", parseCount);
-		}
-	}
-	else if (prefix == "KURA") {
-		// Format: KURA;id_urządzenia;id_kury;waga;data
-		// Przykład: KURA;692641124;F7474A39;-0.37;23:44:15 Wed, Jan 28 2026
-		String kura_str = msg.substring(5);  // Usuń "KURA;"
-		
-		Serial.printf("[Mesh] Pakiet kury po usunięciu prefiksu: %s\n", kura_str.c_str());
-		
-		char id_kury[16];
-		int id_urzadzenia;
-		float waga;
-		
-		// Parsuj pierwsze 3 pola: id_urządzenia;id_kury;waga
-		int parseCount = sscanf(kura_str.c_str(), "%d;%15[^;];%f",
-			&id_urzadzenia,
-			id_kury,
-			&waga
-		);
-		
-		// Wyodrębnij timestamp (po 3 średnikach)
-		String timestamp = "";
-		int count = 0;
-		for (int i = 0; i < kura_str.length(); i++) {
-			if (kura_str[i] == ';') {
-				count++;
-				if (count == 3) {
-					timestamp = kura_str.substring(i + 1);
-					break;
-				}
-			}
-		}
-		
-		Serial.printf("[Mesh] Sparsowano %d pól z pakietu kury\n", parseCount);
-		
-		if (parseCount >= 3) {
-			Serial.printf("[Mesh] ID urządzenia: %d, ID kury: %s, Waga: %.2f, Data: %s\n",
-				id_urzadzenia, id_kury, waga, timestamp.c_str());
-			WyslijPakietKura(id_urzadzenia, id_kury, waga, timestamp);
-		} else {
-			Serial.printf("[Mesh] BŁĄD: Nieprawidłowy format pakietu kury (sparsowano tylko %d/3 pól)\n", parseCount);
-		}
-	}
-	else if (prefix == "TIME") {
-		Serial.println("[Mesh] Otrzymano żądanie synchronizacji czasu");
-		broadcastEpoch();
-	}
-	else {
-		Serial.printf("[Mesh] UWAGA: Nieznany typ wiadomości (prefix: %s)\n", prefix.c_str());
+static void obsluzTime(uint32_t from, const char* dane, size_t dlugosc) {
+	LOG_DEBUG("[Mesh] Otrzymano żądanie synchronizacji czasu");
+	broadcastEpoch();
+}
+
+bool ZadajSurowePomiary(uint32_t wezel, uint16_t liczba) {
+	if (!mesh.isConnected(wezel)) {
+		LOG_OSTRZEZENIE("[Mesh] Węzeł %u nie jest połączony - pomijam żądanie surowych próbek", wezel);
+		return false;
 	}
+	char zadanie[12];
+	snprintf(zadanie, sizeof(zadanie), "SURO%u", liczba);
+	String msg = zadanie;
+	mesh.sendSingle(wezel, msg);
+	LOG_INFO("[Mesh] Wysłano żądanie %u surowych próbek do węzła %u", liczba, wezel);
+	return true;
 }
 
 void broadcastEpoch(){
@@ -141,50 +83,40 @@ void broadcastEpoch(){
 	unsigned long akt_czas = rtc.getLocalEpoch();
 	reply += String(akt_czas);
 	mesh.sendBroadcast(reply);
-	Serial.printf("Wysłano broadcast czasu: %s (epoch: %lu)\n", reply.c_str(), akt_czas);
+	LOG_DEBUG("Wysłano broadcast czasu: %s (epoch: %lu)", reply.c_str(), akt_czas);
 }
 
 void newConnectionCallback(uint32_t nodeId) {
-	Serial.printf("\n>>> NOWE POŁĄCZENIE! Węzeł ID: %u\n", nodeId);
-	Serial.printf(">>> Łącznie węzłów w sieci: %d\n\n", mesh.getNodeList().size());
+	LOG_INFO(">>> NOWE POŁĄCZENIE! Węzeł ID: %u (węzłów w sieci: %d)", nodeId, mesh.getNodeList().size());
 }
 
 void changedConnectionCallback() {
-	Serial.println("\n>>> ZMIANA TOPOLOGII SIECI");
-	Serial.printf(">>> Liczba węzłów: %d\n\n", mesh.getNodeList().size());
+	LOG_INFO(">>> ZMIANA TOPOLOGII SIECI (liczba węzłów: %d)", mesh.getNodeList().size());
 }
 
 void raportujSiec() {
-	Serial.println("\n--- RAPORT MESH ROOT ---");
-	Serial.printf("Mój ID: %u\n", mesh.getNodeId());
-	Serial.printf("Liczba połączeń: %d\n", mesh.getNodeList().size());
+	LOG_INFO("[Mesh] Raport ROOT: ID %u, połączenia: %d", mesh.getNodeId(), mesh.getNodeList().size());
 	
+#if DZIENNIK_POZIOM >= DZIENNIK_DEBUG
 	// Wylistuj wszystkie połączone węzły
 	SimpleList<uint32_t> nodes = mesh.getNodeList();
-	if (nodes.size() > 0) {
-		Serial.println("Połączone węzły:");
-		for (auto &&id : nodes) {
-			Serial.printf("  - Węzeł ID: %u\n", id);
-		}
-	} else {
-		Serial.println("  (brak połączonych węzłów)");
+	for (auto &&id : nodes) {
+		LOG_DEBUG("  - Węzeł ID: %u", id);
 	}
+#endif
 	
-	// Pobierz topologię mesh w formacie JSON
+	// Pobierz topologię mesh w formacie JSON (w logu obcięta do DZIENNIK_MAX_LINIA)
 	String topologyJson = mesh.subConnectionJson();
-	Serial.print("Topologia JSON: ");
-	Serial.println(topologyJson); 
+	LOG_DEBUG("Topologia JSON: %s", topologyJson.c_str());
 	
 	// Wyślij topologię przez MQTT (jeśli połączone)
 	if (asyncMqttClient.connected() && topicInitialized) {
 		String meshTopic = String(topic) + "/mesh/topology";
-		asyncMqttClient.publish(meshTopic.c_str(), 0, false, topologyJson.c_str());
-		Serial.printf("Wysłano topologię mesh przez MQTT do: %s\n", meshTopic.c_str());
+		PublikujMQTT(meshTopic.c_str(), 0, false, topologyJson.c_str());
+		LOG_DEBUG("Wysłano topologię mesh przez MQTT do: %s", meshTopic.c_str());
 	} else {
-		Serial.println("MQTT niedostępny - pomijam wysyłkę topologii");
+		LOG_DEBUG("MQTT niedostępny - pomijam wysyłkę topologii");
 	}
-	
-	Serial.println("------------------------\n");
 }
 
 
@@ -219,6 +151,12 @@ void InicjalizacjaMesh() {
 	mesh.setContainsRoot(true); 
 	mesh.setRoot(true);
 	
+	// Rejestracja obsługi typów wiadomości w dyspozytorze (DANE, KURA, RAMK - odbior_mesh.h)
+	OdbiorMeshInicjalizacja();
+	if (!RejestrujObslugeMesh(TagMesh("TIME"), &obsluzTime)) {
+		LOG_BLAD("[Mesh] BŁĄD: Nie zarejestrowano obsługi TIME w dyspozytorze");
+	}
+
 	// Rejestracja funkcji odbioru
 	mesh.onReceive(&receivedCallback);
 	
@@ -244,6 +182,12 @@ void InicjalizacjaMesh() {
 	
 	// Task synchronizacji NTP
 	userScheduler.addTask(taskSyncNTP);
+
+	// Task metryk profilera zadań
+	userScheduler.addTask(taskMetryki);
+
+	// Task odświeżania migawki czujników
+	userScheduler.addTask(taskPomiary);
 	
 	// === AKTYWACJA TASKÓW ===
 	taskRaport.enable();
@@ -252,6 +196,8 @@ void InicjalizacjaMesh() {
 	taskMonitorPolaczen.enable();
 	taskOLEDRefresh.enable();
 	taskSyncNTP.enable();
+	taskMetryki.enable();
+	taskPomiary.enable();
 
 	Serial.println(">>> ROZPOCZĘTO PRACĘ JAKO ROOT <<<");
 	Serial.printf(">>> Mój NodeID: %u\n", mesh.getNodeId());
@@ -281,27 +227,36 @@ void InicjalizacjaMesh() {
 // === CALLBACK: WYSYŁANIE DANYCH Z CZUJNIKÓW ===
 void wyslijDaneCzujnikowCallback() {
 	Pakiet_Danych pakiet;
-	TEST_pakiet(&pakiet);
-	WyslijPakiet(&pakiet);
-	Serial.println("[Scheduler] Wysłano pakiet danych z czujników");
+	if (!TEST_pakiet(&pakiet)) {
+		LOG_OSTRZEZENIE("[Scheduler] Brak ważnego odczytu DHT22 - pomijam pakiet");
+		return;
+	}
+	ZakolejkujPakiet(&pakiet);
+	LOG_DEBUG("[Scheduler] Zakolejkowano pakiet danych z czujników");
+}
+
+// === CALLBACK: ODŚWIEŻANIE MIGAWKI CZUJNIKÓW ===
+static void odswiezCzujnikiCallback() {
+	CzujnikiOdswiez();
+}
+
+// Ekran czujników z migawki (czujniki.h) - bez odczytu sprzętu
+static void pokazMigawkeCzujnikow() {
+	MigawkaCzujnikow m;
+	CzujnikiPobierzMigawke(&m);
+	oled.showSensorReadings(m.dht_temp, m.dht_hum, m.ntc_temp, m.ldr, m.eco2, m.tvoc);
 }
 
 // === CALLBACK: PRZEŁĄCZANIE EKRANU OLED ===
 void oledSwitchCallback() {
+	ZakresPodsystemu zakres(PODSYSTEM_OLED);
 	_showSensors = !_showSensors;
 	
 	bool wifiOk = (WiFi.status() == WL_CONNECTED);
 	bool mqttOk = asyncMqttClient.connected();
 	
 	if (_showSensors) {
-		// Odczytaj czujniki tylko przy przełączeniu na ekran czujników
-		_dhtTemp = measureDHT22_Temp();
-		_dhtHum = measureDHT22_Hum();
-		_ntcTemp = measureNTC();
-		_ldr = measureLDR();
-		_eCO2 = odczytCO2(_dhtTemp, _dhtHum);
-		_tvoc = odczytTVOC(_dhtTemp, _dhtHum);
-		oled.showSensorReadings(_dhtTemp, _dhtHum, _ntcTemp, _ldr, _eCO2, _tvoc);
+		pokazMigawkeCzujnikow();
 	} else {
 		oled.showConnectionStatus(wifiOk, mqttOk);
 	}
@@ -309,17 +264,12 @@ void oledSwitchCallback() {
 
 // Callback: odświeżenie aktywnego ekranu OLED (wywoływane okresowo)
 void oledRefreshCallback() {
+	ZakresPodsystemu zakres(PODSYSTEM_OLED);
 	// Odśwież aktywny ekran: 0=sensors,1=status,2=mesh
 	if (_currentScreen == 0) {
 		// sensors
 		_showSensors = true;
-		_dhtTemp = measureDHT22_Temp();
-		_dhtHum = measureDHT22_Hum();
-		_ntcTemp = measureNTC();
-		_ldr = measureLDR();
-		_eCO2 = odczytCO2(_dhtTemp, _dhtHum);
-		_tvoc = odczytTVOC(_dhtTemp, _dhtHum);
-		oled.showSensorReadings(_dhtTemp, _dhtHum, _ntcTemp, _ldr, _eCO2, _tvoc);
+		pokazMigawkeCzujnikow();
 	} else if (_currentScreen == 1) {
 		// connection status
 		_showSensors = false;
@@ -337,18 +287,14 @@ void oledRefreshCallback() {
 
 // Manual functions to request specific OLED screens from other modules (e.g., main)
 void oledShowSensors() {
+	ZakresPodsystemu zakres(PODSYSTEM_OLED);
 	_showSensors = true;
 	_currentScreen = 0;
-	_dhtTemp = measureDHT22_Temp();
-	_dhtHum = measureDHT22_Hum();
-	_ntcTemp = measureNTC();
-	_ldr = measureLDR();
-	_eCO2 = odczytCO2(_dhtTemp, _dhtHum);
-	_tvoc = odczytTVOC(_dhtTemp, _dhtHum);
-	oled.showSensorReadings(_dhtTemp, _dhtHum, _ntcTemp, _ldr, _eCO2, _tvoc);
+	pokazMigawkeCzujnikow();
 }
 
 void oledShowStatus() {
+	ZakresPodsystemu zakres(PODSYSTEM_OLED);
 	_showSensors = false;
 	_currentScreen = 1;
 	bool wifiOk = (WiFi.status() == WL_CONNECTED);
@@ -357,6 +303,7 @@ void oledShowStatus() {
 }
 
 void oledShowMeshStatus() {
+	ZakresPodsystemu zakres(PODSYSTEM_OLED);
 	// count connected nodes in mesh
 	_showSensors = false;
 	_currentScreen = 2;
@@ -367,16 +314,22 @@ void oledShowMeshStatus() {
 
 // === CALLBACK: MONITORING POŁĄCZEŃ WIFI/MQTT ===
 void monitorPolaczenCallback() {
+	// Zadanie AsyncTCP powstaje przy pierwszym połączeniu (mesh lub MQTT)
+	static bool tcpPrzypisane = false;
+	if (!tcpPrzypisane) {
+		tcpPrzypisane = PamiecPrzypiszZadanie("async_tcp", PODSYSTEM_TCP);
+	}
+
 	// Sprawdź połączenie WiFi
 	if (WiFi.status() != WL_CONNECTED) {
-		Serial.println("[Scheduler] Utracono WiFi - próba ponownego połączenia");
+		LOG_OSTRZEZENIE("[Scheduler] Utracono WiFi - próba ponownego połączenia");
 		PolaczZWiFi();
 	}
 	
 	// Sprawdź połączenie MQTT
 	if (!asyncMqttClient.connected()) {
 		if (mqttByloPolaczone) {
-			Serial.println("[Scheduler] Utracono MQTT - próba ponownego połączenia");
+			LOG_OSTRZEZENIE("[Scheduler] Utracono MQTT - próba ponownego połączenia");
 			mqttByloPolaczone = false;
 		}
 		PolaczDoMQTT();
@@ -384,8 +337,8 @@ void monitorPolaczenCallback() {
 		// MQTT dopiero co się połączył - wyślij dane z kolejki
 		if (!mqttByloPolaczone) {
 			mqttByloPolaczone = true;
-			Serial.println("[Scheduler] MQTT połączony - wysyłam dane z kolejki");
-			PonowWyslijZKolejki();
+			LOG_INFO("[Scheduler] MQTT połączony - zlecam wysyłkę danych z kolejki");
+			ZlecPonowneWyslanie();
 		}
 	}
 }
@@ -393,10 +346,10 @@ void monitorPolaczenCallback() {
 // === CALLBACK: SYNCHRONIZACJA NTP ===
 void syncNTPCallback() {
 	if (WiFi.status() == WL_CONNECTED) {
-		Serial.println("[Scheduler] Cykliczna synchronizacja czasu z NTP");
+		LOG_INFO("[Scheduler] Cykliczna synchronizacja czasu z NTP");
 		UstawCzasZWiFi();
 	} else {
-		Serial.println("[Scheduler] Brak WiFi - pomijam synchronizację NTP");
+		LOG_OSTRZEZENIE("[Scheduler] Brak WiFi - pomijam synchronizację NTP");
 	}
 }
 
@@ -2,6 +2,8 @@
 #define MESH_LOCAL
 
 #include <painlessMesh.h>
+#include "main.h"
+#include "odbior_mesh.h"
 
 // Dynamiczna nazwa mesh z adresem MAC (generowana w InicjalizacjaMesh)
 extern String MESH_PREFIX;
@@ -27,11 +29,21 @@ extern Task taskOLEDRefresh;
 extern Task taskMonitorPolaczen;
 // Task synchronizacji NTP (co 1 godzinę)
 extern Task taskSyncNTP;
+// Task publikacji metryk profilera zadań
+extern Task taskMetryki;
+// Task odświeżania migawki czujników (co CZUJNIKI_OKRES_MS)
+extern Task taskPomiary;
 
 // === FUNKCJE ===
 // Inicjalizacja i setup mesha
 void InicjalizacjaMesh();
 
+// Prosi węzeł o ostatnie surowe próbki z jego pierścienia (0 = wszystkie, najwyżej
+// AGREGACJA_SUROWE). Węzeł odsyła je od najstarszej w ramkach PACZKA (po RAMKA_PACZKA_MAX
+// próbek), także bez agregacji. Wywoływać z pętli Arduino (mesh nie jest wielowątkowy).
+// return: false gdy węzła nie ma w sieci
+bool ZadajSurowePomiary(uint32_t wezel, uint16_t liczba);
+
 // Callback callbacki tasków (do wywołania zewnętrznego)
 void wyslijDaneCzujnikowCallback();
 void oledSwitchCallback();
@@ -16,6 +16,10 @@
 #include "main.h"
 #include "pamiec_SD.h"
 #include "czujniki.h"
+#include "ponowna_wysylka.h"
+#include "dostarczanie_mqtt.h"
+#include "licznik_alokacji.h"
+#include "dziennik.h"
 
 // Klienci WiFi i MQTT
 WiFiClient espClient;              // Klient WiFi 
@@ -24,6 +28,9 @@ AsyncMqttClient asyncMqttClient;   // Asynchroniczny klient MQTT
 // Globalny zegar RTC (zadeklarowany jako extern w main.h)
 ESP32Time rtc;
 
+// Mutex chroniący publikacje asyncMqttClient (tworzony w InicjalizacjaMQTT)
+static SemaphoreHandle_t mqttMutex = nullptr;
+
 /**
  * Funkcja pomocnicza konwertująca kod stanu MQTT na nazwę tekstową.
  * Używana do debugowania i logowania stanów połączenia.
@@ -65,11 +72,16 @@ const char *mqtt_password = "";        // Hasło użytkownika
  * - Dane logowania (username, password)
  * - Callback onConnect - wywoływany po nawiązaniu połączenia
  * - Callback onDisconnect - wywoływany po utracie połączenia
+ * - Callback onPublish - potwierdzenia PUBACK (bieżące pakiety i ponowna wysyłka kolejki)
  * - Callback onMessage - wywoływany po otrzymaniu wiadomości MQTT
  * 
  * Wywoływana w setup() przed próbą połączenia.
  */
 void InicjalizacjaMQTT() {
+    if (mqttMutex == nullptr) {
+        mqttMutex = xSemaphoreCreateMutex();
+    }
+
     // Ustaw adres serwera MQTT i port
     // Convert IP string to IPAddress to avoid potential null pointer issues
     IPAddress brokerIP;
@@ -88,7 +100,7 @@ void InicjalizacjaMQTT() {
         // Subskrybuj własny topic (odbieraj wiadomości wysłane na ten topic)
         asyncMqttClient.subscribe(topic, 0);
         // Opublikuj wiadomość inicjującą po połączeniu
-        asyncMqttClient.publish(topic, 0, false, "Wiadomosc inicjujaca");
+        PublikujMQTT(topic, 0, false, "Wiadomosc inicjujaca");
     });
 
     // Callback wywoływany po utracie połączenia
@@ -96,6 +108,12 @@ void InicjalizacjaMQTT() {
         Serial.println("Async MQTT disconnected");
     });
 
+    // Callback wywoływany po potwierdzeniu publikacji QoS 1 (PUBACK)
+    asyncMqttClient.onPublish([](uint16_t packetId){
+        PotwierdzeniePublikacji(packetId);
+        PotwierdzenieDostarczenia(packetId);
+    });
+
     // Callback wywoływany po otrzymaniu wiadomości MQTT
     asyncMqttClient.onMessage([](char* t, char* p, AsyncMqttClientMessageProperties props, size_t len, size_t index, size_t total){
         // Przekieruj do funkcji obsługującej wiadomości
@@ -103,6 +121,24 @@ void InicjalizacjaMQTT() {
     });
 }
 
+/**
+ * Publikuje wiadomość MQTT pod mutexem - jedna publikacja naraz niezależnie
+ * od zadania, z którego jest wywoływana.
+ *
+ * return: packet ID zwrócony przez asyncMqttClient (0 = błąd)
+ */
+uint16_t PublikujMQTT(const char* topic, uint8_t qos, bool retain, const char* payload) {
+    ZakresPodsystemu zakres(PODSYSTEM_MQTT);
+    if (mqttMutex == nullptr) {
+        // Przed InicjalizacjaMQTT() działa tylko setup() - brak współbieżności
+        return asyncMqttClient.publish(topic, qos, retain, payload);
+    }
+    xSemaphoreTake(mqttMutex, portMAX_DELAY);
+    uint16_t packetId = asyncMqttClient.publish(topic, qos, retain, payload);
+    xSemaphoreGive(mqttMutex);
+    return packetId;
+}
+
 /**
  * Tworzy unikalny topic MQTT na podstawie adresu MAC urządzenia BLE.
  * Format topic'a: "kurnik/" + adres_MAC (np. "kurnik/b0:cb:d8:03:f9:62")
@@ -199,45 +235,51 @@ void OdpowiedzMQTT(char *topic, byte *payload, unsigned int length) {
     Serial.println();
 }
 
+size_t FormatujPakietCSV(const Pakiet_Danych* pakiet, char* bufor, size_t rozmiar) {
+    // Format CSV: ID;temp;hum;co2;nh3;sun;timestamp
+    int n = snprintf(bufor, rozmiar, "%d;%.2f;%.2f;%d;%d;%d;%s",
+             pakiet->ID_urzadzenia,      // ID urządzenia (int)
+             pakiet->temperatura,        // Temperatura w °C (float, 2 miejsca po przecinku)
+             pakiet->wilgotnosc,         // Wilgotność w % (float, 2 miejsca po przecinku)
+             pakiet->poziom_co2,         // CO2 w ppm (int)
+             pakiet->poziom_amoniaku,    // Amoniak w ppm (int)
+             pakiet->naslonecznienie,    // Nasłonecznienie w lux (int)
+             pakiet->data_i_czas);       // Timestamp
+    if (n < 0) return 0;
+    if ((size_t)n < rozmiar && (pakiet->przeniesione != 0 || pakiet->pominiete != 0)) {
+        int m = snprintf(bufor + n, rozmiar - n, ";%u;%u", pakiet->przeniesione, pakiet->pominiete);
+        if (m > 0) n += m;
+    }
+    return ((size_t)n < rozmiar) ? (size_t)n : rozmiar - 1;
+}
+
 /**
  * Wysyła pakiet danych z czujników przez MQTT i zapisuje na kartę SD.
  * 
- * Format CSV: ID;temp;hum;co2;nh3;sun;timestamp
+ * Format CSV: ID;temp;hum;co2;nh3;sun;timestamp[;przeniesione;pominiete]
  * Przykład: 2;22.32;61.65;1220;15;51;15:55:06 Wed, Jan 07 2026
+ * Dwa ostatnie pola są dopisywane tylko dla pakietu ze strefy martwej węzła:
+ * maska RAMKA_POLE_* pól powtórzonych z poprzedniego pakietu i liczba
+ * próbek niewysłanych od poprzedniego pakietu (do odtworzenia szeregu).
  * 
  * parametr: pakiet, Wskaźnik na strukturę Pakiet_Danych do wysłania
  * 
  * Proces:
- * 1. Aktualizuje timestamp z RTC (aktualny czas)
- * 2. Formatuje dane do CSV
- * 3. Próbuje wysłać przez MQTT
- * 4. Zapisuje na kartę SD:
- *    - backup_data.txt jeśli MQTT się udało (archiwum)
- *    - transfer_waitlist.txt jeśli MQTT nie działa (kolejka do ponownego wysłania)
+ * 1. Formatuje dane do CSV (FormatujPakietCSV) - timestamp pochodzi z węzła
+ * 2. Wysyła przez MQTT z QoS 1 (dostarczanie_mqtt.h) - razem z innymi
+ *    rekordami z okna jako paczkę na "<topic>/paczka"
+ * 3. Zapisuje na kartę SD:
+ *    - archiwum /archiwum/ po potwierdzeniu PUBACK
+ *    - kolejka offline /kolejka/ jeśli MQTT nie działa lub brak potwierdzenia
  */
-void WyslijPakiet(Pakiet_Danych* pakiet) {
-    
-    // Formatuj dane do CSV: ID;temp;hum;co2;nh3;sun;timestamp
+void WyslijPakiet(const Pakiet_Danych* pakiet) {
     char message[150];
-    snprintf(message, sizeof(message), "%d;%.2f;%.2f;%d;%d;%d;%s",
-             pakiet->ID_urzadzenia,      // ID urządzenia (int)
-             pakiet->temperatura,        // Temperatura w °C (float, 2 miejsca po przecinku)
-             pakiet->wilgotnosc,         // Wilgotność w % (float, 2 miejsca po przecinku)
-             pakiet->poziom_co2,         // CO2 w ppm (int)
-             pakiet->poziom_amoniaku,    // Amoniak w ppm (int)
-             pakiet->naslonecznienie,    // Nasłonecznienie w lux (int)
-             pakiet->data_i_czas.c_str()); // Timestamp
-    
-    // Próbuj wysłać przez MQTT (zwraca packet ID lub 0 przy błędzie)
-    uint16_t packetId = asyncMqttClient.publish(topic, 0, false, message);
-    
-    // Sprawdź czy wysyłanie MQTT się udało
-    bool mqttSuccess = (packetId != 0 && asyncMqttClient.connected());
-    
-    // Zapisz dane do odpowiedniego pliku na karcie SD
-    // - backup_data.txt jeśli MQTT działa (archiwum)
-    // - transfer_waitlist.txt jeśli MQTT nie działa (kolejka)
-    ZapiszDanePakiet(message, mqttSuccess);
+    FormatujPakietCSV(pakiet, message, sizeof(message));
+
+    // Wyślij z QoS 1 - zapis na kartę SD nastąpi po PUBACK lub po przekroczeniu czasu
+    // - archiwum /archiwum/ po potwierdzeniu przez broker
+    // - kolejka offline /kolejka/ jeśli MQTT nie działa lub brak potwierdzenia
+    PublikujZPotwierdzeniem(message);
 }
 /**
  * Funkcja testowa generująca 100 pakietów danych z sinusoidalnymi wartościami.
@@ -269,24 +311,31 @@ void TEST_zapelnij_pakiet(Pakiet_Danych* pakiet, int wielkosc) {
         pakiet[i].poziom_co2      = 1200 + 400 * sin(t * 0.8);   // 800-1600 ppm
         pakiet[i].poziom_amoniaku = 15 + 8   * sin(t * 1.7);     // 7-23 ppm
         pakiet[i].naslonecznienie = 50 + 45  * sin(t * 0.5);     // 5-95 lux
+        pakiet[i].przeniesione    = 0;
+        pakiet[i].pominiete       = 0;
         
         // Timestamp jest ustawiany w WyslijPakiet() z aktualnego RTC
     }
 }
 
-void TEST_pakiet(Pakiet_Danych* pakiet) {
+bool TEST_pakiet(Pakiet_Danych* pakiet) {
 
     pakiet->ID_urzadzenia   = 1;  // Stały ID = 1
-        
-    pakiet->temperatura     = measureDHT22_Temp();        
-    pakiet->wilgotnosc      = measureDHT22_Hum();
-    pakiet->poziom_co2      = odczytCO2(pakiet->temperatura, pakiet->wilgotnosc);
-    pakiet->poziom_amoniaku = odczytTVOC(pakiet->temperatura, pakiet->wilgotnosc);
-    pakiet->naslonecznienie = measureLDR(); 
-    pakiet->data_i_czas = rtc.getTimeDate();
+
+    // Wartości z migawki czujników (czujniki.h) - bez odczytu sprzętu
+    MigawkaCzujnikow migawka;
+    CzujnikiPobierzMigawke(&migawka);
+    pakiet->temperatura     = migawka.dht_temp;
+    pakiet->wilgotnosc      = migawka.dht_hum;
+    pakiet->poziom_co2      = migawka.eco2;
+    pakiet->poziom_amoniaku = migawka.tvoc;
+    pakiet->naslonecznienie = migawka.ldr;
+    pakiet->przeniesione    = 0;
+    pakiet->pominiete       = 0;
+    strlcpy(pakiet->data_i_czas, rtc.getTimeDate().c_str(), sizeof(pakiet->data_i_czas));
         
     // Timestamp jest ustawiany w WyslijPakiet() z aktualnego RTC
-    
+    return migawka.dht_poprawny;
 }
 
 /**
@@ -294,33 +343,70 @@ void TEST_pakiet(Pakiet_Danych* pakiet) {
  * 
  * Format: id_urządzenia;id_kury;waga;timestamp
  * Przykład: 692641124;F7474A39;-0.37;23:44:15 Wed, Jan 28 2026
+ *
+ * Rekord przechodzi tę samą drogę co pakiet czujników (PublikujZPotwierdzeniem):
+ * paczka na "<topic>/paczka", archiwum po PUBACK, kolejka offline bez
+ * potwierdzenia. Serwer rozpoznaje zdarzenie kury po liczbie pól (4).
  * 
  * parametr: id_urzadzenia ID urządzenia (wagi)
  * parametr: id_kury Identyfikator kury (hex string z RFID)
  * parametr: waga Zmierzona waga w kg
  * parametr: timestamp Czas pomiaru
  */
-void WyslijPakietKura(int id_urzadzenia, const char* id_kury, float waga, String timestamp) {
+void WyslijPakietKura(int id_urzadzenia, const char* id_kury, float waga, const char* timestamp) {
     // Format: id_urządzenia;id_kury;waga;timestamp
-    char message[150];
-    snprintf(message, sizeof(message), "%d;%s;%.2f;%s",
-             id_urzadzenia,
-             id_kury,
-             waga,
-             timestamp.c_str());
-    
-    // Utwórz topic dla danych kur: kurnik/MAC/kury
-    char kury_topic[64];
-    snprintf(kury_topic, sizeof(kury_topic), "%s/kury", topic);
-    
-    Serial.printf("[MQTT] Wysyłam dane kury na topic %s: %s\n", kury_topic, message);
-    
-    // Wyślij przez MQTT
-    uint16_t packetId = asyncMqttClient.publish(kury_topic, 0, false, message);
-    
-    if (packetId != 0 && asyncMqttClient.connected()) {
-        Serial.println("[MQTT] Pomyślnie wysłano dane kury");
-    } else {
-        Serial.println("[MQTT] BŁĄD: Nie udało się wysłać danych kury");
+    char message[DOSTARCZANIE_MAX_REKORD];
+    int n = snprintf(message, sizeof(message), "%d;%s;%.2f;%s",
+                     id_urzadzenia,
+                     id_kury,
+                     waga,
+                     timestamp);
+    if (n <= 0 || (size_t)n >= sizeof(message)) {
+        LOG_BLAD("[MQTT] BŁĄD: Dane kury %s nie mieszczą się w rekordzie", id_kury);
+        return;
+    }
+
+    LOG_DEBUG("[MQTT] Wysyłam dane kury: %s", message);
+    PublikujZPotwierdzeniem(message);
+}
+
+/**
+ * Wysyła agregat okna pomiarów węzła przez MQTT.
+ *
+ * Format: id;okres_s;probki;t_min;t_max;t_sr;t_odch;h_min;...;sun_odch;timestamp
+ * Przykład: 692641124;60;12;20.00;21.10;20.55;0.35;...;100;100;100;0;15:55:06 Wed, Jan 07 2026
+ * Temperatura i wilgotność z dwoma miejscami po przecinku, pozostałe pola
+ * całkowite (-1 = brak ważnego odczytu w oknie).
+ *
+ * Rekord przechodzi tę samą drogę co pakiet czujników (PublikujZPotwierdzeniem):
+ * paczka na "<topic>/paczka", archiwum po PUBACK, kolejka offline bez
+ * potwierdzenia. Serwer rozpoznaje agregat po liczbie pól (24).
+ */
+void WyslijPakietAgregat(const Pakiet_Agregatu* agregat) {
+    char message[DOSTARCZANIE_MAX_REKORD];
+    int n = snprintf(message, sizeof(message), "%d;%u;%u",
+                     agregat->id_urzadzenia, agregat->okres_s, agregat->probki);
+    for (int i = 0; i < RAMKA_LICZBA_POL && n > 0 && (size_t)n < sizeof(message); i++) {
+        const RamkaStatystyka* s = &agregat->pola[i];
+        int m;
+        if (i < 2) {
+            // Temperatura i wilgotność w setnych
+            m = snprintf(message + n, sizeof(message) - n, ";%.2f;%.2f;%.2f;%.2f",
+                         s->min / 100.0f, s->max / 100.0f, s->srednia / 100.0f, s->odchylenie / 100.0f);
+        } else {
+            m = snprintf(message + n, sizeof(message) - n, ";%ld;%ld;%ld;%ld",
+                         (long)s->min, (long)s->max, (long)s->srednia, (long)s->odchylenie);
+        }
+        n = (m > 0) ? n + m : -1;
     }
+    if (n > 0 && (size_t)n < sizeof(message)) {
+        n += snprintf(message + n, sizeof(message) - n, ";%s", agregat->data_i_czas);
+    }
+    if (n <= 0 || (size_t)n >= sizeof(message)) {
+        LOG_BLAD("[MQTT] BŁĄD: Agregat węzła %d nie mieści się w rekordzie", agregat->id_urzadzenia);
+        return;
+    }
+
+    LOG_DEBUG("[MQTT] Wysyłam agregat: %s", message);
+    PublikujZPotwierdzeniem(message);
 }
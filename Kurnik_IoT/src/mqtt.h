@@ -9,6 +9,8 @@
 #define MQTT_H
 
 #include "main.h"
+#include "dostarczanie_mqtt.h"
+#include "ponowna_wysylka.h"
 #include <WiFi.h>
 #include <WiFiClient.h>
 #include <AsyncMqttClient.h>
@@ -23,6 +25,14 @@ extern AsyncMqttClient asyncMqttClient;   // Asynchroniczny klient MQTT
 extern char topic[48];           // Topic MQTT (kurnik/MAC_ADDRESS)
 extern bool topicInitialized;    // Czy topic został już zainicjalizowany
 
+// Górne ograniczenie liczby publikacji QoS 1 czekających jednocześnie na PUBACK:
+// bieżące publikacje razem z ponowieniami, okno kolejki offline z jednym cofnięciem
+// i zapas na pozostałe publikacje QoS 1. Każdy PUBACK trafia do obu odbiorców
+// (dostarczanie_mqtt i ponowna_wysylka), więc obie kolejki potwierdzeń mają tę
+// pojemność - nawet gdy zadanie uplinku długo zapisuje kartę SD, żadne
+// potwierdzenie nie zostanie odrzucone.
+#define MQTT_MAX_POTWIERDZEN  (DOSTARCZANIE_W_LOCIE * DOSTARCZANIE_MAX_PROB + PONOWNA_WYSYLKA_OKNO * 2 + 16)
+
 // Konfiguracja serwera MQTT
 extern const int mqtt_port;           // Port brokera MQTT (1883)
 extern const char *mqtt_broker;       // Adres IP serwera MQTT
@@ -41,6 +51,15 @@ void InicjalizacjaMQTT();
  */
 void PolaczDoMQTT();
 
+/*
+ * Publikuje wiadomość przez asyncMqttClient z wzajemnym wykluczeniem.
+ * Publikacje wykonują pętla Arduino, zadanie uplinku i callbacki AsyncTCP,
+ * a AsyncMqttClient nie jest bezpieczny dla wielu zadań.
+ *
+ * return: packet ID lub 0 przy błędzie
+ */
+uint16_t PublikujMQTT(const char* topic, uint8_t qos, bool retain, const char* payload);
+
 /*
  * Tworzy unikalny topic MQTT na podstawie adresu MAC urządzenia BLE.
  * Format: "kurnik/MAC_ADDRESS"
@@ -48,10 +67,18 @@ void PolaczDoMQTT();
 void InicjalizacjaTopicuZ_MAC();
 
 /*
- * Wysyła pakiet danych z wagą kury przez MQTT.
+ * Wysyła pakiet danych z wagą kury jako rekord tak jak WyslijPakiet()
+ * (QoS 1, archiwum po PUBACK, kolejka offline bez potwierdzenia).
  * Format: id_urządzenia;id_kury;waga;timestamp
  */
-void WyslijPakietKura(int id_urzadzenia, const char* id_kury, float waga, String timestamp);
+void WyslijPakietKura(int id_urzadzenia, const char* id_kury, float waga, const char* timestamp);
+
+/*
+ * Wysyła agregat okna pomiarów węzła jako rekord tak jak WyslijPakiet()
+ * (QoS 1, archiwum po PUBACK, kolejka offline bez potwierdzenia).
+ * Format: id;okres_s;probki;{min;max;srednia;odchylenie} x5 pól;timestamp
+ */
+void WyslijPakietAgregat(const Pakiet_Agregatu* agregat);
 
 /*
  * Callback wywoływany po otrzymaniu wiadomości MQTT.
@@ -61,11 +88,18 @@ void OdpowiedzMQTT(char *topic, byte *payload, unsigned int length);
 
 /*
  * Wysyła pakiet danych z czujników przez MQTT.
- * Automatycznie zapisuje dane do karty SD (backup lub kolejka).
+ * Zapis na kartę SD (backup lub kolejka) następuje po potwierdzeniu
+ * lub przekroczeniu czasu - patrz dostarczanie_mqtt.h.
  * 
  * parametr: pakiet Wskaźnik do struktury Pakiet_Danych do wysłania
  */
-void WyslijPakiet(Pakiet_Danych* pakiet);
+void WyslijPakiet(const Pakiet_Danych* pakiet);
+
+/*
+ * Formatuje pakiet do rekordu CSV "ID;temp;hum;co2;nh3;sun;timestamp".
+ * return: długość rekordu (bez '\0')
+ */
+size_t FormatujPakietCSV(const Pakiet_Danych* pakiet, char* bufor, size_t rozmiar);
 /*
  * Funkcja testowa - wypełnia tablicę pakietów sinusoidalnymi danymi.
  * Używana do testów bez fizycznych czujników.
@@ -75,6 +109,11 @@ void WyslijPakiet(Pakiet_Danych* pakiet);
  */
 void TEST_zapelnij_pakiet(Pakiet_Danych* pakiet, int wielkosc);
 
-void TEST_pakiet(Pakiet_Danych* pakiet);
+/**
+ * Wypełnia pakiet wartościami z migawki czujników.
+ *
+ * return: false gdy migawka nie ma ważnego odczytu DHT22 (pakiet nie powinien być wysłany)
+ */
+bool TEST_pakiet(Pakiet_Danych* pakiet);
 
 #endif
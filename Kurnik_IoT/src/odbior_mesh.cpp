@@ -0,0 +1,214 @@
+/*
+ * odbior_mesh.cpp
+ *
+ * Wiadomości z danymi węzłów przychodzą z receivedCallback() (pętla Arduino)
+ * lub z symulatora ruchu. Zdekodowane pakiety trafiają do kolejki uplinku -
+ * MQTT i karta SD są obsługiwane w zadaniu uplinku.
+ */
+
+#include "odbior_mesh.h"
+#include "ramka_mesh.h"
+#include "dyspozytor_mesh.h"
+#include "uplink.h"
+#include "dziennik.h"
+
+// === PARSOWANIE W MIEJSCU (bez kopiowania do String) ===
+// Każda funkcja oczekuje separatora ';' pod wskaźnikiem i przesuwa wskaźnik za odczytane pole.
+// Bufor wiadomości painlessMesh jest zakończony '\0', więc strtol/strtof nie wyjdą poza niego.
+
+static bool czytajPoleInt(const char*& p, int* wynik) {
+    if (*p != ';') return false;
+    char* koniec;
+    long v = strtol(p + 1, &koniec, 10);
+    if (koniec == p + 1) return false;
+    *wynik = (int)v;
+    p = koniec;
+    return true;
+}
+
+static bool czytajPoleFloat(const char*& p, float* wynik) {
+    if (*p != ';') return false;
+    char* koniec;
+    float v = strtof(p + 1, &koniec);
+    if (koniec == p + 1) return false;
+    *wynik = v;
+    p = koniec;
+    return true;
+}
+
+// Kopiuje pole tekstowe do najbliższego ';' (lub końca wiadomości) do bufora docelowego
+static bool czytajPoleTekst(const char*& p, const char* koniec, char* wynik, size_t rozmiar) {
+    if (*p != ';') return false;
+    const char* start = ++p;
+    while (p < koniec && *p != ';') p++;
+    size_t n = (size_t)(p - start);
+    if (n == 0 || n >= rozmiar) return false;
+    memcpy(wynik, start, n);
+    wynik[n] = '\0';
+    return true;
+}
+
+bool ParsujPakietDane(const char* dane, size_t dlugosc, Pakiet_Danych* pakiet, int* pozycjaBledu) {
+    const char* p = dane;
+    const char* koniec = dane + dlugosc;
+    memset(pakiet, 0, sizeof(*pakiet));
+
+    bool ok = czytajPoleInt(p, &pakiet->ID_urzadzenia)
+           && czytajPoleFloat(p, &pakiet->temperatura)
+           && czytajPoleFloat(p, &pakiet->wilgotnosc)
+           && czytajPoleInt(p, &pakiet->poziom_co2)
+           && czytajPoleInt(p, &pakiet->poziom_amoniaku)
+           && czytajPoleInt(p, &pakiet->naslonecznienie)
+           && czytajPoleTekst(p, koniec, pakiet->data_i_czas, sizeof(pakiet->data_i_czas));
+
+    // Opcjonalne pola strefy martwej węzła: ;przeniesione;pominiete
+    if (ok && p < koniec) {
+        int przeniesione = 0, pominiete = 0;
+        ok = czytajPoleInt(p, &przeniesione) && czytajPoleInt(p, &pominiete);
+        pakiet->przeniesione = (uint8_t)przeniesione;
+        pakiet->pominiete    = (uint16_t)pominiete;
+    }
+
+    if (!ok && pozycjaBledu) *pozycjaBledu = (int)(p - dane);
+    return ok;
+}
+
+// === OBSŁUGA WIADOMOŚCI (rejestrowane w dyspozytorze w OdbiorMeshInicjalizacja) ===
+
+// DANE;ID;temp;hum;co2;nh3;sun;timestamp[;przeniesione;pominiete]
+static void obsluzDane(uint32_t from, const char* dane, size_t dlugosc) {
+    Pakiet_Danych pakiet;
+    int pozycja = 0;
+
+    if (!ParsujPakietDane(dane, dlugosc, &pakiet, &pozycja)) {
+        LOG_BLAD("[Mesh] BŁĄD: Nieprawidłowy format pakietu DANE od węzła %u (pozycja %d)",
+            from, pozycja);
+        return;
+    }
+    ZakolejkujPakiet(&pakiet);
+}
+
+// KURA;id_urządzenia;id_kury;waga;data
+// Przykład: KURA;692641124;F7474A39;-0.37;23:44:15 Wed, Jan 28 2026
+static void obsluzKura(uint32_t from, const char* dane, size_t dlugosc) {
+    const char* p = dane;
+    const char* koniec = dane + dlugosc;
+    int id_urzadzenia;
+    char id_kury[2 * RAMKA_MAX_UID + 1];
+    float waga;
+    char timestamp[RAMKA_CZAS_DL];
+
+    bool ok = czytajPoleInt(p, &id_urzadzenia)
+           && czytajPoleTekst(p, koniec, id_kury, sizeof(id_kury))
+           && czytajPoleFloat(p, &waga)
+           && czytajPoleTekst(p, koniec, timestamp, sizeof(timestamp));
+
+    if (!ok) {
+        LOG_BLAD("[Mesh] BŁĄD: Nieprawidłowy format pakietu KURA od węzła %u (pozycja %d)",
+            from, (int)(p - dane));
+        return;
+    }
+    ZakolejkujPakietKura(id_urzadzenia, id_kury, waga, timestamp);
+}
+
+// Przepisuje zdekodowaną ramkę DANE (także próbkę z paczki) do pakietu uplinku
+static void ramkaDaneNaPakiet(const RamkaDane* ramka, Pakiet_Danych* pakiet) {
+    pakiet->ID_urzadzenia   = (int)ramka->naglowek.id_wezla;
+    pakiet->temperatura     = ramka->temperatura_c / 100.0f;
+    pakiet->wilgotnosc      = ramka->wilgotnosc_c / 100.0f;
+    pakiet->poziom_co2      = ramka->poziom_co2;
+    pakiet->poziom_amoniaku = ramka->poziom_amoniaku;
+    pakiet->naslonecznienie = ramka->naslonecznienie == RAMKA_BRAK_SWIATLA ? -1 : (int)ramka->naslonecznienie;
+    pakiet->przeniesione    = ramka->przeniesione;
+    pakiet->pominiete       = ramka->pominiete;
+    ramkaFormatujCzas(ramka->naglowek.epoch, pakiet->data_i_czas, sizeof(pakiet->data_i_czas));
+}
+
+/*
+ * Obsługuje binarną ramkę "RAMK<base64>" (format w CommonSource/src/ramka_mesh.h).
+ * Dekodowanie odbywa się w buforach na stosie - bez alokacji String.
+ */
+static void obsluzRamke(uint32_t from, const char* tekst, size_t dlugosc) {
+    uint8_t bufor[RAMKA_MAX_BAJTY];
+    size_t n = ramkaZTekstu(tekst, dlugosc, bufor, sizeof(bufor));
+    uint8_t typ = ramkaSprawdz(bufor, n);
+
+    if (typ == RAMKA_TYP_DANE || typ == RAMKA_TYP_DANE_STREFA) {
+        RamkaDane ramka;
+        if (!ramkaDekodujDane(bufor, n, &ramka)) {
+            LOG_BLAD("[Mesh] BŁĄD: Nieprawidłowa ramka DANE od węzła %u", from);
+            return;
+        }
+        Pakiet_Danych pakiet;
+        ramkaDaneNaPakiet(&ramka, &pakiet);
+        ZakolejkujPakiet(&pakiet);
+    }
+    else if (typ == RAMKA_TYP_PACZKA) {
+        // Jedno dekodowanie i sprawdzenie CRC dla wszystkich próbek paczki
+        RamkaPaczka paczka;
+        if (!ramkaDekodujPaczke(bufor, n, &paczka)) {
+            LOG_BLAD("[Mesh] BŁĄD: Nieprawidłowa ramka PACZKA od węzła %u", from);
+            return;
+        }
+        Pakiet_Danych pakiet;
+        for (uint8_t i = 0; i < paczka.liczba; i++) {
+            ramkaDaneNaPakiet(&paczka.probki[i], &pakiet);
+            ZakolejkujPakiet(&pakiet);
+        }
+    }
+    else if (typ == RAMKA_TYP_KURA) {
+        RamkaKura ramka;
+        if (!ramkaDekodujKura(bufor, n, &ramka)) {
+            LOG_BLAD("[Mesh] BŁĄD: Nieprawidłowa ramka KURA od węzła %u", from);
+            return;
+        }
+        char id_kury[2 * RAMKA_MAX_UID + 1];
+        char czas[RAMKA_CZAS_DL];
+        ramkaUidNaHex(ramka.uid, ramka.uid_dlugosc, id_kury, sizeof(id_kury));
+        ramkaFormatujCzas(ramka.naglowek.epoch, czas, sizeof(czas));
+        ZakolejkujPakietKura((int)ramka.naglowek.id_wezla, id_kury, ramka.waga_c / 100.0f, czas);
+    }
+    else if (typ == RAMKA_TYP_AGREGAT) {
+        Pakiet_Agregatu agregat;
+        RamkaAgregat ramka;
+        if (!ramkaDekodujAgregat(bufor, n, &ramka)) {
+            LOG_BLAD("[Mesh] BŁĄD: Nieprawidłowa ramka AGREGAT od węzła %u", from);
+            return;
+        }
+        agregat.id_urzadzenia = (int)ramka.naglowek.id_wezla;
+        agregat.okres_s       = ramka.okres_s;
+        agregat.probki        = ramka.probki;
+        memcpy(agregat.pola, ramka.pola, sizeof(agregat.pola));
+        ramkaFormatujCzas(ramka.naglowek.epoch, agregat.data_i_czas, sizeof(agregat.data_i_czas));
+        ZakolejkujPakietAgregat(&agregat);
+    }
+    else {
+        LOG_BLAD("[Mesh] BŁĄD: Odrzucono ramkę binarną od węzła %u (CRC/wersja/typ)", from);
+    }
+}
+
+void OdbiorMeshInicjalizacja() {
+    static const struct {
+        uint32_t tag;
+        const char* nazwa;
+        ObslugaWiadomosciMesh obsluga;
+    } OBSLUGI[] = {
+        { TagMesh("DANE"),       "DANE",       &obsluzDane },
+        { TagMesh("KURA"),       "KURA",       &obsluzKura },
+        { TagMesh(RAMKA_PREFIX), RAMKA_PREFIX, &obsluzRamke },
+    };
+    for (const auto& o : OBSLUGI) {
+        // Kolizja slotów tablicy dyspozytora - wiadomości tego typu byłyby odrzucane
+        if (!RejestrujObslugeMesh(o.tag, o.obsluga)) {
+            LOG_BLAD("[Mesh] BŁĄD: Nie zarejestrowano obsługi %s w dyspozytorze", o.nazwa);
+        }
+    }
+}
+
+void receivedCallback( uint32_t from, String &msg ) {
+    LOG_DEBUG("[Mesh] Odebrano wiadomość od węzła %u: %s", from, msg.c_str());
+
+    if (!ObsluzWiadomoscMesh(from, msg.c_str(), msg.length())) {
+        LOG_OSTRZEZENIE("[Mesh] UWAGA: Nieznany typ wiadomości (prefix: %.4s)", msg.c_str());
+    }
+}
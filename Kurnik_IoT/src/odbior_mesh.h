@@ -0,0 +1,34 @@
+/*
+ * MODUŁ ODBIORU DANYCH MESH - odbior_mesh.h
+ *
+ * Obsługa wiadomości z danymi węzłów: tekstowych "DANE;..." i "KURA;..."
+ * oraz binarnych ramek "RAMK<base64>" (ramka_mesh.h). Wiadomości są
+ * parsowane w miejscu, a pakiety trafiają do kolejki uplinku (uplink.h).
+ *
+ * Moduł nie zależy od painlessMesh (mesh_local.h tylko podpina
+ * receivedCallback()), więc kompiluje się też w testach hosta (env:native).
+ */
+
+#ifndef ODBIOR_MESH_H
+#define ODBIOR_MESH_H
+
+#include "main.h"
+
+/*
+ * Rejestruje obsługę DANE, KURA i RAMK w dyspozytorze (dyspozytor_mesh.h).
+ * Wywoływana przez InicjalizacjaMesh().
+ */
+void OdbiorMeshInicjalizacja();
+
+/*
+ * Parsuje treść wiadomości "DANE" (za tagiem, od ';') w miejscu, bez alokacji.
+ * pozycjaBledu (opcjonalnie) - przesunięcie pola, na którym parsowanie się nie powiodło
+ */
+bool ParsujPakietDane(const char* dane, size_t dlugosc, Pakiet_Danych* pakiet, int* pozycjaBledu);
+
+/*
+ * Callback odbioru painlessMesh - przekazuje wiadomość do dyspozytora.
+ */
+void receivedCallback(uint32_t from, String &msg);
+
+#endif
@@ -219,7 +219,7 @@ void OLEDDisplay::showSensorReadings(float dhtT, float dhtH, float ntcT, int ldr
 
   // LDR (percent)
   // LDR w luksach
-  snprintf(buf, sizeof(buf), "%d lx", ldr);
+  if(ldr >= 0) snprintf(buf, sizeof(buf), "%d lx", ldr); else strcpy(buf, "---");
   _printValueLabel("LDR:", buf, 40);
 
   // eCO2 (ppm)
@@ -6,9 +6,9 @@
  * - Inicjalizację karty SD 
  * - Operacje na plikach (tworzenie, odczyt, zapis, usuwanie)
  * - System kolejkowania danych offline:
- *   * backup_data.txt - archiwum pomyślnie wysłanych danych
- *   * transfer_waitlist.txt - kolejka danych do ponownego wysłania
- * - Automatyczne ponowne wysyłanie danych po odzyskaniu połączenia MQTT
+ *   * /archiwum/ - rotowane segmenty archiwum pomyślnie wysłanych danych (archiwum_SD.h)
+ *   * /kolejka/ - segmentowa kolejka danych do ponownego wysłania (kolejka_SD.h)
+ * - Automatyczne ponowne wysyłanie danych po odzyskaniu połączenia MQTT (ponowna_wysylka.h)
  * 
  * Konfiguracja sprzętowa SPI (VSPI):
  * - SCK (Serial Clock):  GPIO 18
@@ -20,6 +20,12 @@
 
 #include "pamiec_SD.h"
 #include "mqtt.h"
+#include "rejestrator_SD.h"
+#include "kolejka_SD.h"
+#include "archiwum_SD.h"
+#include "symulator_ruchu.h"
+#include "licznik_alokacji.h"
+#include "dziennik.h"
 
 // Instancja SPI dla karty SD (VSPI)
 SPIClass spi = SPIClass(VSPI);
@@ -120,20 +126,18 @@ void readFile(fs::FS &fs, const char * path){
  * parametr: message Tekst do zapisania w pliku
  */
 void writeFile(fs::FS &fs, const char * path, const char * message){
-  Serial.printf("Writing file: %s\n", path);
+  LOG_DEBUG("Writing file: %s", path);
 
   // Otwórz plik w trybie zapisu (FILE_WRITE nadpisuje istniejący plik)
   File file = fs.open(path, FILE_WRITE);
   if(!file){
-    Serial.println("Failed to open file for writing");
+    LOG_BLAD("Failed to open file for writing: %s", path);
     return;
   }
   
   // Zapisz tekst do pliku
-  if(file.print(message)){
-    Serial.println("File written");
-  } else {
-    Serial.println("Write failed");
+  if(!file.print(message)){
+    LOG_BLAD("Write failed: %s", path);
   }
   file.close();
 }
@@ -148,23 +152,21 @@ void writeFile(fs::FS &fs, const char * path, const char * message){
  * 
  * Używana głównie do zapisywania danych pomiarowych do:
  * - /backup_data.txt (archiwum)
- * - /transfer_waitlist.txt (kolejka)
+ * - /transfer_waitlist.txt (dawna kolejka)
  */
 void appendFile(fs::FS &fs, const char * path, const char * message){
-  Serial.printf("Dopisuję do pliku: %s\n", path);
+  LOG_DEBUG("Dopisuję do pliku: %s", path);
 
   // Otwórz plik w trybie dopisywania (FILE_APPEND)
   File file = fs.open(path, FILE_APPEND);
   if(!file){
-    Serial.println("Nie udało się otworzyć pliku do dopisania");
+    LOG_BLAD("Nie udało się otworzyć pliku do dopisania: %s", path);
     return;
   }
   
   // Dopisz tekst na końcu pliku
-  if(file.print(message)){
-    Serial.println("Wiadomosc dopisana");
-  } else {
-    Serial.println("Wiadomosc nie dopisana, blad zapisu");
+  if(!file.print(message)){
+    LOG_BLAD("Wiadomosc nie dopisana, blad zapisu: %s", path);
   }
   file.close();
 }
@@ -177,11 +179,9 @@ void appendFile(fs::FS &fs, const char * path, const char * message){
  * parametr: path2 Nowa ścieżka pliku
  */
 void renameFile(fs::FS &fs, const char * path1, const char * path2){
-  Serial.printf("Renaming file %s to %s\n", path1, path2);
-  if (fs.rename(path1, path2)) {
-    Serial.println("File renamed");
-  } else {
-    Serial.println("Rename failed");
+  LOG_DEBUG("Renaming file %s to %s", path1, path2);
+  if (!fs.rename(path1, path2)) {
+    LOG_BLAD("Rename failed: %s -> %s", path1, path2);
   }
 }
 
@@ -195,11 +195,9 @@ void renameFile(fs::FS &fs, const char * path1, const char * path2){
  * W przeciwnym razie może wystąpić błąd "bad arguments".
  */
 void deleteFile(fs::FS &fs, const char * path){
-  Serial.printf("Deleting file: %s\n", path);
-  if(fs.remove(path)){
-    Serial.println("File deleted");
-  } else {
-    Serial.println("Delete failed");
+  LOG_DEBUG("Deleting file: %s", path);
+  if(!fs.remove(path)){
+    LOG_BLAD("Delete failed: %s", path);
   }
 }
 
@@ -213,7 +211,8 @@ void deleteFile(fs::FS &fs, const char * path){
  * 3. Sprawdza typ karty (MMC, SD, SDHC)
  * 4. Wyświetla rozmiar karty
  * 5. Czyści niepotrzebne pliki (zachowuje tylko backup_data.txt i transfer_waitlist.txt)
- * 6. Tworzy pliki systemowe jeśli nie istnieją
+ * 6. Odtwarza archiwum i kolejkę offline (backup_data.txt i transfer_waitlist.txt
+ *    są do nich przenoszone przy pierwszym uruchomieniu)
  * 
  */
 void InicjalizacjaSD(){
@@ -256,6 +255,7 @@ void InicjalizacjaSD(){
 
   // ===== CZYŚCCENIE KARTY SD =====
   // Usuń wszystkie pliki oprócz backup_data.txt i transfer_waitlist.txt
+  // (dawne pliki archiwum i kolejki - zachowywane do migracji do segmentów)
   Serial.println("Czyszczenie karty SD z niepotrzebnych plików...");
   
   // Najpierw zbierz nazwy plików do usunięcia (maksymalnie 50)
@@ -297,35 +297,10 @@ void InicjalizacjaSD(){
     Serial.println("Nie można otworzyć katalogu głównego SD");
   }
 
-  // ===== TWORZENIE PLIKÓW SYSTEMOWYCH =====
-  // Utwórz backup_data.txt jeśli nie istnieje
-  if (!SD.exists("/backup_data.txt")) {
-    Serial.println("Tworzenie pliku backup_data.txt");
-    File backupFile = SD.open("/backup_data.txt", FILE_WRITE);
-    if (backupFile) {
-      backupFile.close();
-      Serial.println("Utworzono backup_data.txt");
-    } else {
-      Serial.println("Nie udało się utworzyć backup_data.txt");
-    }
-  } else {
-    Serial.println("Plik backup_data.txt już istnieje");
-  }
-
-  // Utwórz transfer_waitlist.txt jeśli nie istnieje
-  if (!SD.exists("/transfer_waitlist.txt")) {
-    Serial.println("Tworzenie pliku transfer_waitlist.txt");
-    File waitlistFile = SD.open("/transfer_waitlist.txt", FILE_WRITE);
-    if (waitlistFile) {
-      waitlistFile.close();
-      Serial.println("Utworzono transfer_waitlist.txt");
-    } else {
-      Serial.println("Nie udało się utworzyć transfer_waitlist.txt");
-    }
-  } else {
-    Serial.println("Plik transfer_waitlist.txt już istnieje");
-  }
-
+  // Od teraz zapisy idą przez buforowany rejestrator do segmentów w podkatalogach
+  RejestratorInicjalizacja();
+  ArchiwumInicjalizacja();
+  KolejkaInicjalizacja();
 }
 
 /**
@@ -335,106 +310,30 @@ void InicjalizacjaSD(){
  * parametr: mqttSuccess Czy wysyłanie przez MQTT się udało
  * 
  * Decyzja o pliku docelowym:
- * - mqttSuccess = true  → zapisz do /backup_data.txt (archiwum)
- * - mqttSuccess = false → zapisz do /transfer_waitlist.txt (kolejka do ponownego wysłania)
+ * - mqttSuccess = true  → zapisz do archiwum /archiwum/
+ * - mqttSuccess = false → dopisz do kolejki offline /kolejka/ (do ponownego wysłania)
  * 
- * Dane są zapisywane z nową linią na końcu (\n).
+ * Dane są zapisywane z nową linią na końcu (\n) przez buforowany rejestrator
+ * (rejestrator_SD.h) - fizyczny zapis na kartę następuje porcjami.
  */
 void ZapiszDanePakiet(const char* data, bool mqttSuccess) {
-  const char* filepath;
-  
+  // Rekordy symulatora ruchu nie trafiają na kartę (symulator_ruchu.h)
+  if (SymulatorRekord(data)) {
+    SymulatorPominZapis(data, mqttSuccess);
+    return;
+  }
+
+  ZakresPodsystemu zakres(PODSYSTEM_SD);
+  uint32_t start = micros();
+
   // Wybierz plik docelowy w zależności od statusu MQTT
   if (mqttSuccess) {
-    filepath = "/backup_data.txt";
-    Serial.println("Zapisuję dane do backup_data.txt (MQTT wysłano)");
+    ArchiwumDopisz(data);
   } else {
-    filepath = "/transfer_waitlist.txt";
-    Serial.println("Zapisuję dane do transfer_waitlist.txt (MQTT nieudane)");
+    KolejkaDopisz(data);
   }
-  
-  // Połącz dane z nową linią w jeden string
-  String dataWithNewline = String(data) + "\n";
-  
-  // Dopisz dane na końcu pliku
-  appendFile(SD, filepath, dataWithNewline.c_str());
-}
 
-/**
- * Ponownie wysyła dane z kolejki po odzyskaniu połączenia MQTT.
- * 
- * Proces:
- * 1. Sprawdza czy MQTT jest połączony - jeśli nie, kończy działanie
- * 2. Otwiera plik /transfer_waitlist.txt
- * 3. Czyta linia po linii
- * 4. Próbuje wysłać każdą linię przez MQTT
- * 5. Jeśli wysyłanie się uda, przenosi dane do /backup_data.txt
- * 6. Jeśli wszystkie dane zostały wysłane, czyści plik transfer_waitlist.txt
- * 
- * Wywoływana automatycznie:
- * - W setup() po nawiązaniu połączenia MQTT
- * - W loop() po wykryciu odnowienia połączenia MQTT (flaga mqttByloPolaczone)
- * 
- * Delay: 100ms między wysyłkami aby nie przeciążyć brokera MQTT
- */
-void PonowWyslijZKolejki() {
-  const char* waitlist_path = "/transfer_waitlist.txt";
-  const char* backup_path = "/backup_data.txt";
-  
-  // Sprawdź czy MQTT jest połączony
-  if (!asyncMqttClient.connected()) {
-    Serial.println("MQTT niepodłączony - pomijam ponowne wysyłanie z kolejki");
-    return;  // Nie ma sensu próbować bez MQTT
-  }
-  
-  // Otwórz plik z kolejką
-  File waitlistFile = SD.open(waitlist_path);
-  if (!waitlistFile) {
-    Serial.println("Brak pliku transfer_waitlist.txt lub jest pusty");
-    return;
-  }
-  
-  Serial.println("Rozpoczynam ponowne wysyłanie danych z kolejki...");
-  int wyslanoDanych = 0;      // Licznik pomyślnie wysłanych pakietów
-  int nieudanychDanych = 0;   // Licznik nieudanych wysyłek
-  
-  // Czytaj plik linia po linii
-  while (waitlistFile.available()) {
-    String linia = waitlistFile.readStringUntil('\n');
-    linia.trim(); // Usuń białe znaki (spacje, \r, \n)
-    
-    if (linia.length() == 0) continue; // Pomiń puste linie
-    
-    // Spróbuj wysłać przez MQTT
-    uint16_t packetId = asyncMqttClient.publish(topic, 0, false, linia.c_str());
-    
-    if (packetId != 0 && asyncMqttClient.connected()) {
-      // Udane wysłanie - dopisz do backup_data.txt
-      appendFile(SD, backup_path, linia.c_str());
-      appendFile(SD, backup_path, "\n");
-      wyslanoDanych++;
-      Serial.printf("Ponownie wysłano: %s\n", linia.c_str());
-    } else {
-      // Nieudane - zostaw w kolejce (nie robimy nic)
-      nieudanychDanych++;
-      Serial.printf("Nie udało się ponownie wysłać: %s\n", linia.c_str());
-    }
-    
-    delay(100); // Krótka przerwa między wysyłkami (nie przeciążaj brokera)
-  }
-  
-  waitlistFile.close();
-  
-  // Jeśli wysłano wszystkie dane, wyczyść plik transfer_waitlist
-  if (wyslanoDanych > 0 && nieudanychDanych == 0) {
-    Serial.println("Wszystkie dane wysłano - czyszczenie transfer_waitlist.txt");
-    deleteFile(SD, waitlist_path);
-  } else if (wyslanoDanych > 0) {
-    // Jeśli wysłano część, trzeba by było przepisać plik bez wysłanych danych
-    // To jest bardziej skomplikowane - na razie zostawiamy wszystko w pliku
-    Serial.printf("Wysłano %d pakietów, %d pozostało w kolejce\n", wyslanoDanych, nieudanychDanych);
-  }
-  
-  Serial.printf("Zakończono ponowne wysyłanie: %d udanych, %d nieudanych\n", wyslanoDanych, nieudanychDanych);
+  SymulatorZmierz(ETAP_ZAPIS_SD, micros() - start);
 }
 
 /**
@@ -447,12 +346,17 @@ void PonowWyslijZKolejki() {
  * 3. Zamyka wszystkie handle plików
  * 4. Usuwa wszystkie zebrane pliki
  * 
- * UWAGA: Funkcja usuwa RÓWNIEź pliki systemowe (backup_data.txt, transfer_waitlist.txt)!
+ * UWAGA: Funkcja usuwa RÓWNIEź całe archiwum i całą kolejkę offline!
  * Po wyczyszczeniu należy wywołać InicjalizacjaSD() aby odtworzyć strukturę plików.
  */
 void WyczyscKarteSD() {
   Serial.println("Czyszczenie całej karty SD...");
   
+  // Zamknij pliki rejestratora - usuwanie otwartego pliku kończy się błędem
+  RejestratorZamknij();
+  ArchiwumWyczysc();
+  KolejkaWyczysc();
+  
   // Otwórz katalog główny
   File root = SD.open("/");
   if (!root) {
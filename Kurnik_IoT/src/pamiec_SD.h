@@ -44,30 +44,20 @@ void deleteFile(fs::FS &fs, const char * path);
  * - Montuje kartę SD przez interfejs SPI
  * - Usuwa niepotrzebne pliki (zachowuje backup_data.txt i transfer_waitlist.txt)
  * - Tworzy pliki systemowe jeśli nie istnieją
+ * - Odtwarza archiwum (/archiwum/) i kolejkę offline (/kolejka/)
  */
 void InicjalizacjaSD();
 
 /*
  * Zapisuje pakiet danych do odpowiedniego pliku na karcie SD.
- * - Jeśli MQTT zadziałało -> backup_data.txt (kopia zapasowa)
- * - Jeśli MQTT nie zadziałało -> transfer_waitlist.txt (kolejka do ponownej wysyłki)
+ * - Jeśli MQTT zadziałało -> archiwum /archiwum/ (kopia zapasowa)
+ * - Jeśli MQTT nie zadziałało -> kolejka offline /kolejka/ (do ponownej wysyłki)
  * 
  * parametr: data String z danymi do zapisania (format CSV)
  * parametr: mqttSuccess Status wysyłki MQTT (true = sukces, false = błąd)
  */
 void ZapiszDanePakiet(const char* data, bool mqttSuccess);
 
-/*
- * Ponownie wysyła wszystkie dane z kolejki przez MQTT.
- * - Odczytuje transfer_waitlist.txt
- * - Próbuje wysłać każdą linię przez MQTT
- * - Przenosi wysłane dane do backup_data.txt
- * - Czyści kolejkę jeśli wszystko wysłano
- * 
- * Wywoływana automatycznie po nawiązaniu połączenia MQTT.
- */
-void PonowWyslijZKolejki();
-
 /*
  * Czyści całą kartę SD ze wszystkich plików.
  * Używana podczas pełnego resetu systemu.
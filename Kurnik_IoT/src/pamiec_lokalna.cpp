@@ -6,7 +6,10 @@
  * - Zapisywanie SSID i hasła WiFi do EEPROM
  * - Odczytywanie zapisanych danych przy starcie
  * - Reset pamięci (usunięcie danych WiFi)
- * 
+ *
+ * Bufor EEPROM i commit() do flash są wspólne dla danych WiFi (pętla, BLE)
+ * i bazy SGP30 (zadanie SGP30 na rdzeniu 0), więc każda funkcja modułu
+ * działa pod jednym mutexem.
  */
 
 #include "pamiec_lokalna.h"
@@ -22,6 +25,33 @@ static constexpr int SSID_LEN_ADDR = 0;                      // Adres długości
 static constexpr int SSID_ADDR = 1;                          // Początek SSID (adres 1)
 static constexpr int PASS_LEN_ADDR = (SSID_ADDR + SSID_MAX); // Adres długości hasła (33)
 static constexpr int PASS_ADDR = (PASS_LEN_ADDR + 1);        // Początek hasła (adres 34)
+static constexpr int BAZA_SGP_ADDR = 128;                    // Baza SGP30 (za danymi WiFi)
+static constexpr uint32_t BAZA_SGP_ZNACZNIK = 0x42504753;    // "SGPB"
+
+// Rekord bazy SGP30 w EEPROM
+typedef struct {
+    uint32_t znacznik;
+    BazaSGP baza;
+    uint8_t suma;             // XOR bajtów bazy
+} RekordBazySGP;
+
+static SemaphoreHandle_t eepromMutex = nullptr;
+
+// Bez mutexu (przed inicjalizacją) działa tylko setup() - brak współbieżności
+static inline void zablokuj() {
+    if (eepromMutex) xSemaphoreTake(eepromMutex, portMAX_DELAY);
+}
+
+static inline void odblokuj() {
+    if (eepromMutex) xSemaphoreGive(eepromMutex);
+}
+
+static uint8_t sumaBazy(const BazaSGP* baza) {
+    const uint8_t* b = (const uint8_t*)baza;
+    uint8_t suma = 0x5A;
+    for (size_t i = 0; i < sizeof(BazaSGP); i++) suma ^= b[i];
+    return suma;
+}
 
 /**
  * Inicjalizuje pamięć EEPROM.
@@ -31,6 +61,10 @@ static constexpr int PASS_ADDR = (PASS_LEN_ADDR + 1);        // Początek hasła
  * Wywoływana w setup() przed próbą odczytu danych.
  */
 void InicjalizacjaPamieci() {
+    if (!eepromMutex) {
+        eepromMutex = xSemaphoreCreateMutex();
+    }
+
 #if defined(ESP32) || defined(ESP8266)
     // ESP32/ESP8266 wymagają inicjalizacji EEPROM z podanym rozmiarem
     EEPROM.begin(EEPROM_SIZE);
@@ -53,12 +87,17 @@ void InicjalizacjaPamieci() {
  * Dane są wczytywane do globalnych buforów: wifi_ssid i wifi_password
  */
 bool WczytanieDanychEEPROM() {
+    zablokuj();
+
     // Odczytaj długość SSID z adresu 0
     byte ssid_len = EEPROM.read(SSID_LEN_ADDR);
     
     // Walidacja długości SSID
     // 0xFF = pusta EEPROM, 0 = brak danych, > SSID_MAX = błąd
-    if (ssid_len == 0xFF || ssid_len == 0 || ssid_len > SSID_MAX) return false;
+    if (ssid_len == 0xFF || ssid_len == 0 || ssid_len > SSID_MAX) {
+        odblokuj();
+        return false;
+    }
 
     // Wczytaj SSID znak po znaku
     for (int i = 0; i < ssid_len && i < SSID_MAX; i++) {
@@ -77,6 +116,7 @@ bool WczytanieDanychEEPROM() {
         wifi_password[i] = (char)EEPROM.read(PASS_ADDR + i);
     }
     wifi_password[pass_len] = '\0';  // Dodaj null terminator
+    odblokuj();
 
     // Ustaw flagę wifiConfigured na true
     wifiConfigured = true;
@@ -100,7 +140,9 @@ void ZapiszDaneDoEEPROM() {
     // Oblicz długość SSID i ogranicz do maksymalnej (32)
     byte ssid_len = strlen(wifi_ssid);
     if (ssid_len > SSID_MAX) ssid_len = SSID_MAX;
-    
+
+    zablokuj();
+
     // Zapisz długość SSID
     EEPROM.write(SSID_LEN_ADDR, ssid_len);
     
@@ -124,13 +166,47 @@ void ZapiszDaneDoEEPROM() {
 #if defined(ESP32) || defined(ESP8266)
     // KRYTYCZNE: commit() zapisuje zmiany do flash na ESP32/ESP8266
     EEPROM.commit();
+    odblokuj();
     Serial.println("Zapisano dane do EEPROM");
 #else
     // Na innych platformach zapis jest automatyczny
+    odblokuj();
     Serial.println("Zapisano dane do EEPROM");
 #endif
 }
 
+/**
+ * Wczytuje bazę kalibracji SGP30 zapisaną przez ZapiszBazeSGP().
+ *
+ * return: false jeśli brak znacznika lub suma kontrolna się nie zgadza
+ */
+bool WczytajBazeSGP(BazaSGP* baza) {
+    RekordBazySGP rekord;
+    zablokuj();
+    EEPROM.get(BAZA_SGP_ADDR, rekord);
+    odblokuj();
+    if (rekord.znacznik != BAZA_SGP_ZNACZNIK || rekord.suma != sumaBazy(&rekord.baza)) return false;
+    *baza = rekord.baza;
+    return true;
+}
+
+/**
+ * Zapisuje bazę kalibracji SGP30 (wywoływane co godzinę z zadania SGP30,
+ * pod tym samym mutexem co zapisy danych WiFi z pętli i BLE).
+ */
+void ZapiszBazeSGP(const BazaSGP* baza) {
+    RekordBazySGP rekord;
+    rekord.znacznik = BAZA_SGP_ZNACZNIK;
+    rekord.baza = *baza;
+    rekord.suma = sumaBazy(baza);
+    zablokuj();
+    EEPROM.put(BAZA_SGP_ADDR, rekord);
+#if defined(ESP32) || defined(ESP8266)
+    EEPROM.commit();
+#endif
+    odblokuj();
+}
+
 /**
  * Resetuje pamięć EEPROM - usuwa zapisane dane WiFi.
  * Wywoływana podczas komendy "reset" z Serial Monitor.
@@ -138,11 +214,14 @@ void ZapiszDaneDoEEPROM() {
  * Proces:
  * 1. Ustawia długości SSID i hasła na 0xFF (pusta EEPROM)
  * 2. Zeruje wszystkie bajty SSID i hasła
- * 3. Commituje zmiany (ESP32/ESP8266)
+ * 3. Usuwa znacznik bazy SGP30
+ * 4. Commituje zmiany (ESP32/ESP8266)
  * 
  * Po resecie urządzenie uruchomi się w trybie BLE provisioning.
  */
 void ResetPamiec() {
+    zablokuj();
+
     // Ustaw długości na 0xFF (znacznik pustej EEPROM)
     EEPROM.write(SSID_LEN_ADDR, 0xFF);
     EEPROM.write(PASS_LEN_ADDR, 0xFF);
@@ -157,8 +236,12 @@ void ResetPamiec() {
         EEPROM.write(PASS_ADDR + i, 0);
     }
 
+    // Unieważnij bazę SGP30
+    EEPROM.put(BAZA_SGP_ADDR, (uint32_t)0xFFFFFFFF);
+
 #if defined(ESP32) || defined(ESP8266)
     // Zapisz zmiany do flash
     EEPROM.commit();
 #endif
+    odblokuj();
 }
@@ -3,6 +3,7 @@
  * 
  * Zarządza trwałym przechowywaniem danych WiFi w pamięci EEPROM.
  * Umożliwia zapisanie konfiguracji WiFi między restartami urządzenia.
+ * Przechowuje też bazę kalibracji czujnika SGP30.
  */
 
 #ifndef PAMIEC_LOKALNA_H
@@ -29,6 +30,27 @@ bool WczytanieDanychEEPROM();
  */
 void ZapiszDaneDoEEPROM();
 
+/*
+ * Baza kalibracji algorytmu IAQ czujnika SGP30 (czujniki.h)
+ */
+typedef struct {
+    uint16_t eco2;
+    uint16_t tvoc;
+    uint32_t epoch;           // Czas zapisu (rtc.getEpoch())
+} BazaSGP;
+
+/*
+ * Wczytuje zapisaną bazę SGP30.
+ *
+ * return: false, jeśli w EEPROM nie ma prawidłowej bazy
+ */
+bool WczytajBazeSGP(BazaSGP* baza);
+
+/*
+ * Zapisuje bazę SGP30 do EEPROM (z commit()).
+ */
+void ZapiszBazeSGP(const BazaSGP* baza);
+
 /*
  * Czyści całą pamięć EEPROM (resetuje dane WiFi).
  * Używane podczas pełnego resetu urządzenia.
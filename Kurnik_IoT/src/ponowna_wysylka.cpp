@@ -0,0 +1,205 @@
+/*
+ * ponowna_wysylka.cpp
+ *
+ * Okno ponownej wysyłki to bufor cykliczny rekordów w kolejności z kolejki.
+ * Rekord przechodzi stany: DO_WYSLANIA -> W_LOCIE (ma packetId) ->
+ * POTWIERDZONY. Zatwierdzanie w kolejce (i kopia do archiwum) odbywa
+ * się tylko od początku okna, więc kursor nigdy nie przeskoczy rekordu
+ * bez PUBACK.
+ */
+
+#include "ponowna_wysylka.h"
+#include "kolejka_SD.h"
+#include "archiwum_SD.h"
+#include "mqtt.h"
+#include "symulator_ruchu.h"
+#include <freertos/queue.h>
+
+typedef enum {
+    REKORD_DO_WYSLANIA = 0,   // Odczytany, jeszcze nieopublikowany (pełny bufor TCP lub brak przydziału)
+    REKORD_W_LOCIE,           // Opublikowany, czeka na PUBACK
+    REKORD_POTWIERDZONY
+} StanRekordu;
+
+typedef struct {
+    StanRekordu stan;
+    uint16_t packetId;
+    uint32_t czasWyslania;
+    PozycjaKolejki pozycja;       // Pozycja za rekordem - do KolejkaZatwierdz()
+    char rekord[KOLEJKA_MAX_REKORD];
+} RekordOkna;
+
+static RekordOkna okno[PONOWNA_WYSYLKA_OKNO];
+static uint32_t poczatekOkna = 0;     // Indeks najstarszego rekordu
+static uint32_t liczbaWOknie = 0;
+static bool kolejkaWyczerpana = false;
+
+static QueueHandle_t kolejkaPotwierdzen = nullptr;
+static volatile bool aktywna = false;
+static volatile uint32_t potwierdzone = 0;
+static volatile uint32_t ponowienia = 0;
+static volatile uint32_t przerwania = 0;
+static volatile int32_t wiekOstatniego = -1;
+static volatile uint32_t utraconePotwierdzenia = 0;
+
+static inline RekordOkna& rekordOkna(uint32_t i) {
+    return okno[(poczatekOkna + i) % PONOWNA_WYSYLKA_OKNO];
+}
+
+// Odrzuca okno i wraca do kursora - niepotwierdzone rekordy zostaną wysłane ponownie
+static void cofnijOkno() {
+    poczatekOkna = 0;
+    liczbaWOknie = 0;
+    kolejkaWyczerpana = false;
+    KolejkaCofnij();
+}
+
+static void zakoncz(const char* powod) {
+    cofnijOkno();
+    KolejkaZapiszKursor();
+    aktywna = false;
+
+    StatystykiKolejki kolejka;
+    KolejkaPobierzStatystyki(&kolejka);
+    Serial.printf("[Kolejka] Koniec ponownej wysyłki: %s (potwierdzone: %lu, kursor: %lu:%lu)\n",
+                  powod, (unsigned long)potwierdzone,
+                  (unsigned long)kolejka.kursor.segment, (unsigned long)kolejka.kursor.offset);
+}
+
+/*
+ * Wiek rekordu na podstawie znacznika czasu w ostatnim polu CSV
+ * ("HH:MM:SS Www, Mmm DD YYYY") względem bieżącego czasu RTC.
+ * Oba czasy przechodzą przez mktime(), więc strefa czasowa się znosi.
+ */
+static int32_t wiekRekordu(const char* rekord) {
+    const char* znacznik = strrchr(rekord, ';');
+    if (znacznik == nullptr) return -1;
+
+    struct tm czasRekordu = {};
+    if (strptime(znacznik + 1, "%H:%M:%S %a, %b %d %Y", &czasRekordu) == nullptr) return -1;
+
+    struct tm teraz = rtc.getTimeStruct();
+    return (int32_t)difftime(mktime(&teraz), mktime(&czasRekordu));
+}
+
+static bool publikuj(RekordOkna& r) {
+    uint16_t packetId = PublikujMQTT(SymulatorTopicRekordu(r.rekord), 1, false, r.rekord);
+    if (packetId == 0) return false;   // Bufor TCP pełny - spróbuj w następnym kroku
+    r.stan = REKORD_W_LOCIE;
+    r.packetId = packetId;
+    r.czasWyslania = millis();
+    return true;
+}
+
+void PonownaWysylkaInicjalizacja() {
+    if (kolejkaPotwierdzen == nullptr) {
+        // Kolejka dostaje też potwierdzenia bieżących publikacji (mqtt.h)
+        kolejkaPotwierdzen = xQueueCreate(MQTT_MAX_POTWIERDZEN, sizeof(uint16_t));
+    }
+}
+
+void PonownaWysylkaStart() {
+    if (aktywna) {
+        // Do kolejki doszły rekordy - czytaj dalej zamiast kończyć na "kolejka pusta"
+        kolejkaWyczerpana = false;
+        return;
+    }
+    if (!asyncMqttClient.connected()) {
+        Serial.println("MQTT niepodłączony - pomijam ponowne wysyłanie z kolejki");
+        return;
+    }
+    if (kolejkaPotwierdzen) xQueueReset(kolejkaPotwierdzen);
+    cofnijOkno();
+    aktywna = true;
+    Serial.println("[Kolejka] Rozpoczynam ponowne wysyłanie danych z kolejki...");
+}
+
+uint32_t PonownaWysylkaKrok(uint32_t limitPublikacji) {
+    if (!aktywna) return 0;
+
+    if (!asyncMqttClient.connected()) {
+        przerwania++;
+        zakoncz("MQTT rozłączony");
+        return 0;
+    }
+
+    uint32_t publikacje = 0;
+
+    // 1. Oznacz potwierdzone publikacje
+    uint16_t packetId;
+    while (kolejkaPotwierdzen && xQueueReceive(kolejkaPotwierdzen, &packetId, 0) == pdTRUE) {
+        for (uint32_t i = 0; i < liczbaWOknie; i++) {
+            RekordOkna& r = rekordOkna(i);
+            if (r.stan == REKORD_W_LOCIE && r.packetId == packetId) {
+                r.stan = REKORD_POTWIERDZONY;
+                break;
+            }
+        }
+    }
+
+    // 2. Zatwierdź w kolejności od początku okna
+    while (liczbaWOknie > 0 && rekordOkna(0).stan == REKORD_POTWIERDZONY) {
+        RekordOkna& r = rekordOkna(0);
+        KolejkaZatwierdz(&r.pozycja);
+        ArchiwumDopisz(r.rekord);
+        wiekOstatniego = wiekRekordu(r.rekord);
+        potwierdzone++;
+        poczatekOkna = (poczatekOkna + 1) % PONOWNA_WYSYLKA_OKNO;
+        liczbaWOknie--;
+    }
+
+    // 3. Brak PUBACK dla najstarszego rekordu - wyślij okno od nowa
+    if (liczbaWOknie > 0 && rekordOkna(0).stan == REKORD_W_LOCIE &&
+        millis() - rekordOkna(0).czasWyslania > PONOWNA_WYSYLKA_TIMEOUT_MS) {
+        ponowienia++;
+        Serial.println("[Kolejka] Brak potwierdzenia PUBACK - ponawiam okno od kursora");
+        cofnijOkno();
+    }
+
+    // 4. Dokończ publikacje odłożone przez pełny bufor TCP lub wyczerpany przydział
+    for (uint32_t i = 0; i < liczbaWOknie; i++) {
+        RekordOkna& r = rekordOkna(i);
+        if (r.stan != REKORD_DO_WYSLANIA) continue;
+        if (publikacje >= limitPublikacji || !publikuj(r)) return publikacje;
+        publikacje++;
+    }
+
+    // 5. Uzupełnij okno nowymi rekordami z kolejki
+    while (liczbaWOknie < PONOWNA_WYSYLKA_OKNO && !kolejkaWyczerpana && publikacje < limitPublikacji) {
+        RekordOkna& r = rekordOkna(liczbaWOknie);
+        WynikOdczytuKolejki wynik = KolejkaOdczytaj(r.rekord, sizeof(r.rekord), &r.pozycja);
+        if (wynik == KOLEJKA_ODCZYT_PUSTA) {
+            kolejkaWyczerpana = true;
+            break;
+        }
+        if (wynik == KOLEJKA_ODCZYT_BLAD) break;   // Karta chwilowo niedostępna - ponów w kolejnym kroku
+        r.stan = REKORD_DO_WYSLANIA;
+        liczbaWOknie++;
+        if (!publikuj(r)) return publikacje;
+        publikacje++;
+    }
+
+    if (liczbaWOknie == 0 && kolejkaWyczerpana) {
+        zakoncz("kolejka pusta");
+    }
+    return publikacje;
+}
+
+bool PonownaWysylkaAktywna() {
+    return aktywna;
+}
+
+void PotwierdzeniePublikacji(uint16_t packetId) {
+    if (!aktywna || kolejkaPotwierdzen == nullptr) return;
+    if (xQueueSend(kolejkaPotwierdzen, &packetId, 0) != pdTRUE) utraconePotwierdzenia++;
+}
+
+void PonownaWysylkaPobierzStatystyki(StatystykiPonownejWysylki* statystyki) {
+    statystyki->aktywna = aktywna;
+    statystyki->w_locie = liczbaWOknie;
+    statystyki->potwierdzone = potwierdzone;
+    statystyki->ponowienia = ponowienia;
+    statystyki->przerwania = przerwania;
+    statystyki->wiek_s = wiekOstatniego;
+    statystyki->utracone_potwierdzenia = utraconePotwierdzenia;
+}
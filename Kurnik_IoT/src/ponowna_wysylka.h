@@ -0,0 +1,70 @@
+/*
+ * MODUŁ PONOWNEJ WYSYŁKI - ponowna_wysylka.h
+ *
+ * Przyrostowe wysyłanie kolejki offline (kolejka_SD.h) po odzyskaniu
+ * połączenia MQTT. Rekordy publikowane są z QoS 1, a w locie może być
+ * najwyżej PONOWNA_WYSYLKA_OKNO niepotwierdzonych wiadomości. Kursor kolejki
+ * przesuwa się dopiero po potwierdzeniu PUBACK (onPublish) - w kolejności
+ * rekordów, więc restart w trakcie wysyłki niczego nie gubi.
+ *
+ * Każde wywołanie PonownaWysylkaKrok() wykonuje tylko tyle pracy, ile pozwala
+ * okno i przydział publikacji od harmonogramu uplinku (uplink.h).
+ */
+
+#ifndef PONOWNA_WYSYLKA_H
+#define PONOWNA_WYSYLKA_H
+
+#include "main.h"
+
+// Maksymalna liczba niepotwierdzonych publikacji kolejki
+#define PONOWNA_WYSYLKA_OKNO        8
+// Czas oczekiwania na PUBACK najstarszej publikacji (ms) - potem okno jest wysyłane od nowa
+#define PONOWNA_WYSYLKA_TIMEOUT_MS  15000
+
+// Statystyki ponownej wysyłki
+typedef struct {
+    bool aktywna;             // Czy wysyłka kolejki trwa
+    uint32_t w_locie;         // Rekordy w oknie (wysłane lub czekające na wysłanie)
+    uint32_t potwierdzone;    // Rekordy potwierdzone przez broker (od startu)
+    uint32_t ponowienia;      // Cofnięcia okna po przekroczeniu czasu PUBACK
+    uint32_t przerwania;      // Przerwania z powodu rozłączenia MQTT
+    int32_t wiek_s;           // Wiek ostatnio potwierdzonego rekordu (s), -1 = nieznany
+    uint32_t utracone_potwierdzenia;  // PUBACK odrzucone przy pełnej kolejce potwierdzeń
+} StatystykiPonownejWysylki;
+
+/*
+ * Tworzy kolejkę potwierdzeń. Wywoływana przez InicjalizacjaUplink().
+ */
+void PonownaWysylkaInicjalizacja();
+
+/*
+ * Rozpoczyna wysyłkę kolejki offline (od kursora kolejki). Gdy wysyłka
+ * już trwa, wznawia odczyt kolejki - rekordy dopisane w trakcie też zostaną
+ * wysłane.
+ */
+void PonownaWysylkaStart();
+
+/*
+ * Jeden krok wysyłki: odbiera potwierdzenia, przesuwa kursor i uzupełnia okno.
+ * Wywoływana w każdej iteracji pętli zadania uplinku.
+ * parametr: limitPublikacji Maksymalna liczba publikacji w tym kroku
+ * return: liczba wykonanych publikacji
+ */
+uint32_t PonownaWysylkaKrok(uint32_t limitPublikacji);
+
+/*
+ * return: true gdy wysyłka kolejki trwa (zadanie uplinku czeka wtedy krócej)
+ */
+bool PonownaWysylkaAktywna();
+
+/*
+ * Przekazuje potwierdzenie PUBACK z callbacku onPublish (kontekst AsyncTCP).
+ */
+void PotwierdzeniePublikacji(uint16_t packetId);
+
+/*
+ * Kopiuje statystyki ponownej wysyłki.
+ */
+void PonownaWysylkaPobierzStatystyki(StatystykiPonownejWysylki* statystyki);
+
+#endif
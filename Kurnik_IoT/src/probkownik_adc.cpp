@@ -0,0 +1,140 @@
+/*
+ * probkownik_adc.cpp
+ *
+ * Próbka I2S ADC na ESP32 to 16 bitów: numer kanału w bitach 15..12
+ * i wynik 12-bitowy w bitach 11..0. Zadanie próbkownika jest jedynym
+ * użytkownikiem I2S_NUM_0 i ADC1.
+ */
+
+#include "probkownik_adc.h"
+#include <driver/i2s.h>
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+#include <freertos/task.h>
+
+// Ten sam rdzeń co zadanie uplinku - pętla Arduino nie oddaje procesora
+static const BaseType_t ADC_RDZEN = (ARDUINO_RUNNING_CORE == 0) ? 1 : 0;
+static const i2s_port_t ADC_I2S = I2S_NUM_0;
+
+// Kanały ADC1 wejść czujników (kolejność jak KanalAdc)
+static const adc1_channel_t KANALY[ADC_LICZBA] = {
+    ADC1_CHANNEL_5,   // PIN_NTC = GPIO33
+    ADC1_CHANNEL_4    // PIN_LDR = GPIO32
+};
+
+static esp_adc_cal_characteristics_t charakterystyka;
+
+static portMUX_TYPE blokadaAdc = portMUX_INITIALIZER_UNLOCKED;
+static OdczytAdc odczyty[ADC_LICZBA];      // Pod blokadaAdc
+static StatystykiAdc statystyki;
+
+// Zbiera ADC_NADPROBKOWANIE próbek kanału z buforów DMA i zwraca ich średnią
+static bool seriaKanalu(KanalAdc kanal, uint16_t* srednia) {
+    uint16_t bufor[ADC_DLUGOSC_BUFORA];
+    uint32_t suma = 0, zebrane = 0, ustalanie = 0;
+    uint32_t numer = (uint32_t)KANALY[kanal];
+
+    i2s_set_adc_mode(ADC_UNIT_1, KANALY[kanal]);
+    i2s_adc_enable(ADC_I2S);
+
+    // Limit odczytów chroni przed zapętleniem, gdy w buforach są tylko obce próbki
+    for (int proba = 0; zebrane < ADC_NADPROBKOWANIE && proba < 4 * ADC_BUFORY_DMA; proba++) {
+        size_t przeczytane = 0;
+        // Zadanie śpi do wypełnienia bufora DMA
+        if (i2s_read(ADC_I2S, bufor, sizeof(bufor), &przeczytane, pdMS_TO_TICKS(ADC_OKRES_MS)) != ESP_OK ||
+            przeczytane == 0) {
+            statystyki.bledy++;
+            break;
+        }
+        for (size_t i = 0; i < przeczytane / sizeof(uint16_t); i++) {
+            uint16_t probka = bufor[i];
+            if ((probka >> 12) != numer || ustalanie < ADC_ODRZUC) {
+                if ((probka >> 12) == numer) ustalanie++;
+                statystyki.pominiete++;
+                continue;
+            }
+            suma += probka & 0x0FFF;
+            if (++zebrane >= ADC_NADPROBKOWANIE) break;
+        }
+    }
+
+    i2s_adc_disable(ADC_I2S);
+    if (zebrane == 0) return false;
+    statystyki.probki += zebrane;
+    *srednia = (uint16_t)((suma + zebrane / 2) / zebrane);
+    return true;
+}
+
+static void zadanieAdc(void* parametr) {
+    TickType_t ostatniaSeria = xTaskGetTickCount();
+
+    for (;;) {
+        vTaskDelayUntil(&ostatniaSeria, pdMS_TO_TICKS(ADC_OKRES_MS));
+
+        for (int k = 0; k < ADC_LICZBA; k++) {
+            uint16_t surowy;
+            if (!seriaKanalu((KanalAdc)k, &surowy)) continue;
+
+            // Kalibracja eFuse koryguje nieliniowość i rozrzut napięcia odniesienia
+            uint32_t mv = esp_adc_cal_raw_to_voltage(surowy, &charakterystyka);
+            uint32_t kod = (mv * 4095 + ADC_ZASILANIE_MV / 2) / ADC_ZASILANIE_MV;
+            if (kod > 4095) kod = 4095;
+            uint32_t teraz = millis();
+
+            portENTER_CRITICAL(&blokadaAdc);
+            odczyty[k].surowy = surowy;
+            odczyty[k].mv = (uint16_t)mv;
+            odczyty[k].kod = (uint16_t)kod;
+            odczyty[k].czas_ms = teraz ? teraz : 1;
+            portEXIT_CRITICAL(&blokadaAdc);
+            statystyki.serie++;
+        }
+    }
+}
+
+void AdcInicjalizacja() {
+    adc1_config_width(ADC_WIDTH_BIT_12);
+    for (int k = 0; k < ADC_LICZBA; k++) {
+        adc1_config_channel_atten(KANALY[k], ADC_ATTEN_DB_11);
+    }
+
+    esp_adc_cal_value_t zrodlo = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12,
+                                                          ADC_VREF_DOMYSLNE_MV, &charakterystyka);
+    statystyki.kalibracja = (zrodlo == ESP_ADC_CAL_VAL_EFUSE_TP)   ? "eFuse Two Point" :
+                            (zrodlo == ESP_ADC_CAL_VAL_EFUSE_VREF) ? "eFuse Vref" : "domyślna";
+
+    i2s_config_t konfiguracja = {};
+    konfiguracja.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+    konfiguracja.sample_rate = ADC_CZESTOTLIWOSC_HZ;
+    konfiguracja.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    konfiguracja.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    konfiguracja.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    konfiguracja.intr_alloc_flags = 0;
+    konfiguracja.dma_buf_count = ADC_BUFORY_DMA;
+    konfiguracja.dma_buf_len = ADC_DLUGOSC_BUFORA;
+    konfiguracja.use_apll = false;
+
+    if (i2s_driver_install(ADC_I2S, &konfiguracja, 0, nullptr) != ESP_OK) {
+        Serial.println("[ADC] BŁĄD: Nie udało się zainstalować sterownika I2S ADC");
+        return;
+    }
+    if (xTaskCreatePinnedToCore(zadanieAdc, "adc", ADC_STOS, nullptr, ADC_PRIORYTET, nullptr, ADC_RDZEN) != pdPASS) {
+        Serial.println("[ADC] BŁĄD: Nie udało się uruchomić zadania próbkownika");
+        i2s_driver_uninstall(ADC_I2S);
+        return;
+    }
+    statystyki.aktywny = true;
+    Serial.printf("[ADC] Próbkowanie NTC/LDR przez DMA (%d Hz, %d próbek na wartość, kalibracja: %s)\n",
+                  ADC_CZESTOTLIWOSC_HZ, ADC_NADPROBKOWANIE, statystyki.kalibracja);
+}
+
+bool AdcPobierz(KanalAdc kanal, OdczytAdc* odczyt) {
+    portENTER_CRITICAL(&blokadaAdc);
+    *odczyt = odczyty[kanal];
+    portEXIT_CRITICAL(&blokadaAdc);
+    return odczyt->czas_ms != 0 && millis() - odczyt->czas_ms < ADC_WAZNOSC_MS;
+}
+
+void AdcPobierzStatystyki(StatystykiAdc* wynik) {
+    *wynik = statystyki;
+}
@@ -0,0 +1,82 @@
+/*
+ * MODUŁ PRÓBKOWNIKA ADC - probkownik_adc.h
+ *
+ * Ciągłe próbkowanie wejść analogowych termistora NTC (PIN_NTC) i
+ * fotorezystora LDR (PIN_LDR) zamiast pojedynczego analogRead() przy
+ * każdym odczycie. ADC1 pracuje w trybie I2S, a próbki trafiają przez DMA
+ * do buforów sterownika - zadanie próbkownika czeka na wypełnienie bufora
+ * (bez zajmowania CPU) i uśrednia ADC_NADPROBKOWANIE próbek kanału do
+ * jednej wartości (decymacja).
+ *
+ * Sterownik I2S ADC na ESP32 próbkuje jeden kanał naraz, więc kanały są
+ * przełączane co serię. Próbki z innego kanału (resztki w buforach DMA)
+ * są rozpoznawane po numerze kanału w próbce i pomijane.
+ *
+ * Średnia jest przeliczana na miliwolty z kalibracją z eFuse
+ * (esp_adc_cal), a następnie na kod liniowy 0..4095 względem
+ * ADC_ZASILANIE_MV - kod nadaje się do przeliczeń dzielnika napięcia.
+ *
+ * Odczyt (AdcPobierz) tylko kopiuje ostatnią wartość - nie dotyka sprzętu.
+ */
+
+#ifndef PROBKOWNIK_ADC_H
+#define PROBKOWNIK_ADC_H
+
+#include "main.h"
+
+// Częstotliwość próbkowania DMA (Hz) i bufory sterownika I2S
+#define ADC_CZESTOTLIWOSC_HZ    20000
+#define ADC_BUFORY_DMA          4
+#define ADC_DLUGOSC_BUFORA      256     // Próbek 16-bitowych na bufor
+// Próbek uśrednianych do jednej wartości kanału
+#define ADC_NADPROBKOWANIE      512
+// Próbki pomijane po przełączeniu kanału (ustalanie się wejścia)
+#define ADC_ODRZUC              16
+// Okres serii pomiarów obu kanałów (ms)
+#define ADC_OKRES_MS            100
+// Odczyt starszy niż ten wiek jest niepoprawny (zadanie stoi)
+#define ADC_WAZNOSC_MS          1000
+// Napięcie zasilania dzielników (kod 4095)
+#define ADC_ZASILANIE_MV        3300
+// Domyślne napięcie odniesienia, gdy eFuse nie zawiera kalibracji
+#define ADC_VREF_DOMYSLNE_MV    1100
+
+#define ADC_STOS                3072
+#define ADC_PRIORYTET           1
+
+// Próbkowane kanały
+typedef enum {
+    ADC_NTC = 0,     // PIN_NTC (GPIO33, ADC1 kanał 5)
+    ADC_LDR,         // PIN_LDR (GPIO32, ADC1 kanał 4)
+    ADC_LICZBA
+} KanalAdc;
+
+// Ostatnia zdecymowana wartość kanału
+typedef struct {
+    uint16_t surowy;      // Średnia surowych próbek (0..4095)
+    uint16_t mv;          // Napięcie po kalibracji eFuse
+    uint16_t kod;         // mv przeliczone na 0..4095 względem ADC_ZASILANIE_MV
+    uint32_t czas_ms;     // millis() zakończenia serii (0 = brak)
+} OdczytAdc;
+
+// Statystyki próbkownika
+typedef struct {
+    bool aktywny;
+    const char* kalibracja;     // Źródło kalibracji: "eFuse Vref", "eFuse Two Point", "domyślna"
+    uint32_t serie;             // Zdecymowane wartości (wszystkie kanały)
+    uint32_t probki;            // Próbki użyte w średnich
+    uint32_t pominiete;         // Próbki innego kanału lub z ustalania wejścia
+    uint32_t bledy;             // Błędy odczytu I2S (brak danych w czasie)
+} StatystykiAdc;
+
+// Instaluje sterownik I2S ADC i uruchamia zadanie próbkownika
+void AdcInicjalizacja();
+
+// Kopiuje ostatnią wartość kanału
+// return: true gdy odczyt jest młodszy niż ADC_WAZNOSC_MS
+bool AdcPobierz(KanalAdc kanal, OdczytAdc* odczyt);
+
+// Kopiuje statystyki próbkownika
+void AdcPobierzStatystyki(StatystykiAdc* statystyki);
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * profiler_zadan.cpp
+ *
+ * Wszystkie zadania schedulera, komenda "status" i publikacja metryk
+ * działają w pętli Arduino, więc histogramy nie wymagają blokad.
+ */
+
+#include "profiler_zadan.h"
+#include "histogram_czasu.h"
+#include "mqtt.h"
+#include "licznik_alokacji.h"
+#include "dziennik.h"
+#include "rejestrator_SD.h"
+
+typedef struct {
+    HistogramCzasu okno;
+    uint32_t przekroczenia;
+    uint32_t maxCalkowity;
+} ProfilZadania;
+
+static ProfilZadania profile[ZADANIE_LICZBA];
+static bool zainicjalizowany = false;
+static uint32_t poczatekOkna = 0;
+
+static const char* NAZWY_ZADAN[ZADANIE_LICZBA] = {
+    "raport", "sync_czasu", "czujniki", "oled", "monitor", "ntp", "metryki", "pomiary"
+};
+
+static void wyczyscOkno() {
+    for (int i = 0; i < ZADANIE_LICZBA; i++) {
+        histogramWyczysc(&profile[i].okno);
+        profile[i].przekroczenia = 0;
+    }
+    StraznikPetliNoweOkno();
+    poczatekOkna = millis();
+}
+
+void ProfilerZapisz(ZadanieSchedulera zadanie, int64_t czas_calkowity) {
+    if (zadanie >= ZADANIE_LICZBA) return;
+    if (!zainicjalizowany) {
+        wyczyscOkno();
+        zainicjalizowany = true;
+    }
+
+    // Histogram przyjmuje 32-bitowe us (ponad 71 minut) - dłuższe wywołania są obcinane
+    uint32_t czas_us = (czas_calkowity < 0) ? 0 : (czas_calkowity > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)czas_calkowity);
+    ProfilZadania& p = profile[zadanie];
+    histogramDodaj(&p.okno, czas_us);
+    if (czas_us > PROFILER_BUDZET_US) {
+        p.przekroczenia++;
+        LOG_OSTRZEZENIE("[Profiler] Zadanie %s trwało %lu ms (budżet %d ms)",
+                        NAZWY_ZADAN[zadanie], (unsigned long)(czas_us / 1000), PROFILER_BUDZET_US / 1000);
+    }
+    if (czas_us > p.maxCalkowity) p.maxCalkowity = czas_us;
+}
+
+const char* ProfilerNazwaZadania(ZadanieSchedulera zadanie) {
+    return (zadanie < ZADANIE_LICZBA) ? NAZWY_ZADAN[zadanie] : "?";
+}
+
+void ProfilerPobierzStatystyki(ZadanieSchedulera zadanie, StatystykiZadania* statystyki) {
+    if (zadanie >= ZADANIE_LICZBA) return;
+    const ProfilZadania& p = profile[zadanie];
+    statystyki->nazwa = NAZWY_ZADAN[zadanie];
+    statystyki->wywolania = p.okno.liczba;
+    statystyki->min_us = p.okno.liczba ? p.okno.min_us : 0;
+    statystyki->sr_us = histogramSrednia(&p.okno);
+    statystyki->max_us = p.okno.max_us;
+    statystyki->p99_us = histogramPercentyl(&p.okno, 990);
+    statystyki->przekroczenia = p.przekroczenia;
+    statystyki->max_us_calkowity = p.maxCalkowity;
+}
+
+void ProfilerPublikujMetryki() {
+    if (!asyncMqttClient.connected() || !topicInitialized) return;
+
+    // Statyczny bufor - JSON z zadaniami, stertą i pętlą nie mieści się wygodnie na stosie
+    static char wiadomosc[2560];
+    size_t n = (size_t)snprintf(wiadomosc, sizeof(wiadomosc), "{\"okno_s\":%lu,\"budzet_us\":%d,\"zadania\":[",
+                                (unsigned long)((millis() - poczatekOkna) / 1000), PROFILER_BUDZET_US);
+
+    for (int i = 0; i < ZADANIE_LICZBA && n < sizeof(wiadomosc); i++) {
+        StatystykiZadania s;
+        ProfilerPobierzStatystyki((ZadanieSchedulera)i, &s);
+        n += (size_t)snprintf(wiadomosc + n, sizeof(wiadomosc) - n,
+                              "%s{\"nazwa\":\"%s\",\"n\":%lu,\"min_us\":%lu,\"sr_us\":%lu,\"max_us\":%lu,"
+                              "\"p99_us\":%lu,\"przekroczenia\":%lu}",
+                              i ? "," : "", s.nazwa, (unsigned long)s.wywolania, (unsigned long)s.min_us,
+                              (unsigned long)s.sr_us, (unsigned long)s.max_us, (unsigned long)s.p99_us,
+                              (unsigned long)s.przekroczenia);
+    }
+    // Stan sterty i alokacje podsystemów (licznik_alokacji.h)
+    if (n + 12 < sizeof(wiadomosc)) {
+        strcpy(wiadomosc + n, "],\"sterta\":");
+        n += 11;
+        size_t sterta = PamiecFormatujJSON(wiadomosc + n, sizeof(wiadomosc) - n);
+        n = sterta ? n + sterta : sizeof(wiadomosc);
+    }
+    // Przerwy między wywołaniami mesh.update() (straznik_petli.h)
+    if (n + 10 < sizeof(wiadomosc)) {
+        strcpy(wiadomosc + n, ",\"petla\":");
+        n += 9;
+        size_t petla = StraznikPetliFormatujJSON(wiadomosc + n, sizeof(wiadomosc) - n);
+        n = petla ? n + petla : sizeof(wiadomosc);
+    }
+    // Zapisy na kartę SD: archiwum i kolejka offline (rejestrator_SD.h)
+    if (n + 7 < sizeof(wiadomosc)) {
+        strcpy(wiadomosc + n, ",\"sd\":");
+        n += 6;
+        size_t sd = RejestratorFormatujJSON(wiadomosc + n, sizeof(wiadomosc) - n);
+        n = sd ? n + sd : sizeof(wiadomosc);
+    }
+    if (n + 2 > sizeof(wiadomosc)) {
+        LOG_BLAD("[Profiler] Metryki nie mieszczą się w buforze");
+        return;
+    }
+    strcpy(wiadomosc + n, "}");
+
+    char topicMetryk[64];
+    snprintf(topicMetryk, sizeof(topicMetryk), "%s" PROFILER_TOPIC_SUFIKS, topic);
+    if (PublikujMQTT(topicMetryk, 0, false, wiadomosc) != 0) {
+        wyczyscOkno();
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ * MODUŁ PROFILERA ZADAŃ - profiler_zadan.h
+ *
+ * Pomiar czasu wykonania callbacków TaskScheduler (userScheduler).
+ * Zadania działają kooperacyjnie z mesh.update(), więc jeden wolny
+ * callback opóźnia wszystkie pozostałe i obsługę sieci mesh.
+ *
+ * Callback jest opakowywany szablonem ZadanieProfilowane<>, który mierzy
+ * czas zegarem esp_timer (64-bitowe us) i zapisuje go do histogramu zadania
+ * (histogram_czasu.h). 32-bitowy licznik cykli CPU przepełnia się po
+ * ok. 17,9 s przy 240 MHz, a monitor połączeń (PolaczZWiFi) potrafi
+ * blokować pętlę do 30 s. Wywołanie dłuższe niż PROFILER_BUDZET_US jest
+ * liczone jako przekroczenie. Wywołanie jest też odcinkiem pętli dla
+ * strażnika przestojów (straznik_petli.h).
+ *
+ * Statystyki okna są wypisywane komendą "status" i co
+ * PROFILER_OKRES_METRYK_S publikowane jako JSON na "<topic>/metrics"
+ * razem ze stanem sterty (licznik_alokacji.h) i przerwami pętli. Po publikacji okno
+ * jest zerowane.
+ */
+
+#ifndef PROFILER_ZADAN_H
+#define PROFILER_ZADAN_H
+
+#include "main.h"
+#include "straznik_petli.h"
+#include <esp_timer.h>
+
+// Czas callbacku, powyżej którego liczone jest przekroczenie (us)
+#define PROFILER_BUDZET_US        20000
+// Okres publikacji metryk (s)
+#define PROFILER_OKRES_METRYK_S   60
+// Sufiks topicu metryk
+#define PROFILER_TOPIC_SUFIKS     "/metrics"
+
+// Profilowane zadania schedulera
+typedef enum {
+    ZADANIE_RAPORT = 0,     // taskRaport
+    ZADANIE_SYNC_CZASU,     // syncMeshDataTime
+    ZADANIE_CZUJNIKI,       // taskWyslijDaneCzujnikow
+    ZADANIE_OLED,           // taskOLEDRefresh
+    ZADANIE_MONITOR,        // taskMonitorPolaczen
+    ZADANIE_NTP,            // taskSyncNTP
+    ZADANIE_METRYKI,        // taskMetryki (publikacja metryk)
+    ZADANIE_POMIARY,        // taskPomiary (odczyt czujników do migawki)
+    ZADANIE_LICZBA
+} ZadanieSchedulera;
+
+// Statystyki zadania
+typedef struct {
+    const char* nazwa;
+    uint32_t wywolania;       // Wywołania w bieżącym oknie
+    uint32_t min_us;
+    uint32_t sr_us;
+    uint32_t max_us;
+    uint32_t p99_us;
+    uint32_t przekroczenia;   // Wywołania dłuższe niż PROFILER_BUDZET_US (w oknie)
+    uint32_t max_us_calkowity; // Najdłuższe wywołanie od startu
+} StatystykiZadania;
+
+/*
+ * Zapisuje czas jednego wywołania (us).
+ */
+void ProfilerZapisz(ZadanieSchedulera zadanie, int64_t czas_calkowity);
+
+/*
+ * return: nazwa zadania ("raport", "oled", ...)
+ */
+const char* ProfilerNazwaZadania(ZadanieSchedulera zadanie);
+
+/*
+ * Opakowanie callbacku zadania - użycie:
+ *   Task t(TASK_SECOND, TASK_FOREVER, &ZadanieProfilowane<ZADANIE_RAPORT, raportujSiec>);
+ */
+template <ZadanieSchedulera Z, void (*F)()>
+void ZadanieProfilowane() {
+    OdcinekPetli odcinek(ProfilerNazwaZadania(Z));
+    int64_t start = esp_timer_get_time();
+    F();
+    ProfilerZapisz(Z, esp_timer_get_time() - start);
+}
+
+/*
+ * Kopiuje statystyki bieżącego okna zadania.
+ */
+void ProfilerPobierzStatystyki(ZadanieSchedulera zadanie, StatystykiZadania* statystyki);
+
+/*
+ * Publikuje statystyki wszystkich zadań na "<topic>/metrics" i zeruje okno.
+ * Callback zadania taskMetryki.
+ */
+void ProfilerPublikujMetryki();
+
+#endif
@@ -0,0 +1,262 @@
+/*
+ * rejestrator_SD.cpp
+ *
+ * Buforowany zapis rekordów na kartę SD z trwale otwartymi plikami.
+ *
+ * Zamiast open/print/close na każdą linię (aktualizacja katalogu FAT i kilka
+ * transakcji SPI co 5 s na każdy węzeł) rekordy są zbierane w RAM, a na kartę
+ * trafiają w porcjach kończących się na granicy sektora pliku. Dzięki temu
+ * biblioteka SD nie musi czytać-modyfikować-zapisywać częściowych sektorów.
+ */
+
+#include "rejestrator_SD.h"
+#include "dziennik.h"
+#include "FS.h"
+#include "SD.h"
+
+// Stan jednego pliku rejestratora
+typedef struct {
+    char sciezka[32];
+    File plik;
+    bool otwarty;
+    uint32_t pozycja;                 // Rozmiar pliku = pozycja następnego zapisu
+    char bufor[REJESTRATOR_BUFOR];
+    size_t zapelnienie;
+    uint32_t czasNajstarszego;        // millis() pierwszego niezapisanego rekordu
+    PolitykaTrwalosci polityka;
+    StatystykiRejestratora stat;
+} PlikRejestratora;
+
+static PlikRejestratora pliki[REJESTR_LICZBA];
+static SemaphoreHandle_t rejestratorMutex = nullptr;
+
+// Bez mutexu (przed inicjalizacją) działa tylko setup() - brak współbieżności
+static inline void zablokuj() {
+    if (rejestratorMutex) xSemaphoreTake(rejestratorMutex, portMAX_DELAY);
+}
+
+static inline void odblokuj() {
+    if (rejestratorMutex) xSemaphoreGive(rejestratorMutex);
+}
+
+static bool otworz(PlikRejestratora& p) {
+    if (p.otwarty) return true;
+    p.plik = SD.open(p.sciezka, FILE_APPEND);
+    if (!p.plik) {
+        p.stat.bledy++;
+        LOG_BLAD("[SD] Nie udało się otworzyć %s", p.sciezka);
+        return false;
+    }
+    p.pozycja = p.plik.size();
+    p.otwarty = true;
+    return true;
+}
+
+/*
+ * Zapisuje pierwsze n bajtów bufora i przesuwa resztę na początek.
+ * zatwierdz = true wymusza flush() (aktualizacja rozmiaru pliku i FAT).
+ * Bajty, których karta nie przyjęła, zostają w buforze - część rekordu
+ * jest już w pliku, więc odrzucenie reszty zostawiłoby obciętą linię.
+ */
+static void zapiszBufor(PlikRejestratora& p, size_t n, bool zatwierdz) {
+    if (n == 0 || n > p.zapelnienie) return;
+
+    if (!otworz(p)) {
+        // Karta niedostępna - dane czekają w buforze, ponowna próba przy zrzucie czasowym
+        p.czasNajstarszego = millis();
+        return;
+    }
+
+    uint32_t start = micros();
+    size_t zapisano = p.plik.write((const uint8_t*)p.bufor, n);
+    if (zatwierdz || p.polityka != TRWALOSC_BUFOROWANA) {
+        p.plik.flush();
+    }
+    uint32_t opoznienie = micros() - start;
+
+    if (zapisano != n) {
+        // Błąd zapisu - zamknij plik, przy kolejnym zapisie nastąpi ponowne otwarcie
+        p.stat.bledy++;
+        LOG_BLAD("[SD] Błąd zapisu %s (%u/%u B)", p.sciezka, (unsigned)zapisano, (unsigned)n);
+        p.plik.close();
+        p.otwarty = false;
+    }
+
+    p.stat.zrzuty++;
+    p.stat.bajty += zapisano;
+    p.stat.ostatnie_opoznienie_us = opoznienie;
+    p.stat.suma_opoznien_us += opoznienie;
+    if (opoznienie > p.stat.max_opoznienie_us) p.stat.max_opoznienie_us = opoznienie;
+
+    p.pozycja += zapisano;
+    p.zapelnienie -= zapisano;
+    if (p.zapelnienie > 0) {
+        memmove(p.bufor, p.bufor + zapisano, p.zapelnienie);
+        p.czasNajstarszego = millis();
+    }
+}
+
+// Zapisuje tylko tyle bajtów, aby plik kończył się na granicy sektora
+static void zapiszSektory(PlikRejestratora& p) {
+    size_t przesuniecie = p.pozycja % REJESTRATOR_SEKTOR;
+    size_t koniec = ((przesuniecie + p.zapelnienie) / REJESTRATOR_SEKTOR) * REJESTRATOR_SEKTOR;
+    if (koniec <= przesuniecie) return;  // Za mało danych na pełny sektor
+    zapiszBufor(p, koniec - przesuniecie, false);
+}
+
+void RejestratorInicjalizacja() {
+    if (rejestratorMutex == nullptr) {
+        rejestratorMutex = xSemaphoreCreateMutex();
+    }
+
+    // Ścieżki segmentów ustawiają moduły archiwum i kolejki (RejestratorUstawSciezke)
+    pliki[REJESTR_ARCHIWUM].polityka = TRWALOSC_BUFOROWANA;
+    // Kolejka to jedyna kopia niewysłanych danych - każdy rekord od razu na kartę
+    pliki[REJESTR_KOLEJKA].polityka = TRWALOSC_NATYCHMIASTOWA;
+
+    Serial.printf("[SD] Rejestrator gotowy (bufor: %d B, próg: %d B, max wiek: %d ms)\n",
+                  REJESTRATOR_BUFOR, REJESTRATOR_PROG_ZRZUTU, REJESTRATOR_MAX_WIEK_MS);
+}
+
+void RejestratorUstawPolityke(KanalRejestratora kanal, PolitykaTrwalosci polityka) {
+    if (kanal >= REJESTR_LICZBA) return;
+    zablokuj();
+    pliki[kanal].polityka = polityka;
+    odblokuj();
+}
+
+void RejestratorUstawSciezke(KanalRejestratora kanal, const char* sciezka) {
+    if (kanal >= REJESTR_LICZBA) return;
+    PlikRejestratora& p = pliki[kanal];
+    zablokuj();
+    zapiszBufor(p, p.zapelnienie, true);
+    if (p.zapelnienie > 0) {
+        // Reszta należy do poprzedniego pliku - nie może trafić do nowego
+        p.stat.bledy++;
+        LOG_BLAD("[SD] Odrzucono %u B niezapisanych do %s", (unsigned)p.zapelnienie, p.sciezka);
+        p.zapelnienie = 0;
+    }
+    if (p.otwarty) {
+        p.plik.close();
+        p.otwarty = false;
+    }
+    strlcpy(p.sciezka, sciezka, sizeof(p.sciezka));
+    odblokuj();
+}
+
+/*
+ * Dopisuje dane do bufora pliku (wywoływana z zablokowanym mutexem).
+ * separator != 0 jest dopisywany za danymi (znak nowej linii rekordu tekstowego).
+ */
+static void dopisz(PlikRejestratora& p, const uint8_t* dane, size_t dlugosc, char separator) {
+    size_t calosc = dlugosc + (separator ? 1 : 0);
+    p.stat.rekordy++;
+
+    // Zrób miejsce w buforze: najpierw pełne sektory, w ostateczności cały bufor
+    if (p.zapelnienie + calosc > REJESTRATOR_BUFOR) {
+        zapiszSektory(p);
+        if (p.zapelnienie + calosc > REJESTRATOR_BUFOR) {
+            zapiszBufor(p, p.zapelnienie, false);
+        }
+    }
+
+    if (p.zapelnienie + calosc > REJESTRATOR_BUFOR && p.zapelnienie > 0) {
+        // Karta nie przyjmuje danych - odrzuć cały nowy rekord, bufor zostaje bez zmian
+        p.stat.bledy++;
+        LOG_BLAD("[SD] Bufor %s pełny - odrzucono rekord (%u B)", p.sciezka, (unsigned)calosc);
+        return;
+    }
+
+    if (calosc > REJESTRATOR_BUFOR) {
+        // Rekord większy niż bufor - zapisz bezpośrednio
+        if (otworz(p)) {
+            p.pozycja += p.plik.write(dane, dlugosc);
+            if (separator) p.pozycja += p.plik.write((uint8_t)separator);
+            p.plik.flush();
+        }
+        return;
+    }
+
+    if (p.zapelnienie == 0) p.czasNajstarszego = millis();
+    memcpy(p.bufor + p.zapelnienie, dane, dlugosc);
+    if (separator) p.bufor[p.zapelnienie + dlugosc] = separator;
+    p.zapelnienie += calosc;
+
+    if (p.polityka == TRWALOSC_NATYCHMIASTOWA) {
+        zapiszBufor(p, p.zapelnienie, true);
+    } else if (p.zapelnienie >= REJESTRATOR_PROG_ZRZUTU) {
+        zapiszSektory(p);
+    }
+}
+
+void RejestratorZapisz(KanalRejestratora kanal, const char* rekord) {
+    if (kanal >= REJESTR_LICZBA || pliki[kanal].sciezka[0] == '\0') return;
+    zablokuj();
+    dopisz(pliki[kanal], (const uint8_t*)rekord, strlen(rekord), '\n');
+    odblokuj();
+}
+
+void RejestratorZapiszBajty(KanalRejestratora kanal, const uint8_t* dane, size_t dlugosc) {
+    if (kanal >= REJESTR_LICZBA || pliki[kanal].sciezka[0] == '\0' || dlugosc == 0) return;
+    zablokuj();
+    dopisz(pliki[kanal], dane, dlugosc, 0);
+    odblokuj();
+}
+
+void RejestratorObsluga() {
+    uint32_t teraz = millis();
+    zablokuj();
+    for (int i = 0; i < REJESTR_LICZBA; i++) {
+        PlikRejestratora& p = pliki[i];
+        if (p.zapelnienie > 0 && teraz - p.czasNajstarszego >= REJESTRATOR_MAX_WIEK_MS) {
+            zapiszBufor(p, p.zapelnienie, true);
+        }
+    }
+    odblokuj();
+}
+
+void RejestratorZamknijPlik(KanalRejestratora kanal) {
+    if (kanal >= REJESTR_LICZBA) return;
+    PlikRejestratora& p = pliki[kanal];
+    zablokuj();
+    zapiszBufor(p, p.zapelnienie, true);
+    if (p.otwarty) {
+        p.plik.close();
+        p.otwarty = false;
+    }
+    odblokuj();
+}
+
+void RejestratorZamknij() {
+    for (int i = 0; i < REJESTR_LICZBA; i++) {
+        RejestratorZamknijPlik((KanalRejestratora)i);
+    }
+}
+
+size_t RejestratorFormatujJSON(char* bufor, size_t rozmiar) {
+    static const char* NAZWY[REJESTR_LICZBA] = { "archiwum", "kolejka" };
+    size_t n = 0;
+    for (int i = 0; i < REJESTR_LICZBA && n < rozmiar; i++) {
+        StatystykiRejestratora s;
+        RejestratorPobierzStatystyki((KanalRejestratora)i, &s);
+        int m = snprintf(bufor + n, rozmiar - n,
+                         "%s\"%s\":{\"rekordy\":%lu,\"zrzuty\":%lu,\"bajty\":%lu,\"bledy\":%lu,"
+                         "\"sr_us\":%lu,\"max_us\":%lu}",
+                         i ? "," : "{", NAZWY[i], (unsigned long)s.rekordy, (unsigned long)s.zrzuty,
+                         (unsigned long)s.bajty, (unsigned long)s.bledy,
+                         (unsigned long)(s.zrzuty ? s.suma_opoznien_us / s.zrzuty : 0),
+                         (unsigned long)s.max_opoznienie_us);
+        if (m < 0 || (size_t)m >= rozmiar - n) return 0;
+        n += (size_t)m;
+    }
+    if (n + 2 > rozmiar) return 0;
+    strcpy(bufor + n, "}");
+    return n + 1;
+}
+
+void RejestratorPobierzStatystyki(KanalRejestratora kanal, StatystykiRejestratora* statystyki) {
+    if (kanal >= REJESTR_LICZBA) return;
+    zablokuj();
+    *statystyki = pliki[kanal].stat;
+    odblokuj();
+}
@@ -0,0 +1,110 @@
+/*
+ * MODUŁ REJESTRATORA SD - rejestrator_SD.h
+ *
+ * Buforowany zapis (write-behind) rekordów do plików na karcie SD.
+ * Bieżące segmenty archiwum i kolejki offline pozostają otwarte, a rekordy
+ * trafiają najpierw do bufora w RAM. Bufor jest zapisywany na kartę:
+ * - gdy przekroczy próg - tylko pełne sektory 512 B liczone od pozycji w pliku,
+ * - gdy najstarszy rekord czeka dłużej niż REJESTRATOR_MAX_WIEK_MS,
+ * - przy zamknięciu (reset, ponowne wysyłanie kolejki).
+ *
+ * Rejestrator jest używany z zadania uplinku; mutex chroni go przed
+ * równoczesnym wywołaniem z pętli Arduino (komendy Serial).
+ */
+
+#ifndef REJESTRATOR_SD_H
+#define REJESTRATOR_SD_H
+
+#include "main.h"
+
+// Rozmiar sektora karty SD (bajty)
+#define REJESTRATOR_SEKTOR        512
+// Rozmiar bufora RAM jednego pliku (wielokrotność sektora)
+#define REJESTRATOR_BUFOR         2048
+// Zapełnienie bufora, od którego zapisywane są pełne sektory
+#define REJESTRATOR_PROG_ZRZUTU   1024
+// Maksymalny czas przebywania rekordu w buforze (ms)
+#define REJESTRATOR_MAX_WIEK_MS   10000
+
+// Pliki obsługiwane przez rejestrator
+typedef enum {
+    REJESTR_ARCHIWUM = 0, // Bieżący segment archiwum wysłanych danych (archiwum_SD.h)
+    REJESTR_KOLEJKA,      // Bieżący segment kolejki offline (kolejka_SD.h)
+    REJESTR_LICZBA
+} KanalRejestratora;
+
+// Polityka trwałości zapisu
+typedef enum {
+    TRWALOSC_BUFOROWANA = 0,   // Zapis sektorów bez flush() - FAT aktualizowany przy zrzucie czasowym/zamknięciu
+    TRWALOSC_ZATWIERDZANA,     // Jak wyżej, ale każdy zapis kończy flush() (rozmiar pliku i FAT od razu na karcie)
+    TRWALOSC_NATYCHMIASTOWA    // Każdy rekord zapisany i zatwierdzony od razu (bez bufora, ale bez open/close)
+} PolitykaTrwalosci;
+
+// Statystyki jednego pliku
+typedef struct {
+    uint32_t rekordy;             // Liczba przyjętych rekordów
+    uint32_t zrzuty;              // Liczba zapisów bufora na kartę
+    uint32_t bajty;               // Łączna liczba zapisanych bajtów
+    uint32_t bledy;               // Nieudane otwarcia/zapisy i rekordy odrzucone przy pełnym buforze
+    uint32_t ostatnie_opoznienie_us;
+    uint32_t max_opoznienie_us;
+    uint64_t suma_opoznien_us;    // Do średniej: suma_opoznien_us / zrzuty
+} StatystykiRejestratora;
+
+/*
+ * Przygotowuje rejestrator. Wywoływana przez InicjalizacjaSD() po zamontowaniu karty.
+ */
+void RejestratorInicjalizacja();
+
+/*
+ * Ustawia politykę trwałości dla pliku.
+ * Domyślnie: archiwum - TRWALOSC_BUFOROWANA, kolejka - TRWALOSC_NATYCHMIASTOWA
+ * (kolejka jest jedyną kopią niewysłanego rekordu, więc nie może czekać w RAM).
+ */
+void RejestratorUstawPolityke(KanalRejestratora kanal, PolitykaTrwalosci polityka);
+
+/*
+ * Zmienia plik docelowy kanału (np. nowy segment kolejki offline).
+ * Bufor jest zapisywany, a poprzedni plik zamykany przed przełączeniem.
+ */
+void RejestratorUstawSciezke(KanalRejestratora kanal, const char* sciezka);
+
+/*
+ * Dopisuje rekord (bez znaku nowej linii - dodawany automatycznie) do bufora pliku.
+ */
+void RejestratorZapisz(KanalRejestratora kanal, const char* rekord);
+
+/*
+ * Dopisuje blok binarny (bez separatora) do bufora pliku, np. blok kodeka archiwum.
+ */
+void RejestratorZapiszBajty(KanalRejestratora kanal, const uint8_t* dane, size_t dlugosc);
+
+/*
+ * Zrzut czasowy - zapisuje bufory starsze niż REJESTRATOR_MAX_WIEK_MS.
+ * Wywoływana cyklicznie z pętli zadania uplinku.
+ */
+void RejestratorObsluga();
+
+/*
+ * Zapisuje bufor i zamyka plik (np. przed odczytem lub usunięciem pliku).
+ * Plik zostanie ponownie otwarty przy następnym zapisie.
+ */
+void RejestratorZamknijPlik(KanalRejestratora kanal);
+
+/*
+ * Zapisuje wszystkie bufory i zamyka wszystkie pliki (reset, restart).
+ */
+void RejestratorZamknij();
+
+/*
+ * Kopiuje statystyki pliku.
+ */
+void RejestratorPobierzStatystyki(KanalRejestratora kanal, StatystykiRejestratora* statystyki);
+
+/*
+ * Formatuje statystyki obu kanałów jako obiekt JSON (do /metrics).
+ * Zwraca długość tekstu lub 0, gdy nie mieści się w buforze.
+ */
+size_t RejestratorFormatujJSON(char* bufor, size_t rozmiar);
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * straznik_petli.cpp
+ *
+ * Odcinki zgłaszają swój czas po zakończeniu, więc zewnętrzny odcinek
+ * zgłasza się po wewnętrznym. Dla każdej przerwy pamiętany jest tylko
+ * najdłuższy zgłoszony odcinek (z głębokością zagnieżdżenia).
+ */
+
+#include "straznik_petli.h"
+#include "histogram_czasu.h"
+#include "dziennik.h"
+
+static uint32_t ostatniTik_us = 0;
+static bool pierwszyTik = true;
+
+static HistogramCzasu okno;
+static uint32_t przestojeOkna = 0;
+static uint32_t przestojeCalkowite = 0;
+static uint32_t maxCalkowity = 0;
+
+static PrzestojPetli historia[STRAZNIK_HISTORIA];
+static int nastepnyWpis = 0;
+
+// Najdłuższy odcinek bieżącej przerwy
+static const char* najdluzszaEtykieta = nullptr;
+static uint32_t najdluzszy_us = 0;
+static int najdluzszyPoziom = 0;
+static int poziom = 0;
+
+static void zglosOdcinek(const char* etykieta, uint32_t czas_us, int glebokosc) {
+    if (czas_us <= najdluzszy_us) return;
+    // Zewnętrzny odcinek, którego większość zajął już zgłoszony wewnętrzny
+    if (najdluzszaEtykieta != nullptr && glebokosc < najdluzszyPoziom && najdluzszy_us * 2 >= czas_us) return;
+    najdluzszaEtykieta = etykieta;
+    najdluzszy_us = czas_us;
+    najdluzszyPoziom = glebokosc;
+}
+
+OdcinekPetli::OdcinekPetli(const char* etykieta) : etykieta(etykieta), start(micros()) {
+    poziom++;
+}
+
+OdcinekPetli::~OdcinekPetli() {
+    poziom--;
+    zglosOdcinek(etykieta, micros() - start, poziom);
+}
+
+void StraznikPetliTik() {
+    uint32_t teraz = micros();
+    if (pierwszyTik) {
+        pierwszyTik = false;
+        StraznikPetliNoweOkno();
+        ostatniTik_us = teraz;
+        return;
+    }
+
+    uint32_t przerwa = teraz - ostatniTik_us;
+    ostatniTik_us = teraz;
+    histogramDodaj(&okno, przerwa);
+    if (przerwa > maxCalkowity) maxCalkowity = przerwa;
+
+    if (przerwa > STRAZNIK_PROG_US) {
+        przestojeOkna++;
+        przestojeCalkowite++;
+
+        PrzestojPetli& p = historia[nastepnyWpis];
+        p.czas_ms = millis();
+        p.trwanie_us = przerwa;
+        p.etykieta = najdluzszaEtykieta ? najdluzszaEtykieta : "?";
+        p.etykieta_us = najdluzszy_us;
+        nastepnyWpis = (nastepnyWpis + 1) % STRAZNIK_HISTORIA;
+
+        LOG_OSTRZEZENIE("[Pętla] Przestój mesh.update(): %lu ms (najdłużej: %s, %lu ms)",
+                        (unsigned long)(przerwa / 1000), p.etykieta, (unsigned long)(p.etykieta_us / 1000));
+    }
+
+    najdluzszaEtykieta = nullptr;
+    najdluzszy_us = 0;
+    najdluzszyPoziom = 0;
+}
+
+void StraznikPetliPobierzStatystyki(StatystykiPetli* statystyki) {
+    statystyki->przerwy = okno.liczba;
+    statystyki->p50_us = histogramPercentyl(&okno, 500);
+    statystyki->p99_us = histogramPercentyl(&okno, 990);
+    statystyki->max_us = okno.max_us;
+    statystyki->przestoje = przestojeOkna;
+    statystyki->przestoje_calkowite = przestojeCalkowite;
+    statystyki->max_us_calkowity = maxCalkowity;
+}
+
+bool StraznikPetliPobierzPrzestoj(int indeks, PrzestojPetli* przestoj) {
+    if (indeks < 0 || indeks >= STRAZNIK_HISTORIA || (uint32_t)indeks >= przestojeCalkowite) return false;
+    *przestoj = historia[(nastepnyWpis - 1 - indeks + STRAZNIK_HISTORIA) % STRAZNIK_HISTORIA];
+    return true;
+}
+
+void StraznikPetliNoweOkno() {
+    histogramWyczysc(&okno);
+    przestojeOkna = 0;
+}
+
+size_t StraznikPetliFormatujJSON(char* bufor, size_t rozmiar) {
+    StatystykiPetli s;
+    StraznikPetliPobierzStatystyki(&s);
+    int n = snprintf(bufor, rozmiar,
+                     "{\"przerwy\":%lu,\"p50_us\":%lu,\"p99_us\":%lu,\"max_us\":%lu,\"prog_us\":%d,\"przestoje\":%lu}",
+                     (unsigned long)s.przerwy, (unsigned long)s.p50_us, (unsigned long)s.p99_us,
+                     (unsigned long)s.max_us, STRAZNIK_PROG_US, (unsigned long)s.przestoje);
+    return (n > 0 && (size_t)n < rozmiar) ? (size_t)n : 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * MODUŁ STRAŻNIKA PĘTLI - straznik_petli.h
+ *
+ * Mierzy przerwy między kolejnymi wywołaniami mesh.update() w loop().
+ * painlessMesh obsługuje połączenia tylko w mesh.update(), więc każde
+ * blokujące wywołanie w pętli (delay() w PolaczZWiFi, synchronizacja NTP,
+ * wolny callback schedulera) opóźnia sieć i przy długim przestoju węzły
+ * są rozłączane.
+ *
+ * Rozkład przerw trafia do histogramu (histogram_czasu.h), a przerwa
+ * dłuższa niż STRAZNIK_PROG_US jest zapisywana jako przestój razem
+ * z etykietą odcinka kodu, który trwał w niej najdłużej. Odcinki oznacza
+ * obiekt OdcinekPetli (callbacki schedulera oznacza profiler zadań).
+ *
+ * Wszystkie funkcje wywoływane są tylko z pętli Arduino (loop i setup).
+ */
+
+#ifndef STRAZNIK_PETLI_H
+#define STRAZNIK_PETLI_H
+
+#include "main.h"
+
+// Przerwa między wywołaniami mesh.update() uznawana za przestój (us)
+#define STRAZNIK_PROG_US      100000
+// Liczba zapamiętanych ostatnich przestojów
+#define STRAZNIK_HISTORIA     8
+
+// Zapisany przestój
+typedef struct {
+    uint32_t czas_ms;         // millis() na końcu przestoju
+    uint32_t trwanie_us;
+    const char* etykieta;     // Najdłuższy odcinek w przestoju ("?" gdy brak)
+    uint32_t etykieta_us;     // Czas tego odcinka
+} PrzestojPetli;
+
+// Statystyki przerw między wywołaniami mesh.update()
+typedef struct {
+    uint32_t przerwy;             // Przerwy w bieżącym oknie metryk
+    uint32_t p50_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+    uint32_t przestoje;           // Przestoje w bieżącym oknie
+    uint32_t przestoje_calkowite; // Przestoje od startu
+    uint32_t max_us_calkowity;    // Najdłuższa przerwa od startu
+} StatystykiPetli;
+
+/*
+ * Zamyka bieżącą przerwę - wywoływane bezpośrednio przed mesh.update().
+ */
+void StraznikPetliTik();
+
+/*
+ * Oznacza odcinek kodu w pętli do końca bloku:
+ *   { OdcinekPetli odcinek("PolaczZWiFi"); ... }
+ * Odcinki mogą się zagnieżdżać - przestój jest przypisywany do
+ * wewnętrznego odcinka, jeśli zajął co najmniej połowę zewnętrznego.
+ * Etykieta musi być stałym tekstem.
+ */
+class OdcinekPetli {
+public:
+    explicit OdcinekPetli(const char* etykieta);
+    ~OdcinekPetli();
+private:
+    const char* etykieta;
+    uint32_t start;
+};
+
+/*
+ * Kopiuje statystyki bieżącego okna.
+ */
+void StraznikPetliPobierzStatystyki(StatystykiPetli* statystyki);
+
+/*
+ * Kopiuje zapisany przestój (0 = najnowszy).
+ * return: false, jeśli nie ma tylu przestojów
+ */
+bool StraznikPetliPobierzPrzestoj(int indeks, PrzestojPetli* przestoj);
+
+/*
+ * Zeruje okno statystyk (razem z oknem metryk profilera).
+ */
+void StraznikPetliNoweOkno();
+
+/*
+ * Zapisuje statystyki okna jako obiekt JSON (do metryk profilera).
+ * return: długość tekstu, 0 gdy nie mieści się w buforze
+ */
+size_t StraznikPetliFormatujJSON(char* bufor, size_t rozmiar);
+
+#endif
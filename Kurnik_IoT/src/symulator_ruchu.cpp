@@ -0,0 +1,243 @@
+/*
+ * symulator_ruchu.cpp
+ *
+ * Wiadomości są generowane równomiernie według zegara micros() - w każdej
+ * iteracji loop() powstaje tyle wiadomości, ile wynika z upływu czasu
+ * (maksymalnie SYMULATOR_MAX_NA_PETLE, aby nie zagłodzić mesh.update()).
+ *
+ * Czasy etapów trafiają do histogramów log-liniowych (histogram_czasu.h).
+ */
+
+#include "symulator_ruchu.h"
+#include "dyspozytor_mesh.h"
+#include "ramka_mesh.h"
+#include "mqtt.h"
+#include "uplink.h"
+#include "rejestrator_SD.h"
+#include "dostarczanie_mqtt.h"
+
+static volatile bool aktywna = false;
+static uint32_t liczbaWezlow = 0;
+static float wiadomosciNaSekunde = 0;    // Łącznie ze wszystkich węzłów
+static uint32_t czasTrwania_us = 0;
+static bool binarne = false;
+
+static uint32_t start_us = 0;
+static uint32_t koniec_us = 0;
+static uint32_t wygenerowane = 0;
+static uint16_t sekwencja = 0;
+
+static HistogramCzasu histogramy[ETAP_LICZBA];
+
+// Stan systemu w chwili startu - raport podaje przyrosty
+static StatystykiUplinku uplinkStart;
+static StatystykiDostarczania dostarczanieStart;
+static uint32_t bajtySDStart[REJESTR_LICZBA];
+
+// Rekordy wirtualnych węzłów niezapisane na kartę (bajty z '\n')
+static volatile uint32_t pominieteArchiwum = 0;
+static volatile uint32_t pominieteKolejka = 0;
+
+static char topicSymulacji[64];
+
+static const char* NAZWY_ETAPOW[ETAP_LICZBA] = {
+    "odbiór", "kolejka", "wysyłka", "zapis SD", "PUBACK"
+};
+
+static uint32_t bajtyZapisaneSD(int kanal) {
+    StatystykiRejestratora rej;
+    RejestratorPobierzStatystyki((KanalRejestratora)kanal, &rej);
+    return rej.bajty;
+}
+
+// Wiadomość wirtualnego węzła - wartości zmieniają się powoli jak prawdziwe pomiary
+static size_t utworzWiadomosc(uint32_t wezel, char* bufor, size_t rozmiar) {
+    uint32_t id = SYMULATOR_ID_BAZOWE + wezel;
+    uint32_t epoch = (uint32_t)rtc.getLocalEpoch();
+    float faza = (float)(epoch % 3600) / 3600.0f * 2.0f * (float)M_PI + (float)wezel;
+
+    float temperatura = 22.0f + 5.0f * sinf(faza);
+    float wilgotnosc = 60.0f + 20.0f * sinf(faza * 0.7f);
+    int co2 = 1200 + (int)(400.0f * sinf(faza * 1.3f));
+    int amoniak = 15 + (int)(8.0f * sinf(faza * 0.5f));
+    int swiatlo = 50 + (int)(45.0f * sinf(faza * 1.7f));
+
+    if (binarne) {
+        RamkaDane ramka = {};
+        ramka.naglowek.id_wezla = id;
+        ramka.naglowek.sekwencja = sekwencja++;
+        ramka.naglowek.epoch = epoch;
+        ramka.temperatura_c = (int16_t)ramkaSetne(temperatura);
+        ramka.wilgotnosc_c = (uint16_t)ramkaSetne(wilgotnosc);
+        ramka.poziom_co2 = co2;
+        ramka.poziom_amoniaku = amoniak;
+        ramka.naslonecznienie = (uint32_t)swiatlo;
+
+        uint8_t surowa[RAMKA_MAX_BAJTY];
+        size_t n = ramkaKodujDane(&ramka, surowa, sizeof(surowa));
+        return ramkaDoTekstu(surowa, n, bufor, rozmiar);
+    }
+
+    char czas[RAMKA_CZAS_DL];
+    ramkaFormatujCzas(epoch, czas, sizeof(czas));
+    int n = snprintf(bufor, rozmiar, "DANE;%d;%.2f;%.2f;%d;%d;%d;%s",
+                     (int)id, temperatura, wilgotnosc, co2, amoniak, swiatlo, czas);
+    return (n > 0 && (size_t)n < rozmiar) ? (size_t)n : 0;
+}
+
+static void raport() {
+    StatystykiSymulatora s;
+    SymulatorPobierzStatystyki(&s);
+    float czas_s = s.czas_us / 1e6f;
+
+    Serial.println("\n=== RAPORT SYMULACJI ===");
+    Serial.printf("Węzły: %lu, format: %s, czas: %.1f s\n",
+                  (unsigned long)liczbaWezlow, binarne ? "RAMK" : "DANE", czas_s);
+    Serial.printf("Wygenerowane: %lu (%.1f/s), przetworzone: %lu (%.1f/s), odrzucone (kolejka pełna): %lu\n",
+                  (unsigned long)s.wygenerowane, s.wygenerowane / czas_s,
+                  (unsigned long)s.przetworzone, s.przetworzone / czas_s, (unsigned long)s.odrzucone);
+    Serial.printf("Potwierdzone: %lu, ponowione: %lu, odłożone do kolejki offline: %lu\n",
+                  (unsigned long)s.potwierdzone, (unsigned long)s.ponowione, (unsigned long)s.odlozone);
+    Serial.printf("Zapisano na SD (prawdziwe węzły): %lu B\n", (unsigned long)s.bajty_sd);
+    Serial.printf("Pominięte zapisy symulacji: archiwum %lu B, kolejka offline %lu B (%.1f B/wiadomość)\n",
+                  (unsigned long)s.pominiete_archiwum, (unsigned long)s.pominiete_kolejka,
+                  s.przetworzone ? (float)(s.pominiete_archiwum + s.pominiete_kolejka) / s.przetworzone : 0.0f);
+
+    Serial.println("Etap        liczba    p50 us    p90 us    p99 us    max us");
+    for (int e = 0; e < ETAP_LICZBA; e++) {
+        const HistogramCzasu* h = &histogramy[e];
+        if (h->liczba == 0) {
+            Serial.printf("%-10s  %6u         -         -         -         -\n", NAZWY_ETAPOW[e], 0u);
+            continue;
+        }
+        Serial.printf("%-10s  %6lu  %8lu  %8lu  %8lu  %8lu\n", NAZWY_ETAPOW[e], (unsigned long)h->liczba,
+                      (unsigned long)histogramPercentyl(h, 500),
+                      (unsigned long)histogramPercentyl(h, 900),
+                      (unsigned long)histogramPercentyl(h, 990),
+                      (unsigned long)h->max_us);
+    }
+    Serial.println("========================\n");
+}
+
+bool SymulatorStart(uint32_t wezly, float naSekunde, uint32_t czas_s, bool ramki) {
+    if (aktywna) {
+        Serial.println("[Symulator] Symulacja już trwa (symulacja stop)");
+        return false;
+    }
+    if (wezly == 0 || wezly > SYMULATOR_MAX_WEZLOW || naSekunde <= 0 || czas_s == 0 || czas_s > 3600) {
+        Serial.printf("[Symulator] Nieprawidłowe parametry (węzły 1..%d, czas 1..3600 s)\n", SYMULATOR_MAX_WEZLOW);
+        return false;
+    }
+
+    liczbaWezlow = wezly;
+    wiadomosciNaSekunde = naSekunde * wezly;
+    czasTrwania_us = czas_s * 1000000UL;
+    binarne = ramki;
+    wygenerowane = 0;
+
+    for (int e = 0; e < ETAP_LICZBA; e++) {
+        histogramWyczysc(&histogramy[e]);
+    }
+    PobierzStatystykiUplinku(&uplinkStart);
+    DostarczaniePobierzStatystyki(&dostarczanieStart);
+    for (int i = 0; i < REJESTR_LICZBA; i++) {
+        bajtySDStart[i] = bajtyZapisaneSD(i);
+    }
+    pominieteArchiwum = 0;
+    pominieteKolejka = 0;
+
+    Serial.printf("[Symulator] Start: %lu węzłów x %.2f/s = %.1f wiadomości/s przez %lu s (%s)\n",
+                  (unsigned long)wezly, naSekunde, wiadomosciNaSekunde, (unsigned long)czas_s,
+                  ramki ? "RAMK" : "DANE");
+    start_us = micros();
+    aktywna = true;
+    return true;
+}
+
+void SymulatorStop() {
+    if (!aktywna) return;
+    aktywna = false;
+    koniec_us = micros();
+    raport();
+}
+
+void SymulatorObsluga() {
+    if (!aktywna) return;
+
+    uint32_t uplynelo = micros() - start_us;
+    if (uplynelo >= czasTrwania_us) {
+        SymulatorStop();
+        return;
+    }
+
+    uint32_t naleznych = (uint32_t)((uint64_t)uplynelo * (uint64_t)(wiadomosciNaSekunde * 1000.0f) / 1000000000ULL);
+    uint32_t doWygenerowania = (naleznych > wygenerowane) ? naleznych - wygenerowane : 0;
+    if (doWygenerowania > SYMULATOR_MAX_NA_PETLE) doWygenerowania = SYMULATOR_MAX_NA_PETLE;
+
+    char wiadomosc[RAMKA_MAX_TEKST > 160 ? RAMKA_MAX_TEKST : 160];
+    for (uint32_t i = 0; i < doWygenerowania; i++) {
+        uint32_t wezel = wygenerowane % liczbaWezlow;
+        size_t dlugosc = utworzWiadomosc(wezel, wiadomosc, sizeof(wiadomosc));
+        wygenerowane++;
+        if (dlugosc == 0) continue;
+
+        uint32_t t0 = micros();
+        ObsluzWiadomoscMesh(SYMULATOR_ID_BAZOWE + wezel, wiadomosc, dlugosc);
+        SymulatorZmierz(ETAP_ODBIOR, micros() - t0);
+    }
+}
+
+bool SymulatorAktywny() {
+    return aktywna;
+}
+
+void SymulatorPobierzStatystyki(StatystykiSymulatora* statystyki) {
+    StatystykiUplinku uplink;
+    PobierzStatystykiUplinku(&uplink);
+    StatystykiDostarczania dostarczanie;
+    DostarczaniePobierzStatystyki(&dostarczanie);
+
+    statystyki->czas_us            = (aktywna ? micros() : koniec_us) - start_us;
+    statystyki->wygenerowane       = wygenerowane;
+    statystyki->przetworzone       = uplink.przetworzone - uplinkStart.przetworzone;
+    statystyki->odrzucone          = uplink.odrzucone - uplinkStart.odrzucone;
+    statystyki->potwierdzone       = dostarczanie.potwierdzone - dostarczanieStart.potwierdzone;
+    statystyki->ponowione          = dostarczanie.ponowione - dostarczanieStart.ponowione;
+    statystyki->odlozone           = dostarczanie.odlozone - dostarczanieStart.odlozone;
+    statystyki->bajty_sd           = 0;
+    for (int i = 0; i < REJESTR_LICZBA; i++) {
+        statystyki->bajty_sd += bajtyZapisaneSD(i) - bajtySDStart[i];
+    }
+    statystyki->pominiete_archiwum = pominieteArchiwum;
+    statystyki->pominiete_kolejka  = pominieteKolejka;
+}
+
+const HistogramCzasu* SymulatorHistogram(EtapSymulacji etap) {
+    return (etap < ETAP_LICZBA) ? &histogramy[etap] : nullptr;
+}
+
+void SymulatorZmierz(EtapSymulacji etap, uint32_t czas_us) {
+    if (!aktywna || etap >= ETAP_LICZBA) return;
+    histogramDodaj(&histogramy[etap], czas_us);
+}
+
+bool SymulatorRekord(const char* rekord) {
+    uint32_t id = (uint32_t)strtoul(rekord, nullptr, 10);
+    return id >= SYMULATOR_ID_BAZOWE && id < SYMULATOR_ID_BAZOWE + SYMULATOR_MAX_WEZLOW;
+}
+
+void SymulatorPominZapis(const char* rekord, bool archiwum) {
+    uint32_t bajty = (uint32_t)strlen(rekord) + 1;
+    if (archiwum) {
+        pominieteArchiwum += bajty;
+    } else {
+        pominieteKolejka += bajty;
+    }
+}
+
+const char* SymulatorTopicRekordu(const char* rekord) {
+    if (!SymulatorRekord(rekord)) return topic;
+
+    snprintf(topicSymulacji, sizeof(topicSymulacji), "%s" SYMULATOR_TOPIC_SUFIKS, topic);
+    return topicSymulacji;
+}
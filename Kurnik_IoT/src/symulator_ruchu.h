@@ -0,0 +1,120 @@
+/*
+ * MODUŁ SYMULATORA RUCHU - symulator_ruchu.h
+ *
+ * Generator syntetycznego ruchu z N wirtualnych węzłów mesh do pomiaru
+ * ścieżki przyjmowania danych bez dodatkowego sprzętu. Wiadomości "DANE;..."
+ * lub "RAMK..." trafiają do dyspozytora mesh (ObsluzWiadomoscMesh()) z pętli
+ * Arduino - tak jak z receivedCallback() - i dalej przez kolejkę uplinku,
+ * WyslijPakiet() i potwierdzenie PUBACK.
+ *
+ * Wirtualne węzły mają ID od SYMULATOR_ID_BAZOWE. Ich rekordy są publikowane
+ * na topicu "<topic>/symulacja" (pomijanym przez serwer) i nie trafiają na
+ * kartę SD - ZapiszDanePakiet() przekazuje je do SymulatorPominZapis(), więc
+ * nie zajmują archiwum, kolejki offline ani bloków archiwum prawdziwych węzłów
+ * (ARCHIWUM_BLOKI_URZADZEN). Raport podaje, ile bajtów by zapisały.
+ *
+ * Po zakończeniu wypisywany jest raport: wiadomości/s, percentyle czasu
+ * poszczególnych etapów i liczba bajtów zapisanych na kartę.
+ *
+ * Komenda Serial: "symulacja <węzły> <wiadomości/s na węzeł> <czas s> [ramka]"
+ *                 "symulacja stop"
+ */
+
+#ifndef SYMULATOR_RUCHU_H
+#define SYMULATOR_RUCHU_H
+
+#include "main.h"
+#include "histogram_czasu.h"
+
+// Pierwsze ID wirtualnego węzła
+#define SYMULATOR_ID_BAZOWE       0x5EED0000UL
+// Maksymalna liczba wirtualnych węzłów
+#define SYMULATOR_MAX_WEZLOW      256
+// Maksymalna liczba wiadomości wygenerowanych w jednym wywołaniu SymulatorObsluga()
+#define SYMULATOR_MAX_NA_PETLE    16
+// Sufiks topicu dla rekordów wirtualnych węzłów
+#define SYMULATOR_TOPIC_SUFIKS    "/symulacja"
+
+// Mierzone etapy ścieżki danych
+typedef enum {
+    ETAP_ODBIOR = 0,      // Dyspozytor mesh + parsowanie + wstawienie do kolejki uplinku
+    ETAP_KOLEJKA,         // Oczekiwanie w kolejce uplinku
+    ETAP_WYSYLKA,         // WyslijPakiet() - formatowanie i publikacja
+    ETAP_ZAPIS_SD,        // ZapiszDanePakiet() prawdziwych węzłów w trakcie symulacji
+    ETAP_POTWIERDZENIE,   // Publikacja -> PUBACK
+    ETAP_LICZBA
+} EtapSymulacji;
+
+// Wynik symulacji - przyrosty od SymulatorStart() (raport i testy hosta)
+typedef struct {
+    uint32_t czas_us;            // Czas trwania (do teraz, gdy symulacja trwa)
+    uint32_t wygenerowane;       // Wiadomości wirtualnych węzłów
+    uint32_t przetworzone;       // Pakiety przetworzone przez uplink
+    uint32_t odrzucone;          // Pakiety odrzucone - kolejka uplinku pełna
+    uint32_t potwierdzone;       // Rekordy potwierdzone PUBACK
+    uint32_t ponowione;          // Ponowione publikacje
+    uint32_t odlozone;           // Rekordy odłożone do kolejki offline
+    uint32_t bajty_sd;           // Bajty zapisane na kartę (prawdziwe węzły)
+    uint32_t pominiete_archiwum; // Bajty rekordów symulacji pominięte w archiwum
+    uint32_t pominiete_kolejka;  // Bajty rekordów symulacji pominięte w kolejce offline
+} StatystykiSymulatora;
+
+/*
+ * Uruchamia symulację.
+ * parametr: wezly Liczba wirtualnych węzłów (1..SYMULATOR_MAX_WEZLOW)
+ * parametr: naSekunde Wiadomości na sekundę z jednego węzła
+ * parametr: czas_s Czas trwania w sekundach
+ * parametr: ramki true = binarne ramki "RAMK", false = tekst "DANE"
+ * return: false przy nieprawidłowych parametrach lub gdy symulacja już trwa
+ */
+bool SymulatorStart(uint32_t wezly, float naSekunde, uint32_t czas_s, bool ramki);
+
+/*
+ * Przerywa symulację i wypisuje raport.
+ */
+void SymulatorStop();
+
+/*
+ * Generuje zaległe wiadomości i kończy symulację po upływie czasu.
+ * Wywoływana w każdej iteracji loop() (kontekst callbacków mesh).
+ */
+void SymulatorObsluga();
+
+/*
+ * return: true gdy symulacja trwa
+ */
+bool SymulatorAktywny();
+
+/*
+ * Wypełnia statystyki ostatniej (lub trwającej) symulacji.
+ */
+void SymulatorPobierzStatystyki(StatystykiSymulatora* statystyki);
+
+/*
+ * return: histogram czasów etapu ostatniej (lub trwającej) symulacji
+ */
+const HistogramCzasu* SymulatorHistogram(EtapSymulacji etap);
+
+/*
+ * Zapisuje czas etapu do histogramu (tylko w trakcie symulacji).
+ */
+void SymulatorZmierz(EtapSymulacji etap, uint32_t czas_us);
+
+/*
+ * return: true dla rekordu CSV wirtualnego węzła (ID od SYMULATOR_ID_BAZOWE)
+ */
+bool SymulatorRekord(const char* rekord);
+
+/*
+ * Liczy rekord wirtualnego węzła zamiast zapisu na kartę SD.
+ * parametr: archiwum true = rekord potwierdzony (archiwum), false = kolejka offline
+ */
+void SymulatorPominZapis(const char* rekord, bool archiwum);
+
+/*
+ * Wybiera topic publikacji rekordu CSV: topic symulacji dla wirtualnych
+ * węzłów, w przeciwnym razie główny topic.
+ */
+const char* SymulatorTopicRekordu(const char* rekord);
+
+#endif
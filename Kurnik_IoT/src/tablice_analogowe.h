@@ -0,0 +1,148 @@
+/*
+ * MODUŁ TABLIC PRZELICZENIOWYCH - tablice_analogowe.h
+ *
+ * Tablice kod ADC -> wartość fizyczna generowane w czasie kompilacji
+ * (constexpr) dla czujników analogowych. Przeliczenie próbki to odczyt
+ * dwóch sąsiednich węzłów tablicy i interpolacja liniowa - bez log(),
+ * powf() i dzielenia w czasie pracy.
+ *
+ * Tablica ma TABLICA_WEZLY węzłów co TABLICA_KROK kodów (0..4096) i leży
+ * we flashu. Model sondy to struktura ze statyczną funkcją constexpr
+ * wartosc(kod) - nowy typ sondy wymaga tylko jej deklaracji, np.:
+ *
+ *   struct NtcMojaSonda {
+ *       static constexpr double wartosc(int kod) {
+ *           return tablicaNtcBeta(kod, 10000.0, 47000.0, 25.0, 4050.0);
+ *       }
+ *   };
+ *
+ * Sondę wybiera się dla płytki w build_flags (-DSONDA_NTC=NtcMojaSonda).
+ *
+ * Maksymalny błąd interpolacji względem dotychczasowych obliczeń float
+ * (test hosta test/test_tablice_analogowe dla wszystkich kodów 1..4094):
+ *   NTC 10k/B3950:  < 0.002 °C dla -20..80 °C, < 0.02 °C dla -40..125 °C
+ *   LDR:            < 0.7% dla kodów 64..4094, < 0.05% dla kodów 256..4094
+ * Poniżej tych zakresów (skrajne kody) krzywe są zbyt strome dla węzłów
+ * co TABLICA_KROK i błąd rośnie - to i tak odczyty poza zakresem sond.
+ *
+ * Moduł nie używa Arduino - kompiluje się również na hoście (C++11).
+ */
+
+#ifndef TABLICE_ANALOGOWE_H
+#define TABLICE_ANALOGOWE_H
+
+#include <stdint.h>
+
+// Rozdzielczość tablicy: węzeł co 2^TABLICA_PRZESUNIECIE kodów ADC
+#define TABLICA_PRZESUNIECIE  3
+#define TABLICA_KROK          (1 << TABLICA_PRZESUNIECIE)
+#define TABLICA_WEZLY         (4096 / TABLICA_KROK + 1)
+#define TABLICA_MAX_KOD       4095
+
+// === MATEMATYKA CONSTEXPR (C++11 - jedno wyrażenie na funkcję) ===
+
+constexpr double TABLICA_LN2 = 0.69314718055994530942;
+
+// atanh(z) z szeregu z + z^3/3 + z^5/5 + ...
+constexpr double tablicaAtanh(double z, double z2, double potega, int n) {
+    return n > 41 ? 0.0 : potega / n + tablicaAtanh(z, z2, potega * z2, n + 2);
+}
+
+// ln(x) dla x > 0: sprowadzenie do [0.5, 2], potem ln(x) = 2 atanh((x-1)/(x+1))
+constexpr double tablicaLn(double x) {
+    return x > 2.0 ? tablicaLn(x / 2.0) + TABLICA_LN2
+         : x < 0.5 ? tablicaLn(x * 2.0) - TABLICA_LN2
+         : 2.0 * tablicaAtanh((x - 1.0) / (x + 1.0), ((x - 1.0) / (x + 1.0)) * ((x - 1.0) / (x + 1.0)),
+                              (x - 1.0) / (x + 1.0), 1);
+}
+
+constexpr double tablicaTaylorExp(double x, double wyraz, int n) {
+    return n > 20 ? 0.0 : wyraz + tablicaTaylorExp(x, wyraz * x / n, n + 1);
+}
+
+constexpr double tablicaKwadrat(double x) {
+    return x * x;
+}
+
+// exp(x): połowienie argumentu do |x| <= 0.5, szereg Taylora i podnoszenie do kwadratu
+constexpr double tablicaExp(double x) {
+    return (x > 0.5 || x < -0.5) ? tablicaKwadrat(tablicaExp(x / 2.0)) : tablicaTaylorExp(x, 1.0, 1);
+}
+
+constexpr double tablicaPow(double podstawa, double wykladnik) {
+    return tablicaExp(wykladnik * tablicaLn(podstawa));
+}
+
+constexpr int tablicaOgranicz(int kod) {
+    return kod < 1 ? 1 : (kod > 4094 ? 4094 : kod);
+}
+
+// Rezystancja dolnego elementu dzielnika: VCC --- r_ref --- ADC --- R --- GND
+constexpr double tablicaRezystancja(int kod, double r_ref) {
+    return r_ref * tablicaOgranicz(kod) / (4095.0 - tablicaOgranicz(kod));
+}
+
+// === MODELE CZUJNIKÓW ===
+
+// Termistor NTC, model Beta: T = 1 / (1/T0 + ln(R/R0)/B)  [°C]
+constexpr double tablicaNtcBeta(int kod, double r_ref, double r_nom, double t_nom, double beta) {
+    return 1.0 / (1.0 / (t_nom + 273.15) + tablicaLn(tablicaRezystancja(kod, r_ref) / r_nom) / beta) - 273.15;
+}
+
+// Fotorezystor, model R = A * lux^-B, z liniową kalibracją do miernika wzorcowego [lx]
+constexpr double tablicaLdrPotegowy(int kod, double r_ref, double a, double b, double cal_a, double cal_b) {
+    return cal_a * tablicaPow(a / tablicaRezystancja(kod, r_ref), 1.0 / b) + cal_b;
+}
+
+// Termistor kurnika: 10 kΩ w 25 °C, B = 3950, rezystor referencyjny 10 kΩ
+struct NtcKurnik10k {
+    static constexpr double wartosc(int kod) {
+        return tablicaNtcBeta(kod, 10000.0, 10000.0, 25.0, 3950.0);
+    }
+};
+
+// Fotorezystor kurnika: R_ref 10 kΩ, A = 150000, B = 0.7,
+// kalibracja do miernika wzorcowego: lux' = 0.587444 * lux + 22.2009
+struct LdrKurnik {
+    static constexpr double wartosc(int kod) {
+        return tablicaLdrPotegowy(kod, 10000.0, 150000.0, 0.7, 0.587444, 22.2009);
+    }
+};
+
+// Sondy wybrane dla płytki
+#ifndef SONDA_NTC
+#define SONDA_NTC  NtcKurnik10k
+#endif
+#ifndef SONDA_LDR
+#define SONDA_LDR  LdrKurnik
+#endif
+
+// === GENEROWANIE TABLIC ===
+
+template <int... I> struct TablicaIndeksy {};
+template <int N, int... I> struct TablicaBudujIndeksy : TablicaBudujIndeksy<N - 1, N - 1, I...> {};
+template <int... I> struct TablicaBudujIndeksy<0, I...> { typedef TablicaIndeksy<I...> typ; };
+
+template <typename Model, typename Indeksy = typename TablicaBudujIndeksy<TABLICA_WEZLY>::typ>
+struct TablicaAnalogowa;
+
+template <typename Model, int... I>
+struct TablicaAnalogowa<Model, TablicaIndeksy<I...> > {
+    static constexpr float wezly[sizeof...(I)] = { (float)Model::wartosc(I * TABLICA_KROK)... };
+
+    // Wartość dla kodu ADC 0..4095 (interpolacja liniowa między węzłami)
+    static float przelicz(uint16_t kod) {
+        if (kod > TABLICA_MAX_KOD) kod = TABLICA_MAX_KOD;
+        uint16_t i = kod >> TABLICA_PRZESUNIECIE;
+        float reszta = (float)(kod & (TABLICA_KROK - 1)) * (1.0f / TABLICA_KROK);
+        return wezly[i] + (wezly[i + 1] - wezly[i]) * reszta;
+    }
+};
+
+template <typename Model, int... I>
+constexpr float TablicaAnalogowa<Model, TablicaIndeksy<I...> >::wezly[sizeof...(I)];
+
+typedef TablicaAnalogowa<SONDA_NTC> TablicaNTC;
+typedef TablicaAnalogowa<SONDA_LDR> TablicaLDR;
+
+#endif
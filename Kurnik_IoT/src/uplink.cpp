@@ -0,0 +1,265 @@
+/*
+ * uplink.cpp
+ *
+ * Zadanie uplinku: pobiera pakiety z kolejki FreeRTOS i przekazuje je do
+ * WyslijPakiet()/WyslijPakietKura()/WyslijPakietAgregat() (MQTT + zapis na SD).
+ *
+ * Kolejka przechowuje kopie pakietów (struktury bez String), więc producent
+ * (callback mesh na rdzeniu pętli Arduino) nie czeka na konsumenta.
+ * Gdy kolejka jest pełna, pakiet jest odrzucany i liczony w statystykach.
+ */
+
+#include "uplink.h"
+#include "mqtt.h"
+#include "pamiec_SD.h"
+#include "rejestrator_SD.h"
+#include "archiwum_SD.h"
+#include "ponowna_wysylka.h"
+#include "dostarczanie_mqtt.h"
+#include "symulator_ruchu.h"
+#include "licznik_alokacji.h"
+#include "dziennik.h"
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+// Element kolejki uplinku - pakiet czujników, pomiar wagi kury lub agregat węzła
+typedef struct {
+    uint8_t typ;
+    uint32_t czasWstawienia;    // micros() wstawienia - do pomiaru wieku kolejki
+    union {
+        Pakiet_Danych dane;
+        Pakiet_Kury kura;
+        Pakiet_Agregatu agregat;
+    };
+} ElementUplinku;
+
+enum {
+    ELEMENT_DANE = 1,
+    ELEMENT_KURA = 2,
+    ELEMENT_AGREGAT = 3
+};
+
+// Zadanie uplinku działa na rdzeniu innym niż pętla Arduino (mesh.update())
+static const BaseType_t UPLINK_RDZEN = (ARDUINO_RUNNING_CORE == 0) ? 1 : 0;
+
+static QueueHandle_t kolejkaUplinku = nullptr;
+static TaskHandle_t zadanieUplinku = nullptr;
+
+static volatile bool ponowneWyslanieZlecone = false;
+static volatile bool czyszczenieZlecone = false;
+static volatile bool kartaWyczyszczona = false;
+static volatile uint32_t maxGlebokosc = 0;
+static volatile uint32_t odrzucone = 0;
+static volatile uint32_t przetworzone = 0;
+
+// Rozliczanie budżetu publikacji w oknach 1 s
+static uint32_t poczatekSekundy = 0;
+static uint32_t biezaceWSekundzie = 0;
+static uint32_t zaleglychWSekundzie = 0;
+static volatile uint32_t biezaceNaSekunde = 0;
+static volatile uint32_t zaleglychNaSekunde = 0;
+static volatile uint32_t wiekOstatniego = 0;
+static volatile uint32_t maxWiek = 0;
+
+static void przetworzElement(const ElementUplinku* element) {
+    uint32_t start = micros();
+    uint32_t wiek_us = start - element->czasWstawienia;
+    uint32_t wiek = wiek_us / 1000;
+    wiekOstatniego = wiek;
+    if (wiek > maxWiek) maxWiek = wiek;
+
+    if (element->typ == ELEMENT_DANE) {
+        WyslijPakiet(&element->dane);
+        SymulatorZmierz(ETAP_KOLEJKA, wiek_us);
+        SymulatorZmierz(ETAP_WYSYLKA, micros() - start);
+    } else if (element->typ == ELEMENT_KURA) {
+        WyslijPakietKura(element->kura.id_urzadzenia, element->kura.id_kury,
+                         element->kura.waga, element->kura.data_i_czas);
+    } else if (element->typ == ELEMENT_AGREGAT) {
+        WyslijPakietAgregat(&element->agregat);
+    }
+    przetworzone++;
+    biezaceWSekundzie++;
+}
+
+static void rozliczSekunde() {
+    uint32_t teraz = millis();
+    if (teraz - poczatekSekundy < 1000) return;
+    biezaceNaSekunde = biezaceWSekundzie;
+    zaleglychNaSekunde = zaleglychWSekundzie;
+    biezaceWSekundzie = 0;
+    zaleglychWSekundzie = 0;
+    poczatekSekundy = teraz;
+}
+
+/*
+ * Przydział publikacji dla pasa zaległego w bieżącej sekundzie:
+ * to, czego nie zużył pas bieżący, ale co najmniej gwarantowany udział.
+ */
+static uint32_t przydzialZaleglych() {
+    const uint32_t gwarantowany = UPLINK_PUBLIKACJE_NA_S * UPLINK_UDZIAL_ZALEGLYCH / 100;
+    uint32_t wolny = (biezaceWSekundzie < UPLINK_PUBLIKACJE_NA_S) ? UPLINK_PUBLIKACJE_NA_S - biezaceWSekundzie : 0;
+    uint32_t limit = (wolny > gwarantowany) ? wolny : gwarantowany;
+    return (limit > zaleglychWSekundzie) ? limit - zaleglychWSekundzie : 0;
+}
+
+static bool wstawDoKolejki(ElementUplinku* element) {
+    element->czasWstawienia = micros();
+
+    // Bez zadania uplinku (błąd inicjalizacji) - wyślij synchronicznie jak dawniej
+    if (kolejkaUplinku == nullptr) {
+        przetworzElement(element);
+        return true;
+    }
+
+    // Timeout 0 - callback mesh nigdy nie czeka na miejsce w kolejce
+    if (xQueueSend(kolejkaUplinku, element, 0) != pdTRUE) {
+        odrzucone++;
+        return false;
+    }
+
+    uint32_t glebokosc = (uint32_t)uxQueueMessagesWaiting(kolejkaUplinku);
+    if (glebokosc > maxGlebokosc) maxGlebokosc = glebokosc;
+    return true;
+}
+
+void UplinkKrok() {
+    ElementUplinku element;
+
+    // Czekaj na pakiet maksymalnie 100 ms (10 ms w trakcie wysyłki kolejki,
+    // aby szybko odbierać potwierdzenia PUBACK i uzupełniać okno)
+    TickType_t czekaj = PonownaWysylkaAktywna() ? pdMS_TO_TICKS(10) : pdMS_TO_TICKS(100);
+
+    // Pas bieżący: wszystko, co czeka w kolejce, bez limitu (ograniczone pojemnością)
+    if (xQueueReceive(kolejkaUplinku, &element, czekaj) == pdTRUE) {
+        int n = 0;
+        do {
+            przetworzElement(&element);
+        } while (++n < UPLINK_GLEBOKOSC_KOLEJKI && xQueueReceive(kolejkaUplinku, &element, 0) == pdTRUE);
+    }
+    rozliczSekunde();
+
+    if (ponowneWyslanieZlecone) {
+        ponowneWyslanieZlecone = false;
+        PonownaWysylkaStart();
+    }
+
+    // Potwierdzenia bieżących pakietów, przekroczenia czasu, odkładanie do kolejki
+    DostarczanieObsluga();
+
+    // Odczyt i zapis karty SD (publikacje w środku mają własny zakres MQTT)
+    ZakresPodsystemu zakres(PODSYSTEM_SD);
+
+    // Pas zaległy: kolejka offline w ramach przydziału publikacji
+    zaleglychWSekundzie += PonownaWysylkaKrok(przydzialZaleglych());
+
+    // Zamknij stare bloki archiwum i zapisz bufory, które czekają zbyt długo
+    ArchiwumObsluga();
+    RejestratorObsluga();
+}
+
+static void petlaUplinku(void* parametr) {
+    for (;;) {
+        if (czyszczenieZlecone) {
+            WyczyscKarteSD();
+            kartaWyczyszczona = true;
+            // Urządzenie zaraz się restartuje - nic więcej nie może pisać na kartę
+            vTaskSuspend(nullptr);
+        }
+        UplinkKrok();
+    }
+}
+
+void InicjalizacjaUplink() {
+    if (kolejkaUplinku != nullptr) return;
+
+    PonownaWysylkaInicjalizacja();
+    DostarczanieInicjalizacja();
+
+    kolejkaUplinku = xQueueCreate(UPLINK_GLEBOKOSC_KOLEJKI, sizeof(ElementUplinku));
+    if (kolejkaUplinku == nullptr) {
+        Serial.println("[Uplink] BŁĄD: Nie udało się utworzyć kolejki");
+        return;
+    }
+
+    BaseType_t wynik = xTaskCreatePinnedToCore(petlaUplinku, "uplink", UPLINK_STOS, nullptr,
+                                               UPLINK_PRIORYTET, &zadanieUplinku, UPLINK_RDZEN);
+    if (wynik != pdPASS) {
+        Serial.println("[Uplink] BŁĄD: Nie udało się uruchomić zadania uplinku");
+        vQueueDelete(kolejkaUplinku);
+        kolejkaUplinku = nullptr;
+        return;
+    }
+
+    Serial.printf("[Uplink] Zadanie uplinku uruchomione na rdzeniu %d (kolejka: %d pakietów)\n",
+                  (int)UPLINK_RDZEN, UPLINK_GLEBOKOSC_KOLEJKI);
+}
+
+bool ZakolejkujPakiet(const Pakiet_Danych* pakiet) {
+    ElementUplinku element;
+    element.typ = ELEMENT_DANE;
+    element.dane = *pakiet;
+    return wstawDoKolejki(&element);
+}
+
+bool ZakolejkujPakietKura(int id_urzadzenia, const char* id_kury, float waga, const char* timestamp) {
+    ElementUplinku element;
+    // Jak przy parsowaniu tekstu - za długi UID odrzucamy zamiast obcinać
+    if (strlen(id_kury) >= sizeof(element.kura.id_kury)) {
+        LOG_OSTRZEZENIE("[Uplink] UID kury za długi (%u znaków) - odrzucono", (unsigned)strlen(id_kury));
+        return false;
+    }
+    element.typ = ELEMENT_KURA;
+    element.kura.id_urzadzenia = id_urzadzenia;
+    element.kura.waga = waga;
+    strlcpy(element.kura.id_kury, id_kury, sizeof(element.kura.id_kury));
+    strlcpy(element.kura.data_i_czas, timestamp, sizeof(element.kura.data_i_czas));
+    return wstawDoKolejki(&element);
+}
+
+bool ZakolejkujPakietAgregat(const Pakiet_Agregatu* agregat) {
+    ElementUplinku element;
+    element.typ = ELEMENT_AGREGAT;
+    element.agregat = *agregat;
+    return wstawDoKolejki(&element);
+}
+
+void ZlecPonowneWyslanie() {
+    if (zadanieUplinku == nullptr) {
+        // Wysyłka kolejki działa krokami w zadaniu uplinku - bez niego dane czekają na SD
+        Serial.println("[Uplink] Brak zadania uplinku - kolejka offline nie zostanie wysłana");
+        return;
+    }
+    ponowneWyslanieZlecone = true;
+}
+
+bool WyczyscKarteWUplinku() {
+    if (zadanieUplinku == nullptr) {
+        // Bez zadania uplinku kartą SD zarządza pętla Arduino
+        WyczyscKarteSD();
+        return true;
+    }
+
+    czyszczenieZlecone = true;
+    uint32_t start = millis();
+    while (!kartaWyczyszczona) {
+        if (millis() - start > UPLINK_LIMIT_CZYSZCZENIA_MS) {
+            LOG_BLAD("[Uplink] Karta SD nie została wyczyszczona w %d ms", UPLINK_LIMIT_CZYSZCZENIA_MS);
+            return false;
+        }
+        delay(10);
+    }
+    return true;
+}
+
+void PobierzStatystykiUplinku(StatystykiUplinku* statystyki) {
+    statystyki->glebokosc     = kolejkaUplinku ? (uint32_t)uxQueueMessagesWaiting(kolejkaUplinku) : 0;
+    statystyki->pojemnosc     = UPLINK_GLEBOKOSC_KOLEJKI;
+    statystyki->max_glebokosc = maxGlebokosc;
+    statystyki->odrzucone     = odrzucone;
+    statystyki->przetworzone  = przetworzone;
+    statystyki->biezace_na_s  = biezaceNaSekunde;
+    statystyki->zalegle_na_s  = zaleglychNaSekunde;
+    statystyki->wiek_ms       = wiekOstatniego;
+    statystyki->max_wiek_ms   = maxWiek;
+}
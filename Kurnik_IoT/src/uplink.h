@@ -0,0 +1,102 @@
+/*
+ * MODUŁ UPLINKU - uplink.h
+ *
+ * Oddziela odbiór danych z sieci mesh od wysyłki przez MQTT i zapisu na SD.
+ * Callbacki mesh tylko wstawiają zdekodowane pakiety do ograniczonej kolejki
+ * FreeRTOS, a osobne zadanie uplinku (przypięte do drugiego rdzenia ESP32)
+ * opróżnia ją do MQTT i na kartę SD. Dzięki temu czas mesh.update()
+ * nie zależy od szybkości karty SD ani brokera.
+ *
+ * Harmonogram zadania ma dwa pasy:
+ * - pas bieżący (pakiety z mesh) - ścisły priorytet, opróżniany w całości
+ *   w każdej iteracji,
+ * - pas zaległy (kolejka offline) - dostaje resztę budżetu publikacji
+ *   UPLINK_PUBLIKACJE_NA_S, ale nie mniej niż UPLINK_UDZIAL_ZALEGLYCH procent.
+ *
+ * Zadanie uplinku jest jedynym właścicielem karty SD w czasie pracy -
+ * ponowne wysyłanie kolejki offline (ponowna_wysylka.h) także działa w tym
+ * zadaniu, krokami przeplatanymi z bieżącymi pakietami, a reset urządzenia
+ * czyści kartę przez WyczyscKarteWUplinku().
+ */
+
+#ifndef UPLINK_H
+#define UPLINK_H
+
+#include "main.h"
+
+// Pojemność kolejki uplinku (liczba pakietów)
+#define UPLINK_GLEBOKOSC_KOLEJKI  64
+// Rozmiar stosu zadania uplinku (bajty)
+#define UPLINK_STOS               8192
+// Priorytet zadania uplinku
+#define UPLINK_PRIORYTET          1
+// Budżet publikacji MQTT na sekundę dzielony między pasy
+#define UPLINK_PUBLIKACJE_NA_S    40
+// Gwarantowany udział pasa zaległego w budżecie (%)
+#define UPLINK_UDZIAL_ZALEGLYCH   25
+// Maksymalny czas oczekiwania na wyczyszczenie karty przez zadanie uplinku (ms)
+#define UPLINK_LIMIT_CZYSZCZENIA_MS 10000
+
+// Statystyki kolejki uplinku
+typedef struct {
+    uint32_t glebokosc;       // Aktualna liczba pakietów w kolejce
+    uint32_t pojemnosc;       // Maksymalna liczba pakietów w kolejce
+    uint32_t max_glebokosc;   // Najwyższe zaobserwowane zapełnienie (high-water mark)
+    uint32_t odrzucone;       // Pakiety odrzucone z powodu pełnej kolejki
+    uint32_t przetworzone;    // Pakiety wysłane przez zadanie uplinku
+    uint32_t biezace_na_s;    // Przepustowość pasa bieżącego (publikacje w ostatniej sekundzie)
+    uint32_t zalegle_na_s;    // Przepustowość pasa zaległego (publikacje w ostatniej sekundzie)
+    uint32_t wiek_ms;         // Czas oczekiwania ostatniego pakietu w kolejce uplinku
+    uint32_t max_wiek_ms;     // Najdłuższy czas oczekiwania pakietu w kolejce uplinku
+} StatystykiUplinku;
+
+/*
+ * Tworzy kolejkę i uruchamia zadanie uplinku na drugim rdzeniu.
+ * Wywoływana w setup() po inicjalizacji karty SD.
+ */
+void InicjalizacjaUplink();
+
+/*
+ * Jedna iteracja zadania uplinku: pas bieżący, potwierdzenia PUBACK,
+ * pas zaległy i zrzuty na kartę SD. Wywoływana w pętli zadania uplinku;
+ * testy hosta (env:native) wywołują ją bezpośrednio zamiast zadania.
+ */
+void UplinkKrok();
+
+/*
+ * Wstawia pakiet czujników do kolejki uplinku (nie blokuje).
+ * return: false jeśli kolejka jest pełna i pakiet odrzucono
+ */
+bool ZakolejkujPakiet(const Pakiet_Danych* pakiet);
+
+/*
+ * Wstawia pomiar wagi kury do kolejki uplinku (nie blokuje).
+ * return: false jeśli kolejka jest pełna i pakiet odrzucono
+ */
+bool ZakolejkujPakietKura(int id_urzadzenia, const char* id_kury, float waga, const char* timestamp);
+
+/*
+ * Wstawia agregat okna pomiarów węzła do kolejki uplinku (nie blokuje).
+ * return: false jeśli kolejka jest pełna i pakiet odrzucono
+ */
+bool ZakolejkujPakietAgregat(const Pakiet_Agregatu* agregat);
+
+/*
+ * Zleca zadaniu uplinku ponowne wysłanie danych z kolejki offline na SD.
+ */
+void ZlecPonowneWyslanie();
+
+/*
+ * Czyści kartę SD (WyczyscKarteSD()) w zadaniu uplinku - jedynym właścicielu
+ * karty - i czeka na zakończenie. Po wyczyszczeniu zadanie uplinku zatrzymuje
+ * się, aby nic nie zapisało karty przed restartem (tylko dla resetKurnik()).
+ * return: false, jeśli zadanie nie zdążyło w UPLINK_LIMIT_CZYSZCZENIA_MS
+ */
+bool WyczyscKarteWUplinku();
+
+/*
+ * Kopiuje bieżące statystyki kolejki uplinku.
+ */
+void PobierzStatystykiUplinku(StatystykiUplinku* statystyki);
+
+#endif
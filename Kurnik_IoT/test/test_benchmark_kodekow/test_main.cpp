@@ -0,0 +1,116 @@
+/*
+ * BENCHMARK KODEKÓW NA HOŚCIE - test_benchmark_kodekow/test_main.cpp
+ *
+ * Uruchamia przypadki benchmark_kodekow.h w pio test -e native, żeby
+ * regresje parserów i formaterów były widoczne w CI, nie tylko po komendzie
+ * "benchmark" na urządzeniu. Tabela ns/op i alokacji/op trafia do wyjścia
+ * testu razem z przyspieszeniem względem przypadków bazowych. Asercje
+ * czasu wymagają jawnego współczynnika (MIN_PRZYSPIESZENIE) przy co
+ * najmniej ITERACJE iteracjach i tylko tam, gdzie zmierzony zapas jest
+ * wielokrotnie większy; pozostałe przyspieszenia są tylko raportowane. Alokacje liczy natywne/licznik_alokacji.cpp - sscanf
+ * z glibc nie alokuje (newlib na ESP32 tak), więc bazą dla alokacji są
+ * przypadki ze String.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "benchmark_kodekow.h"
+
+// 12:30:00 Tue, Jan 02 2024
+static const uint32_t EPOCH = 1704198600;
+static const size_t MAX_WYNIKOW = 32;
+// Iteracje na powtórzenie - krótsze pomiary są zbyt zaszumione dla asercji czasu
+static const uint32_t ITERACJE = 20000;
+// Wymagane przyspieszenie względem przypadku bazowego (zmierzone: >= 7x)
+static const float MIN_PRZYSPIESZENIE = 4.0f;
+
+static WynikBenchmarku wyniki[MAX_WYNIKOW];
+static size_t liczbaWynikow = 0;
+
+static const WynikBenchmarku* wynik(const char* nazwa) {
+    for (size_t i = 0; i < liczbaWynikow; i++) {
+        if (strcmp(wyniki[i].nazwa, nazwa) == 0) return &wyniki[i];
+    }
+    TEST_FAIL_MESSAGE(nazwa);
+    return nullptr;
+}
+
+// Przyspieszenie bieżącej implementacji względem bazowej - wypisywane do wyjścia testu
+static float przyspieszenie(const char* bazowy, const char* nowy) {
+    float b = wynik(bazowy)->ns_na_op;
+    float n = wynik(nowy)->ns_na_op;
+    float x = (n > 0.0f) ? b / n : 0.0f;
+
+    char linia[112];
+    snprintf(linia, sizeof(linia), "%s: %.1fx względem %s (%.0f / %.0f ns/op)", nowy, x, bazowy, n, b);
+    TEST_MESSAGE(linia);
+    return x;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_wszystkie_przypadki_zmierzone() {
+    liczbaWynikow = ZmierzBenchmarkKodekow(ITERACJE, wyniki, MAX_WYNIKOW);
+    TEST_ASSERT_GREATER_THAN(0, (int)liczbaWynikow);
+    TEST_ASSERT_LESS_THAN((int)MAX_WYNIKOW, (int)liczbaWynikow);
+
+    char linia[112];
+    for (size_t i = 0; i < liczbaWynikow; i++) {
+        snprintf(linia, sizeof(linia), "%-32s %8.0f ns/op %6.2f alok/op %7.1f B/op", wyniki[i].nazwa,
+                 wyniki[i].ns_na_op, wyniki[i].alokacje_na_op, wyniki[i].bajty_na_op);
+        TEST_MESSAGE(linia);
+        TEST_ASSERT_TRUE(wyniki[i].ns_na_op > 0.0f);
+    }
+}
+
+void test_parser_pakietu_wzgledem_sscanf() {
+    // Wymaga pomiaru z poprzedniego testu; na hoście zapas to tylko ~2x - bez asercji czasu
+    TEST_ASSERT_GREATER_THAN(0, (int)liczbaWynikow);
+    przyspieszenie("sscanf CSV (bazowy)", "ParsujPakietDane");
+}
+
+void test_czas_z_tekstu_szybszy_od_strptime() {
+    TEST_ASSERT_GREATER_THAN(0, (int)liczbaWynikow);
+    TEST_ASSERT_TRUE(przyspieszenie("strptime+mktime (bazowy)", "kodekCzasZTekstu") >= MIN_PRZYSPIESZENIE);
+}
+
+void test_nieznany_tag_tanszy_od_substring() {
+    TEST_ASSERT_GREATER_THAN(0, (int)liczbaWynikow);
+    TEST_ASSERT_TRUE(przyspieszenie("String substring (bazowy)", "ObsluzWiadomoscMesh (nieznany)") >= MIN_PRZYSPIESZENIE);
+}
+
+void test_bazowe_string_alokuja() {
+    TEST_ASSERT_GREATER_THAN(0, (int)liczbaWynikow);
+    TEST_ASSERT_TRUE(wynik("String substring (bazowy)")->alokacje_na_op >= 1.0f);
+    TEST_ASSERT_TRUE(wynik("rtc.getTimeDate (bazowy)")->alokacje_na_op >= 1.0f);
+    TEST_ASSERT_TRUE(wynik("pakietToCSV węzła (bazowy)")->alokacje_na_op >= 1.0f);
+}
+
+void test_kodeki_bez_alokacji() {
+    static const char* const KODEKI[] = {
+        "FormatujPakietCSV", "ParsujPakietDane", "ObsluzWiadomoscMesh (nieznany)",
+        "ramkaFormatujCzas", "kodekCzasZTekstu", "ramka kodowanie+base64",
+        "ramka base64+dekodowanie", "kodekParsujCSV", "kodekFormatujCSV", "kodekDodaj"
+    };
+    TEST_ASSERT_GREATER_THAN(0, (int)liczbaWynikow);
+    for (size_t i = 0; i < sizeof(KODEKI) / sizeof(KODEKI[0]); i++) {
+        const WynikBenchmarku* w = wynik(KODEKI[i]);
+        TEST_ASSERT_EQUAL_FLOAT_MESSAGE(0.0f, w->alokacje_na_op, w->nazwa);
+        TEST_ASSERT_EQUAL_FLOAT_MESSAGE(0.0f, w->bajty_na_op, w->nazwa);
+    }
+}
+
+int main() {
+    rtc.setTime(EPOCH);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_wszystkie_przypadki_zmierzone);
+    RUN_TEST(test_parser_pakietu_wzgledem_sscanf);
+    RUN_TEST(test_czas_z_tekstu_szybszy_od_strptime);
+    RUN_TEST(test_nieznany_tag_tanszy_od_substring);
+    RUN_TEST(test_bazowe_string_alokuja);
+    RUN_TEST(test_kodeki_bez_alokacji);
+    return UNITY_END();
+}
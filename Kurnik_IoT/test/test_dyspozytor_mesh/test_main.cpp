@@ -0,0 +1,225 @@
+/*
+ * TESTY DYSPOZYTORA MESH - test_dyspozytor_mesh/test_main.cpp
+ *
+ * Testy hosta dla dyspozytor_mesh.h (pio test -e native): wyszukiwanie
+ * obsługi po tagu, odrzucanie nieznanych tagów i krótkich wiadomości,
+ * kolizje slotów i nieudane rejestracje oraz porównanie przepustowości
+ * (wiadomości/s) z dawnym rozpoznawaniem prefiksu przez String::substring()
+ * i łańcuch if/else (mesh_local.cpp przed tablicą tagów).
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "dyspozytor_mesh.h"
+
+// Ostatnie wywołanie obsługi
+static int wywolania[4];
+static uint32_t ostatniFrom;
+static const char* ostatnieDane;
+static size_t ostatniaDlugosc;
+
+enum { OBSLUGA_DANE = 0, OBSLUGA_KURA, OBSLUGA_RAMK, OBSLUGA_TIME };
+
+static void zapamietaj(int ktora, uint32_t from, const char* dane, size_t dlugosc) {
+    wywolania[ktora]++;
+    ostatniFrom = from;
+    ostatnieDane = dane;
+    ostatniaDlugosc = dlugosc;
+}
+
+static void obsluzDane(uint32_t from, const char* dane, size_t dlugosc) { zapamietaj(OBSLUGA_DANE, from, dane, dlugosc); }
+static void obsluzKura(uint32_t from, const char* dane, size_t dlugosc) { zapamietaj(OBSLUGA_KURA, from, dane, dlugosc); }
+static void obsluzRamk(uint32_t from, const char* dane, size_t dlugosc) { zapamietaj(OBSLUGA_RAMK, from, dane, dlugosc); }
+static void obsluzTime(uint32_t from, const char* dane, size_t dlugosc) { zapamietaj(OBSLUGA_TIME, from, dane, dlugosc); }
+static void obsluzInne(uint32_t, const char*, size_t) {}
+
+static int sumaWywolan() {
+    return wywolania[0] + wywolania[1] + wywolania[2] + wywolania[3];
+}
+
+static bool wyslij(const char* msg) {
+    return ObsluzWiadomoscMesh(17, msg, strlen(msg));
+}
+
+void setUp() {
+    memset(wywolania, 0, sizeof(wywolania));
+    ostatniFrom = 0;
+    ostatnieDane = nullptr;
+    ostatniaDlugosc = 0;
+}
+
+void tearDown() {}
+
+void test_rejestracja_tagow_gatewaya() {
+    // Tagi używane przez odbior_mesh.cpp i mesh_local.cpp nie kolidują ze sobą
+    TEST_ASSERT_TRUE(RejestrujObslugeMesh(TagMesh("DANE"), &obsluzDane));
+    TEST_ASSERT_TRUE(RejestrujObslugeMesh(TagMesh("KURA"), &obsluzKura));
+    TEST_ASSERT_TRUE(RejestrujObslugeMesh(TagMesh("RAMK"), &obsluzRamk));
+    TEST_ASSERT_TRUE(RejestrujObslugeMesh(TagMesh("TIME"), &obsluzTime));
+}
+
+void test_wyszukiwanie_po_tagu() {
+    const char* msg = "DANE;7;21.50;55.25;800;12;40;12:00:00 Wed, Jan 07 2026";
+    TEST_ASSERT_TRUE(ObsluzWiadomoscMesh(3257743041u, msg, strlen(msg)));
+    TEST_ASSERT_EQUAL_INT(1, wywolania[OBSLUGA_DANE]);
+    TEST_ASSERT_EQUAL_UINT32(3257743041u, ostatniFrom);
+    // Treść za tagiem wskazuje w bufor wiadomości - bez kopii
+    TEST_ASSERT_EQUAL_PTR(msg + 4, ostatnieDane);
+    TEST_ASSERT_EQUAL_UINT32(strlen(msg) - 4, ostatniaDlugosc);
+
+    TEST_ASSERT_TRUE(wyslij("KURA;692641124;F7474A39;-0.37;12:00:01 Wed, Jan 07 2026"));
+    TEST_ASSERT_TRUE(wyslij("RAMKAQIDBAUGBwg="));
+    TEST_ASSERT_EQUAL_INT(1, wywolania[OBSLUGA_KURA]);
+    TEST_ASSERT_EQUAL_INT(1, wywolania[OBSLUGA_RAMK]);
+
+    // Sam tag - obsługa dostaje pustą treść
+    TEST_ASSERT_TRUE(wyslij("TIME"));
+    TEST_ASSERT_EQUAL_INT(1, wywolania[OBSLUGA_TIME]);
+    TEST_ASSERT_EQUAL_UINT32(0, ostatniaDlugosc);
+}
+
+void test_nieznany_tag_i_krotka_wiadomosc() {
+    TEST_ASSERT_FALSE(wyslij("XYZW;1;2;3"));
+    TEST_ASSERT_FALSE(wyslij("dane;7;21.50"));
+    TEST_ASSERT_FALSE(wyslij("DAN"));
+    TEST_ASSERT_FALSE(wyslij(""));
+    // Tag rozpoznawany tylko na początku wiadomości
+    TEST_ASSERT_FALSE(wyslij(" DANE;7"));
+    TEST_ASSERT_EQUAL_INT(0, sumaWywolan());
+}
+
+void test_ponowna_rejestracja_podmienia_obsluge() {
+    TEST_ASSERT_TRUE(RejestrujObslugeMesh(TagMesh("TIME"), &obsluzKura));
+    TEST_ASSERT_TRUE(wyslij("TIME"));
+    TEST_ASSERT_EQUAL_INT(0, wywolania[OBSLUGA_TIME]);
+    TEST_ASSERT_EQUAL_INT(1, wywolania[OBSLUGA_KURA]);
+
+    TEST_ASSERT_TRUE(RejestrujObslugeMesh(TagMesh("TIME"), &obsluzTime));
+    TEST_ASSERT_TRUE(wyslij("TIME"));
+    TEST_ASSERT_EQUAL_INT(1, wywolania[OBSLUGA_TIME]);
+}
+
+void test_rejestracja_bez_obslugi() {
+    TEST_ASSERT_FALSE(RejestrujObslugeMesh(TagMesh("NULL"), nullptr));
+    TEST_ASSERT_FALSE(wyslij("NULL;1"));
+    // Istniejącej obsługi też nie da się wyzerować
+    TEST_ASSERT_FALSE(RejestrujObslugeMesh(TagMesh("DANE"), nullptr));
+    TEST_ASSERT_TRUE(wyslij("DANE;1"));
+    TEST_ASSERT_EQUAL_INT(1, wywolania[OBSLUGA_DANE]);
+}
+
+void test_kolizja_slotu() {
+    // Tablica ma skończoną liczbę slotów - kolejne tagi muszą w końcu trafić w zajęty slot
+    char tekst[5];
+    uint32_t kolidujacy = 0;
+    for (int i = 0; i < 1000 && kolidujacy == 0; i++) {
+        snprintf(tekst, sizeof(tekst), "K%03d", i);
+        uint32_t tag;
+        memcpy(&tag, tekst, sizeof(tag));
+        if (!RejestrujObslugeMesh(tag, &obsluzInne)) kolidujacy = tag;
+    }
+    TEST_ASSERT_NOT_EQUAL(0, kolidujacy);
+
+    // Odrzucony tag nie trafia do obsługi, która zajmuje jego slot
+    char msg[16];
+    memcpy(msg, &kolidujacy, 4);
+    strcpy(msg + 4, ";1;2");
+    TEST_ASSERT_FALSE(wyslij(msg));
+
+    // Kolizja nie nadpisała wcześniejszych rejestracji
+    TEST_ASSERT_TRUE(wyslij("DANE;1"));
+    TEST_ASSERT_TRUE(wyslij("KURA;1"));
+    TEST_ASSERT_TRUE(wyslij("RAMKAA=="));
+    TEST_ASSERT_TRUE(wyslij("TIME"));
+    TEST_ASSERT_EQUAL_INT(1, wywolania[OBSLUGA_DANE]);
+    TEST_ASSERT_EQUAL_INT(1, wywolania[OBSLUGA_KURA]);
+    TEST_ASSERT_EQUAL_INT(1, wywolania[OBSLUGA_RAMK]);
+    TEST_ASSERT_EQUAL_INT(1, wywolania[OBSLUGA_TIME]);
+}
+
+// === DAWNE ROZPOZNAWANIE PREFIKSU (receivedCallback przed dyspozytorem) ===
+
+static bool dyspozycjaLancuchem(uint32_t from, String& msg) {
+    String prefix = msg.substring(0, 4);
+    if (prefix == "DANE") {
+        obsluzDane(from, msg.c_str() + 4, msg.length() - 4);
+    } else if (prefix == "KURA") {
+        obsluzKura(from, msg.c_str() + 4, msg.length() - 4);
+    } else if (prefix == "RAMK") {
+        obsluzRamk(from, msg.c_str() + 4, msg.length() - 4);
+    } else if (prefix == "TIME") {
+        obsluzTime(from, msg.c_str() + 4, msg.length() - 4);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static double wiadomosciNaSekunde(long n, std::chrono::steady_clock::duration czas) {
+    double s = std::chrono::duration<double>(czas).count();
+    return s > 0 ? n / s : 0;
+}
+
+void test_przepustowosc_tablica_vs_lancuch_if() {
+    // Mieszanka ruchu gatewaya; nieznany tag przechodzi cały łańcuch if
+    String wiadomosci[] = {
+        String("DANE;7;21.50;55.25;800;12;40;12:00:00 Wed, Jan 07 2026"),
+        String("KURA;692641124;F7474A39;-0.37;12:00:01 Wed, Jan 07 2026"),
+        String("RAMKAQIDBAUGBwgJCgsMDQ4PEBESExQVFhcYGRobHB0eHyA="),
+        String("TIME"),
+        String("XYZW;1;2;3"),
+    };
+    const int LICZBA = sizeof(wiadomosci) / sizeof(wiadomosci[0]);
+    const long ITERACJE = 200000;
+    const double MIN_PRZYSPIESZENIE = 2.0;
+
+    auto start = std::chrono::steady_clock::now();
+    long rozpoznaneLancuch = 0;
+    for (long i = 0; i < ITERACJE; i++) {
+        rozpoznaneLancuch += dyspozycjaLancuchem(17, wiadomosci[i % LICZBA]);
+    }
+    auto czasLancucha = std::chrono::steady_clock::now() - start;
+    int wywolaniaLancucha = sumaWywolan();
+
+    setUp();
+    start = std::chrono::steady_clock::now();
+    long rozpoznaneTablica = 0;
+    for (long i = 0; i < ITERACJE; i++) {
+        const String& m = wiadomosci[i % LICZBA];
+        rozpoznaneTablica += ObsluzWiadomoscMesh(17, m.c_str(), m.length());
+    }
+    auto czasTablicy = std::chrono::steady_clock::now() - start;
+
+    // Obie drogi kierują ten sam ruch do tych samych obsług
+    TEST_ASSERT_EQUAL_INT32(rozpoznaneLancuch, rozpoznaneTablica);
+    TEST_ASSERT_EQUAL_INT(wywolaniaLancucha, sumaWywolan());
+    TEST_ASSERT_EQUAL_INT32(ITERACJE * 4 / 5, rozpoznaneTablica);
+
+    // Na hoście String nie alokuje krótkiego prefiksu (SSO), na ESP32 substring() woła malloc -
+    // różnica na urządzeniu jest większa (komenda "benchmark")
+    double przyspieszenie = std::chrono::duration<double>(czasLancucha).count() /
+                            std::chrono::duration<double>(czasTablicy).count();
+    char raport[160];
+    snprintf(raport, sizeof(raport), "substring + if: %.0f wiad/s, tablica tagow: %.0f wiad/s (x%.1f)",
+             wiadomosciNaSekunde(ITERACJE, czasLancucha), wiadomosciNaSekunde(ITERACJE, czasTablicy),
+             przyspieszenie);
+    TEST_MESSAGE(raport);
+
+    // Zmierzone 5-8x; wymagane 2x zostawia zapas na obciążenie maszyny CI
+    TEST_ASSERT_TRUE(przyspieszenie >= MIN_PRZYSPIESZENIE);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_rejestracja_tagow_gatewaya);
+    RUN_TEST(test_wyszukiwanie_po_tagu);
+    RUN_TEST(test_nieznany_tag_i_krotka_wiadomosc);
+    RUN_TEST(test_ponowna_rejestracja_podmienia_obsluge);
+    RUN_TEST(test_rejestracja_bez_obslugi);
+    RUN_TEST(test_przepustowosc_tablica_vs_lancuch_if);
+    RUN_TEST(test_kolizja_slotu);
+    return UNITY_END();
+}
@@ -0,0 +1,311 @@
+/*
+ * TESTY KODEKA ARCHIWUM - test_kodek_archiwum/test_main.cpp
+ *
+ * Testy hosta dla kodek_archiwum.h (pio test -e native): kodowanie
+ * i dekodowanie bloków szeregu z nieregularnym czasem i brakami odczytu
+ * (-1), granice klas delta-of-delta i różnic pól (łącznie z klasą 32-bitową
+ * dla dużych skoków), zapełnianie bloku do KODEK_MAX_BLOK oraz odrzucanie
+ * uszkodzonych bloków (CRC, nagłówek, obcięcie).
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "kodek_archiwum.h"
+
+// 12:30:00 Tue, Jan 02 2024
+static const uint32_t EPOCH = 1704198600;
+static const int32_t URZADZENIE = 3257743;
+static const int MAX_PROBEK = 256;
+
+static KoderBloku koder;
+static ProbkaArchiwum zdekodowane[MAX_PROBEK];
+
+static ProbkaArchiwum probka(uint32_t epoch, int32_t temperatura_c) {
+    ProbkaArchiwum p{};
+    p.epoch = epoch;
+    p.temperatura_c = temperatura_c;
+    p.wilgotnosc_c = 5512;
+    p.poziom_co2 = 1200;
+    p.poziom_amoniaku = 15;
+    p.naslonecznienie = 50;
+    return p;
+}
+
+static void porownaj(const ProbkaArchiwum* a, const ProbkaArchiwum* b) {
+    TEST_ASSERT_EQUAL_UINT32(a->epoch, b->epoch);
+    TEST_ASSERT_EQUAL_INT32(a->temperatura_c, b->temperatura_c);
+    TEST_ASSERT_EQUAL_INT32(a->wilgotnosc_c, b->wilgotnosc_c);
+    TEST_ASSERT_EQUAL_INT32(a->poziom_co2, b->poziom_co2);
+    TEST_ASSERT_EQUAL_INT32(a->poziom_amoniaku, b->poziom_amoniaku);
+    TEST_ASSERT_EQUAL_INT32(a->naslonecznienie, b->naslonecznienie);
+    TEST_ASSERT_EQUAL_INT32(a->przeniesione, b->przeniesione);
+    TEST_ASSERT_EQUAL_INT32(a->pominiete, b->pominiete);
+}
+
+// Koduje próbki w jeden blok, dekoduje go i porównuje; zwraca długość bloku
+static size_t wObieStrony(const ProbkaArchiwum* probki, int liczba, uint8_t* blok) {
+    kodekRozpocznij(&koder, KODEK_BLOK_SZEREG, URZADZENIE);
+    for (int i = 0; i < liczba; i++) {
+        TEST_ASSERT_TRUE(kodekDodaj(&koder, &probki[i]));
+    }
+    size_t dlugosc = kodekZamknij(&koder, blok, KODEK_MAX_BLOK);
+    TEST_ASSERT_GREATER_THAN(0, (int)dlugosc);
+    TEST_ASSERT_LESS_OR_EQUAL(KODEK_MAX_BLOK, (int)dlugosc);
+    TEST_ASSERT_EQUAL_UINT32(dlugosc, kodekDlugoscBloku(blok, dlugosc));
+
+    int32_t id = 0;
+    TEST_ASSERT_EQUAL_INT(liczba, kodekDekoduj(blok, dlugosc, &id, zdekodowane, MAX_PROBEK));
+    TEST_ASSERT_EQUAL_INT32(URZADZENIE, id);
+    for (int i = 0; i < liczba; i++) {
+        porownaj(&probki[i], &zdekodowane[i]);
+    }
+    return dlugosc;
+}
+
+// Blok z kilkoma zwykłymi próbkami do testów uszkodzeń
+static size_t zwyklyBlok(uint8_t* blok) {
+    ProbkaArchiwum probki[8];
+    for (int i = 0; i < 8; i++) {
+        probki[i] = probka(EPOCH + i * 60, 2231 + i);
+    }
+    return wObieStrony(probki, 8, blok);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_nieregularny_czas_i_braki_odczytu() {
+    static const uint32_t ODSTEPY[] = {60, 60, 61, 59, 300, 1, 60, 3600, 60, 0, 60, 7};
+    const int LICZBA = sizeof(ODSTEPY) / sizeof(ODSTEPY[0]) + 1;
+    ProbkaArchiwum probki[LICZBA];
+
+    uint32_t epoch = EPOCH;
+    for (int i = 0; i < LICZBA; i++) {
+        if (i > 0) epoch += ODSTEPY[i - 1];
+        probki[i] = probka(epoch, 2231 - i * 17);
+    }
+    // Brak odczytu czujnika (-1) pomiędzy zwykłymi wartościami i na początku bloku
+    probki[0].poziom_co2 = -1;
+    probki[3].poziom_amoniaku = -1;
+    probki[4].poziom_amoniaku = -1;
+    probki[6].poziom_co2 = -1;
+    probki[6].naslonecznienie = -1;
+    probki[LICZBA - 1].temperatura_c = -1;
+    // Pola strefy martwej węzła
+    probki[5].przeniesione = 0x3;
+    probki[5].pominiete = 4;
+    probki[8].pominiete = 1;
+
+    uint8_t blok[KODEK_MAX_BLOK];
+    wObieStrony(probki, LICZBA, blok);
+}
+
+void test_staly_okres_jeden_bit_czasu() {
+    kodekRozpocznij(&koder, KODEK_BLOK_SZEREG, URZADZENIE);
+    ProbkaArchiwum p = probka(EPOCH, 2231);
+    TEST_ASSERT_TRUE(kodekDodaj(&koder, &p));
+    p.epoch += 60;
+    TEST_ASSERT_TRUE(kodekDodaj(&koder, &p));
+
+    // Ten sam okres i te same wartości: 1 bit czasu + 7 pól po 1 bicie
+    uint32_t bity = koder.bity;
+    for (int i = 0; i < 10; i++) {
+        p.epoch += 60;
+        TEST_ASSERT_TRUE(kodekDodaj(&koder, &p));
+    }
+    TEST_ASSERT_EQUAL_UINT32(bity + 10 * 8, koder.bity);
+}
+
+void test_granice_klas_czasu() {
+    // Delta-of-delta na granicach klas 7/9/12 bitów i poza nimi (32 bity)
+    static const int32_t DOD[] = {0, -63, 64, -64, 65, -255, 256, -256, 257,
+                                  -2047, 2048, -2048, 2049, 86400, -86400, 0};
+    const int LICZBA = sizeof(DOD) / sizeof(DOD[0]) + 2;
+    ProbkaArchiwum probki[LICZBA];
+
+    int32_t delta = 100000;
+    uint32_t epoch = EPOCH;
+    probki[0] = probka(epoch, 2231);
+    epoch += delta;
+    probki[1] = probka(epoch, 2231);
+    for (int i = 2; i < LICZBA; i++) {
+        delta += DOD[i - 2];
+        epoch += delta;
+        probki[i] = probka(epoch, 2231);
+    }
+
+    uint8_t blok[KODEK_MAX_BLOK];
+    wObieStrony(probki, LICZBA, blok);
+}
+
+void test_granice_klas_pol_i_skoki() {
+    // Różnice na granicach klas zigzag (4/8/16/32 bity) i zawijanie int32
+    static const int32_t WARTOSCI[] = {0, 7, -8, 8, -9, 127, -128, 128, -129, 32767, -32768,
+                                       32768, -32769, INT32_MAX, INT32_MIN, -1, 0};
+    const int LICZBA = sizeof(WARTOSCI) / sizeof(WARTOSCI[0]);
+    ProbkaArchiwum probki[LICZBA];
+
+    int32_t poprzednia = 0;
+    for (int i = 0; i < LICZBA; i++) {
+        // Każda wartość jest różnicą względem poprzedniej próbki
+        int32_t w = (int32_t)((uint32_t)poprzednia + (uint32_t)WARTOSCI[i]);
+        probki[i] = probka(EPOCH + i * 5, w);
+        probki[i].wilgotnosc_c = -w;
+        probki[i].poziom_co2 = WARTOSCI[i];
+        probki[i].naslonecznienie = (i & 1) ? -1 : INT32_MAX;
+        probki[i].pominiete = (i & 1) ? 65535 : 0;
+        poprzednia = w;
+    }
+
+    uint8_t blok[KODEK_MAX_BLOK];
+    wObieStrony(probki, LICZBA, blok);
+}
+
+void test_pelny_blok() {
+    uint8_t blok[KODEK_MAX_BLOK];
+
+    // Najgorszy przypadek: każda próbka w klasie 32-bitowej - blok kończy się
+    // przed przepełnieniem KODEK_MAX_BLOK
+    kodekRozpocznij(&koder, KODEK_BLOK_SZEREG, URZADZENIE);
+    static ProbkaArchiwum probki[MAX_PROBEK];
+    int liczba = 0;
+    uint32_t epoch = EPOCH;
+    while (liczba < MAX_PROBEK) {
+        int32_t znak = (liczba & 1) ? -1 : 1;
+        epoch += (liczba & 1) ? 1 : 1000000;
+        ProbkaArchiwum p = probka(epoch, znak * 1000000000);
+        p.wilgotnosc_c = -p.temperatura_c;
+        p.poziom_co2 = p.temperatura_c;
+        p.poziom_amoniaku = -p.temperatura_c;
+        p.naslonecznienie = p.temperatura_c;
+        p.przeniesione = p.temperatura_c;
+        p.pominiete = -p.temperatura_c;
+        if (!kodekDodaj(&koder, &p)) break;
+        probki[liczba++] = p;
+    }
+    TEST_ASSERT_GREATER_THAN(1, liczba);
+    TEST_ASSERT_LESS_THAN(MAX_PROBEK, liczba);
+    TEST_ASSERT_LESS_OR_EQUAL(KODEK_MAX_DANE * 8, (int)koder.bity);
+
+    size_t dlugosc = kodekZamknij(&koder, blok, sizeof(blok));
+    TEST_ASSERT_GREATER_THAN(0, (int)dlugosc);
+    TEST_ASSERT_LESS_OR_EQUAL(KODEK_MAX_BLOK, (int)dlugosc);
+    int32_t id = 0;
+    TEST_ASSERT_EQUAL_INT(liczba, kodekDekoduj(blok, dlugosc, &id, zdekodowane, MAX_PROBEK));
+    for (int i = 0; i < liczba; i++) {
+        porownaj(&probki[i], &zdekodowane[i]);
+    }
+
+    // Odrzucona próbka trafia do nowego bloku
+    ProbkaArchiwum nastepna = probka(epoch + 60, 2231);
+    TEST_ASSERT_FALSE(kodekDodaj(&koder, &nastepna));
+    kodekRozpocznij(&koder, KODEK_BLOK_SZEREG, URZADZENIE);
+    TEST_ASSERT_TRUE(kodekDodaj(&koder, &nastepna));
+}
+
+void test_pelny_blok_stalych_probek() {
+    // Próbki po 8 bitów - limit bloku, a nie liczba rekordów, kończy blok
+    kodekRozpocznij(&koder, KODEK_BLOK_SZEREG, URZADZENIE);
+    ProbkaArchiwum p = probka(EPOCH, 2231);
+    int liczba = 0;
+    while (kodekDodaj(&koder, &p)) {
+        liczba++;
+        p.epoch += 60;
+    }
+    TEST_ASSERT_GREATER_THAN(400, liczba);
+
+    static ProbkaArchiwum wynik[KODEK_MAX_DANE];
+    uint8_t blok[KODEK_MAX_BLOK];
+    size_t dlugosc = kodekZamknij(&koder, blok, sizeof(blok));
+    TEST_ASSERT_LESS_OR_EQUAL(KODEK_MAX_BLOK, (int)dlugosc);
+    int32_t id = 0;
+    TEST_ASSERT_EQUAL_INT(liczba, kodekDekoduj(blok, dlugosc, &id, wynik, KODEK_MAX_DANE));
+    TEST_ASSERT_EQUAL_UINT32(EPOCH + (uint32_t)(liczba - 1) * 60, wynik[liczba - 1].epoch);
+
+    // Za mała tablica na próbki - blok odrzucony zamiast przepełnienia
+    TEST_ASSERT_EQUAL_INT(-1, kodekDekoduj(blok, dlugosc, &id, wynik, liczba - 1));
+}
+
+void test_bledne_crc() {
+    uint8_t blok[KODEK_MAX_BLOK];
+    size_t dlugosc = zwyklyBlok(blok);
+    int32_t id;
+
+    // Każdy przekłamany bit nagłówka (poza znacznikiem i długością), danych lub CRC
+    for (size_t i = 2; i < dlugosc; i++) {
+        if (i == 10 || i == 11) continue;
+        for (int bit = 0; bit < 8; bit++) {
+            blok[i] ^= (uint8_t)(1 << bit);
+            TEST_ASSERT_EQUAL_INT(-1, kodekDekoduj(blok, dlugosc, &id, zdekodowane, MAX_PROBEK));
+            blok[i] ^= (uint8_t)(1 << bit);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(8, kodekDekoduj(blok, dlugosc, &id, zdekodowane, MAX_PROBEK));
+}
+
+void test_bledny_naglowek_i_obciecie() {
+    uint8_t blok[KODEK_MAX_BLOK];
+    size_t dlugosc = zwyklyBlok(blok);
+    int32_t id;
+
+    // Obcięty blok i za krótki nagłówek
+    TEST_ASSERT_EQUAL_INT(-1, kodekDekoduj(blok, dlugosc - 1, &id, zdekodowane, MAX_PROBEK));
+    TEST_ASSERT_EQUAL_UINT32(0, kodekDlugoscBloku(blok, KODEK_NAGLOWEK_BAJTY - 1));
+
+    // Zły znacznik, nieznana wersja, długość danych ponad KODEK_MAX_DANE
+    blok[0] = 'X';
+    TEST_ASSERT_EQUAL_UINT32(0, kodekDlugoscBloku(blok, dlugosc));
+    blok[0] = 'K';
+    blok[2] = KODEK_WERSJA + 1;
+    TEST_ASSERT_EQUAL_UINT32(0, kodekDlugoscBloku(blok, dlugosc));
+    blok[2] = KODEK_WERSJA;
+    blok[10] = (uint8_t)((KODEK_MAX_DANE + 1) & 0xFF);
+    blok[11] = (uint8_t)((KODEK_MAX_DANE + 1) >> 8);
+    TEST_ASSERT_EQUAL_UINT32(0, kodekDlugoscBloku(blok, dlugosc));
+    TEST_ASSERT_EQUAL_INT(-1, kodekDekoduj(blok, dlugosc, &id, zdekodowane, MAX_PROBEK));
+}
+
+void test_blok_tekstowy_nie_jest_szeregiem() {
+    kodekRozpocznij(&koder, KODEK_BLOK_TEKST, URZADZENIE);
+    TEST_ASSERT_TRUE(kodekDodajTekst(&koder, "7;21.5;abc;800;12;40;12:00:00 Wed, Jan 07 2026"));
+    ProbkaArchiwum p = probka(EPOCH, 2231);
+    TEST_ASSERT_FALSE(kodekDodaj(&koder, &p));
+
+    uint8_t blok[KODEK_MAX_BLOK];
+    size_t dlugosc = kodekZamknij(&koder, blok, sizeof(blok));
+    TEST_ASSERT_GREATER_THAN(0, (int)dlugosc);
+    int32_t id;
+    TEST_ASSERT_EQUAL_INT(-1, kodekDekoduj(blok, dlugosc, &id, zdekodowane, MAX_PROBEK));
+}
+
+void test_csv_z_brakiem_odczytu_w_obie_strony() {
+    const char* rekord = "3257743;-1.00;55.12;-1;-1;50;12:30:00 Tue, Jan 02 2024";
+    int32_t id;
+    ProbkaArchiwum p;
+    TEST_ASSERT_TRUE(kodekParsujCSV(rekord, &id, &p));
+    TEST_ASSERT_EQUAL_INT32(URZADZENIE, id);
+    TEST_ASSERT_EQUAL_UINT32(EPOCH, p.epoch);
+    TEST_ASSERT_EQUAL_INT32(-100, p.temperatura_c);
+    TEST_ASSERT_EQUAL_INT32(-1, p.poziom_co2);
+    TEST_ASSERT_EQUAL_INT32(-1, p.poziom_amoniaku);
+
+    char tekst[160];
+    kodekFormatujCSV(id, &p, tekst, sizeof(tekst));
+    TEST_ASSERT_EQUAL_STRING(rekord, tekst);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_nieregularny_czas_i_braki_odczytu);
+    RUN_TEST(test_staly_okres_jeden_bit_czasu);
+    RUN_TEST(test_granice_klas_czasu);
+    RUN_TEST(test_granice_klas_pol_i_skoki);
+    RUN_TEST(test_pelny_blok);
+    RUN_TEST(test_pelny_blok_stalych_probek);
+    RUN_TEST(test_bledne_crc);
+    RUN_TEST(test_bledny_naglowek_i_obciecie);
+    RUN_TEST(test_blok_tekstowy_nie_jest_szeregiem);
+    RUN_TEST(test_csv_z_brakiem_odczytu_w_obie_strony);
+    return UNITY_END();
+}
@@ -0,0 +1,562 @@
+/*
+ * TESTY RAMKI MESH - test_ramka_mesh/test_main.cpp
+ *
+ * Testy hosta dla ramka_mesh.h (pio test -e native): kodowanie i dekodowanie
+ * wszystkich typów ramek, odrzucanie uszkodzonych ramek (CRC, base64, UID,
+ * obcięcie) oraz porównanie rozmiaru i przepustowości kodowania/dekodowania
+ * wiadomości binarnej z CSV (i rozmiaru z JSON).
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "ramka_mesh.h"
+
+// 12:30:00 Tue, Jan 02 2024
+static const uint32_t EPOCH = 1704198600;
+
+static RamkaDane probkaDane() {
+    RamkaDane r;
+    memset(&r, 0, sizeof(r));
+    r.naglowek.id_wezla = 3257743041u;
+    r.naglowek.sekwencja = 65535;
+    r.naglowek.epoch = EPOCH;
+    r.temperatura_c = -1234;
+    r.wilgotnosc_c = 6543;
+    r.poziom_co2 = 812;
+    r.poziom_amoniaku = -1;
+    r.naslonecznienie = 54321;
+    return r;
+}
+
+static RamkaKura probkaKura() {
+    RamkaKura r;
+    memset(&r, 0, sizeof(r));
+    r.naglowek.id_wezla = 17;
+    r.naglowek.sekwencja = 42;
+    r.naglowek.epoch = EPOCH;
+    r.waga_c = 215075;
+    r.uid_dlugosc = ramkaUidZHex("F7474A39", r.uid, RAMKA_MAX_UID);
+    return r;
+}
+
+static void porownajDane(const RamkaDane* a, const RamkaDane* b) {
+    TEST_ASSERT_EQUAL_UINT32(a->naglowek.id_wezla, b->naglowek.id_wezla);
+    TEST_ASSERT_EQUAL_UINT16(a->naglowek.sekwencja, b->naglowek.sekwencja);
+    TEST_ASSERT_EQUAL_UINT32(a->naglowek.epoch, b->naglowek.epoch);
+    TEST_ASSERT_EQUAL_INT16(a->temperatura_c, b->temperatura_c);
+    TEST_ASSERT_EQUAL_UINT16(a->wilgotnosc_c, b->wilgotnosc_c);
+    TEST_ASSERT_EQUAL_INT32(a->poziom_co2, b->poziom_co2);
+    TEST_ASSERT_EQUAL_INT32(a->poziom_amoniaku, b->poziom_amoniaku);
+    TEST_ASSERT_EQUAL_UINT32(a->naslonecznienie, b->naslonecznienie);
+    TEST_ASSERT_EQUAL_UINT8(a->przeniesione, b->przeniesione);
+    TEST_ASSERT_EQUAL_UINT16(a->pominiete, b->pominiete);
+}
+
+// Ramka -> "RAMK<base64>" -> ramka, jak w mesh_local.cpp po obu stronach
+static size_t przezTekst(const uint8_t* bin, size_t n, uint8_t* wynik) {
+    char tekst[RAMKA_MAX_TEKST];
+    size_t dl = ramkaDoTekstu(bin, n, tekst, sizeof(tekst));
+    TEST_ASSERT_GREATER_THAN(RAMKA_PREFIX_DL, dl);
+    TEST_ASSERT_EQUAL(0, strncmp(tekst, RAMKA_PREFIX, RAMKA_PREFIX_DL));
+    return ramkaZTekstu(tekst + RAMKA_PREFIX_DL, dl - RAMKA_PREFIX_DL, wynik, RAMKA_MAX_BAJTY);
+}
+
+void setUp() {}
+void tearDown() {}
+
+// === KODOWANIE I DEKODOWANIE ===
+
+void test_dane_w_obie_strony() {
+    RamkaDane r = probkaDane();
+    uint8_t bin[RAMKA_MAX_BAJTY], odczyt[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujDane(&r, bin, sizeof(bin));
+    TEST_ASSERT_EQUAL(RAMKA_NAGLOWEK_BAJTY + 12 + RAMKA_CRC_BAJTY, n);
+    TEST_ASSERT_EQUAL(RAMKA_TYP_DANE, ramkaSprawdz(bin, n));
+
+    TEST_ASSERT_EQUAL(n, przezTekst(bin, n, odczyt));
+    RamkaDane wynik;
+    TEST_ASSERT_TRUE(ramkaDekodujDane(odczyt, n, &wynik));
+    TEST_ASSERT_EQUAL_UINT8(RAMKA_WERSJA, wynik.naglowek.wersja);
+    porownajDane(&r, &wynik);
+}
+
+void test_dane_strefa_w_obie_strony() {
+    RamkaDane r = probkaDane();
+    r.przeniesione = RAMKA_POLE_CO2 | RAMKA_POLE_NASLONECZNIENIE;
+    r.pominiete = 300;
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujDane(&r, bin, sizeof(bin));
+    TEST_ASSERT_EQUAL(RAMKA_NAGLOWEK_BAJTY + 12 + 3 + RAMKA_CRC_BAJTY, n);
+    TEST_ASSERT_EQUAL(RAMKA_TYP_DANE_STREFA, ramkaSprawdz(bin, n));
+
+    RamkaDane wynik;
+    TEST_ASSERT_TRUE(ramkaDekodujDane(bin, n, &wynik));
+    porownajDane(&r, &wynik);
+}
+
+void test_kura_w_obie_strony() {
+    RamkaKura r = probkaKura();
+    TEST_ASSERT_EQUAL(4, r.uid_dlugosc);
+    uint8_t bin[RAMKA_MAX_BAJTY], odczyt[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujKura(&r, bin, sizeof(bin));
+    TEST_ASSERT_EQUAL(RAMKA_TYP_KURA, ramkaSprawdz(bin, n));
+    TEST_ASSERT_EQUAL(n, przezTekst(bin, n, odczyt));
+
+    RamkaKura wynik;
+    TEST_ASSERT_TRUE(ramkaDekodujKura(odczyt, n, &wynik));
+    TEST_ASSERT_EQUAL_UINT32(r.naglowek.id_wezla, wynik.naglowek.id_wezla);
+    TEST_ASSERT_EQUAL_UINT16(r.naglowek.sekwencja, wynik.naglowek.sekwencja);
+    TEST_ASSERT_EQUAL_INT32(r.waga_c, wynik.waga_c);
+    TEST_ASSERT_EQUAL_UINT8(r.uid_dlugosc, wynik.uid_dlugosc);
+
+    char hex[2 * RAMKA_MAX_UID + 1];
+    ramkaUidNaHex(wynik.uid, wynik.uid_dlugosc, hex, sizeof(hex));
+    TEST_ASSERT_EQUAL_STRING("F7474A39", hex);
+}
+
+void test_kura_najdluzszy_uid() {
+    RamkaKura r = probkaKura();
+    r.uid_dlugosc = ramkaUidZHex("0102030405060708090A", r.uid, RAMKA_MAX_UID);
+    TEST_ASSERT_EQUAL(RAMKA_MAX_UID, r.uid_dlugosc);
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujKura(&r, bin, sizeof(bin));
+
+    RamkaKura wynik;
+    TEST_ASSERT_TRUE(ramkaDekodujKura(bin, n, &wynik));
+    TEST_ASSERT_EQUAL(RAMKA_MAX_UID, wynik.uid_dlugosc);
+    TEST_ASSERT_EQUAL_MEMORY(r.uid, wynik.uid, RAMKA_MAX_UID);
+}
+
+void test_agregat_w_obie_strony() {
+    RamkaAgregat r;
+    memset(&r, 0, sizeof(r));
+    r.naglowek.id_wezla = 99;
+    r.naglowek.sekwencja = 7;
+    r.naglowek.epoch = EPOCH;
+    r.okres_s = 300;
+    r.probki = 60;
+    const RamkaStatystyka pola[RAMKA_LICZBA_POL] = {
+        { -520, 2710, 1234, 87 },     // temperatura (setne °C)
+        { 4000, 7100, 5550, 120 },    // wilgotność (setne %)
+        { 400, 1650, 900, 210 },      // CO2
+        { -1, -1, -1, -1 },           // amoniak - brak ważnego odczytu w oknie
+        { 0, 120000, 65000, 3000 },   // nasłonecznienie (> uint16)
+    };
+    memcpy(r.pola, pola, sizeof(pola));
+
+    uint8_t bin[RAMKA_MAX_BAJTY], odczyt[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujAgregat(&r, bin, sizeof(bin));
+    TEST_ASSERT_EQUAL(RAMKA_TYP_AGREGAT, ramkaSprawdz(bin, n));
+    TEST_ASSERT_EQUAL(n, przezTekst(bin, n, odczyt));
+
+    RamkaAgregat wynik;
+    TEST_ASSERT_TRUE(ramkaDekodujAgregat(odczyt, n, &wynik));
+    TEST_ASSERT_EQUAL_UINT16(r.okres_s, wynik.okres_s);
+    TEST_ASSERT_EQUAL_UINT16(r.probki, wynik.probki);
+    for (int i = 0; i < RAMKA_LICZBA_POL; i++) {
+        TEST_ASSERT_EQUAL_INT32(r.pola[i].min, wynik.pola[i].min);
+        TEST_ASSERT_EQUAL_INT32(r.pola[i].max, wynik.pola[i].max);
+        TEST_ASSERT_EQUAL_INT32(r.pola[i].srednia, wynik.pola[i].srednia);
+        TEST_ASSERT_EQUAL_INT32(r.pola[i].odchylenie, wynik.pola[i].odchylenie);
+    }
+}
+
+void test_paczka_w_obie_strony() {
+    RamkaPaczka r;
+    memset(&r, 0, sizeof(r));
+    r.naglowek.id_wezla = 3257743041u;
+    r.naglowek.sekwencja = 1000;
+    r.liczba = RAMKA_PACZKA_MAX;
+    for (uint8_t i = 0; i < r.liczba; i++) {
+        r.probki[i] = probkaDane();
+        // Próbki nie muszą być posortowane - epoch paczki to najwcześniejsza z nich
+        r.probki[i].naglowek.epoch = EPOCH + 60u * ((i + 3) % r.liczba);
+        r.probki[i].temperatura_c = (int16_t)(2000 + i);
+        r.probki[i].przeniesione = (uint8_t)(i & RAMKA_POLE_WILGOTNOSC);
+        r.probki[i].pominiete = i;
+    }
+
+    uint8_t bin[RAMKA_MAX_BAJTY], odczyt[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujPaczke(&r, bin, sizeof(bin));
+    TEST_ASSERT_GREATER_THAN(0, n);
+    TEST_ASSERT_LESS_OR_EQUAL(RAMKA_MAX_BAJTY, n);
+    TEST_ASSERT_EQUAL(RAMKA_TYP_PACZKA, ramkaSprawdz(bin, n));
+    TEST_ASSERT_EQUAL(n, przezTekst(bin, n, odczyt));
+
+    RamkaPaczka wynik;
+    TEST_ASSERT_TRUE(ramkaDekodujPaczke(odczyt, n, &wynik));
+    TEST_ASSERT_EQUAL_UINT8(r.liczba, wynik.liczba);
+    TEST_ASSERT_EQUAL_UINT32(EPOCH, wynik.naglowek.epoch);
+    for (uint8_t i = 0; i < r.liczba; i++) {
+        // Próbka dziedziczy ID węzła i sekwencję paczki
+        r.probki[i].naglowek.id_wezla = r.naglowek.id_wezla;
+        r.probki[i].naglowek.sekwencja = r.naglowek.sekwencja;
+        porownajDane(&r.probki[i], &wynik.probki[i]);
+    }
+}
+
+void test_paczka_poza_zakresem() {
+    RamkaPaczka r;
+    memset(&r, 0, sizeof(r));
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    TEST_ASSERT_EQUAL(0, ramkaKodujPaczke(&r, bin, sizeof(bin)));
+
+    r.liczba = RAMKA_PACZKA_MAX + 1;
+    TEST_ASSERT_EQUAL(0, ramkaKodujPaczke(&r, bin, sizeof(bin)));
+
+    // Próbki rozrzucone o więcej niż uint16 sekund
+    r.liczba = 2;
+    r.probki[0] = probkaDane();
+    r.probki[1] = probkaDane();
+    r.probki[1].naglowek.epoch += UINT16_MAX + 1u;
+    TEST_ASSERT_EQUAL(0, ramkaKodujPaczke(&r, bin, sizeof(bin)));
+}
+
+// Błąd czujnika światła ma własną wartość, odróżnialną od 0 lux (ciemność)
+void test_brak_odczytu_swiatla() {
+    RamkaPaczka r;
+    memset(&r, 0, sizeof(r));
+    r.liczba = 2;
+    r.probki[0] = probkaDane();
+    r.probki[0].naslonecznienie = RAMKA_BRAK_SWIATLA;
+    r.probki[0].poziom_co2 = -1;
+    r.probki[1] = probkaDane();
+    r.probki[1].naslonecznienie = 0;
+
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    RamkaDane dane;
+    size_t n = ramkaKodujDane(&r.probki[0], bin, sizeof(bin));
+    TEST_ASSERT_TRUE(ramkaDekodujDane(bin, n, &dane));
+    TEST_ASSERT_EQUAL_UINT32(RAMKA_BRAK_SWIATLA, dane.naslonecznienie);
+    TEST_ASSERT_EQUAL_INT32(-1, dane.poziom_co2);
+
+    RamkaPaczka wynik;
+    n = ramkaKodujPaczke(&r, bin, sizeof(bin));
+    TEST_ASSERT_TRUE(ramkaDekodujPaczke(bin, n, &wynik));
+    TEST_ASSERT_EQUAL_UINT32(RAMKA_BRAK_SWIATLA, wynik.probki[0].naslonecznienie);
+    TEST_ASSERT_EQUAL_UINT32(0, wynik.probki[1].naslonecznienie);
+}
+
+// === USZKODZONE RAMKI ===
+
+void test_bledne_crc() {
+    RamkaDane r = probkaDane();
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujDane(&r, bin, sizeof(bin));
+    RamkaDane wynik;
+
+    // Każdy przekłamany bit (również w samym CRC) musi zostać wykryty
+    for (size_t i = 0; i < n * 8; i++) {
+        bin[i / 8] ^= (uint8_t)(1u << (i % 8));
+        TEST_ASSERT_EQUAL(0, ramkaSprawdz(bin, n));
+        TEST_ASSERT_FALSE(ramkaDekodujDane(bin, n, &wynik));
+        bin[i / 8] ^= (uint8_t)(1u << (i % 8));
+    }
+    TEST_ASSERT_TRUE(ramkaDekodujDane(bin, n, &wynik));
+}
+
+void test_nieznana_wersja() {
+    RamkaDane r = probkaDane();
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujDane(&r, bin, sizeof(bin));
+
+    // Poprawne CRC, ale wersja nowsza niż RAMKA_WERSJA
+    bin[0] = RAMKA_WERSJA + 1;
+    uint16_t crc = ramkaCrc16(bin, n - RAMKA_CRC_BAJTY);
+    bin[n - 2] = (uint8_t)crc;
+    bin[n - 1] = (uint8_t)(crc >> 8);
+    TEST_ASSERT_EQUAL(0, ramkaSprawdz(bin, n));
+}
+
+void test_zly_typ_ramki() {
+    RamkaKura r = probkaKura();
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujKura(&r, bin, sizeof(bin));
+    RamkaDane dane;
+    RamkaAgregat agregat;
+    RamkaPaczka paczka;
+    TEST_ASSERT_FALSE(ramkaDekodujDane(bin, n, &dane));
+    TEST_ASSERT_FALSE(ramkaDekodujAgregat(bin, n, &agregat));
+    TEST_ASSERT_FALSE(ramkaDekodujPaczke(bin, n, &paczka));
+}
+
+void test_bledny_base64() {
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    const char* bledne[] = {
+        "",             // pusty
+        "QUJD",         // poprawny, ale o długości 3 - kontrola
+        "QUJ",          // długość niepodzielna przez 4
+        "QU*D",         // znak spoza alfabetu
+        "Q===",         // za dużo dopełnienia
+        "QU=D",         // znak po dopełnieniu
+        "QQ==QUJD",     // dopełnienie przed końcem
+    };
+    TEST_ASSERT_EQUAL(0, ramkaZTekstu(bledne[0], 0, bin, sizeof(bin)));
+    TEST_ASSERT_EQUAL(3, ramkaZTekstu(bledne[1], 4, bin, sizeof(bin)));
+    for (size_t i = 2; i < sizeof(bledne) / sizeof(bledne[0]); i++) {
+        TEST_ASSERT_EQUAL_MESSAGE(0, ramkaZTekstu(bledne[i], strlen(bledne[i]), bin, sizeof(bin)), bledne[i]);
+    }
+
+    // Ramka dłuższa niż bufor odbiorcy
+    TEST_ASSERT_EQUAL(0, ramkaZTekstu("QUJD", 4, bin, 2));
+}
+
+void test_za_dlugi_uid() {
+    uint8_t uid[RAMKA_MAX_UID];
+    // 11 bajtów - więcej niż najdłuższy UID MIFARE
+    TEST_ASSERT_EQUAL(0, ramkaUidZHex("0102030405060708090A0B", uid, RAMKA_MAX_UID));
+    // Nieparzysta liczba znaków i znak spoza HEX
+    TEST_ASSERT_EQUAL(0, ramkaUidZHex("F7474A3", uid, RAMKA_MAX_UID));
+    TEST_ASSERT_EQUAL(0, ramkaUidZHex("F7474G39", uid, RAMKA_MAX_UID));
+
+    // Koder przycina UID do RAMKA_MAX_UID
+    RamkaKura r = probkaKura();
+    r.uid_dlugosc = RAMKA_MAX_UID + 5;
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujKura(&r, bin, sizeof(bin));
+    RamkaKura wynik;
+    TEST_ASSERT_TRUE(ramkaDekodujKura(bin, n, &wynik));
+    TEST_ASSERT_EQUAL(RAMKA_MAX_UID, wynik.uid_dlugosc);
+
+    // Ramka z polem długości UID > RAMKA_MAX_UID i poprawnym CRC jest odrzucana
+    uint8_t zla[RAMKA_MAX_BAJTY];
+    memcpy(zla, bin, n - RAMKA_CRC_BAJTY);
+    zla[RAMKA_NAGLOWEK_BAJTY + 4] = RAMKA_MAX_UID + 1;
+    zla[n - RAMKA_CRC_BAJTY] = 0xAB;     // dodatkowy bajt UID
+    size_t dl = n + 1;
+    uint16_t crc = ramkaCrc16(zla, dl - RAMKA_CRC_BAJTY);
+    zla[dl - 2] = (uint8_t)crc;
+    zla[dl - 1] = (uint8_t)(crc >> 8);
+    TEST_ASSERT_EQUAL(RAMKA_TYP_KURA, ramkaSprawdz(zla, dl));
+    TEST_ASSERT_FALSE(ramkaDekodujKura(zla, dl, &wynik));
+}
+
+void test_obciete_ramki() {
+    RamkaDane dane = probkaDane();
+    dane.pominiete = 1;
+    RamkaKura kura = probkaKura();
+    RamkaPaczka paczka;
+    memset(&paczka, 0, sizeof(paczka));
+    paczka.liczba = 3;
+    for (uint8_t i = 0; i < paczka.liczba; i++) paczka.probki[i] = probkaDane();
+
+    uint8_t bin[3][RAMKA_MAX_BAJTY];
+    size_t n[3] = {
+        ramkaKodujDane(&dane, bin[0], sizeof(bin[0])),
+        ramkaKodujKura(&kura, bin[1], sizeof(bin[1])),
+        ramkaKodujPaczke(&paczka, bin[2], sizeof(bin[2])),
+    };
+
+    for (int r = 0; r < 3; r++) {
+        for (size_t dl = 0; dl < n[r]; dl++) {
+            // Obcięta ramka z przeliczonym CRC - nadal musi zostać odrzucona przez kontrolę długości
+            uint8_t kopia[RAMKA_MAX_BAJTY];
+            memcpy(kopia, bin[r], n[r]);
+            if (dl >= RAMKA_NAGLOWEK_BAJTY + RAMKA_CRC_BAJTY) {
+                uint16_t crc = ramkaCrc16(kopia, dl - RAMKA_CRC_BAJTY);
+                kopia[dl - 2] = (uint8_t)crc;
+                kopia[dl - 1] = (uint8_t)(crc >> 8);
+            }
+            TEST_ASSERT_FALSE(ramkaDekodujDane(bin[r], dl, &dane));
+            TEST_ASSERT_FALSE(ramkaDekodujDane(kopia, dl, &dane));
+            TEST_ASSERT_FALSE(ramkaDekodujKura(bin[r], dl, &kura));
+            TEST_ASSERT_FALSE(ramkaDekodujKura(kopia, dl, &kura));
+            TEST_ASSERT_FALSE(ramkaDekodujPaczke(bin[r], dl, &paczka));
+            TEST_ASSERT_FALSE(ramkaDekodujPaczke(kopia, dl, &paczka));
+        }
+    }
+
+    // Obcięty tekst base64
+    char tekst[RAMKA_MAX_TEKST];
+    size_t dl = ramkaDoTekstu(bin[0], n[0], tekst, sizeof(tekst));
+    uint8_t odczyt[RAMKA_MAX_BAJTY];
+    size_t m = ramkaZTekstu(tekst + RAMKA_PREFIX_DL, dl - RAMKA_PREFIX_DL - 4, odczyt, sizeof(odczyt));
+    TEST_ASSERT_FALSE(ramkaDekodujDane(odczyt, m, &dane));
+}
+
+void test_za_maly_bufor() {
+    RamkaDane r = probkaDane();
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujDane(&r, bin, sizeof(bin));
+    TEST_ASSERT_EQUAL(0, ramkaKodujDane(&r, bin, n - 1));
+
+    char tekst[RAMKA_MAX_TEKST];
+    size_t dl = ramkaDoTekstu(bin, n, tekst, sizeof(tekst));
+    TEST_ASSERT_EQUAL(0, ramkaDoTekstu(bin, n, tekst, dl));     // brak miejsca na '\0'
+}
+
+// === ROZMIAR WIADOMOŚCI ===
+
+void test_rozmiar_binarna_csv_json() {
+    RamkaDane r = probkaDane();
+    r.temperatura_c = 2345;
+    r.poziom_amoniaku = 15;
+    char czas[RAMKA_CZAS_DL];
+    ramkaFormatujCzas(r.naglowek.epoch, czas, sizeof(czas));
+    TEST_ASSERT_EQUAL_STRING("12:30:00 Tue, Jan 02 2024", czas);
+
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujDane(&r, bin, sizeof(bin));
+    char ramka[RAMKA_MAX_TEKST];
+    size_t dl_ramka = ramkaDoTekstu(bin, n, ramka, sizeof(ramka));
+
+    // Dotychczasowy format CSV węzła (pakietToCSV z tagiem "DANE;")
+    char csv[160];
+    int dl_csv = snprintf(csv, sizeof(csv), "DANE;%lu;%.2f;%.2f;%ld;%ld;%lu;%s",
+                          (unsigned long)r.naglowek.id_wezla, r.temperatura_c / 100.0, r.wilgotnosc_c / 100.0,
+                          (long)r.poziom_co2, (long)r.poziom_amoniaku, (unsigned long)r.naslonecznienie, czas);
+
+    // Ten sam pomiar jako obiekt JSON
+    char json[256];
+    int dl_json = snprintf(json, sizeof(json),
+                           "{\"id\":%lu,\"seq\":%u,\"temperatura\":%.2f,\"wilgotnosc\":%.2f,"
+                           "\"co2\":%ld,\"amoniak\":%ld,\"naslonecznienie\":%lu,\"czas\":\"%s\"}",
+                           (unsigned long)r.naglowek.id_wezla, r.naglowek.sekwencja, r.temperatura_c / 100.0,
+                           r.wilgotnosc_c / 100.0, (long)r.poziom_co2, (long)r.poziom_amoniaku,
+                           (unsigned long)r.naslonecznienie, czas);
+
+    char raport[160];
+    snprintf(raport, sizeof(raport), "binarna %u B, RAMK+base64 %u B, CSV %d B, JSON %d B",
+             (unsigned)n, (unsigned)dl_ramka, dl_csv, dl_json);
+    TEST_MESSAGE(raport);
+
+    TEST_ASSERT_LESS_THAN(dl_csv, (int)dl_ramka);
+    TEST_ASSERT_LESS_THAN(dl_json, dl_csv);
+    // Sama ramka binarna (przed base64) jest co najmniej o połowę mniejsza od CSV
+    TEST_ASSERT_LESS_OR_EQUAL(dl_csv / 2, (int)n);
+}
+
+// === PRZEPUSTOWOŚĆ: RAMKA BINARNA vs CSV ===
+
+static const long ITERACJE_PRZEPUSTOWOSCI = 100000;
+static volatile uint32_t ujscie = 0;
+
+static double wiadomosciNaSekunde(std::chrono::steady_clock::duration czas) {
+    double s = std::chrono::duration<double>(czas).count();
+    return s > 0 ? ITERACJE_PRZEPUSTOWOSCI / s : 0;
+}
+
+// Węzeł: czas jako tekst + pakietToCSV z tagiem "DANE;"
+static size_t kodujCSV(const RamkaDane* r, char* csv, size_t rozmiar) {
+    char czas[RAMKA_CZAS_DL];
+    ramkaFormatujCzas(r->naglowek.epoch, czas, sizeof(czas));
+    int n = snprintf(csv, rozmiar, "DANE;%lu;%.2f;%.2f;%ld;%ld;%lu;%s",
+                     (unsigned long)r->naglowek.id_wezla, r->temperatura_c / 100.0, r->wilgotnosc_c / 100.0,
+                     (long)r->poziom_co2, (long)r->poziom_amoniaku, (unsigned long)r->naslonecznienie, czas);
+    return n > 0 ? (size_t)n : 0;
+}
+
+// Gateway: pola liczbowe sscanf, czas kopiowany jako tekst
+static bool dekodujCSV(const char* csv, RamkaDane* r, char* czas) {
+    unsigned long id, swiatlo;
+    long co2, nh3;
+    float temperatura, wilgotnosc;
+    int n = sscanf(csv, "DANE;%lu;%f;%f;%ld;%ld;%lu;%31[^\n]", &id, &temperatura, &wilgotnosc,
+                   &co2, &nh3, &swiatlo, czas);
+    r->naglowek.id_wezla = (uint32_t)id;
+    r->temperatura_c = (int16_t)ramkaSetne(temperatura);
+    r->wilgotnosc_c = (uint16_t)ramkaSetne(wilgotnosc);
+    r->poziom_co2 = (int32_t)co2;
+    r->poziom_amoniaku = (int32_t)nh3;
+    r->naslonecznienie = (uint32_t)swiatlo;
+    return n == 7;
+}
+
+// Węzeł: ramka binarna + base64 z prefiksem "RAMK"
+static size_t kodujRamke(const RamkaDane* r, char* tekst, size_t rozmiar) {
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    size_t n = ramkaKodujDane(r, bin, sizeof(bin));
+    return ramkaDoTekstu(bin, n, tekst, rozmiar);
+}
+
+// Gateway: base64 + dekodowanie, czas formatowany do CSV uplinku
+static bool dekodujRamke(const char* tekst, size_t dlugosc, RamkaDane* r, char* czas) {
+    uint8_t bin[RAMKA_MAX_BAJTY];
+    size_t n = ramkaZTekstu(tekst + 4, dlugosc - 4, bin, sizeof(bin));
+    if (!ramkaDekodujDane(bin, n, r)) return false;
+    ramkaFormatujCzas(r->naglowek.epoch, czas, RAMKA_CZAS_DL);
+    return true;
+}
+
+static void sprawdzPola(const RamkaDane* oczekiwana, const RamkaDane* r) {
+    TEST_ASSERT_EQUAL_UINT32(oczekiwana->naglowek.id_wezla, r->naglowek.id_wezla);
+    TEST_ASSERT_EQUAL_INT16(oczekiwana->temperatura_c, r->temperatura_c);
+    TEST_ASSERT_EQUAL_UINT16(oczekiwana->wilgotnosc_c, r->wilgotnosc_c);
+    TEST_ASSERT_EQUAL_INT32(oczekiwana->poziom_co2, r->poziom_co2);
+    TEST_ASSERT_EQUAL_INT32(oczekiwana->poziom_amoniaku, r->poziom_amoniaku);
+    TEST_ASSERT_EQUAL_UINT32(oczekiwana->naslonecznienie, r->naslonecznienie);
+}
+
+void test_przepustowosc_binarna_csv() {
+    RamkaDane r = probkaDane();
+    r.temperatura_c = 2345;
+    r.poziom_amoniaku = 15;
+
+    char csv[160];
+    char ramka[RAMKA_MAX_TEKST];
+    char czas[RAMKA_CZAS_DL];
+    RamkaDane wynik;
+
+    // Kodowanie
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ITERACJE_PRZEPUSTOWOSCI; i++) ujscie += kodujCSV(&r, csv, sizeof(csv));
+    auto kodowanieCSV = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ITERACJE_PRZEPUSTOWOSCI; i++) ujscie += kodujRamke(&r, ramka, sizeof(ramka));
+    auto kodowanieRamki = std::chrono::steady_clock::now() - start;
+
+    // Dekodowanie
+    size_t dl_csv = kodujCSV(&r, csv, sizeof(csv));
+    size_t dl_ramka = kodujRamke(&r, ramka, sizeof(ramka));
+    TEST_ASSERT_GREATER_THAN(0, (int)dl_csv);
+    TEST_ASSERT_GREATER_THAN(0, (int)dl_ramka);
+
+    start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ITERACJE_PRZEPUSTOWOSCI; i++) ujscie += dekodujCSV(csv, &wynik, czas);
+    auto dekodowanieCSV = std::chrono::steady_clock::now() - start;
+    TEST_ASSERT_TRUE(dekodujCSV(csv, &wynik, czas));
+    sprawdzPola(&r, &wynik);
+    TEST_ASSERT_EQUAL_STRING("12:30:00 Tue, Jan 02 2024", czas);
+
+    start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ITERACJE_PRZEPUSTOWOSCI; i++) ujscie += dekodujRamke(ramka, dl_ramka, &wynik, czas);
+    auto dekodowanieRamki = std::chrono::steady_clock::now() - start;
+    memset(&wynik, 0, sizeof(wynik));
+    TEST_ASSERT_TRUE(dekodujRamke(ramka, dl_ramka, &wynik, czas));
+    sprawdzPola(&r, &wynik);
+    TEST_ASSERT_EQUAL_STRING("12:30:00 Tue, Jan 02 2024", czas);
+
+    // Tylko raport - zysk ramki to rozmiar wiadomości w eterze (test_rozmiar_binarna_csv_json),
+    // koszt CPU po obu stronach jest tego samego rzędu i zależy od maszyny
+    char raport[200];
+    snprintf(raport, sizeof(raport), "kodowanie: CSV %.0f wiad/s, ramka %.0f wiad/s; "
+             "dekodowanie: CSV %.0f wiad/s, ramka %.0f wiad/s",
+             wiadomosciNaSekunde(kodowanieCSV), wiadomosciNaSekunde(kodowanieRamki),
+             wiadomosciNaSekunde(dekodowanieCSV), wiadomosciNaSekunde(dekodowanieRamki));
+    TEST_MESSAGE(raport);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_dane_w_obie_strony);
+    RUN_TEST(test_dane_strefa_w_obie_strony);
+    RUN_TEST(test_kura_w_obie_strony);
+    RUN_TEST(test_kura_najdluzszy_uid);
+    RUN_TEST(test_agregat_w_obie_strony);
+    RUN_TEST(test_paczka_w_obie_strony);
+    RUN_TEST(test_paczka_poza_zakresem);
+    RUN_TEST(test_brak_odczytu_swiatla);
+    RUN_TEST(test_bledne_crc);
+    RUN_TEST(test_nieznana_wersja);
+    RUN_TEST(test_zly_typ_ramki);
+    RUN_TEST(test_bledny_base64);
+    RUN_TEST(test_za_dlugi_uid);
+    RUN_TEST(test_obciete_ramki);
+    RUN_TEST(test_za_maly_bufor);
+    RUN_TEST(test_rozmiar_binarna_csv_json);
+    RUN_TEST(test_przepustowosc_binarna_csv);
+    return UNITY_END();
+}
@@ -0,0 +1,224 @@
+/*
+ * TESTY ŚCIEŻKI DANYCH - test_sciezka_danych/test_main.cpp
+ *
+ * Testy hosta (pio test -e native) dla drogi pakietu od callbacku mesh do
+ * brokera i karty SD: receivedCallback() -> kolejka uplinku -> WyslijPakiet()
+ * -> paczka QoS 1 -> PUBACK -> ZapiszDanePakiet() do archiwum, a przy braku
+ * MQTT lub PUBACK - kolejka offline i jej ponowna wysyłka. Platformę
+ * zastępują moduły z natywne/ (karta SD w pamięci, model brokera, zegar
+ * sterowany testem); zadanie uplinku nie działa - testy wywołują UplinkKrok().
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "natywne.h"
+#include "odbior_mesh.h"
+#include "uplink.h"
+#include "mqtt.h"
+#include "pamiec_SD.h"
+#include "archiwum_SD.h"
+#include "kolejka_SD.h"
+#include "dostarczanie_mqtt.h"
+#include "ponowna_wysylka.h"
+
+// 12:00:00 Wed, Jan 07 2026
+static const uint32_t EPOCH = 1767787200;
+static const uint32_t WEZEL = 3257743041u;
+
+static void krok(uint32_t ms) {
+    NatywnyZegarPrzesun(ms);
+    UplinkKrok();
+}
+
+static uint32_t rekordyArchiwum() {
+    StatystykiArchiwum s;
+    ArchiwumPobierzStatystyki(&s);
+    return s.rekordy;
+}
+
+static uint32_t odlozone() {
+    StatystykiDostarczania s;
+    DostarczaniePobierzStatystyki(&s);
+    return s.odlozone;
+}
+
+static uint32_t przetworzone() {
+    StatystykiUplinku s;
+    PobierzStatystykiUplinku(&s);
+    return s.przetworzone;
+}
+
+static void odbierz(const char* wiadomosc) {
+    String msg(wiadomosc);
+    receivedCallback(WEZEL, msg);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_dane_z_mesh_do_archiwum_po_puback() {
+    uint32_t archiwum = rekordyArchiwum();
+    odbierz("DANE;7;21.50;55.25;800;12;40;12:00:00 Wed, Jan 07 2026");
+    odbierz("KURA;692641124;F7474A39;-0.37;12:00:01 Wed, Jan 07 2026");
+
+    // Rekordy czekają w otwartej paczce do końca okna
+    krok(0);
+    TEST_ASSERT_EQUAL_UINT32(0, NatywnyBrokerOtrzymal("/paczka", nullptr));
+
+    krok(DOSTARCZANIE_OKNO_MS);
+    TEST_ASSERT_EQUAL_UINT32(1, NatywnyBrokerOtrzymal("/paczka", "7;21.50;55.25;800;12;40;12:00:00 Wed, Jan 07 2026"));
+    TEST_ASSERT_EQUAL_UINT32(1, NatywnyBrokerOtrzymal("/paczka", "692641124;F7474A39;-0.37"));
+    TEST_ASSERT_TRUE(DostarczanieOczekuje());
+    TEST_ASSERT_EQUAL_UINT32(archiwum, rekordyArchiwum());
+
+    // Archiwum dopiero po PUBACK - oba rekordy paczki
+    TEST_ASSERT_EQUAL_UINT32(1, NatywnyBrokerPotwierdz());
+    krok(10);
+    TEST_ASSERT_FALSE(DostarczanieOczekuje());
+    TEST_ASSERT_EQUAL_UINT32(archiwum + 2, rekordyArchiwum());
+}
+
+void test_bledny_pakiet_odrzucony() {
+    uint32_t przed = przetworzone();
+    odbierz("DANE;7;21.50;abc;800;12;40;12:00:00 Wed, Jan 07 2026");
+    odbierz("XYZW;1;2;3");
+    krok(DOSTARCZANIE_OKNO_MS);
+    TEST_ASSERT_EQUAL_UINT32(przed, przetworzone());
+    TEST_ASSERT_FALSE(DostarczanieOczekuje());
+}
+
+void test_rozlaczenie_kolejka_i_ponowna_wysylka() {
+    const char* rekord = "8;19.75;60.00;950;10;0;12:05:00 Wed, Jan 07 2026";
+    uint32_t archiwum = rekordyArchiwum();
+    uint32_t odlozonePrzed = odlozone();
+
+    NatywnyBrokerRozlacz();
+    odbierz("DANE;8;19.75;60.00;950;10;0;12:05:00 Wed, Jan 07 2026");
+    krok(0);
+    krok(DOSTARCZANIE_OKNO_MS);
+
+    // Paczka bez połączenia trafia rekordami do kolejki offline na karcie
+    TEST_ASSERT_EQUAL_UINT32(odlozonePrzed + 1, odlozone());
+    TEST_ASSERT_EQUAL_UINT32(0, NatywnyBrokerOtrzymal(nullptr, rekord));
+    TEST_ASSERT_EQUAL_UINT32(1, NatywnaKartaLiczbaPlikow(KOLEJKA_KATALOG));
+
+    // Po powrocie połączenia rekord idzie z kolejki na główny topic
+    NatywnyBrokerPolacz();
+    ZlecPonowneWyslanie();
+    krok(10);
+    TEST_ASSERT_TRUE(PonownaWysylkaAktywna());
+    TEST_ASSERT_EQUAL_UINT32(1, NatywnyBrokerOtrzymal(nullptr, rekord));
+    TEST_ASSERT_EQUAL_UINT32(0, NatywnyBrokerOtrzymal("/paczka", rekord));
+
+    // PUBACK przesuwa kursor i kopiuje rekord do archiwum
+    TEST_ASSERT_EQUAL_UINT32(1, NatywnyBrokerPotwierdz());
+    krok(10);
+    krok(10);
+    TEST_ASSERT_FALSE(PonownaWysylkaAktywna());
+    TEST_ASSERT_EQUAL_UINT32(archiwum + 1, rekordyArchiwum());
+
+    StatystykiKolejki kolejka;
+    KolejkaPobierzStatystyki(&kolejka);
+    TEST_ASSERT_EQUAL_UINT32(kolejka.glowa, kolejka.kursor.segment);
+    TEST_ASSERT_EQUAL_UINT32(kolejka.rozmiar_glowy, kolejka.kursor.offset);
+}
+
+void test_zapis_do_kolejki_bez_puback_ponawiany_oknem() {
+    const char* rekord = "9;20.00;50.00;700;5;10;12:10:00 Wed, Jan 07 2026";
+    uint32_t archiwum = rekordyArchiwum();
+
+    // Rekord zapisany wprost (jak po wyczerpaniu prób dostarczania)
+    ZapiszDanePakiet(rekord, false);
+    ZlecPonowneWyslanie();
+    NatywnyBrokerUstawUtrate(true);
+    krok(10);
+    TEST_ASSERT_TRUE(PonownaWysylkaAktywna());
+    TEST_ASSERT_EQUAL_UINT32(0, NatywnyBrokerOtrzymal(nullptr, rekord));
+
+    // Brak PUBACK - po czasie okno jest wysyłane od kursora jeszcze raz
+    NatywnyBrokerUstawUtrate(false);
+    krok(PONOWNA_WYSYLKA_TIMEOUT_MS + 1);
+    TEST_ASSERT_EQUAL_UINT32(1, NatywnyBrokerOtrzymal(nullptr, rekord));
+    TEST_ASSERT_EQUAL_UINT32(1, NatywnyBrokerPotwierdz());
+    krok(10);
+    krok(10);
+    TEST_ASSERT_FALSE(PonownaWysylkaAktywna());
+    TEST_ASSERT_EQUAL_UINT32(archiwum + 1, rekordyArchiwum());
+}
+
+void test_brak_puback_odklada_i_wysyla_bez_ponownego_polaczenia() {
+    const char* rekord = "10;22.00;58.00;900;11;30;12:15:00 Wed, Jan 07 2026";
+    uint32_t archiwum = rekordyArchiwum();
+    uint32_t odlozonePrzed = odlozone();
+
+    // Broker gubi obie publikacje paczki - połączenie cały czas działa
+    NatywnyBrokerUstawUtrate(true);
+    odbierz("DANE;10;22.00;58.00;900;11;30;12:15:00 Wed, Jan 07 2026");
+    krok(0);
+    krok(DOSTARCZANIE_OKNO_MS);
+    krok(DOSTARCZANIE_TIMEOUT_MS + 1);
+    NatywnyBrokerUstawUtrate(false);
+    TEST_ASSERT_EQUAL_UINT32(0, NatywnyBrokerOtrzymal(nullptr, rekord));
+
+    // Wyczerpane próby - rekord w kolejce offline, wysyłka kolejki zlecona od razu
+    krok(DOSTARCZANIE_TIMEOUT_MS + 1);
+    TEST_ASSERT_EQUAL_UINT32(odlozonePrzed + 1, odlozone());
+    krok(10);
+    TEST_ASSERT_TRUE(PonownaWysylkaAktywna());
+    TEST_ASSERT_EQUAL_UINT32(1, NatywnyBrokerOtrzymal(nullptr, rekord));
+
+    TEST_ASSERT_EQUAL_UINT32(1, NatywnyBrokerPotwierdz());
+    krok(10);
+    krok(10);
+    TEST_ASSERT_FALSE(PonownaWysylkaAktywna());
+    TEST_ASSERT_EQUAL_UINT32(archiwum + 1, rekordyArchiwum());
+}
+
+void test_rekord_dopisany_w_trakcie_wysylki_kolejki() {
+    const char* pierwszy = "11;18.00;70.00;650;8;0;12:20:00 Wed, Jan 07 2026";
+    const char* drugi = "12;18.50;69.00;660;8;0;12:20:05 Wed, Jan 07 2026";
+    uint32_t archiwum = rekordyArchiwum();
+
+    // Wysyłka trwa, kolejka przeczytana do końca, pierwszy rekord czeka na PUBACK
+    NatywnyBrokerUstawUtrate(true);
+    ZapiszDanePakiet(pierwszy, false);
+    ZlecPonowneWyslanie();
+    krok(10);
+    NatywnyBrokerUstawUtrate(false);
+    TEST_ASSERT_TRUE(PonownaWysylkaAktywna());
+
+    // Kolejne zlecenie w trakcie wysyłki wznawia odczyt kolejki
+    ZapiszDanePakiet(drugi, false);
+    ZlecPonowneWyslanie();
+    krok(10);
+    TEST_ASSERT_EQUAL_UINT32(1, NatywnyBrokerOtrzymal(nullptr, drugi));
+
+    // Po czasie PUBACK okno od kursora: oba rekordy, potem koniec wysyłki
+    krok(PONOWNA_WYSYLKA_TIMEOUT_MS + 1);
+    TEST_ASSERT_EQUAL_UINT32(1, NatywnyBrokerOtrzymal(nullptr, pierwszy));
+    NatywnyBrokerPotwierdz();
+    krok(10);
+    krok(10);
+    TEST_ASSERT_FALSE(PonownaWysylkaAktywna());
+    TEST_ASSERT_EQUAL_UINT32(archiwum + 2, rekordyArchiwum());
+}
+
+int main() {
+    NatywnaKartaWyczysc();
+    rtc.setTime(EPOCH);
+    InicjalizacjaSD();
+    InicjalizacjaMQTT();
+    InicjalizacjaTopicuZ_MAC();
+    InicjalizacjaUplink();
+    OdbiorMeshInicjalizacja();
+    NatywnyBrokerPolacz();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_dane_z_mesh_do_archiwum_po_puback);
+    RUN_TEST(test_bledny_pakiet_odrzucony);
+    RUN_TEST(test_rozlaczenie_kolejka_i_ponowna_wysylka);
+    RUN_TEST(test_zapis_do_kolejki_bez_puback_ponawiany_oknem);
+    RUN_TEST(test_brak_puback_odklada_i_wysyla_bez_ponownego_polaczenia);
+    RUN_TEST(test_rekord_dopisany_w_trakcie_wysylki_kolejki);
+    return UNITY_END();
+}
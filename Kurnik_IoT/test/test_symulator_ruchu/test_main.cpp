@@ -0,0 +1,156 @@
+/*
+ * OBCIĄŻENIE ŚCIEŻKI DANYCH NA HOŚCIE - test_symulator_ruchu/test_main.cpp
+ *
+ * Uruchamia symulator ruchu (symulator_ruchu.h) z N wirtualnymi węzłami
+ * i prowadzi go krokami zegara przez całą ścieżkę: dyspozytor mesh ->
+ * kolejka uplinku -> paczki QoS 1 i PUBACK -> kolejka offline przy braku
+ * połączenia. Wynik trafia do wyjścia testu: wiadomości/s i ns/wiadomość
+ * (czas ściany hosta), p50/p99 etapów i liczby bajtów. Etapy mierzy
+ * micros() zegara sterowanego testem, więc opóźnienia kolejki i PUBACK są
+ * w krokach symulacji, a koszt CPU etapów widać tylko w ns/wiadomość.
+ * Asercje sprawdzają przepływ rekordów, nie czasy maszyny CI.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include "natywne.h"
+#include "symulator_ruchu.h"
+#include "histogram_czasu.h"
+#include "odbior_mesh.h"
+#include "uplink.h"
+#include "mqtt.h"
+#include "pamiec_SD.h"
+#include "dostarczanie_mqtt.h"
+
+// 12:00:00 Wed, Jan 07 2026
+static const uint32_t EPOCH = 1767787200;
+static const uint32_t WEZLY = 32;
+static const float NA_SEKUNDE = 4.0f;
+static const uint32_t CZAS_S = 20;
+// Krok zegara między iteracjami pętli (loop() + zadanie uplinku)
+static const uint32_t KROK_MS = 10;
+
+static const char* NAZWY_ETAPOW[ETAP_LICZBA] = {
+    "odbiór", "kolejka", "wysyłka", "zapis SD", "PUBACK"
+};
+
+static void krok() {
+    SymulatorObsluga();
+    NatywnyZegarPrzesun(KROK_MS);
+    UplinkKrok();
+    NatywnyBrokerPotwierdz();
+}
+
+// Kroki po końcu symulacji - domknięcie ostatniej paczki i jej PUBACK
+static void dokoncz() {
+    for (uint32_t t = 0; t < DOSTARCZANIE_OKNO_MS * 2; t += KROK_MS) {
+        krok();
+    }
+}
+
+// Przebieg symulacji do końca; zwraca czas ściany hosta w sekundach
+static double przebieg(bool ramki, uint32_t rozlaczOd_s) {
+    TEST_ASSERT_TRUE(SymulatorStart(WEZLY, NA_SEKUNDE, CZAS_S, ramki));
+
+    auto start = std::chrono::steady_clock::now();
+    uint32_t kroki = 0;
+    while (SymulatorAktywny()) {
+        if (rozlaczOd_s && kroki * KROK_MS == rozlaczOd_s * 1000) NatywnyBrokerRozlacz();
+        krok();
+        kroki++;
+    }
+    dokoncz();
+    std::chrono::duration<double> sciana = std::chrono::steady_clock::now() - start;
+    NatywnyBrokerPolacz();
+    return sciana.count();
+}
+
+static void wypiszRaport(const char* nazwa, double sciana_s) {
+    StatystykiSymulatora s;
+    SymulatorPobierzStatystyki(&s);
+
+    char linia[128];
+    snprintf(linia, sizeof(linia), "%s: %lu węzłów, %lu wiadomości w %.1f s symulacji", nazwa,
+             (unsigned long)WEZLY, (unsigned long)s.wygenerowane, s.czas_us / 1e6);
+    TEST_MESSAGE(linia);
+    snprintf(linia, sizeof(linia), "  host: %.0f wiadomości/s, %.0f ns/wiadomość",
+             sciana_s > 0 ? s.przetworzone / sciana_s : 0.0,
+             s.przetworzone ? sciana_s * 1e9 / s.przetworzone : 0.0);
+    TEST_MESSAGE(linia);
+    snprintf(linia, sizeof(linia), "  potwierdzone %lu, odłożone %lu, odrzucone %lu",
+             (unsigned long)s.potwierdzone, (unsigned long)s.odlozone, (unsigned long)s.odrzucone);
+    TEST_MESSAGE(linia);
+    snprintf(linia, sizeof(linia), "  bajty: archiwum %lu B, kolejka offline %lu B, SD %lu B (%.1f B/wiadomość)",
+             (unsigned long)s.pominiete_archiwum, (unsigned long)s.pominiete_kolejka, (unsigned long)s.bajty_sd,
+             s.przetworzone ? (double)(s.pominiete_archiwum + s.pominiete_kolejka) / s.przetworzone : 0.0);
+    TEST_MESSAGE(linia);
+
+    for (int e = 0; e < ETAP_LICZBA; e++) {
+        const HistogramCzasu* h = SymulatorHistogram((EtapSymulacji)e);
+        snprintf(linia, sizeof(linia), "  %-10s %6lu  p50 %8lu us  p99 %8lu us", NAZWY_ETAPOW[e],
+                 (unsigned long)h->liczba, (unsigned long)histogramPercentyl(h, 500),
+                 (unsigned long)histogramPercentyl(h, 990));
+        TEST_MESSAGE(linia);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_symulacja_dane_potwierdzone() {
+    double sciana = przebieg(false, 0);
+    wypiszRaport("DANE", sciana);
+
+    StatystykiSymulatora s;
+    SymulatorPobierzStatystyki(&s);
+    TEST_ASSERT_GREATER_THAN(WEZLY * CZAS_S * (uint32_t)NA_SEKUNDE - WEZLY, s.wygenerowane);
+    TEST_ASSERT_EQUAL_UINT32(0, s.odrzucone);
+    TEST_ASSERT_EQUAL_UINT32(s.wygenerowane, s.przetworzone);
+    TEST_ASSERT_EQUAL_UINT32(s.przetworzone, s.potwierdzone);
+    TEST_ASSERT_EQUAL_UINT32(0, s.odlozone);
+
+    // Rekordy symulacji omijają kartę, ale raport podaje, ile by zajęły
+    TEST_ASSERT_EQUAL_UINT32(0, s.bajty_sd);
+    TEST_ASSERT_GREATER_THAN(s.potwierdzone * 20, s.pominiete_archiwum);
+    TEST_ASSERT_EQUAL_UINT32(0, s.pominiete_kolejka);
+    TEST_ASSERT_GREATER_THAN(0, NatywnyBrokerOtrzymal(SYMULATOR_TOPIC_SUFIKS, nullptr));
+
+    TEST_ASSERT_EQUAL_UINT32(s.przetworzone, SymulatorHistogram(ETAP_ODBIOR)->liczba);
+    TEST_ASSERT_EQUAL_UINT32(s.przetworzone, SymulatorHistogram(ETAP_KOLEJKA)->liczba);
+    TEST_ASSERT_GREATER_THAN(0, SymulatorHistogram(ETAP_POTWIERDZENIE)->liczba);
+}
+
+void test_symulacja_ramki_rozlaczenie_do_kolejki_offline() {
+    NatywnyBrokerWyczysc();
+    double sciana = przebieg(true, CZAS_S / 2);
+    wypiszRaport("RAMK", sciana);
+
+    StatystykiSymulatora s;
+    SymulatorPobierzStatystyki(&s);
+    TEST_ASSERT_EQUAL_UINT32(0, s.odrzucone);
+    TEST_ASSERT_EQUAL_UINT32(s.wygenerowane, s.przetworzone);
+
+    // Pierwsza połowa potwierdzona, druga bez połączenia w kolejce offline
+    TEST_ASSERT_GREATER_THAN(0, s.potwierdzone);
+    TEST_ASSERT_GREATER_THAN(0, s.odlozone);
+    TEST_ASSERT_EQUAL_UINT32(s.przetworzone, s.potwierdzone + s.odlozone);
+    TEST_ASSERT_GREATER_THAN(0, s.pominiete_kolejka);
+    TEST_ASSERT_EQUAL_UINT32(0, s.bajty_sd);
+}
+
+int main() {
+    NatywnaKartaWyczysc();
+    rtc.setTime(EPOCH);
+    InicjalizacjaSD();
+    InicjalizacjaMQTT();
+    InicjalizacjaTopicuZ_MAC();
+    InicjalizacjaUplink();
+    OdbiorMeshInicjalizacja();
+    NatywnyBrokerPolacz();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_symulacja_dane_potwierdzone);
+    RUN_TEST(test_symulacja_ramki_rozlaczenie_do_kolejki_offline);
+    return UNITY_END();
+}
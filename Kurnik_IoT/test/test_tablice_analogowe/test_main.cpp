@@ -0,0 +1,134 @@
+/*
+ * TESTY TABLIC PRZELICZENIOWYCH - test_tablice_analogowe/test_main.cpp
+ *
+ * Testy hosta dla tablice_analogowe.h (pio test -e native): błąd tablic
+ * NTC i LDR względem wcześniejszych obliczeń float z czujniki.cpp
+ * (log() / powf() na każdą próbkę) dla wszystkich kodów ADC 1..4094.
+ * Granice błędu są tymi opisanymi w nagłówku tablice_analogowe.h.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include "tablice_analogowe.h"
+
+// === DOTYCHCZASOWE OBLICZENIA (czujniki.cpp przed tablicami) ===
+
+static float ntcFloat(int raw) {
+    const float REFERENCE_RESISTANCE = 10000.0;
+    const float NOMINAL_RESISTANCE = 10000.0;
+    const float NOMINAL_TEMPERATURE = 25.0;
+    const float B_VALUE = 3950.0;
+
+    float resistance = REFERENCE_RESISTANCE * raw / (4095.0 - raw);
+    float steinhart = resistance / NOMINAL_RESISTANCE;
+    steinhart = log(steinhart);
+    steinhart /= B_VALUE;
+    steinhart += 1.0 / (NOMINAL_TEMPERATURE + 273.15);
+    steinhart = 1.0 / steinhart;
+    return steinhart - 273.15;
+}
+
+// Bez pośredniego zaokrąglenia lux przed kalibracją (tablica go nie powtarza)
+static float ldrFloat(int raw) {
+    const float LDR_REF_R = 10000.0f;
+    const float LDR_A = 150000.0f;
+    const float LDR_B = 0.7f;
+    const float CAL_A = 0.587444f;
+    const float CAL_B = 22.2009f;
+
+    float Rldr = LDR_REF_R * (float)raw / (4095.0f - (float)raw);
+    float lux = powf(LDR_A / Rldr, 1.0f / LDR_B);
+    return CAL_A * lux + CAL_B;
+}
+
+// Największy błąd tablicy w zakresie kodów
+typedef struct {
+    double blad;
+    int kod;
+} MaksBlad;
+
+static MaksBlad bladNtc(float t_min, float t_max) {
+    MaksBlad m = { 0.0, 0 };
+    for (int kod = 1; kod <= 4094; kod++) {
+        float wzorzec = ntcFloat(kod);
+        if (wzorzec < t_min || wzorzec > t_max) continue;
+        double blad = fabs((double)TablicaNTC::przelicz(kod) - wzorzec);
+        if (blad > m.blad) { m.blad = blad; m.kod = kod; }
+    }
+    return m;
+}
+
+// Błąd względny LDR
+static MaksBlad bladLdr(int kod_min) {
+    MaksBlad m = { 0.0, 0 };
+    for (int kod = kod_min; kod <= 4094; kod++) {
+        float wzorzec = ldrFloat(kod);
+        double blad = fabs((double)TablicaLDR::przelicz(kod) - wzorzec) / wzorzec;
+        if (blad > m.blad) { m.blad = blad; m.kod = kod; }
+    }
+    return m;
+}
+
+static void raport(const char* opis, MaksBlad m) {
+    char tekst[96];
+    snprintf(tekst, sizeof(tekst), "%s: maks. błąd %.5f (kod %d)", opis, m.blad, m.kod);
+    TEST_MESSAGE(tekst);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_ntc_zakres_pracy() {
+    MaksBlad m = bladNtc(-20.0f, 80.0f);
+    raport("NTC -20..80 °C [°C]", m);
+    TEST_ASSERT_LESS_THAN(0.002, m.blad);
+}
+
+void test_ntc_pelny_zakres_sondy() {
+    MaksBlad m = bladNtc(-40.0f, 125.0f);
+    raport("NTC -40..125 °C [°C]", m);
+    TEST_ASSERT_LESS_THAN(0.02, m.blad);
+}
+
+void test_ldr_kody_od_64() {
+    MaksBlad m = bladLdr(64);
+    raport("LDR kody 64..4094 [względny]", m);
+    TEST_ASSERT_LESS_THAN(0.007, m.blad);
+}
+
+void test_ldr_kody_od_256() {
+    MaksBlad m = bladLdr(256);
+    raport("LDR kody 256..4094 [względny]", m);
+    TEST_ASSERT_LESS_THAN(0.0005, m.blad);
+}
+
+// Kod w węźle tablicy zwraca sam węzeł, a węzeł to model policzony w double
+void test_wezly_tablicy() {
+    for (int i = 0; i < TABLICA_WEZLY - 1; i++) {
+        int kod = i * TABLICA_KROK;
+        TEST_ASSERT_FLOAT_WITHIN(1e-4, NtcKurnik10k::wartosc(kod), TablicaNTC::wezly[i]);
+        TEST_ASSERT_TRUE(TablicaNTC::przelicz(kod) == TablicaNTC::wezly[i]);
+        TEST_ASSERT_TRUE(TablicaLDR::przelicz(kod) == TablicaLDR::wezly[i]);
+    }
+}
+
+// Kody poza 0..4095 i skrajne kody nie wychodzą poza tablicę
+void test_kody_skrajne() {
+    TEST_ASSERT_TRUE(isfinite(TablicaNTC::przelicz(0)));
+    TEST_ASSERT_TRUE(isfinite(TablicaNTC::przelicz(4095)));
+    TEST_ASSERT_TRUE(TablicaNTC::przelicz(4095) == TablicaNTC::przelicz(65535));
+    TEST_ASSERT_TRUE(isfinite(TablicaLDR::przelicz(0)));
+    TEST_ASSERT_TRUE(TablicaLDR::przelicz(4095) >= 0.0f);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_ntc_zakres_pracy);
+    RUN_TEST(test_ntc_pelny_zakres_sondy);
+    RUN_TEST(test_ldr_kody_od_64);
+    RUN_TEST(test_ldr_kody_od_256);
+    RUN_TEST(test_wezly_tablicy);
+    RUN_TEST(test_kody_skrajne);
+    return UNITY_END();
+}
@@ -0,0 +1,173 @@
+"""
+Dekoder segmentów archiwum z karty SD Kurnik_IoT (/archiwum/*.bin).
+
+Odtwarza rekordy CSV "ID;temp;hum;co2;nh3;sun;HH:MM:SS Www, Mmm DD YYYY"
+(z ";przeniesione;pominiete", gdy węzeł je podał) z bloków kodeka
+(opis formatu: CommonSource/src/kodek_archiwum.h). Czyta bloki wersji 1 i 2.
+Segmenty .txt sprzed kodeka są przepisywane bez zmian.
+
+Użycie:
+    python dekoder_archiwum.py 00000001.txt 00000002.bin ... > dane.csv
+    python dekoder_archiwum.py /sciezka/do/archiwum > dane.csv
+"""
+
+import os
+import struct
+import sys
+import time
+
+WERSJA = 2
+BLOK_SZEREG = 1
+BLOK_TEKST = 2
+NAGLOWEK_BAJTY = 16
+CRC_BAJTY = 2
+MAX_DANE = 512 - NAGLOWEK_BAJTY - CRC_BAJTY
+
+
+def crc16(dane):
+    """CRC-16/CCITT-FALSE - ta sama suma co ramkaCrc16()."""
+    crc = 0xFFFF
+    for bajt in dane:
+        crc ^= bajt << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def int32(wartosc):
+    """Zawijanie do int32 jak w C."""
+    wartosc &= 0xFFFFFFFF
+    return wartosc - (1 << 32) if wartosc & 0x80000000 else wartosc
+
+
+class CzytnikBitow:
+    """Strumień bitów od najstarszego bitu bajtu (MSB-first)."""
+
+    def __init__(self, dane):
+        self.dane = dane
+        self.pozycja = 0
+
+    def bity(self, liczba):
+        wartosc = 0
+        for _ in range(liczba):
+            if self.pozycja >= len(self.dane) * 8:
+                raise ValueError("koniec danych bloku")
+            bajt = self.dane[self.pozycja >> 3]
+            wartosc = (wartosc << 1) | ((bajt >> (7 - (self.pozycja & 7))) & 1)
+            self.pozycja += 1
+        return wartosc
+
+    def prefiks(self):
+        klasa = 0
+        while klasa < 4 and self.bity(1) == 1:
+            klasa += 1
+        return klasa
+
+    def dod(self):
+        klasa = self.prefiks()
+        if klasa == 0:
+            return 0
+        if klasa == 1:
+            return self.bity(7) - 63
+        if klasa == 2:
+            return self.bity(9) - 255
+        if klasa == 3:
+            return self.bity(12) - 2047
+        return int32(self.bity(32))
+
+    def roznica(self):
+        klasa = self.prefiks()
+        z = self.bity((0, 4, 8, 16, 32)[klasa]) if klasa else 0
+        return int32((z >> 1) ^ -(z & 1))
+
+
+def formatuj_czas(epoch):
+    # Czas w rekordach nie ma strefy - tak samo jak ramkaFormatujCzas() (gmtime)
+    return time.strftime("%H:%M:%S %a, %b %d %Y", time.gmtime(epoch))
+
+
+def dekoduj_szereg(id_urzadzenia, liczba, epoch, dane, wersja):
+    czytnik = CzytnikBitow(dane)
+    # Wersja 1: 5 pól czujników, wersja 2: także przeniesione i pominięte
+    pola = [0] * (5 if wersja == 1 else 7)
+    delta = 0
+    for i in range(liczba):
+        if i > 0:
+            delta = int32(delta + czytnik.dod())
+            epoch = (epoch + delta) & 0xFFFFFFFF
+        pola = [int32(p + czytnik.roznica()) for p in pola]
+        temp, hum, co2, nh3, sun = pola[:5]
+        linia = "%d;%.2f;%.2f;%d;%d;%d;%s" % (
+            id_urzadzenia, temp / 100.0, hum / 100.0, co2, nh3, sun, formatuj_czas(epoch))
+        if len(pola) > 5 and (pola[5] or pola[6]):
+            linia += ";%d;%d" % (pola[5], pola[6])
+        yield linia
+
+
+def dekoduj_segment(dane, nazwa, wyjscie, bledy):
+    """Dekoduje wszystkie bloki segmentu. Uszkodzony blok jest pomijany."""
+    pozycja = 0
+    while pozycja + NAGLOWEK_BAJTY <= len(dane):
+        naglowek = dane[pozycja:pozycja + NAGLOWEK_BAJTY]
+        znacznik, wersja, typ, id_urz, liczba, dlugosc, epoch = struct.unpack("<2sBBiHHI", naglowek)
+        if znacznik != b"KA" or not 1 <= wersja <= WERSJA or dlugosc > MAX_DANE:
+            # Przesunięcie o bajt - odszukanie następnego nagłówka po uszkodzeniu
+            pozycja += 1
+            continue
+
+        koniec = pozycja + NAGLOWEK_BAJTY + dlugosc
+        if koniec + CRC_BAJTY > len(dane):
+            bledy.append("%s@%d: niepełny blok" % (nazwa, pozycja))
+            break
+        (crc,) = struct.unpack("<H", dane[koniec:koniec + CRC_BAJTY])
+        if crc16(dane[pozycja:koniec]) != crc:
+            bledy.append("%s@%d: błędne CRC" % (nazwa, pozycja))
+            pozycja += 1
+            continue
+
+        tresc = dane[pozycja + NAGLOWEK_BAJTY:koniec]
+        try:
+            if typ == BLOK_SZEREG:
+                for linia in dekoduj_szereg(id_urz, liczba, epoch, tresc, wersja):
+                    wyjscie.write(linia + "\n")
+            elif typ == BLOK_TEKST:
+                wyjscie.write(tresc.decode("utf-8", errors="replace"))
+            else:
+                bledy.append("%s@%d: nieznany typ bloku %d" % (nazwa, pozycja, typ))
+        except ValueError as e:
+            bledy.append("%s@%d: %s" % (nazwa, pozycja, e))
+        pozycja = koniec + CRC_BAJTY
+
+
+def pliki_segmentow(argumenty):
+    for sciezka in argumenty:
+        if os.path.isdir(sciezka):
+            nazwy = sorted(n for n in os.listdir(sciezka) if n.endswith((".bin", ".txt")) and n[:-4].isdigit())
+            for nazwa in nazwy:
+                yield os.path.join(sciezka, nazwa)
+        else:
+            yield sciezka
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        return 1
+
+    bledy = []
+    for sciezka in pliki_segmentow(sys.argv[1:]):
+        with open(sciezka, "rb") as plik:
+            dane = plik.read()
+        if sciezka.endswith(".txt"):
+            sys.stdout.write(dane.decode("utf-8", errors="replace"))
+        else:
+            dekoduj_segment(dane, os.path.basename(sciezka), sys.stdout, bledy)
+
+    for blad in bledy:
+        print("[!] " + blad, file=sys.stderr)
+    return 1 if bledy else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
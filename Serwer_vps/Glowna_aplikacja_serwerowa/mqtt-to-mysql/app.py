@@ -24,9 +24,14 @@ def get_kurnik_from_topic(topic: str) -> str:
     return parts[1] if len(parts) > 1 else "unknown"
 
 
-def parse_csv_payload(payload: str) -> Optional[Tuple[int, float, float, int, int, int, str]]:
+def parse_csv_payload(payload: str) -> Optional[Tuple[int, float, float, int, int, int, str, int, int]]:
+    # device_id;temp;hum;co2;nh3;sun;DateTime[;carried_mask;skipped]
+    # The two optional fields come from a node's deadband: carried_mask flags the
+    # values repeated from the node's previous report (bit 0 temp, 1 hum, 2 co2,
+    # 3 nh3, 4 sun), skipped is the number of samples the node did not send
+    # since then - each of them holds the previous row's values.
     fields = [f.strip() for f in payload.split(";")]
-    if len(fields) != 7:
+    if len(fields) not in (7, 9):
         return None
 
     try:
@@ -37,10 +42,34 @@ def parse_csv_payload(payload: str) -> Optional[Tuple[int, float, float, int, in
         nh3 = int(fields[4])
         sun = int(fields[5])
         timestamp_str = fields[6]
+        carried_mask = int(fields[7]) if len(fields) == 9 else 0
+        skipped = int(fields[8]) if len(fields) == 9 else 0
     except (ValueError, IndexError):
         return None
 
-    return device_id, temp, hum, co2, nh3, sun, timestamp_str
+    return device_id, temp, hum, co2, nh3, sun, timestamp_str, carried_mask, skipped
+
+
+AGGREGATE_FIELDS = ("temp", "hum", "co2", "nh3", "sun")
+AGGREGATE_STATS = ("min", "max", "avg", "std")
+
+
+def parse_aggregate_payload(payload: str) -> Optional[Tuple[int, int, int, list, str]]:
+    # device_id;period_s;samples;{min;max;avg;std} for temp, hum, co2, nh3, sun;DateTime
+    # A node window summary (RAMKA_TYP_AGREGAT). temp/hum are floats; co2/nh3/sun
+    # are ints, -1 when the window had no valid reading of that sensor.
+    fields = [f.strip() for f in payload.split(";")]
+    if len(fields) != 3 + len(AGGREGATE_FIELDS) * len(AGGREGATE_STATS) + 1:
+        return None
+    try:
+        device_id = int(fields[0])
+        period_s = int(fields[1])
+        samples = int(fields[2])
+        float_count = 2 * len(AGGREGATE_STATS)  # temp, hum
+        stats = [float(v) if i < float_count else int(v) for i, v in enumerate(fields[3:-1])]
+    except ValueError:
+        return None
+    return device_id, period_s, samples, stats, fields[-1]
 
 
 def parse_kury_payload(payload: str) -> Optional[Tuple[str, str, float, str]]:
@@ -115,6 +144,90 @@ def ensure_schema(conn) -> None:
         if "Duplicate column name" not in str(e):
             print(f"Migration note: {e}")
 
+    # Migration: deadband metadata (carried-forward fields, skipped samples)
+    for column in ("carried_mask TINYINT NOT NULL DEFAULT 0", "skipped INT NOT NULL DEFAULT 0"):
+        try:
+            cursor.execute(f"ALTER TABLE kurniki_dane ADD COLUMN {column}")
+            print(f"Added {column.split()[0]} column to existing table")
+        except Exception as e:
+            if "Duplicate column name" not in str(e):
+                print(f"Migration note: {e}")
+
+    # Migration: one row per device sample. The gateway delivers at least once
+    # (a lost PUBACK means the record is published again), so redeliveries of
+    # the same sample must not create duplicate rows. Exact copies already in
+    # the table are removed before the unique key is added.
+    try:
+        cursor.execute("SHOW INDEX FROM kurniki_dane WHERE Key_name = 'uq_kurnik_device_time'")
+        if not cursor.fetchall():
+            cursor.execute(
+                """
+                DELETE newer FROM kurniki_dane newer
+                JOIN kurniki_dane older
+                  ON newer.kurnik = older.kurnik
+                 AND newer.device_id = older.device_id
+                 AND newer.measurement_time = older.measurement_time
+                 AND newer.payload_raw = older.payload_raw
+                 AND newer.id > older.id
+                """
+            )
+            if cursor.rowcount:
+                print(f"Removed {cursor.rowcount} redelivered duplicate rows from kurniki_dane")
+            cursor.execute(
+                "ALTER TABLE kurniki_dane ADD UNIQUE KEY uq_kurnik_device_time (kurnik, device_id, measurement_time)"
+            )
+            print("Added unique key uq_kurnik_device_time to kurniki_dane")
+    except Exception as e:
+        print(f"Migration note for kurniki_dane unique key: {e}")
+
+    # Node window aggregates (min/max/avg/std per sensor)
+    stat_columns = ",\n".join(
+        f"          {field}_{stat} {'FLOAT' if field in ('temp', 'hum') else 'INT'}"
+        for field in AGGREGATE_FIELDS for stat in AGGREGATE_STATS
+    )
+    try:
+        cursor.execute(
+            f"""
+            CREATE TABLE IF NOT EXISTS kurniki_agregaty (
+              id INT AUTO_INCREMENT PRIMARY KEY,
+              kurnik VARCHAR(50),
+              device_id INT,
+              period_s INT,
+              samples INT,
+{stat_columns},
+              window_end DATETIME,
+              created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+              UNIQUE KEY uq_kurnik_device_end (kurnik, device_id, window_end)
+            )
+            """
+        )
+    except Exception as e:
+        print(f"Failed to ensure kurniki_agregaty table: {e}")
+
+    # Migration: aggregates go through the gateway's offline queue like samples,
+    # so a window can be delivered more than once - one row per device window
+    try:
+        cursor.execute("SHOW INDEX FROM kurniki_agregaty WHERE Key_name = 'uq_kurnik_device_end'")
+        if not cursor.fetchall():
+            cursor.execute(
+                """
+                DELETE newer FROM kurniki_agregaty newer
+                JOIN kurniki_agregaty older
+                  ON newer.kurnik = older.kurnik
+                 AND newer.device_id = older.device_id
+                 AND newer.window_end = older.window_end
+                 AND newer.id > older.id
+                """
+            )
+            if cursor.rowcount:
+                print(f"Removed {cursor.rowcount} redelivered duplicate rows from kurniki_agregaty")
+            cursor.execute(
+                "ALTER TABLE kurniki_agregaty ADD UNIQUE KEY uq_kurnik_device_end (kurnik, device_id, window_end)"
+            )
+            print("Added unique key uq_kurnik_device_end to kurniki_agregaty")
+    except Exception as e:
+        print(f"Migration note for kurniki_agregaty unique key: {e}")
+
     # Create new table for chicken events
     try:
         cursor.execute(
@@ -128,7 +241,8 @@ def ensure_schema(conn) -> None:
               waga FLOAT,
               event_time DATETIME,
               payload_raw TEXT,
-              created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+              created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+              UNIQUE KEY uq_kurnik_kura_time (kurnik, id_kury, event_time)
             )
             """
         )
@@ -160,6 +274,30 @@ def ensure_schema(conn) -> None:
         if "duplicate" not in str(e).lower() and "check" not in str(e).lower():
             print(f"Migration note for kury.id_kury: {e}")
 
+    # Migration: scale events go through QoS 1 and the gateway's offline queue,
+    # so an event can arrive twice - one row per chicken event
+    try:
+        cursor.execute("SHOW INDEX FROM kury WHERE Key_name = 'uq_kurnik_kura_time'")
+        if not cursor.fetchall():
+            cursor.execute(
+                """
+                DELETE newer FROM kury newer
+                JOIN kury older
+                  ON newer.kurnik = older.kurnik
+                 AND newer.id_kury = older.id_kury
+                 AND newer.event_time = older.event_time
+                 AND newer.id > older.id
+                """
+            )
+            if cursor.rowcount:
+                print(f"Removed {cursor.rowcount} redelivered duplicate rows from kury")
+            cursor.execute(
+                "ALTER TABLE kury ADD UNIQUE KEY uq_kurnik_kura_time (kurnik, id_kury, event_time)"
+            )
+            print("Added unique key uq_kurnik_kura_time to kury")
+    except Exception as e:
+        print(f"Migration note for kury unique key: {e}")
+
     # Create table for mesh topology
     try:
         cursor.execute(
@@ -179,6 +317,169 @@ def ensure_schema(conn) -> None:
     cursor.close()
 
 
+# A redelivered sample hits uq_kurnik_device_time and is ignored
+INSERT_SENSOR_ROW = """
+    INSERT INTO kurniki_dane
+      (kurnik, device_id, temp, hum, co2, nh3, sun, payload_raw, measurement_time,
+       carried_mask, skipped)
+    VALUES (%s, %s, %s, %s, %s, %s, %s, %s, %s, %s, %s)
+    ON DUPLICATE KEY UPDATE id = id
+"""
+
+AGGREGATE_COLUMNS = [f"{field}_{stat}" for field in AGGREGATE_FIELDS for stat in AGGREGATE_STATS]
+
+# A redelivered window hits uq_kurnik_device_end and is ignored
+INSERT_AGGREGATE_ROW = f"""
+    INSERT INTO kurniki_agregaty
+      (kurnik, device_id, period_s, samples, {", ".join(AGGREGATE_COLUMNS)}, window_end)
+    VALUES ({", ".join(["%s"] * (len(AGGREGATE_COLUMNS) + 5))})
+    ON DUPLICATE KEY UPDATE id = id
+"""
+
+
+def ensure_device(db, kurnik: str, device_id: int, measurement_time: Optional[datetime]) -> None:
+    """Ensure a devices row exists for this kurnik/device_id (auto-create if missing)."""
+    try:
+        c2 = db.cursor()
+        c2.execute("SELECT id FROM kurniki WHERE topic_id = %s", (kurnik,))
+        krow = c2.fetchone()
+        if krow:
+            kurnik_id = krow[0]
+            c2.execute("SELECT id FROM devices WHERE kurnik_id = %s AND device_id = %s", (kurnik_id, device_id))
+            row = c2.fetchone()
+            default_name = f"Urządzenie {device_id}"
+            if not row:
+                try:
+                    if measurement_time:
+                        c2.execute(
+                            "INSERT INTO devices (kurnik_id, device_id, name, paired_at) VALUES (%s, %s, %s, %s)",
+                            (kurnik_id, device_id, default_name, measurement_time),
+                        )
+                    else:
+                        c2.execute(
+                            "INSERT INTO devices (kurnik_id, device_id, name, paired_at) VALUES (%s, %s, %s, NOW())",
+                            (kurnik_id, device_id, default_name),
+                        )
+                    print(f"Auto-created device entry for kurnik_id={kurnik_id} device_id={device_id}")
+                except Exception as e:
+                    print(f"Failed to auto-create device entry: {e}")
+            else:
+                try:
+                    c2.execute("SELECT name, paired_at FROM devices WHERE kurnik_id = %s AND device_id = %s", (kurnik_id, device_id))
+                    info = c2.fetchone()
+                    name_val = info[0] if info else None
+                    paired_val = info[1] if info and len(info) > 1 else None
+                    if name_val is None or paired_val is None:
+                        if measurement_time:
+                            c2.execute(
+                                "UPDATE devices SET name = %s, paired_at = %s WHERE kurnik_id = %s AND device_id = %s",
+                                (default_name, measurement_time, kurnik_id, device_id),
+                            )
+                        else:
+                            c2.execute(
+                                "UPDATE devices SET name = %s, paired_at = NOW() WHERE kurnik_id = %s AND device_id = %s",
+                                (default_name, kurnik_id, device_id),
+                            )
+                        print(f"Restored device metadata for kurnik_id={kurnik_id} device_id={device_id}")
+                except Exception as e:
+                    print(f"Failed to restore device metadata: {e}")
+        c2.close()
+    except Exception as e:
+        print(f"Device auto-create check failed: {e}")
+
+
+def save_aggregate(db, kurnik: str, parsed_agg) -> None:
+    """Store one node window aggregate (from /agregaty or a gateway record)."""
+    device_id, period_s, samples, stats, timestamp_str = parsed_agg
+    try:
+        window_end = datetime.strptime(timestamp_str, "%H:%M:%S %a, %b %d %Y")
+    except ValueError as e:
+        print(f"Bad aggregate timestamp format: {timestamp_str}, error: {e}")
+        window_end = None
+
+    ensure_device(db, kurnik, device_id, window_end)
+
+    try:
+        c = db.cursor()
+        c.execute(INSERT_AGGREGATE_ROW, (kurnik, device_id, period_s, samples, *stats, window_end))
+        c.close()
+        print(f"Saved aggregate: {kurnik}, {device_id}, {samples} samples / {period_s}s @ {window_end}")
+    except Exception as e:
+        print(f"Failed to save aggregate: {e}")
+
+
+def save_kury_event(db, kurnik: str, parsed_kury, payload_str: str) -> None:
+    """Store one chicken scale event (from /kury or a gateway record)."""
+    id_kury, device_id, waga, timestamp_str = parsed_kury  # id_kury is hex string, waga is in kg
+    try:
+        event_time = datetime.strptime(timestamp_str, "%H:%M:%S %a, %b %d %Y")
+    except ValueError as e:
+        print(f"Bad kury timestamp format: {timestamp_str}, error: {e}")
+        event_time = None
+
+    try:
+        c = db.cursor()
+
+        # A redelivered event must not toggle the mode again - skip it
+        # before the toggle is computed (uq_kurnik_kura_time backs this up)
+        if event_time is not None:
+            c.execute(
+                """SELECT 1 FROM kury
+                   WHERE kurnik = %s AND id_kury = %s AND event_time = %s
+                   LIMIT 1""",
+                (kurnik, id_kury, event_time)
+            )
+            if c.fetchone() is not None:
+                print(f"Skipped redelivered kury event: {kurnik}, kura {id_kury} @ {event_time}")
+                c.close()
+                return
+
+        # Determine tryb_kury (mode): toggle between in/out of coop
+        # First check if chicken exists and get its last mode
+        c.execute(
+            """SELECT tryb_kury FROM kury 
+               WHERE kurnik = %s AND id_kury = %s 
+               ORDER BY id DESC LIMIT 1""",
+            (kurnik, id_kury)
+        )
+        last_entry = c.fetchone()
+        
+        if last_entry is None:
+            # New chicken - first entry means chicken is IN the coop
+            tryb_kury = 1
+            # Auto-create entry in kury_meta for new chicken
+            try:
+                c.execute(
+                    """INSERT INTO kury_meta (kurnik, id_kury, name) 
+                       VALUES (%s, %s, %s)
+                       ON DUPLICATE KEY UPDATE kurnik=kurnik""",
+                    (kurnik, id_kury, f"Kura {id_kury}")
+                )
+                print(f"Auto-created kury_meta entry for new chicken: {id_kury}")
+            except Exception as meta_err:
+                print(f"Failed to create kury_meta entry: {meta_err}")
+        else:
+            # Toggle mode: 1 (in coop) <-> 0 (outside coop)
+            last_mode = last_entry[0]
+            tryb_kury = 0 if last_mode == 1 else 1
+        
+        # Save the event with determined mode
+        c.execute(
+            """
+            INSERT INTO kury
+              (kurnik, device_id, id_kury, tryb_kury, waga, event_time, payload_raw)
+            VALUES (%s, %s, %s, %s, %s, %s, %s)
+            """,
+            (kurnik, device_id, id_kury, tryb_kury, waga, event_time, payload_str),
+        )
+        
+        status_text = "w kurniku" if tryb_kury == 1 else "poza kurnikiem"
+        print(f"Saved kury event: {kurnik}, kura {id_kury}, {status_text}, waga {waga}kg @ {event_time}")
+        c.close()
+    except Exception as e:
+        print(f"Failed to save kury event: {e}")
+
+
 def main() -> None:
     db = connect_mysql_with_retry()
     ensure_schema(db)
@@ -188,6 +489,14 @@ def main() -> None:
         client.subscribe(MQTT_TOPIC)
 
     def on_message(client, userdata, msg):
+        # Synthetic load from the gateway's traffic simulator - never stored
+        if msg.topic.rstrip("/").endswith("/symulacja"):
+            return
+
+        # Gateway task profiler metrics (JSON) - for monitoring tools, not sensor data
+        if msg.topic.rstrip("/").endswith("/metrics"):
+            return
+
         kurnik = get_kurnik_from_topic(msg.topic)
         payload_str = msg.payload.decode("utf-8", errors="replace").strip()
 
@@ -215,75 +524,86 @@ def main() -> None:
                 print(f"Failed to save mesh topology: {e}")
             return
 
-        # If topic ends with /kury -> parse chicken event
+        # Node window aggregates (sent instead of every raw sample). Current
+        # gateways send them as records on the main and /paczka topics.
+        if msg.topic.rstrip("/").endswith("/agregaty"):
+            parsed_agg = parse_aggregate_payload(payload_str)
+            if parsed_agg is None:
+                print("Bad aggregate payload (expected 24 semicolon-separated fields):", msg.topic, payload_str)
+                return
+            save_aggregate(db, kurnik, parsed_agg)
+            return
+
+        # If topic ends with /kury -> parse chicken event. Current gateways send
+        # them as records on the main and /paczka topics (recognised by 4 fields).
         if msg.topic.rstrip("/").endswith("/kury") or msg.topic.split("/")[-1] == "kury":
             parsed_kury = parse_kury_payload(payload_str)
             if parsed_kury is None:
                 print("Bad kury payload (expected 4 semicolon-separated fields):", msg.topic, payload_str)
                 return
-            id_kury, device_id, waga, timestamp_str = parsed_kury  # id_kury is hex string, waga is in kg
-            try:
-                event_time = datetime.strptime(timestamp_str, "%H:%M:%S %a, %b %d %Y")
-            except ValueError as e:
-                print(f"Bad kury timestamp format: {timestamp_str}, error: {e}")
-                event_time = None
+            save_kury_event(db, kurnik, parsed_kury, payload_str)
+            return
+
+        # Gateway batch: newline-separated sensor records from one publish window,
+        # stored with a single multi-row INSERT
+        if msg.topic.rstrip("/").endswith("/paczka"):
+            rows = []
+            devices = {}
+            for line in payload_str.splitlines():
+                line = line.strip()
+                if not line:
+                    continue
+                parsed = parse_csv_payload(line)
+                if parsed is None:
+                    parsed_agg = parse_aggregate_payload(line)
+                    parsed_kury = parse_kury_payload(line) if parsed_agg is None else None
+                    if parsed_agg is not None:
+                        save_aggregate(db, kurnik, parsed_agg)
+                    elif parsed_kury is not None:
+                        save_kury_event(db, kurnik, parsed_kury, line)
+                    else:
+                        print("Bad batch record (expected 4, 7, 9 or 24 semicolon-separated fields):", msg.topic, line)
+                    continue
+                device_id, temp, hum, co2, nh3, sun, timestamp_str, carried_mask, skipped = parsed
+                try:
+                    measurement_time = datetime.strptime(timestamp_str, "%H:%M:%S %a, %b %d %Y")
+                except ValueError as e:
+                    print(f"Bad timestamp format: {timestamp_str}, error: {e}")
+                    measurement_time = None
+                devices.setdefault(device_id, measurement_time)
+                rows.append((kurnik, device_id, temp, hum, co2, nh3, sun, line, measurement_time,
+                             carried_mask, skipped))
+            if not rows:
+                return
+
+            for device_id, measurement_time in devices.items():
+                ensure_device(db, kurnik, device_id, measurement_time)
 
             try:
-                c = db.cursor()
-                
-                # Determine tryb_kury (mode): toggle between in/out of coop
-                # First check if chicken exists and get its last mode
-                c.execute(
-                    """SELECT tryb_kury FROM kury 
-                       WHERE kurnik = %s AND id_kury = %s 
-                       ORDER BY id DESC LIMIT 1""",
-                    (kurnik, id_kury)
-                )
-                last_entry = c.fetchone()
-                
-                if last_entry is None:
-                    # New chicken - first entry means chicken is IN the coop
-                    tryb_kury = 1
-                    # Auto-create entry in kury_meta for new chicken
-                    try:
-                        c.execute(
-                            """INSERT INTO kury_meta (kurnik, id_kury, name) 
-                               VALUES (%s, %s, %s)
-                               ON DUPLICATE KEY UPDATE kurnik=kurnik""",
-                            (kurnik, id_kury, f"Kura {id_kury}")
-                        )
-                        print(f"Auto-created kury_meta entry for new chicken: {id_kury}")
-                    except Exception as meta_err:
-                        print(f"Failed to create kury_meta entry: {meta_err}")
-                else:
-                    # Toggle mode: 1 (in coop) <-> 0 (outside coop)
-                    last_mode = last_entry[0]
-                    tryb_kury = 0 if last_mode == 1 else 1
-                
-                # Save the event with determined mode
-                c.execute(
-                    """
-                    INSERT INTO kury
-                      (kurnik, device_id, id_kury, tryb_kury, waga, event_time, payload_raw)
-                    VALUES (%s, %s, %s, %s, %s, %s, %s)
-                    """,
-                    (kurnik, device_id, id_kury, tryb_kury, waga, event_time, payload_str),
-                )
-                
-                status_text = "w kurniku" if tryb_kury == 1 else "poza kurnikiem"
-                print(f"Saved kury event: {kurnik}, kura {id_kury}, {status_text}, waga {waga}kg @ {event_time}")
-                c.close()
+                cursor = db.cursor()
+                # mysql.connector rewrites executemany() of an INSERT ... VALUES into one statement
+                cursor.executemany(INSERT_SENSOR_ROW, rows)
+                cursor.close()
+                print(f"Saved batch: {kurnik}, {len(rows)} records from {len(devices)} devices")
             except Exception as e:
-                print(f"Failed to save kury event: {e}")
+                print(f"Failed to save batch: {e}")
             return
 
         # Otherwise handle sensor payloads
         parsed = parse_csv_payload(payload_str)
         if parsed is None:
-            print("Bad payload (expected 7 semicolon-separated fields):", msg.topic, payload_str)
+            parsed_agg = parse_aggregate_payload(payload_str)
+            if parsed_agg is not None:
+                save_aggregate(db, kurnik, parsed_agg)
+                return
+            parsed_kury = parse_kury_payload(payload_str)
+            if parsed_kury is not None:
+                save_kury_event(db, kurnik, parsed_kury, payload_str)
+                return
+            print("Bad payload (expected 4, 7, 9 or 24 semicolon-separated fields):", msg.topic, payload_str)
             return
 
-        device_id, temp, hum, co2, nh3, sun, timestamp_str = parsed
+        device_id, temp, hum, co2, nh3, sun, timestamp_str, carried_mask, skipped = parsed
 
         # Parse timestamp from format: "14:30:04 Tue, Jan 06 2026"
         try:
@@ -292,63 +612,13 @@ def main() -> None:
             print(f"Bad timestamp format: {timestamp_str}, error: {e}")
             measurement_time = None
 
-        # Ensure a devices row exists for this kurnik/device_id (auto-create if missing)
-        try:
-            c2 = db.cursor()
-            c2.execute("SELECT id FROM kurniki WHERE topic_id = %s", (kurnik,))
-            krow = c2.fetchone()
-            if krow:
-                kurnik_id = krow[0]
-                c2.execute("SELECT id FROM devices WHERE kurnik_id = %s AND device_id = %s", (kurnik_id, device_id))
-                row = c2.fetchone()
-                default_name = f"Urządzenie {device_id}"
-                if not row:
-                    try:
-                        if measurement_time:
-                            c2.execute(
-                                "INSERT INTO devices (kurnik_id, device_id, name, paired_at) VALUES (%s, %s, %s, %s)",
-                                (kurnik_id, device_id, default_name, measurement_time),
-                            )
-                        else:
-                            c2.execute(
-                                "INSERT INTO devices (kurnik_id, device_id, name, paired_at) VALUES (%s, %s, %s, NOW())",
-                                (kurnik_id, device_id, default_name),
-                            )
-                        print(f"Auto-created device entry for kurnik_id={kurnik_id} device_id={device_id}")
-                    except Exception as e:
-                        print(f"Failed to auto-create device entry: {e}")
-                else:
-                    try:
-                        c2.execute("SELECT name, paired_at FROM devices WHERE kurnik_id = %s AND device_id = %s", (kurnik_id, device_id))
-                        info = c2.fetchone()
-                        name_val = info[0] if info else None
-                        paired_val = info[1] if info and len(info) > 1 else None
-                        if name_val is None or paired_val is None:
-                            if measurement_time:
-                                c2.execute(
-                                    "UPDATE devices SET name = %s, paired_at = %s WHERE kurnik_id = %s AND device_id = %s",
-                                    (default_name, measurement_time, kurnik_id, device_id),
-                                )
-                            else:
-                                c2.execute(
-                                    "UPDATE devices SET name = %s, paired_at = NOW() WHERE kurnik_id = %s AND device_id = %s",
-                                    (default_name, kurnik_id, device_id),
-                                )
-                            print(f"Restored device metadata for kurnik_id={kurnik_id} device_id={device_id}")
-                    except Exception as e:
-                        print(f"Failed to restore device metadata: {e}")
-            c2.close()
-        except Exception as e:
-            print(f"Device auto-create check failed: {e}")
+        ensure_device(db, kurnik, device_id, measurement_time)
 
         cursor = db.cursor()
         cursor.execute(
-            """
-            INSERT INTO kurniki_dane
-              (kurnik, device_id, temp, hum, co2, nh3, sun, payload_raw, measurement_time)
-            VALUES (%s, %s, %s, %s, %s, %s, %s, %s, %s)
-            """,
-            (kurnik, device_id, temp, hum, co2, nh3, sun, payload_str, measurement_time),
+            INSERT_SENSOR_ROW,
+            (kurnik, device_id, temp, hum, co2, nh3, sun, payload_str, measurement_time,
+             carried_mask, skipped),
         )
         cursor.close()
 